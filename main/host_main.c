@@ -0,0 +1,140 @@
+#include "mpr121_bench.h"
+
+// -------------------------- 主机端基准测试入口（linux目标，无需硬件） --------------------------
+#define HOST_BENCH_FRAMES 2000 // 每条读取路径的帧数
+
+static const char *TAG = "host_main";
+
+/**
+ * @brief 4片模拟芯片上对比同步与异步扫描（模拟器的异步读取立即完成，仅验证路径与开销），
+ *        每片按住不同的电极，校验合并后的48位掩码中每片的位置
+ */
+static esp_err_t host_bench_scan(void)
+{
+    static const uint8_t touched[MPR121_MAX_DEVICES] = {0, 5, 7, 11}; // 各片按住的电极（含首尾电极）
+    static mpr121_sim_t sims[MPR121_MAX_DEVICES];
+    static mpr121_dev_t devs[MPR121_MAX_DEVICES];
+    mpr121_dev_t *dev_ptrs[MPR121_MAX_DEVICES];
+    uint64_t expected = 0;
+
+    for (int i = 0; i < MPR121_MAX_DEVICES; i++)
+    {
+        const mpr121_sim_touch_t touch = {
+            .start_sample = 8, // 先让基线收敛
+            .end_sample = UINT32_MAX,
+            .mask = 1 << touched[i],
+            .drop = 60,
+        };
+        ESP_RETURN_ON_ERROR(mpr121_bench_sim_setup(&sims[i], &devs[i], NULL, MPR121_DEFAULT_ADDR + i, 700, 2), TAG,
+                            "Setup failed");
+        ESP_RETURN_ON_ERROR(mpr121_sim_add_touch(&sims[i], &touch), TAG, "Add touch failed");
+        for (int n = 0; n < 16; n++)
+        {
+            mpr121_sim_step(&sims[i]);
+        }
+        dev_ptrs[i] = &devs[i];
+        expected |= 1ULL << (i * MPR121_NUM_ELECTRODES + touched[i]);
+    }
+
+    uint64_t mask = 0;
+    ESP_RETURN_ON_ERROR(mpr121_bench_scan(dev_ptrs, MPR121_MAX_DEVICES, HOST_BENCH_FRAMES, &mask), TAG, "Scan failed");
+    if (mask != expected)
+    {
+        ESP_LOGE(TAG, "Scan mask 0x%012llX, expected 0x%012llX", (unsigned long long)mask,
+                 (unsigned long long)expected);
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief 在模拟芯片上运行采集/处理流水线（FreeRTOS POSIX移植下两个任务为宿主线程）
+ */
+static esp_err_t host_bench_pipeline(void)
+{
+    static mpr121_sim_t sim;
+    static mpr121_dev_t dev;
+
+    ESP_RETURN_ON_ERROR(mpr121_bench_sim_setup(&sim, &dev, NULL, MPR121_DEFAULT_ADDR, 700, 2), TAG, "Setup failed");
+    return mpr121_bench_pipeline(&dev, 500);
+}
+
+void app_main(void)
+{
+    ESP_LOGI(TAG, "Running MPR121 benchmarks on the register-level simulator...");
+
+    esp_err_t err = mpr121_bench_sim(HOST_BENCH_FRAMES);
+    if (err == ESP_OK)
+    {
+        err = mpr121_bench_slider(HOST_BENCH_FRAMES * 100);
+    }
+    if (err == ESP_OK)
+    {
+        err = host_bench_scan();
+    }
+    if (err == ESP_OK)
+    {
+        err = mpr121_bench_trace(HOST_BENCH_FRAMES * 100);
+    }
+    if (err == ESP_OK)
+    {
+        err = mpr121_bench_profile();
+    }
+    if (err == ESP_OK)
+    {
+        err = mpr121_bench_filter(HOST_BENCH_FRAMES * 100);
+    }
+    if (err == ESP_OK)
+    {
+        err = host_bench_pipeline();
+    }
+    if (err == ESP_OK)
+    {
+        err = mpr121_bench_gpio(HOST_BENCH_FRAMES);
+    }
+    if (err == ESP_OK)
+    {
+        err = mpr121_bench_recover(100);
+    }
+    if (err == ESP_OK)
+    {
+        err = mpr121_bench_health(HOST_BENCH_FRAMES);
+    }
+    if (err == ESP_OK)
+    {
+        err = mpr121_bench_record(HOST_BENCH_FRAMES);
+    }
+    if (err == ESP_OK)
+    {
+        err = mpr121_bench_sched(500);
+    }
+    if (err == ESP_OK)
+    {
+        err = mpr121_bench_tune(HOST_BENCH_FRAMES);
+    }
+    if (err == ESP_OK)
+    {
+        err = mpr121_bench_pubsub(HOST_BENCH_FRAMES);
+    }
+    if (err == ESP_OK)
+    {
+        err = mpr121_bench_calib();
+    }
+    if (err == ESP_OK)
+    {
+        err = mpr121_bench_power(4);
+    }
+    if (err == ESP_OK)
+    {
+        err = mpr121_bench_gesture(200);
+    }
+    if (err == ESP_OK)
+    {
+        err = mpr121_bench_stream(500);
+    }
+    if (err == ESP_OK)
+    {
+        err = mpr121_bench_event();
+    }
+    ESP_LOGI(TAG, "Benchmarks finished: %s", esp_err_to_name(err));
+}
@@ -1,4 +1,22 @@
 #include "mpr121.h"
+#if CONFIG_MPR121_BENCH
+#include "mpr121_bench.h"
+#endif
+#include "mpr121_event.h"
+#include "mpr121_calib.h"
+#include "mpr121_power.h"
+#include "mpr121_trace.h"
+#include "mpr121_profile.h"
+#include "mpr121_recover.h"
+#include "mpr121_health.h"
+#include "mpr121_record.h"
+#include "mpr121_pipeline.h"
+#include "mpr121_sched.h"
+#include "mpr121_tune.h"
+#include "mpr121_pubsub.h"
+#include <nvs_flash.h>
+#include <nvs.h>
+#include <esp_timer.h>
 
 // -------------------------- 硬件参数配置（集中管理，方便移植） --------------------------
 #define I2C_MASTER_NUM I2C_NUM_0            // I2C端口号
@@ -7,23 +25,57 @@
 #define I2C_MASTER_FREQ_HZ 100000           // I2C频率
 #define MPR121_INT_PIN 4                    // 中断引脚
 #define MPR121_I2C_ADDR MPR121_DEFAULT_ADDR // MPR121地址
+#define MPR121_BENCH_FRAMES 0               // 启动时读取路径基准测试帧数（0=不运行；需在menuconfig中使能CONFIG_MPR121_BENCH）
+#define MPR121_RECORD_BYTES 0               // 启动时按MPR121_RECORD_PERIOD_MS周期录制完整帧的缓冲区大小，录满后导出到控制台（0=不录制；约16~24字节/帧）
+#define MPR121_RECORD_PERIOD_MS 20          // 录制周期（整数个tick，不小于芯片采样间隔ESI=16ms，否则相邻帧重复）
+#define MPR121_AUTO_TUNE_FRAMES 0           // 启动时按该帧数统计空闲噪声并逐电极调校阈值，再以一半帧数验证误触发（0=不调校）
+#define MPR121_AUTO_TUNE_PERIOD_MS 5        // 调校时的读取周期（不小于芯片采样间隔）
+#define MPR121_I2C_ASYNC 0                  // 1=以异步模式添加设备（传输完成回调，可多传输在途）
+#define MPR121_BUS_SCHED 0                  // 1=经总线调度器访问（总线上另有IMU/EEPROM等设备时，触摸状态读取优先）
+#define MPR121_LOW_POWER 0                  // 1=接近检测门控的低功耗模式（空闲时仅ELEPROX以长ESI采样）
+#define MPR121_IDLE_TIMEOUT_MS 5000         // 低功耗模式：全部释放后回到空闲的超时
+#define MPR121_EVENT_TRACE 1                // 1=事件写入二进制跟踪环由低优先级任务输出；0=逐事件ESP_LOGI
+#define MPR121_TRACE_DRAIN_MS 100           // 跟踪输出周期
+#define MPR121_LATENCY_REPORT_EVENTS 256    // 每处理该数量的事件输出一次处理延迟统计
+#define MPR121_HEALTH_CHECK_MS 1000         // 无中断时回读校验芯片配置的周期（检测静默的掉电复位）
+#define MPR121_VDD_MV 3300                  // MPR121供电电压（用于自动配置上下限）
+#define MPR121_TOUCH_PROFILE MPR121_PROFILE_DRY // 启动时应用的调校配置（运行中可随环境调用mpr121_profile_apply()切换）
+#define MPR121_CALIB_NVS_NAMESPACE "mpr121" // 校准数据NVS命名空间
+#define MPR121_CALIB_NVS_KEY "calib"        // 校准数据NVS键名
 
 static const char *TAG = "main";
 
 // -------------------------- 全局资源（仅必要时声明为全局） --------------------------
 SemaphoreHandle_t mpr121_semaphore = NULL;     // 触摸中断信号量
 i2c_master_bus_handle_t i2c_bus_handle = NULL; // I2C总线句柄
-i2c_master_dev_handle_t mpr121_handle = NULL;  // MPR121设备句柄
+mpr121_dev_t mpr121_dev = {0};                 // MPR121设备句柄
+mpr121_event_pipe_t mpr121_events;             // 触摸事件管线（IRQ时间戳环+事件环）
+mpr121_power_t mpr121_power;                   // 低功耗模式管理器
+mpr121_recover_t mpr121_recover;               // 总线故障恢复器
+mpr121_health_t mpr121_health;                 // 芯片健康监测器（超范围/过流）
+mpr121_sched_t i2c_sched;                      // 总线调度器（MPR121_BUS_SCHED=1时使用）
+mpr121_sched_client_t mpr121_bus_client;       // MPR121的总线客户端（其他设备另行添加客户端）
+mpr121_pubsub_t mpr121_pubsub;                 // 触摸事件发布器（UI/振动/遥测等任务以mpr121_pubsub_subscribe()订阅）
 
 // -------------------------- 资源清理函数（专业代码必备） --------------------------
 static void i2c_master_deinit(void)
 {
-    if (mpr121_handle != NULL)
+    if (MPR121_BUS_SCHED && mpr121_bus_client.io_ctx != NULL)
     {
-        ESP_ERROR_CHECK(i2c_master_bus_rm_device(mpr121_handle));
-        mpr121_handle = NULL;
+        ESP_ERROR_CHECK(mpr121_sched_del_i2c_client(&mpr121_bus_client));
+        mpr121_dev.bus_ctx = NULL;
+        ESP_LOGI(TAG, "Removed MPR121 bus client");
+    }
+    if (mpr121_dev.bus_ctx != NULL)
+    {
+        ESP_ERROR_CHECK(mpr121_del_device(&mpr121_dev));
         ESP_LOGI(TAG, "Removed MPR121 I2C device");
     }
+    if (MPR121_BUS_SCHED && i2c_sched.lock != NULL)
+    {
+        ESP_ERROR_CHECK(mpr121_sched_deinit(&i2c_sched));
+        ESP_LOGI(TAG, "Deleted I2C bus scheduler");
+    }
     if (i2c_bus_handle != NULL)
     {
         ESP_ERROR_CHECK(i2c_del_master_bus(i2c_bus_handle));
@@ -32,6 +84,44 @@ static void i2c_master_deinit(void)
     }
 }
 
+// -------------------------- 校准数据存储（NVS blob） --------------------------
+static esp_err_t calib_nvs_load(void *ctx, void *buf, size_t len)
+{
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(MPR121_CALIB_NVS_NAMESPACE, NVS_READONLY, &nvs);
+    if (err == ESP_OK)
+    {
+        size_t size = len;
+        err = nvs_get_blob(nvs, MPR121_CALIB_NVS_KEY, buf, &size);
+        nvs_close(nvs);
+        if (err == ESP_OK && size != len)
+        {
+            err = ESP_ERR_INVALID_SIZE;
+        }
+    }
+    // 首次启动命名空间或键不存在，视为无校准数据
+    return err == ESP_ERR_NVS_NOT_FOUND ? ESP_ERR_NOT_FOUND : err;
+}
+
+static esp_err_t calib_nvs_save(void *ctx, const void *buf, size_t len)
+{
+    nvs_handle_t nvs;
+    ESP_RETURN_ON_ERROR(nvs_open(MPR121_CALIB_NVS_NAMESPACE, NVS_READWRITE, &nvs), TAG, "Open NVS failed");
+    esp_err_t err = nvs_set_blob(nvs, MPR121_CALIB_NVS_KEY, buf, len);
+    if (err == ESP_OK)
+    {
+        err = nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+    return err;
+}
+
+static const mpr121_calib_storage_t calib_storage = {
+    .load = calib_nvs_load,
+    .save = calib_nvs_save,
+    .ctx = NULL,
+};
+
 // -------------------------- IRQ中断处理函数（轻量化+IRAM安全） --------------------------
 static void IRAM_ATTR mpr121_irq_handler(void *arg)
 {
@@ -40,7 +130,9 @@ static void IRAM_ATTR mpr121_irq_handler(void *arg)
     if (gpio_num == MPR121_INT_PIN && gpio_get_level(MPR121_INT_PIN) == 0)
     {
         BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-        // 信号量触发（ISR中必须用FromISR版本）
+        // 记录IRQ时间戳（无锁环形缓冲，多个IRQ不会被合并丢失）
+        mpr121_event_irq_from_isr(&mpr121_events);
+        // 信号量仅用于唤醒任务（ISR中必须用FromISR版本）
         if (mpr121_semaphore != NULL)
         {
             xSemaphoreGiveFromISR(mpr121_semaphore, &xHigherPriorityTaskWoken);
@@ -59,6 +151,7 @@ static esp_err_t i2c_master_init(void)
         .scl_io_num = I2C_MASTER_SCL_IO,
         .sda_io_num = I2C_MASTER_SDA_IO,
         .glitch_ignore_cnt = 7,               // 过滤7个时钟周期的毛刺
+        .trans_queue_depth = MPR121_I2C_ASYNC ? 8 : 0, // 异步模式需要传输队列
         .flags.enable_internal_pullup = true, // 启用内部上拉（外部建议加4.7kΩ上拉）
     };
 
@@ -67,16 +160,28 @@ static esp_err_t i2c_master_init(void)
         i2c_new_master_bus(&i2c_bus_cfg, &i2c_bus_handle),
         TAG, "Create I2C master bus failed");
 
-    // 配置MPR121从设备
-    i2c_device_config_t mpr121_dev_cfg = {
-        .dev_addr_length = I2C_ADDR_BIT_LEN_7,
-        .device_address = MPR121_I2C_ADDR,
-        .scl_speed_hz = I2C_MASTER_FREQ_HZ,
-    };
+    // 共享总线：MPR121作为调度器的客户端，IMU/EEPROM等设备以mpr121_sched_add_i2c_client()加入同一调度器
+    if (MPR121_BUS_SCHED)
+    {
+        const mpr121_sched_client_config_t client_cfg = {
+            .name = "mpr121",
+            .cls = MPR121_SCHED_NORMAL, // 触摸状态读取自动提升为URGENT
+            .addr_len = 1,
+        };
+        ESP_RETURN_ON_ERROR(mpr121_sched_init(&i2c_sched, MPR121_SCHED_CHUNK_BYTES), TAG, "Init bus scheduler failed");
+        ESP_RETURN_ON_ERROR(mpr121_sched_add_i2c_client(&i2c_sched, i2c_bus_handle, MPR121_I2C_ADDR, I2C_MASTER_FREQ_HZ,
+                                                        &client_cfg, &mpr121_bus_client),
+                            TAG, "Add MPR121 bus client failed");
+        ESP_RETURN_ON_ERROR(mpr121_sched_attach_dev(&mpr121_dev, &mpr121_bus_client, MPR121_I2C_ADDR),
+                            TAG, "Attach MPR121 to scheduler failed");
+        ESP_LOGI(TAG, "I2C master init successful (SCL: %d, SDA: %d, scheduled)", I2C_MASTER_SCL_IO, I2C_MASTER_SDA_IO);
+        return ESP_OK;
+    }
 
     // 添加MPR121设备到I2C总线
     ESP_RETURN_ON_ERROR(
-        i2c_master_bus_add_device(i2c_bus_handle, &mpr121_dev_cfg, &mpr121_handle),
+        MPR121_I2C_ASYNC ? mpr121_add_device_async(i2c_bus_handle, MPR121_I2C_ADDR, I2C_MASTER_FREQ_HZ, &mpr121_dev)
+                         : mpr121_add_device(i2c_bus_handle, MPR121_I2C_ADDR, I2C_MASTER_FREQ_HZ, &mpr121_dev),
         TAG, "Add MPR121 to I2C bus failed");
 
     ESP_LOGI(TAG, "I2C master init successful (SCL: %d, SDA: %d)",
@@ -84,6 +189,14 @@ static esp_err_t i2c_master_init(void)
     return ESP_OK;
 }
 
+/**
+ * @brief 总线复位回调：发送SCL脉冲释放被从机拉住的SDA（故障恢复时调用）
+ */
+static esp_err_t i2c_bus_reset(void *arg)
+{
+    return i2c_master_bus_reset((i2c_master_bus_handle_t)arg);
+}
+
 // -------------------------- GPIO中断配置函数（分离逻辑+规范命名） --------------------------
 static esp_err_t mpr121_irq_init(void)
 {
@@ -98,6 +211,14 @@ static esp_err_t mpr121_irq_init(void)
 
     // 安装中断服务（参数0：不使用共享中断）
     gpio_install_isr_service(0);
+    // 初始化事件管线（须在中断使能前完成）
+    ESP_RETURN_ON_ERROR(mpr121_event_pipe_init(&mpr121_events, &mpr121_dev), TAG, "Init event pipe failed");
+    // 健康监测随每次IRQ的状态读取进行（超范围/过流标志与触摸状态一次读出）
+    ESP_RETURN_ON_ERROR(mpr121_health_init(&mpr121_health, &mpr121_dev), TAG, "Init health monitor failed");
+    mpr121_event_pipe_set_health(&mpr121_events, &mpr121_health);
+    // 事件只读取一次总线，由主循环发布给所有订阅者
+    ESP_RETURN_ON_ERROR(mpr121_pubsub_init(&mpr121_pubsub), TAG, "Init event publisher failed");
+
     // 添加中断处理函数
     ESP_RETURN_ON_ERROR(
         gpio_isr_handler_add(MPR121_INT_PIN, mpr121_irq_handler, (void *)MPR121_INT_PIN),
@@ -115,12 +236,124 @@ static esp_err_t mpr121_irq_init(void)
     return ESP_OK;
 }
 
+#if MPR121_RECORD_BYTES > 0
+static uint8_t s_record_buf[MPR121_RECORD_BYTES]; // 录制缓冲区
+
+/**
+ * @brief 以流水线按MPR121_RECORD_PERIOD_MS周期采集完整帧并差分编码录制（周期写入文件头），
+ *        缓冲区写满后停止并以十六进制行导出到控制台，
+ *        主机端用mpr121_record_parse_line()从日志恢复后交给mpr121_replay离线扫描阈值/去抖参数
+ * @return esp_err_t ESP_OK: 录制完成；其他: 启动失败
+ */
+static esp_err_t mpr121_record_capture(void)
+{
+    static mpr121_record_t rec;
+    static mpr121_pipeline_t pipe;
+
+    ESP_RETURN_ON_ERROR(mpr121_record_init(&rec, s_record_buf, sizeof(s_record_buf), MPR121_RECORD_PERIOD_MS * 1000),
+                        TAG, "Init recorder failed");
+    const mpr121_pipeline_config_t cfg = {
+        .dev = &mpr121_dev,
+        .period_ms = MPR121_RECORD_PERIOD_MS,
+        .policy = MPR121_PIPELINE_BLOCK, // 录制需要连续的帧
+        .block_timeout_ms = 5,
+        .acq_core = 0,
+        .proc_core = 1,
+        .acq_prio = configMAX_PRIORITIES - 2,
+        .proc_prio = 5,
+        .process = mpr121_record_process,
+        .arg = &rec,
+    };
+    ESP_RETURN_ON_ERROR(mpr121_pipeline_start(&pipe, &cfg), TAG, "Start recording failed");
+    ESP_LOGI(TAG, "Recording frames into %u bytes, touch the electrodes now", (unsigned)sizeof(s_record_buf));
+    while (rec.dropped == 0)
+    {
+        vTaskDelay(pdMS_TO_TICKS(100));
+    }
+    mpr121_pipeline_stop(&pipe);
+
+    mpr121_pipeline_stats_t stats;
+    mpr121_pipeline_get_stats(&pipe, &stats);
+    ESP_LOGI(TAG, "Recorded %lu frames (%lu dropped by the pipeline)", (unsigned long)rec.frames,
+             (unsigned long)(stats.dropped_newest + stats.dropped_oldest));
+    mpr121_record_dump(&rec, NULL, NULL);
+    return ESP_OK;
+}
+#endif
+
+#if MPR121_AUTO_TUNE_FRAMES > 0
+/**
+ * @brief 统计各电极的空闲噪声并按噪声设置逐电极阈值，应用后再统计一段时间，输出误触发的下降
+ * @note 调校期间可以照常触摸（有触摸迹象的窗口不计入噪声）
+ * @return esp_err_t ESP_OK: 调校完成；其他: 读取或写入失败
+ */
+static esp_err_t mpr121_auto_tune(void)
+{
+    static mpr121_tune_t tune;
+    mpr121_tune_result_t result;
+    mpr121_tune_report_t report;
+
+    ESP_RETURN_ON_ERROR(mpr121_tune_init(&tune, NULL), TAG, "Init tuner failed");
+    ESP_RETURN_ON_ERROR(mpr121_tune_collect(&tune, &mpr121_dev, MPR121_AUTO_TUNE_FRAMES, MPR121_AUTO_TUNE_PERIOD_MS),
+                        TAG, "Collect noise failed");
+    esp_err_t err = mpr121_tune_compute(&tune, &result);
+    if (err == ESP_ERR_NOT_FOUND)
+    {
+        ESP_LOGW(TAG, "Not enough idle frames, thresholds unchanged");
+        return ESP_OK;
+    }
+    ESP_RETURN_ON_ERROR(mpr121_tune_apply(&tune, &mpr121_dev, &result), TAG, "Apply thresholds failed");
+    for (int ch = 0; ch < MPR121_NUM_CHANNELS; ch++)
+    {
+        if (result.tuned & (1 << ch))
+        {
+            ESP_LOGI(TAG, "ELE%d noise %u.%u -> touch %u, release %u", ch, result.noise_x10[ch] / 10,
+                     result.noise_x10[ch] % 10, result.touch[ch], result.release[ch]);
+        }
+    }
+
+    ESP_RETURN_ON_ERROR(mpr121_tune_collect(&tune, &mpr121_dev, MPR121_AUTO_TUNE_FRAMES / 2, MPR121_AUTO_TUNE_PERIOD_MS),
+                        TAG, "Verify thresholds failed");
+    mpr121_tune_get_report(&tune, &report);
+    ESP_LOGI(TAG, "Spurious touch changes: %lu in %lu idle frames -> %lu in %lu (%ld.%ld%% fewer)",
+             (unsigned long)report.spurious_before, (unsigned long)report.idle_frames_before,
+             (unsigned long)report.spurious_after, (unsigned long)report.idle_frames_after,
+             (long)(report.reduction_permille / 10), (long)(report.reduction_permille % 10));
+    return ESP_OK;
+}
+#endif
+
+/**
+ * @brief 电源状态切换后输出切换到的状态与低功耗统计
+ */
+static void mpr121_power_log_state(void)
+{
+    mpr121_power_stats_t power_stats;
+    mpr121_power_get_stats(&mpr121_power, &power_stats);
+    ESP_LOGI(TAG, "Power state -> %s: %lu wakes, %lu sleeps, wake latency last %lu us / max %lu us, idle %lu permille",
+             power_stats.state == MPR121_POWER_IDLE ? "idle" : "active", (unsigned long)power_stats.wakes,
+             (unsigned long)power_stats.sleeps, (unsigned long)power_stats.wake_latency_last_us,
+             (unsigned long)power_stats.wake_latency_max_us, (unsigned long)power_stats.idle_permille);
+}
+
 // -------------------------- 主函数（流程清晰+错误处理） --------------------------
 void app_main(void)
 {
     ESP_LOGI(TAG, "Starting MPR121 touch demo...");
     esp_err_t err = ESP_OK;
 
+    // 0. 初始化NVS（保存MPR121校准数据）
+    err = nvs_flash_init();
+    if (err == ESP_ERR_NVS_NO_FREE_PAGES || err == ESP_ERR_NVS_NEW_VERSION_FOUND)
+    {
+        ESP_ERROR_CHECK(nvs_flash_erase());
+        err = nvs_flash_init();
+    }
+    if (err != ESP_OK)
+    {
+        goto app_exit;
+    }
+
     // 1. 初始化I2C总线
     err = i2c_master_init();
     if (err != ESP_OK)
@@ -128,12 +361,54 @@ void app_main(void)
         goto app_exit; // 初始化失败，跳转到清理流程
     }
 
-    // 2. 初始化MPR121
-    err = mpr121_init(); // 启用接近电极和自动配置
+    // 2. 初始化MPR121（首次启动执行自动配置并保存结果，之后恢复校准数据跳过搜索）
+    const mpr121_calib_config_t calib_cfg = {
+        .vdd_mv = MPR121_VDD_MV,
+        .storage = &calib_storage,
+    };
+    err = mpr121_calib_boot(&mpr121_dev, &calib_cfg, NULL);
     if (err != ESP_OK)
     {
         goto app_exit;
     }
+    err = mpr121_profile_apply(&mpr121_dev, mpr121_profile_get(MPR121_TOUCH_PROFILE), NULL);
+    if (err != ESP_OK)
+    {
+        goto app_exit;
+    }
+
+    // 总线故障恢复：复位总线并按影子缓存重放配置，无需重启
+    const mpr121_recover_config_t recover_cfg = {
+        .bus_reset = i2c_bus_reset,
+        .bus_reset_arg = i2c_bus_handle,
+    };
+    err = mpr121_recover_init(&mpr121_recover, &mpr121_dev, &recover_cfg);
+    if (err != ESP_OK)
+    {
+        goto app_exit;
+    }
+
+#if CONFIG_MPR121_BENCH && MPR121_BENCH_FRAMES > 0
+    // 可选：对比逐电极读取与整帧突发读取的总线开销
+    mpr121_bench_frame_read(&mpr121_dev, MPR121_BENCH_FRAMES);
+    mpr121_dev_t *const scan_devs[] = {&mpr121_dev};
+    mpr121_bench_scan(scan_devs, 1, MPR121_BENCH_FRAMES, NULL);
+    mpr121_bench_pipeline(&mpr121_dev, 1000);
+#endif
+
+#if MPR121_AUTO_TUNE_FRAMES > 0
+    // 可选：按各电极噪声调校阈值（须在中断初始化前，调校期间独占设备）
+    err = mpr121_auto_tune();
+    if (err != ESP_OK)
+    {
+        goto app_exit;
+    }
+#endif
+
+#if MPR121_RECORD_BYTES > 0
+    // 可选：录制完整帧供离线调参（须在中断初始化前，流水线独占设备）
+    mpr121_record_capture();
+#endif
 
     // 3. 初始化MPR121中断
     err = mpr121_irq_init();
@@ -142,29 +417,151 @@ void app_main(void)
         goto app_exit;
     }
 
-    // 4. 主循环：等待中断，处理触摸状态
-    uint16_t current_touch_status = 0;
+    // 可选：进入低功耗模式（须在中断初始化后，接近触发的IRQ才能被接收）
+    if (MPR121_LOW_POWER)
+    {
+        const mpr121_power_config_t power_cfg = {
+            .idle_esi = 5,   // 32ms
+            .active_esi = 2, // 4ms
+            .prox_en = 3,    // ELE0~ELE11组合为接近电极
+            .prox_touch = 0x06,
+            .prox_release = 0x04,
+            .idle_timeout_ms = MPR121_IDLE_TIMEOUT_MS,
+        };
+        err = mpr121_power_init(&mpr121_power, &mpr121_dev, &power_cfg);
+        if (err != ESP_OK)
+        {
+            goto app_exit;
+        }
+    }
+
+    // 跟踪输出任务：格式化与串口输出移出触摸处理路径
+    if (MPR121_EVENT_TRACE && mpr121_trace_start_drain(MPR121_TRACE_DRAIN_MS) != ESP_OK)
+    {
+        ESP_LOGW(TAG, "Trace drain task not started, records stay in the ring");
+    }
+
+    // 4. 主循环：等待中断，将IRQ转换为带时间戳的按下/释放事件
+    mpr121_touch_event_t event;
+    mpr121_event_stats_t stats;
+    uint32_t reported_overflows = 0;
+    uint32_t handled = 0;           // 本统计周期内处理的事件数
+    uint64_t handle_sum_us = 0;     // IRQ时间戳到事件输出完成的延迟总和
+    uint32_t handle_max_us = 0;     // 最大处理延迟
     while (1)
     {
-        // 等待中断信号量（永久阻塞，直到有触摸事件）
-        if (xSemaphoreTake(mpr121_semaphore, portMAX_DELAY) == pdTRUE)
+        // 等待中断信号量（最多等到配置校验周期；低功耗模式的活动状态下最多等到空闲超时）
+        TickType_t wait = MPR121_LOW_POWER ? mpr121_power_wait_ticks(&mpr121_power, esp_timer_get_time())
+                                           : portMAX_DELAY;
+        if (wait > pdMS_TO_TICKS(MPR121_HEALTH_CHECK_MS))
         {
-            // 读取触摸状态
-            err = mpr121_read_touch(&current_touch_status);
+            wait = pdMS_TO_TICKS(MPR121_HEALTH_CHECK_MS);
+        }
+        if (xSemaphoreTake(mpr121_semaphore, wait) == pdTRUE)
+        {
+            err = mpr121_event_process(&mpr121_events);
             if (err != ESP_OK)
             {
-                ESP_LOGE(TAG, "Read touch status failed, skip this event");
-                continue;
+                // 总线故障：恢复后重新处理保留的IRQ（失败的读取不会出队）
+                err = mpr121_recover_run(&mpr121_recover, err);
+                if (err == ESP_OK)
+                {
+                    err = mpr121_event_process(&mpr121_events);
+                }
+                if (err != ESP_OK)
+                {
+                    ESP_LOGE(TAG, "MPR121 recovery failed, retry on next health check");
+                }
             }
 
-            // 打印触摸状态（仅在有触摸时打印，减少冗余）
-            ESP_LOGI(TAG, "Touch status: 0x%04X", current_touch_status);
-            for (int i = 0; i < 12; i++)
+            // 逐个发布并输出边沿事件（短按的按下与释放都会被保留）
+            while (mpr121_event_pop(&mpr121_events, &event))
             {
-                if (current_touch_status & (1 << i))
+                mpr121_pubsub_publish_event(&mpr121_pubsub, &event);
+                if (MPR121_EVENT_TRACE)
+                {
+                    mpr121_trace_write(event.type == MPR121_EVENT_PRESS ? MPR121_TRACE_PRESS : MPR121_TRACE_RELEASE,
+                                       event.electrode, 0, (int32_t)event.latency_us);
+                }
+                else
+                {
+                    ESP_LOGI(TAG, "→ Electrode %d %s at %lld us (latency %lu us)",
+                             event.electrode,
+                             event.type == MPR121_EVENT_PRESS ? "pressed" : "released",
+                             (long long)event.timestamp_us, (unsigned long)event.latency_us);
+                }
+                if (MPR121_LOW_POWER)
                 {
-                    ESP_LOGI(TAG, "→ Electrode %d is touched", i);
+                    mpr121_power_state_t before = mpr121_power.state;
+                    if (mpr121_power_on_event(&mpr121_power, &event) != ESP_OK)
+                    {
+                        ESP_LOGE(TAG, "Power state switch failed");
+                    }
+                    else if (mpr121_power.state != before)
+                    {
+                        mpr121_trace_write(MPR121_TRACE_POWER, mpr121_power.state, 0,
+                                           (int32_t)mpr121_power.wake_latency_last_us);
+                        mpr121_power_log_state();
+                    }
                 }
+
+                // 处理延迟：IRQ到达到该事件输出完成（含日志或跟踪写入的开销）
+                uint32_t handle_us = (uint32_t)(esp_timer_get_time() - event.timestamp_us);
+                handle_sum_us += handle_us;
+                if (handle_us > handle_max_us)
+                {
+                    handle_max_us = handle_us;
+                }
+                if (++handled == MPR121_LATENCY_REPORT_EVENTS)
+                {
+                    ESP_LOGI(TAG, "Event handling latency over %d events: avg %lu us, max %lu us",
+                             MPR121_LATENCY_REPORT_EVENTS, (unsigned long)(handle_sum_us / handled),
+                             (unsigned long)handle_max_us);
+                    handled = 0;
+                    handle_sum_us = 0;
+                    handle_max_us = 0;
+                }
+            }
+
+            mpr121_event_get_stats(&mpr121_events, &stats);
+            if (stats.irq_overflows + stats.event_overflows != reported_overflows)
+            {
+                reported_overflows = stats.irq_overflows + stats.event_overflows;
+                mpr121_trace_write(MPR121_TRACE_EVENT_OVERFLOW, 0, (uint16_t)stats.irq_overflows,
+                                   (int32_t)stats.event_overflows);
+            }
+        }
+        else
+        {
+            // 无中断：回读校验配置（掉电复位后芯片停止扫描且不再产生IRQ）；
+            // 恢复后补发信号量，处理之前恢复失败时保留的IRQ
+            uint32_t recoveries = mpr121_recover.stats.recoveries;
+            if (mpr121_recover_check(&mpr121_recover) != ESP_OK)
+            {
+                ESP_LOGE(TAG, "MPR121 not responding, retry on next health check");
+            }
+            else if (mpr121_recover.stats.recoveries != recoveries)
+            {
+                mpr121_recover_stats_t rec_stats;
+                mpr121_recover_get_stats(&mpr121_recover, &rec_stats);
+                ESP_LOGW(TAG, "MPR121 recovered: %lu recoveries (%lu replays), last %lu us, max %lu us",
+                         (unsigned long)rec_stats.recoveries, (unsigned long)rec_stats.replays,
+                         (unsigned long)rec_stats.last_us, (unsigned long)rec_stats.max_us);
+                xSemaphoreGive(mpr121_semaphore);
+            }
+        }
+
+        if (MPR121_LOW_POWER)
+        {
+            mpr121_power_state_t before = mpr121_power.state;
+            if (mpr121_power_tick(&mpr121_power, esp_timer_get_time()) != ESP_OK)
+            {
+                ESP_LOGE(TAG, "Power state switch failed");
+            }
+            if (mpr121_power.state != before)
+            {
+                mpr121_trace_write(MPR121_TRACE_POWER, mpr121_power.state, 0, 0);
+                mpr121_power_log_state();
             }
         }
     }
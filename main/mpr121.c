@@ -1,65 +1,533 @@
 #include "mpr121.h"
+#include "mpr121_stats.h"
+#include "mpr121_trace.h"
+#include <string.h>
+#include <stdatomic.h>
+#include <esp_attr.h>
+#include <esp_timer.h>
 
 static const char *TAG = "mpr121";
 
-// -------------------------- 静态辅助函数（仅内部使用） --------------------------
+#define CFG_IDX(reg) ((reg) - MPR121_CFG_FIRST)
+
+// -------------------------- I2C总线实现（ESP-IDF i2c_master） --------------------------
+#if MPR121_I2C_SUPPORTED
 /**
- * @brief 向MPR121指定寄存器写入1字节数据
- * @param reg 寄存器地址（0x00~0x80）
- * @param data 要写入的数据
+ * @brief I2C块写：寄存器地址与数据在同一次事务中发送
+ * @param ctx I2C设备句柄（i2c_master_dev_handle_t）
+ * @param reg 起始寄存器地址
+ * @param data 待写入数据
+ * @param len 写入字节数
  * @return esp_err_t ESP_OK: 写入成功；其他: 写入失败
  */
-static esp_err_t mpr121_write_reg(uint8_t reg, uint8_t data)
+static esp_err_t mpr121_i2c_write(void *ctx, uint8_t reg, const uint8_t *data, size_t len)
 {
-
     i2c_master_transmit_multi_buffer_info_t buffers[2] = {
         {.write_buffer = &reg, .buffer_size = 1},
-        {.write_buffer = &data, .buffer_size = 1},
+        {.write_buffer = (uint8_t *)data, .buffer_size = len},
     };
+    return i2c_master_multi_buffer_transmit((i2c_master_dev_handle_t)ctx, buffers, 2, MPR121_I2C_TIMEOUT_MS);
+}
 
-    esp_err_t err = i2c_master_multi_buffer_transmit(mpr121_handle, buffers, 2, portMAX_DELAY);
+/**
+ * @brief I2C块读：先写寄存器地址，重复起始后连续读取
+ * @param ctx I2C设备句柄（i2c_master_dev_handle_t）
+ * @param reg 起始寄存器地址
+ * @param[out] data 接收缓冲区
+ * @param len 读取字节数
+ * @return esp_err_t ESP_OK: 读取成功；其他: 读取失败
+ */
+static esp_err_t mpr121_i2c_read(void *ctx, uint8_t reg, uint8_t *data, size_t len)
+{
+    return i2c_master_transmit_receive((i2c_master_dev_handle_t)ctx, &reg, 1, data, len, MPR121_I2C_TIMEOUT_MS);
+}
+
+static const mpr121_bus_ops_t s_i2c_bus_ops = {
+    .write = mpr121_i2c_write,
+    .read = mpr121_i2c_read,
+};
+
+// 异步模式：i2c_master注册回调后，该设备的传输函数立即返回，完成时在ISR中回调。
+// 发送/接收缓冲区在传输完成前必须保持有效，因此同步读写经由上下文内的缓冲区中转。
+#define MPR121_I2C_ASYNC_BUF (MPR121_SOFT_RESET + 1) // 单次传输最大字节数（覆盖全部寄存器）
+
+/**
+ * @brief 异步模式I2C设备上下文（静态分配，每个设备一个）
+ */
+typedef struct
+{
+    i2c_master_dev_handle_t handle;      // I2C设备句柄（NULL=未使用）
+    atomic_bool busy;                    // 是否有传输在途
+    mpr121_xfer_cb_t cb;                 // 当前传输的完成回调
+    void *cb_arg;                        // 回调参数
+    SemaphoreHandle_t sync;              // 同步读写等待完成
+    esp_err_t sync_result;               // 同步读写结果
+    uint8_t tx[MPR121_I2C_ASYNC_BUF];    // 发送缓冲（寄存器地址+写入数据）
+    uint8_t rx[MPR121_I2C_ASYNC_BUF];    // 同步读取的接收缓冲
+} mpr121_i2c_async_t;
+
+static mpr121_i2c_async_t s_i2c_async[MPR121_MAX_DEVICES];
 
+/**
+ * @brief i2c_master传输完成回调（ISR上下文）：转换事件为esp_err_t并转交当前传输的回调
+ */
+static bool IRAM_ATTR mpr121_i2c_trans_done(i2c_master_dev_handle_t i2c_dev, const i2c_master_event_data_t *evt_data, void *arg)
+{
+    mpr121_i2c_async_t *ctx = (mpr121_i2c_async_t *)arg;
+    if (evt_data->event == I2C_EVENT_ALIVE)
+    {
+        return false;
+    }
+
+    esp_err_t result = evt_data->event == I2C_EVENT_DONE   ? ESP_OK
+                       : evt_data->event == I2C_EVENT_NACK ? ESP_ERR_INVALID_RESPONSE
+                                                           : ESP_ERR_TIMEOUT;
+    mpr121_xfer_cb_t cb = ctx->cb;
+    void *cb_arg = ctx->cb_arg;
+    atomic_store_explicit(&ctx->busy, false, memory_order_release);
+    return cb != NULL ? cb(cb_arg, result) : false;
+}
+
+/**
+ * @brief 占用设备并登记完成回调（同一设备同一时刻只允许一个传输在途）
+ * @return esp_err_t ESP_OK: 占用成功；ESP_ERR_INVALID_STATE: 上一个传输尚未完成
+ */
+static esp_err_t mpr121_i2c_async_claim(mpr121_i2c_async_t *ctx, mpr121_xfer_cb_t cb, void *arg)
+{
+    bool expected = false;
+    if (!atomic_compare_exchange_strong(&ctx->busy, &expected, true))
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    ctx->cb = cb;
+    ctx->cb_arg = arg;
+    return ESP_OK;
+}
+
+/**
+ * @brief 同步读写的完成回调：记录结果并唤醒等待者
+ */
+static bool IRAM_ATTR mpr121_i2c_sync_done(void *arg, esp_err_t result)
+{
+    mpr121_i2c_async_t *ctx = (mpr121_i2c_async_t *)arg;
+    BaseType_t woken = pdFALSE;
+    ctx->sync_result = result;
+    xSemaphoreGiveFromISR(ctx->sync, &woken);
+    return woken == pdTRUE;
+}
+
+/**
+ * @brief 等待同步读写完成（带超时；超时后迟到的完成信号在下次提交前被清除）
+ */
+static esp_err_t mpr121_i2c_sync_wait(mpr121_i2c_async_t *ctx)
+{
+    if (xSemaphoreTake(ctx->sync, pdMS_TO_TICKS(MPR121_I2C_TIMEOUT_MS) + 1) != pdTRUE)
+    {
+        return ESP_ERR_TIMEOUT;
+    }
+    return ctx->sync_result;
+}
+
+static esp_err_t mpr121_i2c_async_write(void *ctx_, uint8_t reg, const uint8_t *data, size_t len)
+{
+    mpr121_i2c_async_t *ctx = (mpr121_i2c_async_t *)ctx_;
+    if (len + 1 > sizeof(ctx->tx))
+    {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    esp_err_t err = mpr121_i2c_async_claim(ctx, mpr121_i2c_sync_done, ctx);
+    if (err != ESP_OK)
+    {
+        return err; // 由mpr121_read_regs()/mpr121_write_regs()写入跟踪记录
+    }
+    xSemaphoreTake(ctx->sync, 0);
+    ctx->tx[0] = reg;
+    memcpy(&ctx->tx[1], data, len);
+    err = i2c_master_transmit(ctx->handle, ctx->tx, len + 1, MPR121_I2C_TIMEOUT_MS);
+    if (err != ESP_OK)
+    {
+        atomic_store(&ctx->busy, false);
+        return err;
+    }
+    return mpr121_i2c_sync_wait(ctx);
+}
+
+static esp_err_t mpr121_i2c_async_read(void *ctx_, uint8_t reg, uint8_t *data, size_t len)
+{
+    mpr121_i2c_async_t *ctx = (mpr121_i2c_async_t *)ctx_;
+    if (len > sizeof(ctx->rx))
+    {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    esp_err_t err = mpr121_i2c_async_claim(ctx, mpr121_i2c_sync_done, ctx);
     if (err != ESP_OK)
     {
-        ESP_LOGE(TAG, "Write reg 0x%02X (data 0x%02X) failed: %s",
-                 reg, data, esp_err_to_name(err));
+        return err; // 由mpr121_read_regs()/mpr121_write_regs()写入跟踪记录
+    }
+    xSemaphoreTake(ctx->sync, 0);
+    ctx->tx[0] = reg;
+    err = i2c_master_transmit_receive(ctx->handle, ctx->tx, 1, ctx->rx, len, MPR121_I2C_TIMEOUT_MS);
+    if (err != ESP_OK)
+    {
+        atomic_store(&ctx->busy, false);
+        return err;
+    }
+    err = mpr121_i2c_sync_wait(ctx);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+    memcpy(data, ctx->rx, len);
+    return ESP_OK;
+}
+
+static esp_err_t mpr121_i2c_async_submit_read(void *ctx_, uint8_t reg, uint8_t *data, size_t len,
+                                              mpr121_xfer_cb_t cb, void *arg)
+{
+    mpr121_i2c_async_t *ctx = (mpr121_i2c_async_t *)ctx_;
+    esp_err_t err = mpr121_i2c_async_claim(ctx, cb, arg);
+    if (err != ESP_OK)
+    {
+        return err; // 由mpr121_async写入跟踪记录
+    }
+    ctx->tx[0] = reg;
+    err = i2c_master_transmit_receive(ctx->handle, ctx->tx, 1, data, len, MPR121_I2C_TIMEOUT_MS);
+    if (err != ESP_OK)
+    {
+        atomic_store(&ctx->busy, false); // 未入队（如队列已满），不会再回调
     }
     return err;
 }
 
+static const mpr121_bus_ops_t s_i2c_async_bus_ops = {
+    .write = mpr121_i2c_async_write,
+    .read = mpr121_i2c_async_read,
+    .submit_read = mpr121_i2c_async_submit_read,
+};
+#endif // MPR121_I2C_SUPPORTED
+
+// -------------------------- 静态辅助函数（仅内部使用） --------------------------
+/**
+ * @brief 向MPR121指定寄存器写入1字节数据
+ * @param dev 设备句柄
+ * @param reg 寄存器地址（0x00~0x80）
+ * @param data 要写入的数据
+ * @return esp_err_t ESP_OK: 写入成功；其他: 写入失败
+ */
+static esp_err_t mpr121_write_reg(mpr121_dev_t *dev, uint8_t reg, uint8_t data)
+{
+    return mpr121_write_regs(dev, reg, &data, 1);
+}
+
 /**
  * @brief 从MPR121指定寄存器读取1字节数据
+ * @param dev 设备句柄
  * @param reg 寄存器地址（0x00~0x80）
  * @param[out] data 读取到的数据
  * @return esp_err_t ESP_OK: 读取成功；其他: 读取失败
  */
-static esp_err_t mpr121_read_reg(uint8_t reg, uint8_t *data)
+static esp_err_t mpr121_read_reg(mpr121_dev_t *dev, uint8_t reg, uint8_t *data)
+{
+    return mpr121_read_regs(dev, reg, data, 1);
+}
+
+/**
+ * @brief 将芯片缓存置为上电/软复位默认值（除0x5C/0x5D外均为0），影子缓存不变
+ */
+static void mpr121_cfg_chip_defaults(mpr121_dev_t *dev)
+{
+    memset(dev->cfg_chip, 0, sizeof(dev->cfg_chip));
+    dev->cfg_chip[CFG_IDX(MPR121_FILT_CDC_CFG)] = 0x10;
+    dev->cfg_chip[CFG_IDX(MPR121_FILT_CDT_CFG)] = 0x24;
+}
+
+/**
+ * @brief 软复位后将影子缓存恢复为芯片上电默认值
+ */
+static void mpr121_cfg_reset_defaults(mpr121_dev_t *dev)
+{
+    mpr121_cfg_chip_defaults(dev);
+    memcpy(dev->cfg_shadow, dev->cfg_chip, sizeof(dev->cfg_shadow));
+}
+
+/**
+ * @brief 判断寄存器是否允许在运行模式下写入（数据手册：仅ELE_CFG与GPIO寄存器）
+ */
+static bool mpr121_cfg_run_writable(uint8_t reg)
+{
+    return reg == MPR121_ELE_CFG || (reg >= MPR121_GPIO_CTRL0 && reg <= MPR121_GPIO_TOGGLE);
+}
+
+/**
+ * @brief 判断未改动的寄存器能否在合并块写时重写原值
+ *
+ * ELE_CFG与GPIO寄存器写入有副作用（模式切换、SET/CLEAR/TOGGLE）；CDC/CDT可能被自动重配置修改，
+ * 缓存值不一定与芯片一致，均不可作为填充。
+ */
+static bool mpr121_cfg_gap_fillable(uint8_t reg)
+{
+    return !mpr121_cfg_run_writable(reg) && (reg < MPR121_CDC_0 || reg > MPR121_CDT_PROX);
+}
+
+/**
+ * @brief 判断寄存器是否待提交（ELE_CFG单独处理，不参与连续区间合并）
+ */
+static bool mpr121_cfg_is_dirty(mpr121_dev_t *dev, uint8_t reg)
+{
+    return reg != MPR121_ELE_CFG && dev->cfg_shadow[CFG_IDX(reg)] != dev->cfg_chip[CFG_IDX(reg)];
+}
+
+// -------------------------- 外部接口实现 --------------------------
+esp_err_t mpr121_attach_bus(mpr121_dev_t *dev, const mpr121_bus_ops_t *ops, void *ctx, uint8_t addr)
+{
+    if (dev == NULL || ops == NULL || ops->write == NULL || ops->read == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(dev, 0, sizeof(*dev));
+    dev->bus = ops;
+    dev->bus_ctx = ctx;
+    dev->addr = addr;
+    mpr121_cfg_reset_defaults(dev);
+    return ESP_OK;
+}
+
+#if MPR121_I2C_SUPPORTED
+esp_err_t mpr121_add_device(i2c_master_bus_handle_t bus, uint8_t addr, uint32_t scl_speed_hz, mpr121_dev_t *dev)
+{
+    if (bus == NULL || dev == NULL || addr < MPR121_DEFAULT_ADDR || addr >= MPR121_DEFAULT_ADDR + MPR121_MAX_DEVICES)
+    {
+        ESP_LOGE(TAG, "Invalid device args (addr 0x%02X)", addr);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    i2c_master_dev_handle_t i2c_dev = NULL;
+    i2c_device_config_t dev_cfg = {
+        .dev_addr_length = I2C_ADDR_BIT_LEN_7,
+        .device_address = addr,
+        .scl_speed_hz = scl_speed_hz,
+    };
+    ESP_RETURN_ON_ERROR(
+        i2c_master_bus_add_device(bus, &dev_cfg, &i2c_dev),
+        TAG, "Add MPR121 0x%02X to I2C bus failed", addr);
+    return mpr121_attach_bus(dev, &s_i2c_bus_ops, i2c_dev, addr);
+}
+
+esp_err_t mpr121_add_device_async(i2c_master_bus_handle_t bus, uint8_t addr, uint32_t scl_speed_hz, mpr121_dev_t *dev)
+{
+    mpr121_i2c_async_t *ctx = NULL;
+    for (int i = 0; i < MPR121_MAX_DEVICES; i++)
+    {
+        if (s_i2c_async[i].handle == NULL)
+        {
+            ctx = &s_i2c_async[i];
+            break;
+        }
+    }
+    if (ctx == NULL)
+    {
+        ESP_LOGE(TAG, "No free async context for 0x%02X", addr);
+        return ESP_ERR_NO_MEM;
+    }
+
+    // 先按同步方式添加，再注册回调切换为异步模式
+    ESP_RETURN_ON_ERROR(mpr121_add_device(bus, addr, scl_speed_hz, dev), TAG, "Add device failed");
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->handle = (i2c_master_dev_handle_t)dev->bus_ctx;
+    ctx->sync = xSemaphoreCreateBinary();
+    i2c_master_event_callbacks_t cbs = {
+        .on_trans_done = mpr121_i2c_trans_done,
+    };
+    esp_err_t err = ctx->sync != NULL ? i2c_master_register_event_callbacks(ctx->handle, &cbs, ctx) : ESP_ERR_NO_MEM;
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Enable async mode for 0x%02X failed: %s", addr, esp_err_to_name(err));
+        if (ctx->sync != NULL)
+        {
+            vSemaphoreDelete(ctx->sync);
+        }
+        mpr121_del_device(dev);
+        memset(ctx, 0, sizeof(*ctx));
+        return err;
+    }
+
+    dev->bus = &s_i2c_async_bus_ops;
+    dev->bus_ctx = ctx;
+    return ESP_OK;
+}
+
+esp_err_t mpr121_del_device(mpr121_dev_t *dev)
+{
+    if (dev == NULL || dev->bus_ctx == NULL)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (dev->bus == &s_i2c_async_bus_ops)
+    {
+        mpr121_i2c_async_t *ctx = (mpr121_i2c_async_t *)dev->bus_ctx;
+        if (atomic_load(&ctx->busy))
+        {
+            return ESP_ERR_INVALID_STATE; // 传输在途，回调仍会访问上下文
+        }
+        ESP_RETURN_ON_ERROR(i2c_master_bus_rm_device(ctx->handle), TAG, "Remove MPR121 0x%02X failed", dev->addr);
+        vSemaphoreDelete(ctx->sync);
+        memset(ctx, 0, sizeof(*ctx));
+    }
+    else if (dev->bus == &s_i2c_bus_ops)
+    {
+        ESP_RETURN_ON_ERROR(i2c_master_bus_rm_device((i2c_master_dev_handle_t)dev->bus_ctx),
+                            TAG, "Remove MPR121 0x%02X failed", dev->addr);
+    }
+    else
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    dev->bus_ctx = NULL;
+    return ESP_OK;
+}
+#endif // MPR121_I2C_SUPPORTED
+
+esp_err_t mpr121_read_regs(mpr121_dev_t *dev, uint8_t reg, uint8_t *data, size_t len)
 {
-    if (data == NULL)
+    if (data == NULL || len == 0)
     {
-        ESP_LOGE(TAG, "Read failed: data buffer is NULL");
+        ESP_LOGE(TAG, "Burst read failed: invalid buffer");
         return ESP_ERR_INVALID_ARG;
     }
 
-    esp_err_t err = i2c_master_transmit_receive(
-        mpr121_handle,
-        &reg, // 发送寄存器地址
-        1,    // 地址长度
-        data, // 接收数据缓冲区
-        1,    // 数据长度
-        portMAX_DELAY);
+    MPR121_STATS_TXN_BEGIN();
+    esp_err_t err = dev->bus->read(dev->bus_ctx, reg, data, len);
+    MPR121_STATS_TXN_END(1, len, err);
+    dev->bus_stats.transactions++;
+    dev->bus_stats.tx_bytes += 1;
+    dev->bus_stats.rx_bytes += len;
 
     if (err != ESP_OK)
     {
-        ESP_LOGE(TAG, "Read reg 0x%02X failed: %s",
-                 reg, esp_err_to_name(err));
+        // 热路径：记录二进制跟踪而非格式化日志，由低优先级任务输出
+        MPR121_TRACE(MPR121_TRACE_READ_ERROR, dev->addr, reg, err);
     }
     return err;
 }
 
-// -------------------------- 外部接口实现 --------------------------
-esp_err_t mpr121_set_thresholds(uint8_t touch, uint8_t release)
+esp_err_t mpr121_write_regs(mpr121_dev_t *dev, uint8_t reg, const uint8_t *data, size_t len)
+{
+    if (data == NULL || len == 0)
+    {
+        ESP_LOGE(TAG, "Block write failed: invalid buffer");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    MPR121_STATS_TXN_BEGIN();
+    esp_err_t err = dev->bus->write(dev->bus_ctx, reg, data, len);
+    MPR121_STATS_TXN_END(1 + len, 0, err);
+    dev->bus_stats.transactions++;
+    dev->bus_stats.tx_bytes += 1 + len;
+
+    if (err != ESP_OK)
+    {
+        MPR121_TRACE(MPR121_TRACE_WRITE_ERROR, dev->addr, reg, err);
+    }
+    return err;
+}
+
+esp_err_t mpr121_cfg_set(mpr121_dev_t *dev, uint8_t reg, uint8_t val)
+{
+    return mpr121_cfg_set_block(dev, reg, &val, 1);
+}
+
+esp_err_t mpr121_cfg_set_block(mpr121_dev_t *dev, uint8_t reg, const uint8_t *vals, size_t len)
+{
+    if (vals == NULL || reg < MPR121_CFG_FIRST || reg + len - 1 > MPR121_CFG_LAST || len == 0)
+    {
+        ESP_LOGE(TAG, "Invalid config range: 0x%02X (+%u)", reg, (unsigned)len);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memcpy(&dev->cfg_shadow[CFG_IDX(reg)], vals, len);
+    return ESP_OK;
+}
+
+esp_err_t mpr121_cfg_get(mpr121_dev_t *dev, uint8_t reg, uint8_t *val)
+{
+    if (val == NULL || reg < MPR121_CFG_FIRST || reg > MPR121_CFG_LAST)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    *val = dev->cfg_shadow[CFG_IDX(reg)];
+    return ESP_OK;
+}
+
+esp_err_t mpr121_cfg_commit(mpr121_dev_t *dev)
+{
+    MPR121_STATS_API(MPR121_API_CFG_COMMIT);
+    uint8_t ecr_target = dev->cfg_shadow[CFG_IDX(MPR121_ELE_CFG)];
+    bool need_stop = false;
+
+    // 运行模式下（ELE_EN或ELEPROX_EN非0）修改仅待机可写的寄存器时，需先进入待机模式
+    if (dev->cfg_chip[CFG_IDX(MPR121_ELE_CFG)] & 0x3F)
+    {
+        for (int reg = MPR121_CFG_FIRST; reg <= MPR121_CFG_LAST; reg++)
+        {
+            if (mpr121_cfg_is_dirty(dev, reg) && !mpr121_cfg_run_writable(reg))
+            {
+                need_stop = true;
+                break;
+            }
+        }
+    }
+    if (need_stop)
+    {
+        ESP_RETURN_ON_ERROR(mpr121_write_reg(dev, MPR121_ELE_CFG, 0x00), TAG, "Enter stop mode failed");
+        dev->cfg_chip[CFG_IDX(MPR121_ELE_CFG)] = 0x00;
+    }
+
+    // 将连续的待提交寄存器合并为一次块写，未改动的寄存器跳过；
+    // 待机模式下（不扫描）相隔少量未改动寄存器的区间也合并：重写几个字节比新开一次事务（起始位+地址+寄存器地址）更快
+    int gap = (dev->cfg_chip[CFG_IDX(MPR121_ELE_CFG)] & 0x3F) ? 0 : MPR121_CFG_MERGE_GAP;
+    int reg = MPR121_CFG_FIRST;
+    while (reg <= MPR121_CFG_LAST)
+    {
+        if (!mpr121_cfg_is_dirty(dev, reg))
+        {
+            reg++;
+            continue;
+        }
+        int end = reg;
+        for (int next = reg + 1; next <= MPR121_CFG_LAST && next - end - 1 <= gap; next++)
+        {
+            if (mpr121_cfg_is_dirty(dev, next))
+            {
+                end = next;
+            }
+            else if (!mpr121_cfg_gap_fillable(next))
+            {
+                break;
+            }
+        }
+        size_t len = end - reg + 1;
+        ESP_RETURN_ON_ERROR(
+            mpr121_write_regs(dev, reg, &dev->cfg_shadow[CFG_IDX(reg)], len),
+            TAG, "Commit config 0x%02X~0x%02X failed", reg, end);
+        memcpy(&dev->cfg_chip[CFG_IDX(reg)], &dev->cfg_shadow[CFG_IDX(reg)], len);
+        reg = end + 1;
+    }
+
+    // 最后写入ELE_CFG，确保其余配置在进入运行模式前已生效
+    if (dev->cfg_chip[CFG_IDX(MPR121_ELE_CFG)] != ecr_target)
+    {
+        ESP_RETURN_ON_ERROR(mpr121_write_reg(dev, MPR121_ELE_CFG, ecr_target), TAG, "Write ELE_CFG failed");
+        dev->cfg_chip[CFG_IDX(MPR121_ELE_CFG)] = ecr_target;
+    }
+    return ESP_OK;
+}
+
+esp_err_t mpr121_set_thresholds(mpr121_dev_t *dev, uint8_t touch, uint8_t release)
 {
+    MPR121_STATS_API(MPR121_API_SET_THRESHOLDS);
     // 检查阈值合理性（释放阈值应小于触摸阈值，避免抖动）
     if (release >= touch)
     {
@@ -69,90 +537,259 @@ esp_err_t mpr121_set_thresholds(uint8_t touch, uint8_t release)
 
     for (int i = 0; i < 12; i++)
     {
-        // 写入触摸阈值（ELE0~ELE11：0x41,0x43,...0x57）
-        ESP_RETURN_ON_ERROR(
-            mpr121_write_reg(MPR121_TOUCH_THRESH_0 + i * 2, touch),
-            TAG, "Set touch threshold for ELE%d failed", i);
-        // 写入释放阈值（ELE0~ELE11：0x42,0x44,...0x58）
-        ESP_RETURN_ON_ERROR(
-            mpr121_write_reg(MPR121_RELEASE_THRESH_0 + i * 2, release),
-            TAG, "Set release threshold for ELE%d failed", i);
+        // 触摸阈值（ELE0~ELE11：0x41,0x43,...0x57），释放阈值（0x42,0x44,...0x58）
+        dev->cfg_shadow[CFG_IDX(MPR121_TOUCH_THRESH_0 + i * 2)] = touch;
+        dev->cfg_shadow[CFG_IDX(MPR121_RELEASE_THRESH_0 + i * 2)] = release;
     }
-    return ESP_OK;
+    return mpr121_cfg_commit(dev);
+}
+
+esp_err_t mpr121_set_electrode_thresholds(mpr121_dev_t *dev, uint8_t electrode, uint8_t touch, uint8_t release)
+{
+    if (electrode >= MPR121_NUM_CHANNELS || release >= touch)
+    {
+        ESP_LOGE(TAG, "Invalid thresholds for ELE%d: touch %d, release %d", electrode, touch, release);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // ELEPROX的阈值（0x59/0x5A）紧接ELE11之后，可按同一步长寻址
+    dev->cfg_shadow[CFG_IDX(MPR121_TOUCH_THRESH_0 + electrode * 2)] = touch;
+    dev->cfg_shadow[CFG_IDX(MPR121_RELEASE_THRESH_0 + electrode * 2)] = release;
+    return mpr121_cfg_commit(dev);
 }
 
-esp_err_t mpr121_init()
+esp_err_t mpr121_set_debounce(mpr121_dev_t *dev, uint8_t dt, uint8_t dr)
 {
-    uint8_t tmp;
+    if (dt > 7 || dr > 7)
+    {
+        ESP_LOGE(TAG, "Invalid debounce: DT %d, DR %d (0~7)", dt, dr);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    dev->cfg_shadow[CFG_IDX(MPR121_DEBOUNCE)] = (dr << 4) | dt;
+    return mpr121_cfg_commit(dev);
+}
 
+esp_err_t mpr121_soft_reset(mpr121_dev_t *dev)
+{
     // Step 1: 进入待机模式（必须先待机，才能修改配置寄存器）
     ESP_RETURN_ON_ERROR(
-        mpr121_write_reg(MPR121_ELE_CFG, 0x00),
+        mpr121_write_reg(dev, MPR121_ELE_CFG, 0x00),
         TAG, "Enter stop mode failed");
     vTaskDelay(pdMS_TO_TICKS(5)); // 等待模式切换稳定
 
     // Step 2: 软复位（恢复所有寄存器默认值，确保初始化一致性）
     ESP_RETURN_ON_ERROR(
-        mpr121_write_reg(MPR121_SOFT_RESET, 0x63),
+        mpr121_write_reg(dev, MPR121_SOFT_RESET, 0x63),
         TAG, "Soft reset failed");
     vTaskDelay(pdMS_TO_TICKS(5)); // 等待复位完成
+    mpr121_cfg_reset_defaults(dev);  // 影子缓存同步为复位默认值
+    return ESP_OK;
+}
 
-    // Step 3: 配置基线滤波（上升沿：数据>基线时的滤波参数）
-    ESP_RETURN_ON_ERROR(mpr121_write_reg(MPR121_MHDR, 0x01), TAG, "Write MHDR failed");
-    ESP_RETURN_ON_ERROR(mpr121_write_reg(MPR121_NHDR, 0x01), TAG, "Write NHDR failed");
-    ESP_RETURN_ON_ERROR(mpr121_write_reg(MPR121_NCLR, 0x00), TAG, "Write NCLR failed");
-    ESP_RETURN_ON_ERROR(mpr121_write_reg(MPR121_FDLR, 0x00), TAG, "Write FDLR failed");
+void mpr121_cfg_load_defaults(mpr121_dev_t *dev)
+{
+    // 配置基线滤波（上升沿：数据>基线时的滤波参数）
+    mpr121_cfg_set(dev, MPR121_MHDR, 0x01);
+    mpr121_cfg_set(dev, MPR121_NHDR, 0x01);
+    mpr121_cfg_set(dev, MPR121_NCLR, 0x00);
+    mpr121_cfg_set(dev, MPR121_FDLR, 0x00);
 
-    // Step 4: 配置基线滤波（下降沿：数据<基线时的滤波参数）
-    ESP_RETURN_ON_ERROR(mpr121_write_reg(MPR121_MHDF, 0x01), TAG, "Write MHDF failed");
-    ESP_RETURN_ON_ERROR(mpr121_write_reg(MPR121_NHDF, 0x01), TAG, "Write NHDF failed");
-    ESP_RETURN_ON_ERROR(mpr121_write_reg(MPR121_NCLF, 0xFF), TAG, "Write NCLF failed");
-    ESP_RETURN_ON_ERROR(mpr121_write_reg(MPR121_FDLF, 0x02), TAG, "Write FDLF failed");
+    // 配置基线滤波（下降沿：数据<基线时的滤波参数）
+    mpr121_cfg_set(dev, MPR121_MHDF, 0x01);
+    mpr121_cfg_set(dev, MPR121_NHDF, 0x01);
+    mpr121_cfg_set(dev, MPR121_NCLF, 0xFF);
+    mpr121_cfg_set(dev, MPR121_FDLF, 0x02);
 
-    // Step 5: 配置触摸/释放阈值（所有电极统一阈值，按需可改为动态配置）
-    ESP_RETURN_ON_ERROR(
-        mpr121_set_thresholds(0x0F, 0x0A),
-        TAG, "Set thresholds failed");
+    // 配置滤波全局参数（ESI=2，SFI=0，对应采样间隔4ms，滤波迭代4次）
+    mpr121_cfg_set(dev, MPR121_FILT_CDT_CFG, 0x04);
+
+    // 配置触摸/释放阈值（所有电极统一阈值）
+    for (int i = 0; i < MPR121_NUM_ELECTRODES; i++)
+    {
+        dev->cfg_shadow[CFG_IDX(MPR121_TOUCH_THRESH_0 + i * 2)] = MPR121_DEFAULT_TOUCH_THRESH;
+        dev->cfg_shadow[CFG_IDX(MPR121_RELEASE_THRESH_0 + i * 2)] = MPR121_DEFAULT_RELEASE_THRESH;
+    }
+}
+
+esp_err_t mpr121_cfg_sync(mpr121_dev_t *dev, uint8_t reg, size_t len)
+{
+    if (reg < MPR121_CFG_FIRST || len == 0 || reg + len - 1 > MPR121_CFG_LAST)
+    {
+        ESP_LOGE(TAG, "Invalid config range: 0x%02X (+%u)", reg, (unsigned)len);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    ESP_RETURN_ON_ERROR(mpr121_read_regs(dev, reg, &dev->cfg_chip[CFG_IDX(reg)], len),
+                        TAG, "Sync config 0x%02X failed", reg);
+    memcpy(&dev->cfg_shadow[CFG_IDX(reg)], &dev->cfg_chip[CFG_IDX(reg)], len);
+    return ESP_OK;
+}
 
-    // Step 6: 配置滤波全局参数（ESI=2，SFI=0，对应采样间隔4ms，滤波迭代4次）
-    ESP_RETURN_ON_ERROR(mpr121_write_reg(MPR121_FILT_CDT_CFG, 0x04), TAG, "Write FIL_CFG failed");
+esp_err_t mpr121_cfg_commit_block(mpr121_dev_t *dev, uint8_t reg, size_t len)
+{
+    if (reg < MPR121_CFG_FIRST || len == 0 || reg + len - 1 > MPR121_CFG_LAST ||
+        (reg <= MPR121_ELE_CFG && reg + len - 1 >= MPR121_ELE_CFG))
+    {
+        ESP_LOGE(TAG, "Invalid config block: 0x%02X (+%u)", reg, (unsigned)len);
+        return ESP_ERR_INVALID_ARG;
+    }
+    // 运行模式下仅允许GPIO等运行时可写的区间，其余区间请使用mpr121_cfg_commit()
+    if (dev->cfg_chip[CFG_IDX(MPR121_ELE_CFG)] & 0x3F)
+    {
+        for (size_t i = 0; i < len; i++)
+        {
+            if (!mpr121_cfg_run_writable(reg + i))
+            {
+                return ESP_ERR_INVALID_STATE;
+            }
+        }
+    }
+    if (memcmp(&dev->cfg_shadow[CFG_IDX(reg)], &dev->cfg_chip[CFG_IDX(reg)], len) == 0)
+    {
+        return ESP_OK;
+    }
+
+    ESP_RETURN_ON_ERROR(mpr121_write_regs(dev, reg, &dev->cfg_shadow[CFG_IDX(reg)], len),
+                        TAG, "Commit config block 0x%02X failed", reg);
+    memcpy(&dev->cfg_chip[CFG_IDX(reg)], &dev->cfg_shadow[CFG_IDX(reg)], len);
+    return ESP_OK;
+}
+
+esp_err_t mpr121_cfg_verify(mpr121_dev_t *dev, bool *intact)
+{
+    if (intact == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // DEBOUNCE~ELE_CFG（0x5B~0x5E）一次读取：掉电复位后ELE_CFG归零、0x5C/0x5D恢复默认值
+    uint8_t regs[MPR121_ELE_CFG - MPR121_DEBOUNCE + 1];
+    esp_err_t err = mpr121_read_regs(dev, MPR121_DEBOUNCE, regs, sizeof(regs));
+    if (err != ESP_OK)
+    {
+        return err; // 已写入跟踪记录
+    }
+    *intact = memcmp(regs, &dev->cfg_chip[CFG_IDX(MPR121_DEBOUNCE)], sizeof(regs)) == 0;
+    return ESP_OK;
+}
+
+esp_err_t mpr121_cfg_replay(mpr121_dev_t *dev)
+{
+    // Step 1: 软复位使芯片处于确定的默认状态（掉电时部分寄存器可能已被改写）
+    ESP_RETURN_ON_ERROR(mpr121_write_reg(dev, MPR121_SOFT_RESET, 0x63), TAG, "Soft reset failed");
+
+    // Step 2: 以回读代替固定延时，0x5C/0x5D为默认值即复位完成
+    uint8_t cfg[2] = {0};
+    int polls = 0;
+    do
+    {
+        ESP_RETURN_ON_ERROR(mpr121_read_regs(dev, MPR121_FILT_CDC_CFG, cfg, sizeof(cfg)), TAG, "Poll reset failed");
+    } while ((cfg[0] != 0x10 || cfg[1] != 0x24) && ++polls < MPR121_REPLAY_RESET_POLLS);
+    if (polls == MPR121_REPLAY_RESET_POLLS)
+    {
+        return ESP_ERR_TIMEOUT;
+    }
+
+    // Step 3: 芯片缓存置为默认值，与影子缓存不同的寄存器即为需重写的部分，按提交规则合并为少量块写，最后写ELE_CFG。
+    // CL=00保留当前基线，但复位后基线为0，重新进入运行模式时改为CL=10按数据高5位装载基线
+    uint8_t ecr = dev->cfg_shadow[CFG_IDX(MPR121_ELE_CFG)];
+    bool load_baseline = (ecr & 0xC0) == 0 && (ecr & 0x3F);
+    mpr121_cfg_chip_defaults(dev);
+    if (load_baseline)
+    {
+        dev->cfg_shadow[CFG_IDX(MPR121_ELE_CFG)] = ecr | 0x80;
+    }
+    esp_err_t err = mpr121_cfg_commit(dev);
+    dev->cfg_shadow[CFG_IDX(MPR121_ELE_CFG)] = ecr;
+    ESP_RETURN_ON_ERROR(err, TAG, "Replay config failed");
+
+    // Step 4: CL仅在进入运行模式时生效，运行中写回原ELE_CFG不影响基线，使芯片与缓存一致（mpr121_cfg_verify()按字节比较）
+    if (load_baseline)
+    {
+        ESP_RETURN_ON_ERROR(mpr121_write_reg(dev, MPR121_ELE_CFG, ecr), TAG, "Restore ELE_CFG failed");
+        dev->cfg_chip[CFG_IDX(MPR121_ELE_CFG)] = ecr;
+    }
+    return ESP_OK;
+}
+
+esp_err_t mpr121_init(mpr121_dev_t *dev)
+{
+    MPR121_STATS_API(MPR121_API_INIT);
+    uint8_t tmp[2];
+
+    // Step 1~2: 待机+软复位
+    ESP_RETURN_ON_ERROR(mpr121_soft_reset(dev), TAG, "Reset failed");
+
+    // Step 3~6: 基线滤波、采样间隔与阈值写入影子缓存，并一次性提交
+    mpr121_cfg_load_defaults(dev);
+    ESP_RETURN_ON_ERROR(
+        mpr121_cfg_commit(dev),
+        TAG, "Commit default config failed");
 
     // Step 7: 清除初始中断（读取状态寄存器，MPR121会自动拉高IRQ）
-    ESP_RETURN_ON_ERROR(mpr121_read_reg(MPR121_TOUCHSTATUS_L, &tmp), TAG, "Clear IRQ failed (L)");
-    ESP_RETURN_ON_ERROR(mpr121_read_reg(MPR121_TOUCHSTATUS_H, &tmp), TAG, "Clear IRQ failed (H)");
+    ESP_RETURN_ON_ERROR(mpr121_read_regs(dev, MPR121_TOUCHSTATUS_L, tmp, sizeof(tmp)), TAG, "Clear IRQ failed");
 
     // Step 8: 启用所有12个电极（ECR=0x0C：ELE_EN=1100，对应ELE0~ELE11全部启用）
+    mpr121_cfg_set(dev, MPR121_ELE_CFG, 0x0C);
     ESP_RETURN_ON_ERROR(
-        mpr121_write_reg(MPR121_ELE_CFG, 0x0C),
+        mpr121_cfg_commit(dev),
         TAG, "Enable all electrodes failed");
 
     ESP_LOGI(TAG, "mpr121 init successful");
     return ESP_OK;
 }
 
-esp_err_t mpr121_read_touch(uint16_t *touch_status)
+esp_err_t mpr121_read_touch(mpr121_dev_t *dev, uint16_t *touch_status)
 {
+    MPR121_STATS_API(MPR121_API_READ_TOUCH);
     if (touch_status == NULL)
     {
         ESP_LOGE(TAG, "Read touch failed: touch_status is NULL");
         return ESP_ERR_INVALID_ARG;
     }
 
-    uint8_t touch_l = 0, touch_h = 0;
-    // 先读低8位，再读高8位（MPR121支持连续读取，确保数据一致性）
-    ESP_RETURN_ON_ERROR(
-        mpr121_read_reg(MPR121_TOUCHSTATUS_L, &touch_l),
-        TAG, "Read touch status (L) failed");
-    ESP_RETURN_ON_ERROR(
-        mpr121_read_reg(MPR121_TOUCHSTATUS_H, &touch_h),
-        TAG, "Read touch status (H) failed");
+    uint8_t raw[2];
+    // 低8位与高8位在同一次突发读取中获取，确保数据一致性
+    esp_err_t err = mpr121_read_regs(dev, MPR121_TOUCHSTATUS_L, raw, sizeof(raw));
+    if (err != ESP_OK)
+    {
+        return err; // 已写入跟踪记录
+    }
+
+    // D15为OVCF过流标志、D14~D13保留，不属于电极状态
+    *touch_status = ((raw[1] << 8) | raw[0]) & MPR121_STATUS_CH_MASK;
+    return ESP_OK;
+}
+
+esp_err_t mpr121_read_status(mpr121_dev_t *dev, mpr121_status_t *status)
+{
+    MPR121_STATS_API(MPR121_API_READ_STATUS);
+    if (status == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint8_t raw[MPR121_OORSTATUS_H - MPR121_TOUCHSTATUS_L + 1];
+    esp_err_t err = mpr121_read_regs(dev, MPR121_TOUCHSTATUS_L, raw, sizeof(raw));
+    if (err != ESP_OK)
+    {
+        return err; // 已写入跟踪记录
+    }
 
-    *touch_status = (touch_h << 8) | touch_l;
+    uint16_t touch = (raw[MPR121_TOUCHSTATUS_H] << 8) | raw[MPR121_TOUCHSTATUS_L];
+    uint16_t oor = (raw[MPR121_OORSTATUS_H] << 8) | raw[MPR121_OORSTATUS_L];
+    status->touch = touch & MPR121_STATUS_CH_MASK;
+    status->oor = oor & MPR121_STATUS_CH_MASK;
+    status->ovcf = (touch & MPR121_STATUS_OVCF) != 0;
+    status->acff = (oor & MPR121_STATUS_ACFF) != 0;
+    status->arff = (oor & MPR121_STATUS_ARFF) != 0;
     return ESP_OK;
 }
 
-esp_err_t mpr121_read_filtered(uint8_t electrode, uint16_t *filtered_val)
+esp_err_t mpr121_read_filtered(mpr121_dev_t *dev, uint8_t electrode, uint16_t *filtered_val)
 {
+    MPR121_STATS_API(MPR121_API_READ_FILTERED);
     if (filtered_val == NULL)
     {
         return ESP_ERR_INVALID_ARG;
@@ -166,18 +803,19 @@ esp_err_t mpr121_read_filtered(uint8_t electrode, uint16_t *filtered_val)
     uint8_t val_l = 0, val_h = 0;
     // 滤波数据为10位：低8位在0x04+2*i，高2位在0x05+2*i的bit1~bit0
     ESP_RETURN_ON_ERROR(
-        mpr121_read_reg(MPR121_FILTDATA_0L + electrode * 2, &val_l),
+        mpr121_read_reg(dev, MPR121_FILTDATA_0L + electrode * 2, &val_l),
         TAG, "Read filtered data (L) for ELE%d failed", electrode);
     ESP_RETURN_ON_ERROR(
-        mpr121_read_reg(MPR121_FILTDATA_0L + electrode * 2 + 1, &val_h),
+        mpr121_read_reg(dev, MPR121_FILTDATA_0L + electrode * 2 + 1, &val_h),
         TAG, "Read filtered data (H) for ELE%d failed", electrode);
 
     *filtered_val = (val_h << 8) | val_l;
     return ESP_OK;
 }
 
-esp_err_t mpr121_read_baseline(uint8_t electrode, uint8_t *baseline_val)
+esp_err_t mpr121_read_baseline(mpr121_dev_t *dev, uint8_t electrode, uint8_t *baseline_val)
 {
+    MPR121_STATS_API(MPR121_API_READ_BASELINE);
     if (baseline_val == NULL)
     {
         return ESP_ERR_INVALID_ARG;
@@ -188,5 +826,48 @@ esp_err_t mpr121_read_baseline(uint8_t electrode, uint8_t *baseline_val)
         return ESP_ERR_INVALID_ARG;
     }
 
-    return mpr121_read_reg(MPR121_BASELINE_0 + electrode, baseline_val);
+    return mpr121_read_reg(dev, MPR121_BASELINE_0 + electrode, baseline_val);
+}
+
+esp_err_t mpr121_read_frame(mpr121_dev_t *dev, mpr121_frame_t *frame)
+{
+    MPR121_STATS_API(MPR121_API_READ_FRAME);
+    if (frame == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint8_t raw[MPR121_FRAME_LEN];
+    esp_err_t err = mpr121_read_regs(dev, MPR121_TOUCHSTATUS_L, raw, sizeof(raw));
+    if (err != ESP_OK)
+    {
+        return err; // 已写入跟踪记录
+    }
+
+    frame->timestamp_us = esp_timer_get_time();
+    frame->touch_status = (raw[MPR121_TOUCHSTATUS_H] << 8) | raw[MPR121_TOUCHSTATUS_L];
+    frame->oor_status = (raw[MPR121_OORSTATUS_H] << 8) | raw[MPR121_OORSTATUS_L];
+    for (int i = 0; i < MPR121_NUM_CHANNELS; i++)
+    {
+        // 滤波数据高字节仅bit1~bit0有效，基线需左移2位与滤波数据对齐
+        uint16_t filtered = ((raw[MPR121_FILTDATA_0H + i * 2] & 0x03) << 8) | raw[MPR121_FILTDATA_0L + i * 2];
+        uint8_t baseline = raw[MPR121_BASELINE_0 + i];
+        frame->filtered[i] = filtered;
+        frame->baseline[i] = baseline;
+        frame->delta[i] = (int16_t)((baseline << 2) - filtered);
+    }
+    return ESP_OK;
+}
+
+void mpr121_get_bus_stats(mpr121_dev_t *dev, mpr121_bus_stats_t *stats)
+{
+    if (stats != NULL)
+    {
+        *stats = dev->bus_stats;
+    }
+}
+
+void mpr121_reset_bus_stats(mpr121_dev_t *dev)
+{
+    memset(&dev->bus_stats, 0, sizeof(dev->bus_stats));
 }
@@ -5,20 +5,44 @@
 #include <esp_err.h>
 #include <esp_check.h>
 #include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <sdkconfig.h>
+#if !CONFIG_IDF_TARGET_LINUX
 #include <driver/gpio.h>
 #include <driver/i2c_master.h>
+#endif
 #include <freertos/FreeRTOS.h>
 #include <freertos/semphr.h>
 #include <freertos/task.h>
 
 // -------------------------- 可配置参数（集中管理，方便修改） --------------------------
 #define MPR121_DEFAULT_ADDR 0x5A // 默认I2C地址（ADD引脚接地）
+#define MPR121_NUM_ELECTRODES 12 // 普通电极数量（ELE0~ELE11）
+#define MPR121_NUM_CHANNELS 13   // 采样通道数量（ELE0~ELE11 + ELEPROX）
+#define MPR121_MAX_DEVICES 4     // 同一总线最多挂载的MPR121数量（地址0x5A~0x5D）
+#define MPR121_I2C_SUPPORTED (!CONFIG_IDF_TARGET_LINUX) // 是否提供ESP-IDF I2C总线实现（linux目标仅可使用模拟器等自定义总线）
+#define MPR121_I2C_TIMEOUT_MS 20 // 单次I2C传输超时（总线卡死时返回ESP_ERR_TIMEOUT，不再永久阻塞）
+#define MPR121_DEFAULT_TOUCH_THRESH 0x0F   // 默认触摸阈值（mpr121_cfg_load_defaults()使用）
+#define MPR121_DEFAULT_RELEASE_THRESH 0x0A // 默认释放阈值
+#define MPR121_CFG_MERGE_GAP 2   // 待机模式提交时，间隔不超过该数量未改动寄存器的待提交区间合并为一次块写
+#define MPR121_REPLAY_RESET_POLLS 4 // 配置重放：软复位后回读确认复位完成的最多次数
+#ifndef MPR121_ENABLE_STATS
+#define MPR121_ENABLE_STATS 1    // 性能统计开关（0=统计埋点编译为空，零开销）
+#endif
+#ifndef MPR121_ENABLE_TRACE
+#define MPR121_ENABLE_TRACE 1    // 二进制跟踪开关（热路径错误写入跟踪环而非格式化日志；0=埋点编译为空）
+#endif
 
 // 状态寄存器（触摸/超范围状态）
 #define MPR121_TOUCHSTATUS_L 0x00 // 触摸状态低8位（ELE0~ELE7：1=触摸，0=释放）
 #define MPR121_TOUCHSTATUS_H 0x01 // 触摸状态高8位（D7=OVCF过流标志，D4=ELEPROX接近电极，D3~D0=ELE11~ELE8）
 #define MPR121_OORSTATUS_L 0x02   // 超范围状态低8位（ELE0~ELE7：1=超出配置范围）
 #define MPR121_OORSTATUS_H 0x03   // 超范围状态高8位（D7=ACFF配置失败，D6=ARFF重配置失败，D4=ELEPROX，D3~D0=ELE11~ELE8）
+#define MPR121_STATUS_CH_MASK 0x1FFF // 触摸/超范围状态中的通道位（ELE0~ELE11 + ELEPROX），其余为标志位
+#define MPR121_STATUS_OVCF 0x8000    // 触摸状态D15：REXT引脚过流，芯片进入待机模式（写1清除）
+#define MPR121_STATUS_ACFF 0x8000    // 超范围状态D15：自动配置失败
+#define MPR121_STATUS_ARFF 0x4000    // 超范围状态D14：自动重配置失败
 
 // 滤波数据寄存器（10位，低8位+高2位）
 #define MPR121_FILTDATA_0L 0x04    // ELE0滤波数据低8位
@@ -120,7 +144,7 @@
 #define MPR121_RELEASE_THRESH_PROX 0x5A // ELEPROX释放阈值
 
 // 去抖动寄存器
-#define MPR121_DEBOUNCE 0x5B // D3~D1=DR释放去抖动次数（0~7），D0~D2=DT触摸去抖动次数（0~7）
+#define MPR121_DEBOUNCE 0x5B // D6~D4=DR释放去抖动次数（0~7），D2~D0=DT触摸去抖动次数（0~7）
 
 // 滤波与全局CDC/CDT配置寄存器
 #define MPR121_FILT_CDC_CFG 0x5C // D7~D2=CDC全局充电电流（0~63μA），D1~D0=FFI一级滤波采样数（6/10/18/34）
@@ -173,45 +197,319 @@
 // 软复位寄存器
 #define MPR121_SOFT_RESET 0x80 // 软复位寄存器（写入0x63触发复位，不影响I2C模块）
 
-// -------------------------- 外部变量声明（仅暴露必要接口） --------------------------
-extern i2c_master_dev_handle_t mpr121_handle;
+// 整帧突发读取范围（0x00~0x2A：触摸状态+超范围状态+全部滤波数据+全部基线，共43字节）
+#define MPR121_FRAME_LEN (MPR121_BASELINE_PROX - MPR121_TOUCHSTATUS_L + 1)
+
+// 配置寄存器影子缓存范围（0x2B~0x7F）
+#define MPR121_CFG_FIRST MPR121_MHDR
+#define MPR121_CFG_LAST MPR121_AUTO_TL
+#define MPR121_CFG_LEN (MPR121_CFG_LAST - MPR121_CFG_FIRST + 1)
+
+// -------------------------- 数据结构 --------------------------
+/**
+ * @brief 一次突发读取得到的完整电极数据帧（通道12为ELEPROX接近电极）
+ */
+typedef struct
+{
+    int64_t timestamp_us;                      // 读取完成时刻（esp_timer时间，μs）
+    uint16_t touch_status;                     // 触摸状态（寄存器0x00~0x01原始值）
+    uint16_t oor_status;                       // 超范围状态（寄存器0x02~0x03原始值）
+    uint16_t filtered[MPR121_NUM_CHANNELS];    // 10位滤波数据
+    int16_t delta[MPR121_NUM_CHANNELS];        // 差值：(基线<<2) - 滤波数据，触摸时为正
+    uint8_t baseline[MPR121_NUM_CHANNELS];     // 8位基线值
+} mpr121_frame_t;
+
+/**
+ * @brief 芯片状态（0x00~0x03一次突发读取，通道掩码与标志位分离）
+ */
+typedef struct
+{
+    uint16_t touch; // 触摸通道掩码（bit0~bit11=ELE0~ELE11，bit12=ELEPROX，不含OVCF）
+    uint16_t oor;   // 超范围通道掩码（同上，不含ACFF/ARFF）
+    bool ovcf;      // 过流标志（芯片已进入待机模式）
+    bool acff;      // 自动配置失败标志
+    bool arff;      // 自动重配置失败标志
+} mpr121_status_t;
+
+/**
+ * @brief I2C传输统计（用于评估各读写路径的总线开销）
+ */
+typedef struct
+{
+    uint32_t transactions; // I2C事务次数
+    uint32_t tx_bytes;     // 发送字节数（含寄存器地址）
+    uint32_t rx_bytes;     // 接收字节数
+} mpr121_bus_stats_t;
+
+/**
+ * @brief 异步传输完成回调（I2C实现中在ISR上下文调用，须IRAM安全）
+ * @param arg 提交时传入的参数
+ * @param result ESP_OK: 传输成功；ESP_ERR_INVALID_RESPONSE: NACK；ESP_ERR_TIMEOUT: 总线超时
+ * @return bool 是否唤醒了更高优先级任务（用于ISR退出时切换）
+ */
+typedef bool (*mpr121_xfer_cb_t)(void *arg, esp_err_t result);
+
+/**
+ * @brief 寄存器总线抽象：驱动只通过这些操作访问芯片（I2C实现或主机端模拟器）
+ * @note 各操作均为单次事务，寄存器地址由芯片自动递增；write/read为同步操作，submit_read可选
+ */
+typedef struct
+{
+    esp_err_t (*write)(void *ctx, uint8_t reg, const uint8_t *data, size_t len); // 从reg开始连续写len字节
+    esp_err_t (*read)(void *ctx, uint8_t reg, uint8_t *data, size_t len);        // 从reg开始连续读len字节
+    esp_err_t (*submit_read)(void *ctx, uint8_t reg, uint8_t *data, size_t len,
+                             mpr121_xfer_cb_t cb, void *arg);                     // 提交异步读取，完成后调用cb（NULL=不支持）
+} mpr121_bus_ops_t;
+
+/**
+ * @brief MPR121设备句柄（由调用者静态分配，经mpr121_add_device()或mpr121_attach_bus()初始化）
+ */
+typedef struct
+{
+    const mpr121_bus_ops_t *bus;          // 总线操作
+    void *bus_ctx;                        // 总线上下文（I2C实现中为i2c_master_dev_handle_t）
+    uint8_t addr;                         // 7位I2C地址
+    mpr121_bus_stats_t bus_stats;         // I2C传输统计
+    uint8_t cfg_shadow[MPR121_CFG_LEN];   // 配置寄存器期望值（影子缓存）
+    uint8_t cfg_chip[MPR121_CFG_LEN];     // 芯片中配置寄存器的已知值，与期望值不同即为待提交
+} mpr121_dev_t;
 
 // -------------------------- 函数接口（规范返回值+明确功能） --------------------------
+/**
+ * @brief 使用自定义总线操作初始化设备句柄（如主机端模拟器）
+ * @param[out] dev 设备句柄（调用者分配）
+ * @param ops 总线操作（须在设备使用期间保持有效）
+ * @param ctx 传递给总线操作的上下文
+ * @param addr 7位I2C地址（仅用于日志与多设备区分）
+ * @return esp_err_t ESP_OK: 初始化成功；ESP_ERR_INVALID_ARG: 参数无效
+ */
+esp_err_t mpr121_attach_bus(mpr121_dev_t *dev, const mpr121_bus_ops_t *ops, void *ctx, uint8_t addr);
+
+#if MPR121_I2C_SUPPORTED
+/**
+ * @brief 将MPR121添加到I2C总线并初始化设备句柄
+ * @param bus I2C总线句柄
+ * @param addr 7位I2C地址（0x5A~0x5D，由ADD引脚决定）
+ * @param scl_speed_hz SCL频率
+ * @param[out] dev 设备句柄（调用者分配）
+ * @return esp_err_t ESP_OK: 添加成功；其他: 添加失败
+ */
+esp_err_t mpr121_add_device(i2c_master_bus_handle_t bus, uint8_t addr, uint32_t scl_speed_hz, mpr121_dev_t *dev);
+
+/**
+ * @brief 以异步模式将MPR121添加到I2C总线（基于i2c_master传输完成回调）
+ * @note 总线须以trans_queue_depth>0创建；同一设备同一时刻只有一个传输在途，多设备的传输可同时排队。
+ *       同步读写仍可使用（提交后等待完成，超时MPR121_I2C_TIMEOUT_MS）
+ * @param bus I2C总线句柄
+ * @param addr 7位I2C地址（0x5A~0x5D）
+ * @param scl_speed_hz SCL频率
+ * @param[out] dev 设备句柄（调用者分配）
+ * @return esp_err_t ESP_OK: 添加成功；ESP_ERR_NO_MEM: 异步上下文已用完；其他: 添加失败
+ */
+esp_err_t mpr121_add_device_async(i2c_master_bus_handle_t bus, uint8_t addr, uint32_t scl_speed_hz, mpr121_dev_t *dev);
+
+/**
+ * @brief 从I2C总线移除MPR121
+ * @param dev 设备句柄
+ * @return esp_err_t ESP_OK: 移除成功；其他: 移除失败
+ */
+esp_err_t mpr121_del_device(mpr121_dev_t *dev);
+#endif // MPR121_I2C_SUPPORTED
+
 /**
  * @brief 初始化MPR121（含软复位、滤波配置、阈值配置、电极使能）
+ * @param dev 设备句柄
  * @return esp_err_t ESP_OK: 初始化成功；其他: 初始化失败（如I2C通信错误）
  */
-esp_err_t mpr121_init(void);
+esp_err_t mpr121_init(mpr121_dev_t *dev);
+
+/**
+ * @brief 进入待机模式并软复位，影子缓存同步为复位默认值（mpr121_init()的前两步）
+ * @param dev 设备句柄
+ * @return esp_err_t ESP_OK: 复位成功；其他: I2C通信失败
+ */
+esp_err_t mpr121_soft_reset(mpr121_dev_t *dev);
+
+/**
+ * @brief 将驱动默认配置（基线滤波、采样间隔、默认阈值）写入影子缓存（不访问总线，不修改ELE_CFG）
+ * @param dev 设备句柄
+ */
+void mpr121_cfg_load_defaults(mpr121_dev_t *dev);
 
 /**
- * @brief 设置所有电极的触摸/释放阈值
+ * @brief 设置所有电极的触摸/释放阈值（写入影子缓存后立即提交，24个连续寄存器合并为一次块写）
+ * @param dev 设备句柄
  * @param touch 触摸阈值（0~0xFF，推荐0x04~0x10）
  * @param release 释放阈值（0~0xFF，需小于触摸阈值，推荐0x02~0x08）
  * @return esp_err_t ESP_OK: 配置成功；其他: 配置失败
  */
-esp_err_t mpr121_set_thresholds(uint8_t touch, uint8_t release);
+esp_err_t mpr121_set_thresholds(mpr121_dev_t *dev, uint8_t touch, uint8_t release);
+
+/**
+ * @brief 设置单个电极的触摸/释放阈值（电极面积不同时分别设置，写入影子缓存后立即提交）
+ * @param dev 设备句柄
+ * @param electrode 电极（0~11，12=ELEPROX）
+ * @param touch 触摸阈值（0~0xFF）
+ * @param release 释放阈值（需小于触摸阈值）
+ * @return esp_err_t ESP_OK: 配置成功；ESP_ERR_INVALID_ARG: 参数无效；其他: 配置失败
+ */
+esp_err_t mpr121_set_electrode_thresholds(mpr121_dev_t *dev, uint8_t electrode, uint8_t touch, uint8_t release);
+
+/**
+ * @brief 设置触摸/释放去抖次数（写入DEBOUNCE后立即提交）
+ * @note 芯片只有一个DEBOUNCE寄存器，对全部电极生效；电极间噪声差异应以各自的阈值区分
+ * @param dev 设备句柄
+ * @param dt 触摸去抖次数（0~7：连续dt+1次超过触摸阈值才判定按下）
+ * @param dr 释放去抖次数（0~7：连续dr+1次低于释放阈值才判定释放）
+ * @return esp_err_t ESP_OK: 配置成功；ESP_ERR_INVALID_ARG: 参数无效；其他: 配置失败
+ */
+esp_err_t mpr121_set_debounce(mpr121_dev_t *dev, uint8_t dt, uint8_t dr);
 
 /**
  * @brief 读取所有电极的触摸状态
- * @param[out] touch_status 触摸状态（16位：bit0~bit11对应ELE0~ELE11，1=触摸，0=释放）
+ * @param dev 设备句柄
+ * @param[out] touch_status 触摸状态（bit0~bit11对应ELE0~ELE11，bit12=ELEPROX，1=触摸，0=释放；已去除OVCF标志）
+ * @return esp_err_t ESP_OK: 读取成功；其他: 读取失败
+ */
+esp_err_t mpr121_read_touch(mpr121_dev_t *dev, uint16_t *touch_status);
+
+/**
+ * @brief 在同一次突发读取中获取触摸状态与超范围状态（0x00~0x03，比mpr121_read_touch()多2字节）
+ * @param dev 设备句柄
+ * @param[out] status 通道掩码与OVCF/ACFF/ARFF标志
  * @return esp_err_t ESP_OK: 读取成功；其他: 读取失败
  */
-esp_err_t mpr121_read_touch(uint16_t *touch_status);
+esp_err_t mpr121_read_status(mpr121_dev_t *dev, mpr121_status_t *status);
 
 /**
  * @brief 读取指定电极的滤波后电容数据（10位）
+ * @param dev 设备句柄
  * @param electrode 电极编号（0~11）
  * @param[out] filtered_val 滤波后数据（0~1023，与电容值成反比）
  * @return esp_err_t ESP_OK: 读取成功；其他: 读取失败（如电极编号无效）
  */
-esp_err_t mpr121_read_filtered(uint8_t electrode, uint16_t *filtered_val);
+esp_err_t mpr121_read_filtered(mpr121_dev_t *dev, uint8_t electrode, uint16_t *filtered_val);
 
 /**
  * @brief 读取指定电极的基线值（8位，需左移2位后与滤波数据对比）
+ * @param dev 设备句柄
  * @param electrode 电极编号（0~11）
  * @param[out] baseline_val 基线值（0~255）
  * @return esp_err_t ESP_OK: 读取成功；其他: 读取失败（如电极编号无效）
  */
-esp_err_t mpr121_read_baseline(uint8_t electrode, uint8_t *baseline_val);
+esp_err_t mpr121_read_baseline(mpr121_dev_t *dev, uint8_t electrode, uint8_t *baseline_val);
+
+/**
+ * @brief 利用寄存器地址自动递增，单次事务读取0x00~0x2A并解码为完整数据帧
+ * @param dev 设备句柄
+ * @param[out] frame 解码后的数据帧（含13个通道的滤波数据、基线及差值）
+ * @return esp_err_t ESP_OK: 读取成功；其他: 读取失败
+ */
+esp_err_t mpr121_read_frame(mpr121_dev_t *dev, mpr121_frame_t *frame);
+
+/**
+ * @brief 从MPR121连续读取多个寄存器（芯片读指针自动递增，单次I2C事务完成）
+ * @param dev 设备句柄
+ * @param reg 起始寄存器地址
+ * @param[out] data 接收缓冲区
+ * @param len 读取字节数
+ * @return esp_err_t ESP_OK: 读取成功；其他: 读取失败
+ */
+esp_err_t mpr121_read_regs(mpr121_dev_t *dev, uint8_t reg, uint8_t *data, size_t len);
+
+/**
+ * @brief 向MPR121连续写入多个寄存器（芯片写指针自动递增，单次I2C事务完成，不经过影子缓存）
+ * @param dev 设备句柄
+ * @param reg 起始寄存器地址
+ * @param data 待写入数据
+ * @param len 写入字节数
+ * @return esp_err_t ESP_OK: 写入成功；其他: 写入失败
+ */
+esp_err_t mpr121_write_regs(mpr121_dev_t *dev, uint8_t reg, const uint8_t *data, size_t len);
+
+/**
+ * @brief 修改影子缓存中的配置寄存器（仅标记，不访问总线，需调用mpr121_cfg_commit()生效）
+ * @param dev 设备句柄
+ * @param reg 寄存器地址（0x2B~0x7F）
+ * @param val 寄存器值
+ * @return esp_err_t ESP_OK: 修改成功；ESP_ERR_INVALID_ARG: 地址超出缓存范围
+ */
+esp_err_t mpr121_cfg_set(mpr121_dev_t *dev, uint8_t reg, uint8_t val);
+
+/**
+ * @brief 批量修改影子缓存中的连续配置寄存器
+ * @param dev 设备句柄
+ * @param reg 起始寄存器地址（0x2B~0x7F）
+ * @param vals 寄存器值数组
+ * @param len 寄存器个数
+ * @return esp_err_t ESP_OK: 修改成功；ESP_ERR_INVALID_ARG: 范围越界
+ */
+esp_err_t mpr121_cfg_set_block(mpr121_dev_t *dev, uint8_t reg, const uint8_t *vals, size_t len);
+
+/**
+ * @brief 从影子缓存读取配置寄存器（不访问总线）
+ * @param dev 设备句柄
+ * @param reg 寄存器地址（0x2B~0x7F）
+ * @param[out] val 缓存中的寄存器值
+ * @return esp_err_t ESP_OK: 读取成功；ESP_ERR_INVALID_ARG: 地址超出缓存范围
+ */
+esp_err_t mpr121_cfg_get(mpr121_dev_t *dev, uint8_t reg, uint8_t *val);
+
+/**
+ * @brief 提交影子缓存：仅将与芯片当前值不同的寄存器按连续区间合并为块写
+ * @note 若芯片处于运行模式且需修改仅待机可写的寄存器，会自动进入待机模式，写完后恢复MPR121_ELE_CFG；
+ *       待机期间相距不超过MPR121_CFG_MERGE_GAP的区间合并写入（中间寄存器重写原值，不跨越ELE_CFG/GPIO/CDC/CDT）
+ * @param dev 设备句柄
+ * @return esp_err_t ESP_OK: 提交成功；其他: I2C写入失败（未写入的寄存器保持待提交状态）
+ */
+esp_err_t mpr121_cfg_commit(mpr121_dev_t *dev);
+
+/**
+ * @brief 将影子缓存中的一段连续寄存器整段写入（任一字节待提交时写入整段，保证单次事务）
+ * @note 区间不可包含ELE_CFG；运行模式下仅允许运行时可写的寄存器（GPIO）
+ * @param dev 设备句柄
+ * @param reg 起始寄存器地址（0x2B~0x7F）
+ * @param len 寄存器个数
+ * @return esp_err_t ESP_OK: 提交成功或无需提交；ESP_ERR_INVALID_ARG: 范围无效；ESP_ERR_INVALID_STATE: 运行模式下含仅待机可写的寄存器；其他: 写入失败
+ */
+esp_err_t mpr121_cfg_commit_block(mpr121_dev_t *dev, uint8_t reg, size_t len);
+
+/**
+ * @brief 从芯片回读连续配置寄存器，同时更新影子缓存与芯片已知值（用于芯片自行修改的寄存器，如自动配置得到的CDC/CDT）
+ * @param dev 设备句柄
+ * @param reg 起始寄存器地址（0x2B~0x7F）
+ * @param len 寄存器个数
+ * @return esp_err_t ESP_OK: 同步成功；ESP_ERR_INVALID_ARG: 范围越界；其他: 读取失败
+ */
+esp_err_t mpr121_cfg_sync(mpr121_dev_t *dev, uint8_t reg, size_t len);
+
+/**
+ * @brief 回读DEBOUNCE~ELE_CFG（0x5B~0x5E，一次事务）并与芯片已知值比较，检测芯片是否丢失配置（如掉电复位）
+ * @param dev 设备句柄
+ * @param[out] intact true: 与已知值一致；false: 配置已丢失或被改写
+ * @return esp_err_t ESP_OK: 回读成功；其他: 读取失败（NACK或总线超时）
+ */
+esp_err_t mpr121_cfg_verify(mpr121_dev_t *dev, bool *intact);
+
+/**
+ * @brief 重放影子缓存中的配置：软复位后按提交规则以少量块写恢复全部配置，最后写入ELE_CFG
+ * @note 不含mpr121_init()的固定延时（以回读确认复位完成）；CL=00时以CL=10重新装载基线
+ * @param dev 设备句柄
+ * @return esp_err_t ESP_OK: 重放成功；ESP_ERR_TIMEOUT: 未确认复位完成；其他: 读写失败
+ */
+esp_err_t mpr121_cfg_replay(mpr121_dev_t *dev);
+
+/**
+ * @brief 获取I2C传输统计
+ * @param dev 设备句柄
+ * @param[out] stats 自上次清零以来的事务数与字节数
+ */
+void mpr121_get_bus_stats(mpr121_dev_t *dev, mpr121_bus_stats_t *stats);
+
+/**
+ * @brief 清零I2C传输统计
+ * @param dev 设备句柄
+ */
+void mpr121_reset_bus_stats(mpr121_dev_t *dev);
 
 #endif // MPR121_H
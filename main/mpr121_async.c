@@ -0,0 +1,260 @@
+#include "mpr121_async.h"
+#include "mpr121_stats.h"
+#include "mpr121_trace.h"
+#include <string.h>
+#include <esp_attr.h>
+#include <esp_timer.h>
+
+// -------------------------- 静态辅助函数（仅内部使用） --------------------------
+/**
+ * @brief 传输完成回调（I2C实现中为ISR上下文）：标记请求完成并唤醒采集任务；已放弃的请求直接释放
+ * @param arg 请求槽
+ * @param result 传输结果
+ * @return bool 是否唤醒了更高优先级任务
+ */
+static bool IRAM_ATTR async_xfer_done(void *arg, esp_err_t result)
+{
+    mpr121_async_req_t *req = (mpr121_async_req_t *)arg;
+    unsigned char expected = MPR121_ASYNC_INFLIGHT;
+
+    req->result = result;
+    req->done_us = esp_timer_get_time();
+    if (!atomic_compare_exchange_strong_explicit(&req->state, &expected, MPR121_ASYNC_DONE,
+                                                 memory_order_acq_rel, memory_order_acquire))
+    {
+        // 采集任务已放弃该请求：释放槽（调用者取回前owned仍为true，不会被复用）
+        atomic_store_explicit(&req->state, MPR121_ASYNC_FREE, memory_order_release);
+        atomic_fetch_add_explicit(&req->owner->late, 1, memory_order_relaxed);
+        return false;
+    }
+
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(req->owner->task, &woken);
+    return woken == pdTRUE;
+}
+
+/**
+ * @brief 向总线提交请求的一次传输（提交即失败时直接记为完成）
+ * @param req 请求槽
+ */
+static void async_start(mpr121_async_req_t *req)
+{
+    mpr121_dev_t *dev = req->dev;
+    mpr121_async_t *async = req->owner;
+
+    req->submit_us = esp_timer_get_time();
+    atomic_store_explicit(&req->state, MPR121_ASYNC_INFLIGHT, memory_order_release);
+    async->stats.submitted++;
+    dev->bus_stats.transactions++;
+    dev->bus_stats.tx_bytes += 1;
+    dev->bus_stats.rx_bytes += req->len;
+
+    esp_err_t err = dev->bus->submit_read(dev->bus_ctx, req->reg, req->buf, req->len, async_xfer_done, req);
+    if (err != ESP_OK)
+    {
+        MPR121_TRACE(MPR121_TRACE_READ_ERROR, dev->addr, req->reg, err);
+        req->result = err;
+        req->done_us = req->submit_us;
+        atomic_store_explicit(&req->state, MPR121_ASYNC_DONE, memory_order_release);
+    }
+}
+
+/**
+ * @brief 处理一个已完成的请求：记录事务统计，失败且未超时时重试
+ * @param req 请求槽
+ * @param now 当前时刻
+ * @return bool true: 已重新提交；false: 请求已结束
+ */
+static bool async_retire(mpr121_async_req_t *req, int64_t now)
+{
+#if MPR121_ENABLE_STATS
+    mpr121_stats_txn(1, req->len, req->result, req->done_us - req->submit_us);
+#endif
+    if (req->result != ESP_OK && req->retries_left > 0 && now < req->deadline_us)
+    {
+        req->retries_left--;
+        req->owner->stats.retries++;
+        async_start(req);
+        return true;
+    }
+    return false;
+}
+
+// -------------------------- 外部接口实现 --------------------------
+esp_err_t mpr121_async_init(mpr121_async_t *async)
+{
+    if (async == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(async, 0, sizeof(*async));
+    async->task = xTaskGetCurrentTaskHandle();
+    for (int i = 0; i < MPR121_ASYNC_MAX_INFLIGHT; i++)
+    {
+        async->reqs[i].owner = async;
+        atomic_init(&async->reqs[i].state, MPR121_ASYNC_FREE);
+    }
+    atomic_init(&async->late, 0);
+    return ESP_OK;
+}
+
+esp_err_t mpr121_async_submit(mpr121_async_t *async, mpr121_dev_t *dev, uint8_t reg, size_t len,
+                              uint32_t timeout_us, uint8_t retries, int *handle)
+{
+    if (async == NULL || dev == NULL || handle == NULL || len == 0 || len > MPR121_ASYNC_MAX_LEN)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (dev->bus->submit_read == NULL)
+    {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    for (int i = 0; i < MPR121_ASYNC_MAX_INFLIGHT; i++)
+    {
+        mpr121_async_req_t *req = &async->reqs[i];
+        if (req->owned || atomic_load_explicit(&req->state, memory_order_acquire) != MPR121_ASYNC_FREE)
+        {
+            continue;
+        }
+
+        req->owned = true;
+        req->finished = false;
+        req->timed_out = false;
+        req->dev = dev;
+        req->reg = reg;
+        req->len = len;
+        req->retries_left = retries;
+        req->deadline_us = esp_timer_get_time() + timeout_us;
+        async_start(req);
+
+        uint32_t inflight = 0;
+        for (int j = 0; j < MPR121_ASYNC_MAX_INFLIGHT; j++)
+        {
+            inflight += async->reqs[j].owned;
+        }
+        if (inflight > async->stats.max_inflight)
+        {
+            async->stats.max_inflight = inflight;
+        }
+        *handle = i;
+        return ESP_OK;
+    }
+
+    async->stats.no_slot++; // 热路径不做格式化输出，由调用者按返回值处理
+    return ESP_ERR_NO_MEM;
+}
+
+void mpr121_async_wait(mpr121_async_t *async)
+{
+    while (1)
+    {
+        int64_t now = esp_timer_get_time();
+        int64_t nearest = INT64_MAX;
+        int inflight = 0;
+
+        for (int i = 0; i < MPR121_ASYNC_MAX_INFLIGHT; i++)
+        {
+            mpr121_async_req_t *req = &async->reqs[i];
+            if (!req->owned || req->finished)
+            {
+                continue;
+            }
+
+            // 已完成的请求：成功或不再重试则结束；重试可能立即完成（如提交失败），循环处理
+            unsigned char state = atomic_load_explicit(&req->state, memory_order_acquire);
+            while (state == MPR121_ASYNC_DONE && !req->finished)
+            {
+                if (!async_retire(req, now))
+                {
+                    req->finished = true;
+                }
+                state = atomic_load_explicit(&req->state, memory_order_acquire);
+            }
+            if (req->finished)
+            {
+                continue;
+            }
+
+            if (now >= req->deadline_us)
+            {
+                // 超过截止时间：放弃请求；若回调恰好同时到达，则按已完成处理
+                unsigned char expected = MPR121_ASYNC_INFLIGHT;
+                if (atomic_compare_exchange_strong(&req->state, &expected, MPR121_ASYNC_ABANDONED))
+                {
+                    req->finished = true;
+                    req->timed_out = true;
+                    async->stats.timeouts++;
+                    continue;
+                }
+                inflight++;
+                nearest = now;
+                continue;
+            }
+            inflight++;
+            if (req->deadline_us < nearest)
+            {
+                nearest = req->deadline_us;
+            }
+        }
+
+        if (inflight == 0)
+        {
+            break;
+        }
+
+        // 阻塞直到任一完成回调通知或最近的截止时间（精度为1个tick）
+        TickType_t ticks = 0;
+        if (nearest > now)
+        {
+            ticks = (TickType_t)((nearest - now + portTICK_PERIOD_MS * 1000 - 1) / (portTICK_PERIOD_MS * 1000));
+        }
+        int64_t t0 = esp_timer_get_time();
+        ulTaskNotifyTake(pdTRUE, ticks);
+        async->stats.wait_us += esp_timer_get_time() - t0;
+    }
+}
+
+esp_err_t mpr121_async_collect(mpr121_async_t *async, int handle, uint8_t *data)
+{
+    if (async == NULL || handle < 0 || handle >= MPR121_ASYNC_MAX_INFLIGHT || !async->reqs[handle].owned)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    mpr121_async_req_t *req = &async->reqs[handle];
+    if (!req->finished)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (req->timed_out)
+    {
+        // ABANDONED状态的槽由迟到的回调释放
+        req->owned = false;
+        return ESP_ERR_TIMEOUT;
+    }
+    esp_err_t err = req->result;
+    if (err == ESP_OK)
+    {
+        async->stats.completed++;
+        if (data != NULL)
+        {
+            memcpy(data, req->buf, req->len);
+        }
+    }
+    else
+    {
+        async->stats.errors++;
+        MPR121_TRACE(MPR121_TRACE_READ_ERROR, req->dev->addr, req->reg, err);
+    }
+    req->owned = false;
+    atomic_store_explicit(&req->state, MPR121_ASYNC_FREE, memory_order_release);
+    return err;
+}
+
+void mpr121_async_get_stats(mpr121_async_t *async, mpr121_async_stats_t *stats)
+{
+    *stats = async->stats;
+    stats->late = atomic_load_explicit(&async->late, memory_order_relaxed);
+}
@@ -0,0 +1,118 @@
+#ifndef MPR121_ASYNC_H
+#define MPR121_ASYNC_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include "mpr121.h"
+
+// -------------------------- 可配置参数 --------------------------
+#define MPR121_ASYNC_MAX_INFLIGHT 8           // 同时在途的请求数（跨设备）
+#define MPR121_ASYNC_MAX_LEN MPR121_FRAME_LEN // 单个请求最大读取字节数（整帧）
+
+// -------------------------- 数据结构 --------------------------
+/**
+ * @brief 请求槽状态（由完成回调与采集任务共同修改，原子访问）
+ */
+typedef enum
+{
+    MPR121_ASYNC_FREE = 0,   // 空闲
+    MPR121_ASYNC_INFLIGHT,   // 已提交，等待完成回调
+    MPR121_ASYNC_DONE,       // 已完成（成功或失败），等待处理/取回
+    MPR121_ASYNC_ABANDONED,  // 已超过截止时间被放弃，传输仍在途，迟到的回调将其释放
+} mpr121_async_state_t;
+
+typedef struct mpr121_async mpr121_async_t;
+
+/**
+ * @brief 异步读取请求（接收缓冲区位于槽内，放弃后迟到的传输不会写入调用者内存）
+ */
+typedef struct
+{
+    mpr121_async_t *owner;             // 所属异步上下文
+    mpr121_dev_t *dev;                 // 目标设备
+    uint8_t reg;                       // 起始寄存器
+    uint8_t len;                       // 读取字节数
+    uint8_t retries_left;              // 剩余重试次数
+    bool owned;                        // 已分配给调用者（取回前不可复用）
+    bool finished;                     // 已结束（成功、重试用尽或超时），可取回
+    bool timed_out;                    // 超过截止时间
+    atomic_uchar state;                // mpr121_async_state_t
+    esp_err_t result;                  // 最近一次传输结果
+    int64_t deadline_us;               // 截止时间（esp_timer时间）
+    int64_t submit_us;                 // 最近一次提交时刻
+    int64_t done_us;                   // 最近一次完成时刻（回调中记录）
+    uint8_t buf[MPR121_ASYNC_MAX_LEN]; // 接收缓冲区
+} mpr121_async_req_t;
+
+/**
+ * @brief 异步传输统计
+ */
+typedef struct
+{
+    uint32_t submitted;     // 提交次数（含重试）
+    uint32_t completed;     // 成功完成的请求数
+    uint32_t retries;       // 重试次数
+    uint32_t timeouts;      // 超过截止时间的请求数
+    uint32_t errors;        // 重试用尽后仍失败的请求数
+    uint32_t late;          // 放弃后迟到的完成回调数
+    uint32_t max_inflight;  // 同时在途请求数峰值
+    uint32_t no_slot;       // 无空闲请求槽被拒绝的提交次数
+    uint64_t wait_us;       // 采集任务阻塞等待完成的累计时间（此期间CPU可运行其他任务或空闲）
+} mpr121_async_stats_t;
+
+/**
+ * @brief 异步读取上下文（单个采集任务使用，完成回调通过任务通知唤醒该任务）
+ */
+struct mpr121_async
+{
+    TaskHandle_t task;                                  // 采集任务
+    mpr121_async_req_t reqs[MPR121_ASYNC_MAX_INFLIGHT]; // 请求槽
+    atomic_uint late;                                   // 迟到回调计数（ISR中递增）
+    mpr121_async_stats_t stats;                         // 统计（仅采集任务修改）
+};
+
+// -------------------------- 函数接口 --------------------------
+/**
+ * @brief 初始化异步上下文，绑定当前任务为采集任务
+ * @param async 异步上下文
+ * @return esp_err_t ESP_OK: 初始化成功；ESP_ERR_INVALID_ARG: 参数无效
+ */
+esp_err_t mpr121_async_init(mpr121_async_t *async);
+
+/**
+ * @brief 提交一次异步连续读取（立即返回，设备须支持submit_read）
+ * @param async 异步上下文
+ * @param dev 设备句柄
+ * @param reg 起始寄存器
+ * @param len 读取字节数（1~MPR121_ASYNC_MAX_LEN）
+ * @param timeout_us 相对截止时间（超过后请求以ESP_ERR_TIMEOUT结束）
+ * @param retries 失败（NACK等）后在截止时间内的最大重试次数
+ * @param[out] handle 请求句柄（用于mpr121_async_collect()）
+ * @return esp_err_t ESP_OK: 已提交；ESP_ERR_NO_MEM: 无空闲槽（计入stats.no_slot）；ESP_ERR_NOT_SUPPORTED: 总线不支持异步
+ */
+esp_err_t mpr121_async_submit(mpr121_async_t *async, mpr121_dev_t *dev, uint8_t reg, size_t len,
+                              uint32_t timeout_us, uint8_t retries, int *handle);
+
+/**
+ * @brief 阻塞等待所有在途请求结束（完成、重试用尽或超过截止时间），期间处理重试
+ * @param async 异步上下文
+ */
+void mpr121_async_wait(mpr121_async_t *async);
+
+/**
+ * @brief 取回已结束请求的结果并释放请求槽
+ * @param async 异步上下文
+ * @param handle 请求句柄
+ * @param[out] data 接收缓冲区（成功时写入len字节）
+ * @return esp_err_t ESP_OK: 读取成功；ESP_ERR_TIMEOUT: 超过截止时间；ESP_ERR_INVALID_STATE: 请求尚未结束；其他: 传输错误
+ */
+esp_err_t mpr121_async_collect(mpr121_async_t *async, int handle, uint8_t *data);
+
+/**
+ * @brief 获取异步传输统计
+ * @param async 异步上下文
+ * @param[out] stats 统计快照
+ */
+void mpr121_async_get_stats(mpr121_async_t *async, mpr121_async_stats_t *stats);
+
+#endif // MPR121_ASYNC_H
@@ -0,0 +1,2274 @@
+#include "mpr121_bench.h"
+#include "mpr121_scan.h"
+#include "mpr121_trace.h"
+#include "mpr121_profile.h"
+#include "mpr121_filter.h"
+#include "mpr121_pipeline.h"
+#include "mpr121_gpio.h"
+#include "mpr121_recover.h"
+#include "mpr121_health.h"
+#include "mpr121_event.h"
+#include "mpr121_record.h"
+#include "mpr121_replay.h"
+#include "mpr121_sched.h"
+#include "mpr121_tune.h"
+#include "mpr121_pubsub.h"
+#include "mpr121_calib.h"
+#include "mpr121_gesture.h"
+#include "mpr121_stream.h"
+#include "mpr121_power.h"
+#include "mpr121_stats.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <esp_timer.h>
+#include <string.h>
+
+static const char *TAG = "mpr121_bench";
+
+// -------------------------- 模拟器测试夹具 --------------------------
+esp_err_t mpr121_bench_sim_setup(mpr121_sim_t *sim, mpr121_dev_t *dev, const mpr121_bus_ops_t *ops, uint8_t addr,
+                                 uint16_t idle_level, uint8_t noise)
+{
+    mpr121_sim_init(sim, idle_level, noise);
+    ESP_RETURN_ON_ERROR(mpr121_attach_bus(dev, ops != NULL ? ops : &mpr121_sim_bus_ops, sim, addr), TAG,
+                        "Attach simulator failed");
+    return mpr121_init(dev);
+}
+
+// -------------------------- 静态辅助函数（仅内部使用） --------------------------
+/**
+ * @brief 逐电极读取一帧（旧路径：触摸状态+12路滤波数据+12路基线，每字节单独事务）
+ * @param dev 设备句柄
+ * @param[out] frame 读取结果
+ */
+static esp_err_t bench_read_per_electrode(mpr121_dev_t *dev, mpr121_frame_t *frame)
+{
+    ESP_RETURN_ON_ERROR(mpr121_read_touch(dev, &frame->touch_status), TAG, "Read touch failed");
+    for (uint8_t i = 0; i < MPR121_NUM_ELECTRODES; i++)
+    {
+        ESP_RETURN_ON_ERROR(mpr121_read_filtered(dev, i, &frame->filtered[i]), TAG, "Read filtered failed");
+        ESP_RETURN_ON_ERROR(mpr121_read_baseline(dev, i, &frame->baseline[i]), TAG, "Read baseline failed");
+        frame->delta[i] = (int16_t)((frame->baseline[i] << 2) - frame->filtered[i]);
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief 打印单条路径的平均每帧开销
+ */
+static void bench_report(const char *name, const mpr121_bus_stats_t *stats, int64_t elapsed_us, uint32_t iterations)
+{
+    ESP_LOGI(TAG, "%-14s: %lu txn/frame, %lu tx + %lu rx bytes/frame, %lld us/frame",
+             name,
+             (unsigned long)(stats->transactions / iterations),
+             (unsigned long)(stats->tx_bytes / iterations),
+             (unsigned long)(stats->rx_bytes / iterations),
+             (long long)(elapsed_us / iterations));
+}
+
+// -------------------------- 外部接口实现 --------------------------
+esp_err_t mpr121_bench_frame_read(mpr121_dev_t *dev, uint32_t iterations)
+{
+    if (dev == NULL || iterations == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    mpr121_frame_t frame;
+    mpr121_bus_stats_t stats;
+    int64_t start;
+
+    // 路径1：逐电极读取
+    mpr121_reset_bus_stats(dev);
+    start = esp_timer_get_time();
+    for (uint32_t n = 0; n < iterations; n++)
+    {
+        ESP_RETURN_ON_ERROR(bench_read_per_electrode(dev, &frame), TAG, "Per-electrode path failed");
+    }
+    mpr121_get_bus_stats(dev, &stats);
+    bench_report("per-electrode", &stats, esp_timer_get_time() - start, iterations);
+
+    // 路径2：整帧突发读取
+    mpr121_reset_bus_stats(dev);
+    start = esp_timer_get_time();
+    for (uint32_t n = 0; n < iterations; n++)
+    {
+        ESP_RETURN_ON_ERROR(mpr121_read_frame(dev, &frame), TAG, "Burst frame path failed");
+    }
+    mpr121_get_bus_stats(dev, &stats);
+    bench_report("burst frame", &stats, esp_timer_get_time() - start, iterations);
+
+    mpr121_reset_bus_stats(dev);
+    return ESP_OK;
+}
+
+esp_err_t mpr121_bench_thresholds(mpr121_dev_t *dev, uint8_t touch, uint8_t release)
+{
+    mpr121_bus_stats_t stats;
+
+    mpr121_reset_bus_stats(dev);
+    int64_t start = esp_timer_get_time();
+    ESP_RETURN_ON_ERROR(mpr121_set_thresholds(dev, touch, release), TAG, "Set thresholds failed");
+    mpr121_get_bus_stats(dev, &stats);
+    bench_report("thresholds", &stats, esp_timer_get_time() - start, 1);
+
+    // 再次写入相同阈值：影子缓存判定无变化，不产生任何事务
+    mpr121_reset_bus_stats(dev);
+    start = esp_timer_get_time();
+    ESP_RETURN_ON_ERROR(mpr121_set_thresholds(dev, touch, release), TAG, "Set thresholds failed");
+    mpr121_get_bus_stats(dev, &stats);
+    bench_report("thresholds (=)", &stats, esp_timer_get_time() - start, 1);
+
+    mpr121_reset_bus_stats(dev);
+    return ESP_OK;
+}
+
+/**
+ * @brief 以只含指定电极差值的一帧更新滑条，返回是否触摸与位置
+ */
+static bool bench_slider_feed(mpr121_slider_t *slider, uint16_t mask, int16_t value, int16_t value2, int32_t *position)
+{
+    int16_t delta[MPR121_NUM_CHANNELS] = {0};
+    bool first = true;
+    for (int ch = 0; ch < MPR121_NUM_ELECTRODES; ch++)
+    {
+        if (mask & (1 << ch))
+        {
+            delta[ch] = first ? value : value2;
+            first = false;
+        }
+    }
+    *position = -1;
+    return mpr121_slider_update(slider, delta, position);
+}
+
+/**
+ * @brief 校验配置检查、三点质心位置、触摸迟滞边界与滚轮跨零点的平滑方向
+ * @return esp_err_t ESP_OK: 全部符合预期；ESP_ERR_INVALID_RESPONSE: 有不符合的结果
+ */
+static esp_err_t bench_slider_verify(void)
+{
+    mpr121_slider_t slider;
+    int32_t pos = 0;
+    bool ok = true;
+    mpr121_slider_config_t cfg = {
+        .type = MPR121_SLIDER_LINEAR,
+        .electrodes = {0, 1, 2, 3},
+        .count = 4,
+        .touch_thresh = 20,
+        .release_thresh = 10,
+        .filter_shift = 0,
+        .deadband = 0,
+    };
+
+    // 无效配置：阈值非正（全零差值时质心除以0）、移位超出位宽、未知类型
+    static const struct
+    {
+        int16_t touch;
+        int16_t release;
+        uint8_t shift;
+        uint8_t type;
+    } invalid[] = {
+        {0, -1, 0, MPR121_SLIDER_LINEAR},
+        {1, 0, 0, MPR121_SLIDER_LINEAR},
+        {20, 10, 16, MPR121_SLIDER_LINEAR},
+        {20, 10, 255, MPR121_SLIDER_LINEAR},
+        {20, 10, 0, 2},
+    };
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++)
+    {
+        mpr121_slider_config_t bad = cfg;
+        bad.touch_thresh = invalid[i].touch;
+        bad.release_thresh = invalid[i].release;
+        bad.filter_shift = invalid[i].shift;
+        bad.type = (mpr121_slider_type_t)invalid[i].type;
+        if (mpr121_slider_init(&slider, &bad) != ESP_ERR_INVALID_ARG)
+        {
+            ESP_LOGE(TAG, "Slider accepted invalid config #%u", (unsigned)i);
+            ok = false;
+        }
+    }
+
+    // 线性质心：单电极落在电极上，相邻等强落在中点，首电极无左邻
+    ESP_RETURN_ON_ERROR(mpr121_slider_init(&slider, &cfg), TAG, "Init slider failed");
+    ok &= bench_slider_feed(&slider, 1 << 1, 40, 0, &pos) && pos == 256;
+    ok &= bench_slider_feed(&slider, (1 << 1) | (1 << 2), 30, 30, &pos) && pos == 384;
+    ok &= bench_slider_feed(&slider, (1 << 0) | (1 << 1), 40, 20, &pos) && pos == 20 * 256 / 60;
+    ok &= bench_slider_feed(&slider, 1 << 3, 40, 0, &pos) && pos == 3 * 256;
+
+    // 迟滞：差值和达到touch_thresh才按下，低于release_thresh才释放，释放后重新需要touch_thresh
+    ESP_RETURN_ON_ERROR(mpr121_slider_init(&slider, &cfg), TAG, "Init slider failed");
+    ok &= !bench_slider_feed(&slider, 1 << 2, 19, 0, &pos);
+    ok &= bench_slider_feed(&slider, 1 << 2, 20, 0, &pos);
+    ok &= bench_slider_feed(&slider, 1 << 2, 15, 0, &pos);
+    ok &= bench_slider_feed(&slider, 1 << 2, 10, 0, &pos);
+    ok &= !bench_slider_feed(&slider, 1 << 2, 9, 0, &pos);
+    ok &= !bench_slider_feed(&slider, 1 << 2, 15, 0, &pos);
+    ok &= !bench_slider_feed(&slider, 0, 0, 0, &pos);
+
+    // 滚轮：ELE11与ELE0等强落在11.5个电极处；平滑沿最短路径跨过0点（位置增大并回绕），不绕大圈
+    cfg.type = MPR121_SLIDER_WHEEL;
+    for (int i = 0; i < MPR121_NUM_ELECTRODES; i++)
+    {
+        cfg.electrodes[i] = i;
+    }
+    cfg.count = MPR121_NUM_ELECTRODES;
+    cfg.filter_shift = 1;
+    const int32_t range = MPR121_NUM_ELECTRODES * 256;
+    ESP_RETURN_ON_ERROR(mpr121_slider_init(&slider, &cfg), TAG, "Init wheel failed");
+    ok &= bench_slider_feed(&slider, (1 << 0) | (1 << 11), 40, 40, &pos) && pos == range - 128;
+    ok &= bench_slider_feed(&slider, 1 << 0, 40, 0, &pos) && pos == range - 64;
+    ok &= bench_slider_feed(&slider, 1 << 0, 40, 0, &pos) && pos == range - 32;
+    bench_slider_feed(&slider, 0, 0, 0, &pos);
+    ok &= bench_slider_feed(&slider, 1 << 11, 40, 0, &pos) && pos == 11 * 256;
+    ok &= bench_slider_feed(&slider, 1 << 1, 40, 0, &pos) && pos == 0; // 2816→256的最短路径经过0点，半程恰好回绕到0
+    for (int n = 0; n < 64; n++)
+    {
+        bench_slider_feed(&slider, 1 << 1, 40, 0, &pos);
+    }
+    ok &= pos >= 255 && pos <= 256; // 收敛到ELE1（IIR截断最多差1）
+
+    if (!ok)
+    {
+        ESP_LOGE(TAG, "Slider position/hysteresis/wrap check failed (last position %ld)", (long)pos);
+    }
+    return ok ? ESP_OK : ESP_ERR_INVALID_RESPONSE;
+}
+
+esp_err_t mpr121_bench_slider(uint32_t iterations)
+{
+    if (iterations == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    mpr121_slider_t slider;
+    mpr121_slider_config_t cfg = {
+        .type = MPR121_SLIDER_WHEEL,
+        .electrodes = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11},
+        .count = MPR121_NUM_ELECTRODES,
+        .touch_thresh = 20,
+        .release_thresh = 10,
+        .filter_shift = 2,
+        .deadband = 4,
+    };
+    ESP_RETURN_ON_ERROR(mpr121_slider_init(&slider, &cfg), TAG, "Init slider failed");
+
+    // 合成一个沿滚轮移动的手指：峰值电极及相邻电极带有不同强度的差值
+    int16_t delta[MPR121_NUM_CHANNELS] = {0};
+    int32_t position = 0;
+    int64_t start = esp_timer_get_time();
+    for (uint32_t n = 0; n < iterations; n++)
+    {
+        int peak = (n >> 4) % MPR121_NUM_ELECTRODES;
+        delta[(peak + MPR121_NUM_ELECTRODES - 1) % MPR121_NUM_ELECTRODES] = 0;
+        delta[peak] = 40;
+        delta[(peak + 1) % MPR121_NUM_ELECTRODES] = (int16_t)(n & 0x0F) * 2;
+        mpr121_slider_update(&slider, delta, &position);
+    }
+    int64_t elapsed_us = esp_timer_get_time() - start;
+
+    ESP_LOGI(TAG, "slider update : %lld ns/frame (last position %ld)",
+             (long long)(elapsed_us * 1000 / iterations), (long)position);
+    return bench_slider_verify();
+}
+
+// -------------------------- 模拟器基准测试 --------------------------
+typedef enum
+{
+    BENCH_PATH_PER_ELECTRODE = 0, // 逐电极读取
+    BENCH_PATH_FRAME,             // 整帧突发读取
+    BENCH_PATH_TOUCH,             // 仅触摸状态
+    BENCH_PATH_MAX,
+} bench_path_t;
+
+static const char *s_bench_path_names[BENCH_PATH_MAX] = {"per-electrode", "burst frame", "touch only"};
+
+esp_err_t mpr121_bench_sim(uint32_t frames)
+{
+    if (frames == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    static mpr121_sim_t sim;
+    static mpr121_dev_t dev;
+    ESP_RETURN_ON_ERROR(mpr121_bench_sim_setup(&sim, &dev, NULL, MPR121_DEFAULT_ADDR, 700, 2), TAG, "Setup failed");
+    // 脚本：ELE3周期性短按，ELE4~ELE5一次较长的双电极按压
+    for (uint32_t start = 50; start < frames && sim.touch_count < MPR121_SIM_MAX_TOUCHES - 1; start += 200)
+    {
+        mpr121_sim_touch_t tap = {.start_sample = start, .end_sample = start + 40, .mask = 1 << 3, .drop = 80};
+        mpr121_sim_add_touch(&sim, &tap);
+    }
+    mpr121_sim_touch_t hold = {.start_sample = frames / 2, .end_sample = frames / 2 + 300, .mask = 0x30, .drop = 60};
+    mpr121_sim_add_touch(&sim, &hold);
+    ESP_LOGI(TAG, "init on simulator: %lu txn, %llu us bus time @100kHz, %lu writes rejected in run mode",
+             (unsigned long)sim.transactions, (unsigned long long)mpr121_sim_bus_time_us(&sim, 100000),
+             (unsigned long)sim.ignored_writes);
+
+    mpr121_frame_t frame;
+    for (int path = 0; path < BENCH_PATH_MAX; path++)
+    {
+        sim.transactions = 0;
+        sim.bus_bits = 0;
+        sim.sample = 0;
+        int64_t cpu_us = 0;
+        for (uint32_t n = 0; n < frames; n++)
+        {
+            mpr121_sim_step(&sim);
+            int64_t start = esp_timer_get_time();
+            switch (path)
+            {
+            case BENCH_PATH_PER_ELECTRODE:
+                ESP_RETURN_ON_ERROR(bench_read_per_electrode(&dev, &frame), TAG, "Per-electrode path failed");
+                break;
+            case BENCH_PATH_FRAME:
+                ESP_RETURN_ON_ERROR(mpr121_read_frame(&dev, &frame), TAG, "Burst frame path failed");
+                break;
+            default:
+                ESP_RETURN_ON_ERROR(mpr121_read_touch(&dev, &frame.touch_status), TAG, "Touch path failed");
+                break;
+            }
+            cpu_us += esp_timer_get_time() - start;
+        }
+
+        ESP_LOGI(TAG, "%-14s: %lu txn/frame, bus %llu us/frame @100kHz, %llu us/frame @400kHz, cpu %lld ns/frame",
+                 s_bench_path_names[path],
+                 (unsigned long)(sim.transactions / frames),
+                 (unsigned long long)(mpr121_sim_bus_time_us(&sim, 100000) / frames),
+                 (unsigned long long)(mpr121_sim_bus_time_us(&sim, 400000) / frames),
+                 (long long)(cpu_us * 1000 / frames));
+    }
+    return ESP_OK;
+}
+
+// -------------------------- 同步/异步扫描对比 --------------------------
+esp_err_t mpr121_bench_scan(mpr121_dev_t *const devs[], uint8_t count, uint32_t frames, uint64_t *touch_mask)
+{
+    if (frames == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    static mpr121_scanner_t scanner;
+    static mpr121_async_t async;
+    ESP_RETURN_ON_ERROR(mpr121_scanner_init(&scanner, devs, count), TAG, "Init scanner failed");
+
+    uint64_t blocking_mask = 0;
+    int64_t start = esp_timer_get_time();
+    for (uint32_t n = 0; n < frames; n++)
+    {
+        ESP_RETURN_ON_ERROR(mpr121_scanner_scan(&scanner, &blocking_mask), TAG, "Blocking scan failed");
+    }
+    ESP_LOGI(TAG, "blocking scan : %lld us/frame, task idle %lu permille, mask 0x%012llX",
+             (long long)((esp_timer_get_time() - start) / frames),
+             (unsigned long)mpr121_scanner_get_idle_permille(&scanner), (unsigned long long)blocking_mask);
+    if (touch_mask != NULL)
+    {
+        *touch_mask = blocking_mask;
+    }
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (devs[i]->bus->submit_read == NULL)
+        {
+            ESP_LOGW(TAG, "MPR121 0x%02X has no async bus, skipping async scan", devs[i]->addr);
+            return ESP_OK;
+        }
+    }
+
+    ESP_RETURN_ON_ERROR(mpr121_scanner_init(&scanner, devs, count), TAG, "Init scanner failed");
+    ESP_RETURN_ON_ERROR(mpr121_async_init(&async), TAG, "Init async failed");
+    uint64_t async_mask = 0;
+    start = esp_timer_get_time();
+    for (uint32_t n = 0; n < frames; n++)
+    {
+        ESP_RETURN_ON_ERROR(mpr121_scanner_scan_async(&scanner, &async, &async_mask), TAG, "Async scan failed");
+    }
+    mpr121_async_stats_t stats;
+    mpr121_async_get_stats(&async, &stats);
+    ESP_LOGI(TAG, "async scan    : %lld us/frame, task idle %lu permille, max %lu in flight, "
+                  "%lu retries, %lu timeouts, %lu late, %lu without a free slot",
+             (long long)((esp_timer_get_time() - start) / frames),
+             (unsigned long)mpr121_scanner_get_idle_permille(&scanner),
+             (unsigned long)stats.max_inflight, (unsigned long)stats.retries,
+             (unsigned long)stats.timeouts, (unsigned long)stats.late, (unsigned long)stats.no_slot);
+    if (async_mask != blocking_mask)
+    {
+        ESP_LOGE(TAG, "Async mask 0x%012llX differs from blocking mask", (unsigned long long)async_mask);
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+    return ESP_OK;
+}
+
+// -------------------------- 跟踪基准测试 --------------------------
+esp_err_t mpr121_bench_trace(uint32_t iterations)
+{
+    if (iterations == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // 与主循环逐事件日志相同的格式化内容；volatile防止编译器优化掉未使用的结果
+    char line[96];
+    volatile int sink = 0;
+    int64_t start = esp_timer_get_time();
+    for (uint32_t n = 0; n < iterations; n++)
+    {
+        sink += snprintf(line, sizeof(line), "→ Electrode %d %s at %lld us (latency %lu us)",
+                         (int)(n % MPR121_NUM_ELECTRODES), (n & 1) ? "released" : "pressed",
+                         (long long)start + n, (unsigned long)(n & 0xFF));
+    }
+    int64_t format_us = esp_timer_get_time() - start;
+
+    start = esp_timer_get_time();
+    for (uint32_t n = 0; n < iterations; n++)
+    {
+        mpr121_trace_write((n & 1) ? MPR121_TRACE_RELEASE : MPR121_TRACE_PRESS,
+                           n % MPR121_NUM_ELECTRODES, 0, (int32_t)(n & 0xFF));
+    }
+    int64_t trace_us = esp_timer_get_time() - start;
+
+    ESP_LOGI(TAG, "event output  : snprintf %lld ns/event, trace write %lld ns/event (%d bytes/record)",
+             (long long)(format_us * 1000 / iterations), (long long)(trace_us * 1000 / iterations),
+             (int)sizeof(mpr121_trace_rec_t));
+
+    // 取出全部记录（环中只保留最近MPR121_TRACE_RING_SIZE条），解码最后两条验证格式
+    mpr121_trace_rec_t recs[16];
+    mpr121_trace_rec_t last[2] = {0};
+    size_t n, total = 0;
+    while ((n = mpr121_trace_read(recs, 16)) > 0)
+    {
+        last[0] = n >= 2 ? recs[n - 2] : last[1];
+        last[1] = recs[n - 1];
+        total += n;
+    }
+    mpr121_trace_stats_t stats;
+    mpr121_trace_get_stats(&stats);
+    ESP_LOGI(TAG, "trace ring    : %u drained, %lu dropped (sink %d)",
+             (unsigned)total, (unsigned long)stats.dropped, sink);
+    for (int i = 0; i < 2 && total >= 2; i++)
+    {
+        mpr121_trace_format(&last[i], line, sizeof(line));
+        ESP_LOGI(TAG, "  %s", line);
+    }
+    return ESP_OK;
+}
+
+// -------------------------- 调校配置切换基准测试 --------------------------
+esp_err_t mpr121_bench_profile(void)
+{
+    static mpr121_sim_t sim;
+    static mpr121_dev_t dev;
+    static const mpr121_profile_id_t sequence[] = {MPR121_PROFILE_WET, MPR121_PROFILE_GLOVE, MPR121_PROFILE_DRY};
+    uint8_t before[MPR121_NUM_CHANNELS];
+    uint8_t after[MPR121_NUM_CHANNELS];
+
+    ESP_RETURN_ON_ERROR(mpr121_bench_sim_setup(&sim, &dev, NULL, MPR121_DEFAULT_ADDR, 700, 2), TAG, "Setup failed");
+    for (int n = 0; n < 64; n++)
+    {
+        mpr121_sim_step(&sim); // 让基线收敛
+    }
+
+    for (size_t i = 0; i < sizeof(sequence) / sizeof(sequence[0]); i++)
+    {
+        const mpr121_profile_t *profile = mpr121_profile_get(sequence[i]);
+        mpr121_profile_result_t result;
+        ESP_RETURN_ON_ERROR(mpr121_read_regs(&dev, MPR121_BASELINE_0, before, sizeof(before)), TAG, "Read baseline failed");
+        sim.bus_bits = 0;
+        ESP_RETURN_ON_ERROR(mpr121_profile_apply(&dev, profile, &result), TAG, "Switch failed");
+        uint64_t bus_us = mpr121_sim_bus_time_us(&sim, 400000);
+        mpr121_sim_step(&sim); // 重新进入运行模式后的第一个采样周期
+        ESP_RETURN_ON_ERROR(mpr121_read_regs(&dev, MPR121_BASELINE_0, after, sizeof(after)), TAG, "Read baseline failed");
+
+        int drift = 0;
+        for (int ch = 0; ch < MPR121_NUM_CHANNELS; ch++)
+        {
+            int d = after[ch] > before[ch] ? after[ch] - before[ch] : before[ch] - after[ch];
+            drift = d > drift ? d : drift;
+        }
+        ESP_LOGI(TAG, "profile %-6s: %2u regs, %u txn, %3u bytes, bus %llu us @400kHz, max baseline change %d",
+                 profile->name, result.regs_changed, result.transactions, result.tx_bytes,
+                 (unsigned long long)bus_us, drift);
+    }
+
+    // 对比：待机后整段重写MHDR~CDT_10_11（不比较差异），再恢复运行模式
+    uint8_t all[MPR121_CDT_10_11 - MPR121_MHDR + 1];
+    uint8_t ecr = 0;
+    for (size_t r = 0; r < sizeof(all); r++)
+    {
+        mpr121_cfg_get(&dev, MPR121_MHDR + r, &all[r]);
+    }
+    mpr121_cfg_get(&dev, MPR121_ELE_CFG, &ecr);
+    all[MPR121_ELE_CFG - MPR121_MHDR] = 0x00;
+    const uint8_t stop = 0x00;
+    sim.bus_bits = 0;
+    ESP_RETURN_ON_ERROR(mpr121_write_regs(&dev, MPR121_ELE_CFG, &stop, 1), TAG, "Stop failed");
+    ESP_RETURN_ON_ERROR(mpr121_write_regs(&dev, MPR121_MHDR, all, sizeof(all)), TAG, "Full rewrite failed");
+    ESP_RETURN_ON_ERROR(mpr121_write_regs(&dev, MPR121_ELE_CFG, &ecr, 1), TAG, "Run failed");
+    ESP_LOGI(TAG, "full rewrite  : %u bytes, bus %llu us @400kHz",
+             (unsigned)(sizeof(all) + 5), (unsigned long long)mpr121_sim_bus_time_us(&sim, 400000));
+
+    // 使能ACE后再切换：每次重新进入运行模式都会执行自动配置，FFI须与FILT_CDC_CFG一致，否则搜索失败（ACFF）
+    const uint8_t auto_cfg[] = {0x0B, 0x00, 201, 130, 181}; // ACE+ARE+BVA=CL10，USL/LSL/TL按3.3V
+    uint32_t failed = 0;
+    uint32_t runs = sim.autoconfig_runs;
+    mpr121_cfg_set_block(&dev, MPR121_AUTO_CFG0, auto_cfg, sizeof(auto_cfg));
+    ESP_RETURN_ON_ERROR(mpr121_cfg_commit(&dev), TAG, "Enable auto-config failed");
+    for (size_t i = 0; i < sizeof(sequence) / sizeof(sequence[0]); i++)
+    {
+        const mpr121_profile_t *profile = mpr121_profile_get(sequence[i]);
+        ESP_RETURN_ON_ERROR(mpr121_profile_apply(&dev, profile, NULL), TAG, "Switch failed");
+        for (int k = 0; k < MPR121_SIM_AUTOCONFIG_SAMPLES; k++)
+        {
+            mpr121_sim_step(&sim); // 等待搜索结束
+        }
+        if ((sim.regs[MPR121_OORSTATUS_H] & 0x80) ||
+            (sim.regs[MPR121_AUTO_CFG0] & 0xC0) != (sim.regs[MPR121_FILT_CDC_CFG] & 0xC0))
+        {
+            ESP_LOGE(TAG, "Profile %s: AUTO_CFG0 0x%02X, FILT_CDC_CFG 0x%02X, auto-config failed", profile->name,
+                     sim.regs[MPR121_AUTO_CFG0], sim.regs[MPR121_FILT_CDC_CFG]);
+            failed++;
+        }
+    }
+    ESP_LOGI(TAG, "profile ACE=1 : %u switches, %lu auto-config runs, %lu failed",
+             (unsigned)(sizeof(sequence) / sizeof(sequence[0])), (unsigned long)(sim.autoconfig_runs - runs),
+             (unsigned long)failed);
+    return failed ? ESP_ERR_INVALID_RESPONSE : ESP_OK;
+}
+
+// -------------------------- 软件滤波器组基准测试 --------------------------
+esp_err_t mpr121_bench_filter(uint32_t iterations)
+{
+    if (iterations < 64)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    static mpr121_filter_bank_t bank;
+    mpr121_filter_config_t cfg;
+    for (int ch = 0; ch < MPR121_NUM_CHANNELS; ch++)
+    {
+        cfg.median_n[ch] = 5;
+        cfg.iir_shift[ch] = 2;
+        cfg.slew_max[ch] = 8;
+    }
+    ESP_RETURN_ON_ERROR(mpr121_filter_init(&bank, &cfg), TAG, "Init filter bank failed");
+
+    // 合成数据：空闲电平700，±4噪声，每37帧一个+60的单帧尖峰
+    mpr121_frame_t frame = {0};
+    memset(frame.baseline, 700 >> 2, sizeof(frame.baseline));
+    uint32_t rng = 1;
+    int in_min = INT32_MAX, in_max = INT32_MIN, out_min = INT32_MAX, out_max = INT32_MIN;
+    int64_t cpu_us = 0;
+    for (uint32_t n = 0; n < iterations; n++)
+    {
+        for (int ch = 0; ch < MPR121_NUM_CHANNELS; ch++)
+        {
+            rng = rng * 1103515245 + 12345;
+            frame.filtered[ch] = 700 + (int)((rng >> 16) % 9) - 4 + ((n + ch) % 37 == 0 ? 60 : 0);
+        }
+        int in = frame.filtered[0];
+        int64_t start = esp_timer_get_time();
+        mpr121_filter_process(&bank, &frame);
+        cpu_us += esp_timer_get_time() - start;
+        if (n >= 16) // 跳过启动段
+        {
+            in_min = in < in_min ? in : in_min;
+            in_max = in > in_max ? in : in_max;
+            out_min = frame.filtered[0] < out_min ? frame.filtered[0] : out_min;
+            out_max = frame.filtered[0] > out_max ? frame.filtered[0] : out_max;
+        }
+    }
+
+    ESP_LOGI(TAG, "filter bank   : %lld ns/frame (13 ch, median5+IIR+slew), p-p noise %d -> %d",
+             (long long)(cpu_us * 1000 / iterations), in_max - in_min, out_max - out_min);
+    return ESP_OK;
+}
+
+// -------------------------- 双核流水线基准测试 --------------------------
+#define BENCH_PIPELINE_PERIOD_MS portTICK_PERIOD_MS                 // 采集周期（流水线支持的最短周期：一个tick）
+#define BENCH_PIPELINE_WORK_US (BENCH_PIPELINE_PERIOD_MS * 1200)      // 模拟处理负载（比采集周期长20%，迫使队列填满）
+
+typedef struct
+{
+    mpr121_filter_bank_t bank; // 滤波器组
+    uint32_t work_us;          // 每帧额外忙等时间
+} bench_pipeline_ctx_t;
+
+static void bench_pipeline_process(void *arg, const mpr121_frame_t *frame)
+{
+    bench_pipeline_ctx_t *ctx = (bench_pipeline_ctx_t *)arg;
+    mpr121_frame_t copy = *frame;
+    int64_t start = esp_timer_get_time();
+
+    mpr121_filter_process(&ctx->bank, &copy);
+    while (esp_timer_get_time() - start < ctx->work_us)
+    {
+    }
+}
+
+esp_err_t mpr121_bench_pipeline(mpr121_dev_t *dev, uint32_t duration_ms)
+{
+    static const char *policy_names[] = {"drop-newest", "drop-oldest", "block"};
+    static bench_pipeline_ctx_t ctx;
+    static mpr121_pipeline_t pipe;
+    mpr121_filter_config_t filter_cfg;
+
+    for (int ch = 0; ch < MPR121_NUM_CHANNELS; ch++)
+    {
+        filter_cfg.median_n[ch] = 3;
+        filter_cfg.iir_shift[ch] = 2;
+        filter_cfg.slew_max[ch] = 0;
+    }
+
+    for (int policy = MPR121_PIPELINE_DROP_NEWEST; policy <= MPR121_PIPELINE_BLOCK; policy++)
+    {
+        ESP_RETURN_ON_ERROR(mpr121_filter_init(&ctx.bank, &filter_cfg), TAG, "Init filter bank failed");
+        ctx.work_us = BENCH_PIPELINE_WORK_US;
+        const mpr121_pipeline_config_t cfg = {
+            .dev = dev,
+            .period_ms = BENCH_PIPELINE_PERIOD_MS,
+            .policy = (mpr121_pipeline_policy_t)policy,
+            .block_timeout_ms = 5,
+            .acq_core = 0,
+            .proc_core = 1,
+            .acq_prio = configMAX_PRIORITIES - 2,
+            .proc_prio = 5,
+            .process = bench_pipeline_process,
+            .arg = &ctx,
+        };
+        ESP_RETURN_ON_ERROR(mpr121_pipeline_start(&pipe, &cfg), TAG, "Start pipeline failed");
+        vTaskDelay(pdMS_TO_TICKS(duration_ms));
+        mpr121_pipeline_stats_t stats;
+        mpr121_pipeline_get_stats(&pipe, &stats);
+        ESP_RETURN_ON_ERROR(mpr121_pipeline_stop(&pipe), TAG, "Stop pipeline failed");
+
+        ESP_LOGI(TAG, "pipeline %-11s: %lu acquired, %lu processed (%lu fps), dropped new %lu / old %lu, "
+                      "blocked %lu us, queue peak %lu, latency avg %lu us / max %lu us",
+                 policy_names[policy], (unsigned long)stats.acquired, (unsigned long)stats.processed,
+                 (unsigned long)(stats.processed * 1000ULL / duration_ms), (unsigned long)stats.dropped_newest,
+                 (unsigned long)stats.dropped_oldest, (unsigned long)stats.blocked_us,
+                 (unsigned long)stats.queue_peak, (unsigned long)stats.latency_avg_us,
+                 (unsigned long)stats.latency_max_us);
+    }
+    return ESP_OK;
+}
+
+// -------------------------- GPIO/LED合并写入基准测试 --------------------------
+#define BENCH_GPIO_UPDATES_PER_FRAME 20
+#define BENCH_GPIO_FRAME_US 10000 // 模拟帧间隔（闪烁相位按模拟时间推进）
+
+esp_err_t mpr121_bench_gpio(uint32_t frames)
+{
+    static mpr121_sim_t sim;
+    static mpr121_dev_t dev;
+    static mpr121_gpio_t gpio;
+
+    ESP_RETURN_ON_ERROR(mpr121_bench_sim_setup(&sim, &dev, NULL, MPR121_DEFAULT_ADDR, 700, 2), TAG, "Setup failed");
+    // 仅ELE0~ELE3作为电极，ELE4~ELE11全部用作LED输出
+    mpr121_cfg_set(&dev, MPR121_ELE_CFG, 0x04);
+    ESP_RETURN_ON_ERROR(mpr121_cfg_commit(&dev), TAG, "Set ELE_EN failed");
+    ESP_RETURN_ON_ERROR(mpr121_gpio_init(&gpio, &dev), TAG, "Init GPIO failed");
+
+    uint32_t txn_before = sim.transactions;
+    ESP_RETURN_ON_ERROR(mpr121_gpio_config(&gpio, 0xFF, MPR121_GPIO_OUTPUT_HIGH_SIDE, false), TAG, "Config failed");
+    ESP_LOGI(TAG, "gpio config   : 8 pins in %lu txn", (unsigned long)(sim.transactions - txn_before));
+
+    const mpr121_gpio_blink_t blink = {.on_ms = 50, .off_ms = 150, .count = 0};
+    int64_t now_us = 0;
+    uint32_t rng = 7;
+    txn_before = sim.transactions;
+    for (uint32_t n = 0; n < frames; n++)
+    {
+        if (n == 0)
+        {
+            ESP_RETURN_ON_ERROR(mpr121_gpio_blink(&gpio, MPR121_GPIO_PIN(10) | MPR121_GPIO_PIN(11), &blink, now_us),
+                                TAG, "Blink failed");
+        }
+        for (int k = 0; k < BENCH_GPIO_UPDATES_PER_FRAME; k++)
+        {
+            rng = rng * 1103515245 + 12345;
+            uint8_t pin = MPR121_GPIO_PIN(4 + (rng >> 16) % 6); // ELE4~ELE9，ELE10/11在闪烁
+            switch ((rng >> 24) % 3)
+            {
+            case 0:
+                mpr121_gpio_set(&gpio, pin);
+                break;
+            case 1:
+                mpr121_gpio_clear(&gpio, pin);
+                break;
+            default:
+                mpr121_gpio_toggle(&gpio, pin);
+                break;
+            }
+        }
+        ESP_RETURN_ON_ERROR(mpr121_gpio_flush(&gpio, now_us), TAG, "Flush failed");
+        if ((sim.regs[MPR121_GPIO_DATA] & gpio.outputs) != gpio.level)
+        {
+            ESP_LOGE(TAG, "GPIO mismatch at frame %lu: chip 0x%02X, expected 0x%02X",
+                     (unsigned long)n, sim.regs[MPR121_GPIO_DATA], gpio.level);
+            return ESP_ERR_INVALID_RESPONSE;
+        }
+        now_us += BENCH_GPIO_FRAME_US;
+    }
+
+    // 逐次读-改-写：每次更新读DATA+写DATA两次事务，闪烁每个边沿另需一次
+    uint32_t coalesced = sim.transactions - txn_before;
+    uint32_t rmw = frames * BENCH_GPIO_UPDATES_PER_FRAME * 2;
+    ESP_LOGI(TAG, "gpio leds     : %lu updates/frame -> coalesced %lu txn (%.2f/frame) vs read-modify-write %lu txn",
+             (unsigned long)BENCH_GPIO_UPDATES_PER_FRAME, (unsigned long)coalesced, (double)coalesced / frames,
+             (unsigned long)rmw);
+    return ESP_OK;
+}
+
+// -------------------------- 总线故障恢复测试 --------------------------
+/**
+ * @brief 校验模拟芯片的配置寄存器与影子缓存一致（ELE_CFG仅比较使能位，重放时CL可能被改为10）
+ */
+static bool bench_recover_cfg_matches(const mpr121_sim_t *sim, mpr121_dev_t *dev)
+{
+    for (int reg = MPR121_CFG_FIRST; reg <= MPR121_CFG_LAST; reg++)
+    {
+        uint8_t want = 0;
+        mpr121_cfg_get(dev, reg, &want);
+        if (reg >= MPR121_GPIO_SET && reg <= MPR121_GPIO_TOGGLE)
+        {
+            continue; // 只写寄存器
+        }
+        if (sim->regs[reg] != want)
+        {
+            ESP_LOGE(TAG, "Reg 0x%02X: chip 0x%02X, expected 0x%02X", reg, sim->regs[reg], want);
+            return false;
+        }
+    }
+    return true;
+}
+
+esp_err_t mpr121_bench_recover(uint32_t cycles)
+{
+    static mpr121_sim_t sim;
+    static mpr121_dev_t dev;
+    static mpr121_recover_t rec;
+    static const struct
+    {
+        mpr121_sim_fault_t fault;
+        uint32_t count;
+        const char *name;
+    } cases[] = {
+        {MPR121_SIM_FAULT_NACK, 2, "nack"},
+        {MPR121_SIM_FAULT_BUS_STUCK, 0, "bus stuck"},
+        {MPR121_SIM_FAULT_BROWNOUT, 0, "brown-out"},
+    };
+
+    // 对比基准：重启时的完整初始化（软复位+两次5ms延时+默认配置提交）再应用调校配置
+    int64_t start = esp_timer_get_time();
+    ESP_RETURN_ON_ERROR(mpr121_bench_sim_setup(&sim, &dev, NULL, MPR121_DEFAULT_ADDR, 700, 2), TAG, "Setup failed");
+    ESP_RETURN_ON_ERROR(mpr121_profile_apply(&dev, mpr121_profile_get(MPR121_PROFILE_DRY), NULL),
+                        TAG, "Apply profile failed");
+    ESP_LOGI(TAG, "init+profile     : %4.1f txn, bus %4llu us @400kHz, wall %6lu us (fixed delays)",
+             (double)sim.transactions, (unsigned long long)mpr121_sim_bus_time_us(&sim, 400000),
+             (unsigned long)(esp_timer_get_time() - start));
+
+    const mpr121_recover_config_t rec_cfg = {
+        .bus_reset = mpr121_sim_bus_reset,
+        .bus_reset_arg = &sim,
+    };
+    ESP_RETURN_ON_ERROR(mpr121_recover_init(&rec, &dev, &rec_cfg), TAG, "Init recovery failed");
+
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++)
+    {
+        uint32_t recovered = 0, txn = 0, max_us = 0;
+        uint64_t bus_bits = 0;
+        uint64_t total_us = rec.total_us;
+        mpr121_recover_stats_t before;
+        mpr121_recover_get_stats(&rec, &before);
+        mpr121_stats_t bus_before;
+        bool have_stats = mpr121_get_stats(&bus_before, false) == ESP_OK;
+        for (uint32_t n = 0; n < cycles; n++)
+        {
+            for (int k = 0; k < 16; k++)
+            {
+                mpr121_sim_step(&sim);
+            }
+            mpr121_sim_inject_fault(&sim, cases[c].fault, cases[c].count);
+
+            // 故障检测：传输失败（NACK/卡死）或周期校验发现配置丢失（掉电复位时读取仍成功）
+            uint16_t touch = 0;
+            esp_err_t err = mpr121_read_touch(&dev, &touch);
+            uint32_t txn_before = sim.transactions;
+            uint64_t bits_before = sim.bus_bits;
+            err = err != ESP_OK ? mpr121_recover_run(&rec, err) : mpr121_recover_check(&rec);
+            txn += sim.transactions - txn_before;
+            bus_bits += sim.bus_bits - bits_before;
+            if (err != ESP_OK)
+            {
+                continue;
+            }
+            max_us = rec.stats.last_us > max_us ? rec.stats.last_us : max_us;
+            if (!bench_recover_cfg_matches(&sim, &dev))
+            {
+                return ESP_ERR_INVALID_RESPONSE;
+            }
+            // 恢复扫描后不应出现误触摸（重放后基线按当前数据装载）
+            for (int k = 0; k < 16; k++)
+            {
+                mpr121_sim_step(&sim);
+            }
+            ESP_RETURN_ON_ERROR(mpr121_read_touch(&dev, &touch), TAG, "Read after recovery failed");
+            if (touch & 0x0FFF)
+            {
+                ESP_LOGE(TAG, "False touch 0x%03X after %s recovery", touch, cases[c].name);
+                return ESP_ERR_INVALID_RESPONSE;
+            }
+            // 无故障时的周期校验不应再次重放（芯片与缓存完全一致，含ELE_CFG的CL位）
+            uint32_t replays = rec.stats.replays;
+            ESP_RETURN_ON_ERROR(mpr121_recover_check(&rec), TAG, "Fault-free check failed");
+            if (rec.stats.replays != replays)
+            {
+                ESP_LOGE(TAG, "Fault-free check replayed config after %s recovery", cases[c].name);
+                return ESP_ERR_INVALID_RESPONSE;
+            }
+            recovered++;
+        }
+
+        mpr121_recover_stats_t after;
+        mpr121_recover_get_stats(&rec, &after);
+        uint32_t done = after.recoveries - before.recoveries;
+        uint32_t n = cycles ? cycles : 1;
+        ESP_LOGI(TAG, "recover %-9s: %4.1f txn, bus %4llu us @400kHz, wall avg %6lu us max %lu us "
+                      "(%lu/%lu ok, %lu replays)",
+                 cases[c].name, (double)txn / n, (unsigned long long)(bus_bits * 1000000ULL / 400000 / n),
+                 (unsigned long)(done ? (rec.total_us - total_us) / done : 0), (unsigned long)max_us,
+                 (unsigned long)recovered, (unsigned long)cycles, (unsigned long)(after.replays - before.replays));
+
+        // NACK按ESP_ERR_INVALID_RESPONSE单独计数，不混入FAIL/OTHER
+        mpr121_stats_t bus_after;
+        if (have_stats && cases[c].fault == MPR121_SIM_FAULT_NACK && mpr121_get_stats(&bus_after, false) == ESP_OK)
+        {
+            uint32_t nacks = bus_after.errors[MPR121_ERR_NACK] - bus_before.errors[MPR121_ERR_NACK];
+            if (nacks < cycles || bus_after.errors[MPR121_ERR_FAIL] != bus_before.errors[MPR121_ERR_FAIL] ||
+                bus_after.errors[MPR121_ERR_OTHER] != bus_before.errors[MPR121_ERR_OTHER])
+            {
+                ESP_LOGE(TAG, "NACK faults counted as %lu nack, %lu fail, %lu other", (unsigned long)nacks,
+                         (unsigned long)(bus_after.errors[MPR121_ERR_FAIL] - bus_before.errors[MPR121_ERR_FAIL]),
+                         (unsigned long)(bus_after.errors[MPR121_ERR_OTHER] - bus_before.errors[MPR121_ERR_OTHER]));
+                return ESP_ERR_INVALID_RESPONSE;
+            }
+        }
+    }
+
+    mpr121_recover_stats_t stats;
+    mpr121_recover_get_stats(&rec, &stats);
+    ESP_LOGI(TAG, "recovery total: %lu faults, %lu recovered, %lu failed, %lu bus resets",
+             (unsigned long)stats.faults, (unsigned long)stats.recoveries, (unsigned long)stats.failures,
+             (unsigned long)stats.bus_resets);
+    return stats.failures ? ESP_FAIL : ESP_OK;
+}
+
+// -------------------------- 芯片健康监测测试 --------------------------
+#define BENCH_HEALTH_CDC 0x20                                          // 手动调校的充电电流（关闭ACE）
+#define BENCH_HEALTH_OOR ((1 << 5) | (1 << 9))                          // 超范围电极
+#define BENCH_HEALTH_STUCK (1 << 9)                                     // 自动配置也无法修复的电极
+
+/**
+ * @brief 模拟器读取：自动配置搜索进行中时每次读取前推进一个采样周期（模拟轮询间隔），使轮询等待能看到搜索结束
+ */
+static esp_err_t bench_search_bus_read(void *ctx, uint8_t reg, uint8_t *data, size_t len)
+{
+    if (((mpr121_sim_t *)ctx)->autoconfig_pending)
+    {
+        mpr121_sim_step((mpr121_sim_t *)ctx);
+    }
+    return mpr121_sim_bus_ops.read(ctx, reg, data, len);
+}
+
+static esp_err_t bench_sim_bus_write(void *ctx, uint8_t reg, const uint8_t *data, size_t len)
+{
+    return mpr121_sim_bus_ops.write(ctx, reg, data, len);
+}
+
+static const mpr121_bus_ops_t bench_search_bus_ops = {
+    .write = bench_sim_bus_write,
+    .read = bench_search_bus_read,
+};
+
+/**
+ * @brief 在事件管线上运行一段采样：IRQ引脚拉低时记录中断并处理，取出全部事件
+ * @param[out] events 生成的事件数
+ */
+static esp_err_t bench_health_run(mpr121_sim_t *sim, mpr121_event_pipe_t *pipe, uint32_t samples,
+                                  uint32_t ovcf_at, uint32_t *events)
+{
+    mpr121_touch_event_t event;
+    for (uint32_t n = 0; n < samples; n++)
+    {
+        if (n == ovcf_at)
+        {
+            mpr121_sim_inject_fault(sim, MPR121_SIM_FAULT_OVERCURRENT, 0);
+        }
+        mpr121_sim_step(sim);
+        if (sim->irq)
+        {
+            mpr121_event_irq_from_isr(pipe);
+            ESP_RETURN_ON_ERROR(mpr121_event_process(pipe), TAG, "Process IRQ failed");
+        }
+        while (mpr121_event_pop(pipe, &event))
+        {
+            (*events)++;
+        }
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief 故障电极位于使能范围顶端（ELE11）：隔离后ELE_EN收缩、该电极停止采样，之后不再产生IRQ
+ * @param[out] ele_en 隔离后芯片的ELE_EN
+ * @param[out] late_irqs 隔离后再运行samples个采样周期的IRQ数
+ */
+static esp_err_t bench_health_top(mpr121_sim_t *sim, mpr121_dev_t *dev, mpr121_event_pipe_t *pipe,
+                                  mpr121_health_t *health, uint32_t samples, uint8_t *ele_en, uint32_t *late_irqs)
+{
+    uint32_t events = 0;
+
+    ESP_RETURN_ON_ERROR(mpr121_bench_sim_setup(sim, dev, &bench_search_bus_ops, MPR121_DEFAULT_ADDR, 700, 2), TAG,
+                        "Setup failed");
+    mpr121_sim_set_oor(sim, 1 << (MPR121_NUM_ELECTRODES - 1), 1 << (MPR121_NUM_ELECTRODES - 1));
+    ESP_RETURN_ON_ERROR(mpr121_event_pipe_init(pipe, dev), TAG, "Init event pipe failed");
+    ESP_RETURN_ON_ERROR(mpr121_health_init(health, dev), TAG, "Init health failed");
+    mpr121_event_pipe_set_health(pipe, health);
+    ESP_RETURN_ON_ERROR(bench_health_run(sim, pipe, samples, UINT32_MAX, &events), TAG, "Run failed");
+
+    uint32_t irqs = pipe->irqs;
+    ESP_RETURN_ON_ERROR(bench_health_run(sim, pipe, samples, UINT32_MAX, &events), TAG, "Run failed");
+    *late_irqs = pipe->irqs - irqs;
+    *ele_en = sim->regs[MPR121_ELE_CFG] & 0x0F;
+    return ESP_OK;
+}
+
+esp_err_t mpr121_bench_health(uint32_t samples)
+{
+    static mpr121_sim_t sim;
+    static mpr121_dev_t dev;
+    static mpr121_event_pipe_t pipe;
+    static mpr121_health_t health;
+    uint32_t irqs[2] = {0}, events[2] = {0};
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        ESP_RETURN_ON_ERROR(mpr121_bench_sim_setup(&sim, &dev, &bench_search_bus_ops, MPR121_DEFAULT_ADDR, 700, 2),
+                            TAG, "Setup failed");
+        // 关闭ACE并固定全部通道的CDC，模拟产线调校后的电极
+        uint8_t auto_cfg0 = 0;
+        mpr121_cfg_get(&dev, MPR121_AUTO_CFG0, &auto_cfg0);
+        mpr121_cfg_set(&dev, MPR121_AUTO_CFG0, auto_cfg0 & ~0x01);
+        for (int ch = 0; ch < MPR121_NUM_CHANNELS; ch++)
+        {
+            mpr121_cfg_set(&dev, MPR121_CDC_0 + ch, BENCH_HEALTH_CDC);
+        }
+        ESP_RETURN_ON_ERROR(mpr121_cfg_commit(&dev), TAG, "Commit CDC failed");
+        mpr121_sim_set_oor(&sim, BENCH_HEALTH_OOR, BENCH_HEALTH_STUCK);
+
+        ESP_RETURN_ON_ERROR(mpr121_event_pipe_init(&pipe, &dev), TAG, "Init event pipe failed");
+        if (pass == 1)
+        {
+            ESP_RETURN_ON_ERROR(mpr121_health_init(&health, &dev), TAG, "Init health failed");
+            mpr121_event_pipe_set_health(&pipe, &health);
+        }
+        // 仅在挂接监测器时注入过流：未处理时芯片停在待机，后半段IRQ数不再可比
+        ESP_RETURN_ON_ERROR(bench_health_run(&sim, &pipe, samples, pass == 1 ? samples / 2 : UINT32_MAX, &events[pass]),
+                            TAG, "Run failed");
+        irqs[pass] = pipe.irqs;
+    }
+
+    mpr121_health_stats_t stats;
+    mpr121_health_get_stats(&health, &stats);
+    uint8_t ecr = 0;
+    mpr121_cfg_get(&dev, MPR121_ELE_CFG, &ecr);
+    ESP_LOGI(TAG, "health off     : %lu IRQs, %lu events in %lu samples (status read 2 bytes)",
+             (unsigned long)irqs[0], (unsigned long)events[0], (unsigned long)samples);
+    ESP_LOGI(TAG, "health on      : %lu IRQs, %lu events in %lu samples (status read 4 bytes), IRQ storm -%.1f%%",
+             (unsigned long)irqs[1], (unsigned long)events[1], (unsigned long)samples,
+             irqs[0] ? 100.0 * (irqs[0] - irqs[1]) / irqs[0] : 0.0);
+    ESP_LOGI(TAG, "health actions : %lu reconfigs (%lu search failed), quarantined 0x%03X, %lu OVCF "
+                  "(ELE_CFG 0x%02X restored 0x%02X), %lu ACFF reads",
+             (unsigned long)stats.reconfigs, (unsigned long)stats.reconfig_failures, stats.quarantined,
+             (unsigned long)stats.ovcf, ecr, sim.regs[MPR121_ELE_CFG], (unsigned long)stats.acff);
+    ESP_LOGI(TAG, "health CDC     : ELE0 0x%02X (kept), ELE5 0x%02X (re-searched), ELE9 0x%02X (stuck, restored), "
+                  "%lu auto-config runs",
+             sim.regs[MPR121_CDC_0], sim.regs[MPR121_CDC_0 + 5], sim.regs[MPR121_CDC_0 + 9],
+             (unsigned long)sim.autoconfig_runs);
+
+    // 搜索需若干采样周期才写出结果：ELE5采用新CDC说明重新配置等到了搜索结束；ELE9的ACFF使其恢复原值并计为失败
+    bool ok = stats.quarantined == BENCH_HEALTH_STUCK && stats.ovcf == 1 && stats.reconfig_failures == 1 &&
+              (sim.regs[MPR121_ELE_CFG] & 0x3F) == (ecr & 0x3F) && sim.regs[MPR121_CDC_0] == BENCH_HEALTH_CDC &&
+              sim.regs[MPR121_CDC_0 + 5] != BENCH_HEALTH_CDC && sim.regs[MPR121_CDC_0 + 9] == BENCH_HEALTH_CDC &&
+              bench_recover_cfg_matches(&sim, &dev);
+
+    uint8_t ele_en = 0;
+    uint32_t late_irqs = 0;
+    ESP_RETURN_ON_ERROR(bench_health_top(&sim, &dev, &pipe, &health, samples, &ele_en, &late_irqs), TAG,
+                        "Top electrode run failed");
+    mpr121_health_get_stats(&health, &stats);
+    ESP_LOGI(TAG, "health top ELE : quarantined 0x%03X, ELE_EN %u, %lu IRQs in %lu samples after quarantine",
+             stats.quarantined, ele_en, (unsigned long)late_irqs, (unsigned long)samples);
+    ok &= stats.quarantined == 1 << (MPR121_NUM_ELECTRODES - 1) && ele_en == MPR121_NUM_ELECTRODES - 1 &&
+          late_irqs == 0 && bench_recover_cfg_matches(&sim, &dev);
+    return ok ? ESP_OK : ESP_ERR_INVALID_RESPONSE;
+}
+
+// -------------------------- 录制与离线回放测试 --------------------------
+#define BENCH_RECORD_MAX_FRAMES 2000   // 录制帧数上限（决定静态缓冲区大小）
+#define BENCH_RECORD_BYTES_PER_FRAME 32 // 录制缓冲区按每帧平均字节数分配（模拟器基线每周期变化，高于实际芯片）
+#define BENCH_RECORD_PERIOD_US 1000    // 模拟的采样周期
+
+/**
+ * @brief 录制脚本（位置为录制长度的千分比）：真实触摸与持续1~2个采样的噪声尖峰
+ */
+static const struct
+{
+    uint16_t start, end; // 千分比
+    uint16_t mask;
+    uint16_t drop;
+    bool real;           // true=真实触摸（参考标注），false=噪声尖峰
+} s_bench_record_script[] = {
+    {50, 80, 1 << 1, 40, true},      {100, 101, 1 << 2, 22, false}, {150, 190, 1 << 3, 50, true},
+    {225, 226, 1 << 4, 22, false},   {300, 320, 1 << 1, 28, true},  {375, 376, 1 << 1, 24, false},
+    {450, 500, 1 << 6, 45, true},    {550, 551, 1 << 7, 22, false}, {650, 670, 1 << 3, 32, true},
+    {725, 726, 1 << 2, 26, false},   {800, 850, 1 << 6, 40, true},  {900, 901, 1 << 5, 24, false},
+};
+
+/**
+ * @brief 录制帧的FNV-1a摘要（不含可重新计算的delta），用于校验编码/解码无损
+ */
+static uint32_t bench_record_hash(uint32_t h, const mpr121_frame_t *frame)
+{
+    const uint8_t *parts[] = {(const uint8_t *)&frame->timestamp_us, (const uint8_t *)&frame->touch_status,
+                              (const uint8_t *)&frame->oor_status, (const uint8_t *)frame->filtered, frame->baseline};
+    const size_t sizes[] = {sizeof(frame->timestamp_us), sizeof(frame->touch_status), sizeof(frame->oor_status),
+                            sizeof(frame->filtered), sizeof(frame->baseline)};
+    for (size_t p = 0; p < sizeof(parts) / sizeof(parts[0]); p++)
+    {
+        for (size_t i = 0; i < sizes[p]; i++)
+        {
+            h = (h ^ parts[p][i]) * 16777619u;
+        }
+    }
+    return h;
+}
+
+/**
+ * @brief 控制台导出的行回调：直接解析回缓冲区，模拟主机端从串口日志恢复录制数据
+ */
+typedef struct
+{
+    uint8_t *buf;
+    size_t cap;
+    size_t len;
+    uint32_t lines;
+    esp_err_t err;
+} bench_record_capture_t;
+
+static void bench_record_sink(const char *line, void *arg)
+{
+    bench_record_capture_t *cap = (bench_record_capture_t *)arg;
+    esp_err_t err = mpr121_record_parse_line(line, cap->buf, cap->cap, &cap->len);
+    cap->lines++;
+    cap->err = err != ESP_OK ? err : cap->err;
+}
+
+esp_err_t mpr121_bench_record(uint32_t frames)
+{
+    static mpr121_sim_t sim;
+    static mpr121_dev_t dev;
+    static mpr121_record_t rec;
+    static uint8_t rec_buf[BENCH_RECORD_MAX_FRAMES * BENCH_RECORD_BYTES_PER_FRAME];
+    static uint8_t dump_buf[sizeof(rec_buf)];
+    static mpr121_replay_frame_t replay_frames[BENCH_RECORD_MAX_FRAMES];
+    static mpr121_replay_t replay;
+    const size_t script_len = sizeof(s_bench_record_script) / sizeof(s_bench_record_script[0]);
+
+    frames = frames < BENCH_RECORD_MAX_FRAMES ? frames : BENCH_RECORD_MAX_FRAMES;
+    ESP_RETURN_ON_ERROR(mpr121_bench_sim_setup(&sim, &dev, NULL, MPR121_DEFAULT_ADDR, 700, 3), TAG, "Setup failed");
+    for (size_t i = 0; i < script_len; i++)
+    {
+        const mpr121_sim_touch_t touch = {
+            .start_sample = frames * s_bench_record_script[i].start / 1000 + 1, // 第n帧在第n+1次采样后读取
+            .end_sample = frames * s_bench_record_script[i].end / 1000 + 1,
+            .mask = s_bench_record_script[i].mask,
+            .drop = s_bench_record_script[i].drop,
+        };
+        ESP_RETURN_ON_ERROR(mpr121_sim_add_touch(&sim, &touch), TAG, "Add touch failed");
+    }
+
+    // 1. 全速录制：每个采样周期一次整帧突发读取
+    ESP_RETURN_ON_ERROR(mpr121_record_init(&rec, rec_buf, sizeof(rec_buf), BENCH_RECORD_PERIOD_US),
+                        TAG, "Init recorder failed");
+    uint32_t hash = 2166136261u;
+    int64_t encode_us = 0;
+    mpr121_frame_t frame;
+    for (uint32_t n = 0; n < frames; n++)
+    {
+        mpr121_sim_step(&sim);
+        ESP_RETURN_ON_ERROR(mpr121_read_frame(&dev, &frame), TAG, "Read frame failed");
+        frame.timestamp_us = (int64_t)n * BENCH_RECORD_PERIOD_US; // 模拟器无真实采样节拍
+        hash = bench_record_hash(hash, &frame);
+        int64_t start = esp_timer_get_time();
+        ESP_RETURN_ON_ERROR(mpr121_record_add(&rec, &frame), TAG, "Recording buffer full");
+        encode_us += esp_timer_get_time() - start;
+    }
+
+    // 2. 控制台导出并从文本行恢复，解码后与录制前的帧逐一比对摘要
+    bench_record_capture_t capture = {.buf = dump_buf, .cap = sizeof(dump_buf)};
+    mpr121_record_dump(&rec, bench_record_sink, &capture);
+    if (capture.err != ESP_OK || capture.len != rec.len || memcmp(dump_buf, rec_buf, rec.len) != 0)
+    {
+        ESP_LOGE(TAG, "Console dump round trip failed: %s, %u/%u bytes", esp_err_to_name(capture.err),
+                 (unsigned)capture.len, (unsigned)rec.len);
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+    mpr121_record_reader_t reader;
+    ESP_RETURN_ON_ERROR(mpr121_record_reader_init(&reader, dump_buf, capture.len), TAG, "Invalid recording");
+    uint32_t decoded_hash = 2166136261u;
+    while (mpr121_record_next(&reader, &frame) == ESP_OK)
+    {
+        decoded_hash = bench_record_hash(decoded_hash, &frame);
+    }
+    if (reader.frames != frames || decoded_hash != hash || reader.period_us != BENCH_RECORD_PERIOD_US)
+    {
+        ESP_LOGE(TAG, "Decoded %lu/%lu frames, hash 0x%08lx vs 0x%08lx, period %lu us", (unsigned long)reader.frames,
+                 (unsigned long)frames, (unsigned long)decoded_hash, (unsigned long)hash,
+                 (unsigned long)reader.period_us);
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+    ESP_LOGI(TAG, "record         : %lu frames, %u bytes (%.1f B/frame vs %u B register burst, %u B frame struct), "
+                  "encode %.2f us/frame, %lu dump lines",
+             (unsigned long)frames, (unsigned)rec.len, (double)(rec.len - MPR121_RECORD_HEADER_LEN) / frames,
+             (unsigned)(MPR121_BASELINE_PROX + 1), (unsigned)sizeof(mpr121_frame_t), (double)encode_us / frames,
+             (unsigned long)capture.lines);
+
+    // 3. 离线回放：参考状态取脚本中的真实触摸，比较录制时参数与扫描得到的最优参数
+    ESP_RETURN_ON_ERROR(mpr121_replay_init(&replay, replay_frames, BENCH_RECORD_MAX_FRAMES), TAG, "Init replay failed");
+    ESP_RETURN_ON_ERROR(mpr121_replay_load(&replay, dump_buf, capture.len), TAG, "Load recording failed");
+    mpr121_replay_label(&replay, 0, replay.count, MPR121_STATUS_CH_MASK, false);
+    for (size_t i = 0; i < script_len; i++)
+    {
+        if (s_bench_record_script[i].real)
+        {
+            mpr121_replay_label(&replay, frames * s_bench_record_script[i].start / 1000,
+                                frames * s_bench_record_script[i].end / 1000, s_bench_record_script[i].mask, true);
+        }
+    }
+
+    uint8_t touch_th = 0, release_th = 0, debounce = 0;
+    mpr121_cfg_get(&dev, MPR121_TOUCH_THRESH_0, &touch_th);
+    mpr121_cfg_get(&dev, MPR121_RELEASE_THRESH_0, &release_th);
+    mpr121_cfg_get(&dev, MPR121_DEBOUNCE, &debounce);
+    const mpr121_replay_params_t current = {
+        .touch_th = touch_th,
+        .release_th = release_th,
+        .dt = debounce & 0x07,
+        .dr = (debounce >> 4) & 0x07,
+    };
+    mpr121_replay_result_t base, best;
+    mpr121_replay_run(&replay, 0x0FFF, &current, &base);
+
+    const mpr121_replay_grid_t grid = {
+        .touch_min = 4,
+        .touch_max = 48,
+        .touch_step = 1,
+        .release_min = 2,
+        .release_step = 2,
+        .dt_max = 3,
+        .dr_max = 3,
+        .channels = 0x0FFF,
+    };
+    int64_t start = esp_timer_get_time();
+    uint32_t evaluated = mpr121_replay_sweep(&replay, &grid, &best);
+    int64_t sweep_us = esp_timer_get_time() - start;
+
+    const mpr121_replay_result_t *rows[] = {&base, &best};
+    const char *names[] = {"recorded", "best"};
+    for (int i = 0; i < 2; i++)
+    {
+        const mpr121_replay_result_t *r = rows[i];
+        ESP_LOGI(TAG, "replay %-8s: TH %2u/%2u DT %u DR %u -> %lu/%lu hits, %lu misses, %lu false, "
+                      "latency avg %lu us max %lu us",
+                 names[i], r->params.touch_th, r->params.release_th, r->params.dt, r->params.dr,
+                 (unsigned long)r->hits, (unsigned long)r->touches, (unsigned long)r->misses,
+                 (unsigned long)r->false_triggers, (unsigned long)r->latency_avg_us, (unsigned long)r->latency_max_us);
+    }
+    ESP_LOGI(TAG, "replay sweep   : %lu combinations x %u frames in %lld us (%.0f combinations/s)",
+             (unsigned long)evaluated, (unsigned)replay.count, (long long)sweep_us,
+             sweep_us ? evaluated * 1e6 / sweep_us : 0.0);
+    return best.cost <= base.cost ? ESP_OK : ESP_ERR_INVALID_RESPONSE;
+}
+
+// -------------------------- 共享总线调度测试 --------------------------
+#define BENCH_SCHED_BUS_HZ 400000     // 模拟的总线速率
+#define BENCH_SCHED_EEPROM_BYTES 256  // EEPROM每次写入的字节数
+#define BENCH_SCHED_IMU_BYTES 14      // IMU每次读取的字节数（加速度+温度+陀螺仪）
+
+/**
+ * @brief 模拟总线上的一个设备：MPR121转发到模拟器，其他设备只占用总线时间
+ */
+typedef struct
+{
+    mpr121_sim_t *sim; // NULL=无寄存器模型（IMU/EEPROM）
+} bench_sched_dev_t;
+
+/**
+ * @brief 按总线速率占用总线（I2C硬件传输期间CPU空闲，因此让出CPU而非空转）
+ * @param bytes 传输字节数（含设备地址与寄存器地址）
+ */
+static void bench_sched_hold(size_t bytes)
+{
+    int64_t end = esp_timer_get_time() + (int64_t)(bytes * 9 + 2) * 1000000 / BENCH_SCHED_BUS_HZ;
+    while (esp_timer_get_time() < end)
+    {
+        taskYIELD();
+    }
+}
+
+static esp_err_t bench_sched_io_write(void *ctx, const uint8_t *addr, size_t addr_len, const uint8_t *data, size_t len)
+{
+    bench_sched_dev_t *dev = (bench_sched_dev_t *)ctx;
+    bench_sched_hold(1 + addr_len + len);
+    return dev->sim ? mpr121_sim_bus_ops.write(dev->sim, addr[addr_len - 1], data, len) : ESP_OK;
+}
+
+static esp_err_t bench_sched_io_read(void *ctx, const uint8_t *addr, size_t addr_len, uint8_t *data, size_t len)
+{
+    bench_sched_dev_t *dev = (bench_sched_dev_t *)ctx;
+    bench_sched_hold(2 + addr_len + len);
+    if (dev->sim == NULL)
+    {
+        memset(data, 0, len);
+        return ESP_OK;
+    }
+    return mpr121_sim_bus_ops.read(dev->sim, addr[addr_len - 1], data, len);
+}
+
+static const mpr121_sched_io_t s_bench_sched_io = {
+    .write = bench_sched_io_write,
+    .read = bench_sched_io_read,
+};
+
+/**
+ * @brief 测试任务上下文
+ */
+typedef struct
+{
+    mpr121_sched_client_t *client;
+    mpr121_sched_class_t cls;  // 本轮使用的类别
+    uint32_t period_ms;        // 请求周期（0=连续）
+    size_t len;                // 每次传输字节数
+    bool write;                // true=写入
+    volatile bool *stop;       // 停止标志
+    atomic_int *running;       // 运行中的任务数
+} bench_sched_task_t;
+
+static void bench_sched_task(void *arg)
+{
+    bench_sched_task_t *t = (bench_sched_task_t *)arg;
+    uint8_t buf[BENCH_SCHED_EEPROM_BYTES] = {0};
+    uint32_t addr = 0;
+
+    while (!*t->stop)
+    {
+        if (t->period_ms)
+        {
+            vTaskDelay(pdMS_TO_TICKS(t->period_ms));
+        }
+        mpr121_sched_transfer(t->client, t->cls, !t->write, addr, buf, t->len);
+        addr = t->write ? (addr + t->len) % 0x8000 : addr;
+        if (!t->period_ms)
+        {
+            taskYIELD();
+        }
+    }
+    atomic_fetch_sub(t->running, 1);
+    vTaskDelete(NULL);
+}
+
+esp_err_t mpr121_bench_sched(uint32_t duration_ms)
+{
+    static mpr121_sim_t sim;
+    static mpr121_dev_t dev;
+    static mpr121_sched_t sched;
+    static mpr121_sched_client_t clients[3];
+    static bench_sched_dev_t bus_devs[3];
+    static bench_sched_task_t tasks[3];
+    static const char *mode_names[] = {"single FIFO", "scheduled"};
+
+    mpr121_sim_init(&sim, 700, 2);
+    bus_devs[0].sim = &sim;
+    for (int mode = 0; mode < 2; mode++)
+    {
+        // 对比基准：全部请求同一类别、大块不拆分，等同于i2c_master总线锁的先到先得
+        bool scheduled = mode == 1;
+        const mpr121_sched_client_config_t cfgs[3] = {
+            {.name = "mpr121", .cls = MPR121_SCHED_NORMAL, .addr_len = 1},
+            {.name = "imu", .cls = MPR121_SCHED_NORMAL, .addr_len = 1},
+            {.name = "eeprom", .cls = scheduled ? MPR121_SCHED_BULK : MPR121_SCHED_NORMAL, .addr_len = 2},
+        };
+        ESP_RETURN_ON_ERROR(mpr121_sched_init(&sched, scheduled ? MPR121_SCHED_CHUNK_BYTES : 0), TAG, "Init scheduler failed");
+        for (int i = 0; i < 3; i++)
+        {
+            ESP_RETURN_ON_ERROR(mpr121_sched_add_client(&sched, &cfgs[i], &s_bench_sched_io, &bus_devs[i], &clients[i]),
+                                TAG, "Add client failed");
+        }
+        ESP_RETURN_ON_ERROR(mpr121_sched_attach_dev(&dev, &clients[0], MPR121_DEFAULT_ADDR), TAG, "Attach failed");
+        ESP_RETURN_ON_ERROR(mpr121_init(&dev), TAG, "Init through scheduler failed");
+        memset(&clients[0].stats, 0, sizeof(clients[0].stats)); // 只统计运行期间的触摸读取
+        clients[0].wait_sum_us = 0;
+
+        volatile bool stop = false;
+        atomic_int running = 3;
+        tasks[0] = (bench_sched_task_t){&clients[0], scheduled ? MPR121_SCHED_URGENT : MPR121_SCHED_NORMAL, 1, 2, false, &stop, &running};
+        tasks[1] = (bench_sched_task_t){&clients[1], cfgs[1].cls, 2, BENCH_SCHED_IMU_BYTES, false, &stop, &running};
+        tasks[2] = (bench_sched_task_t){&clients[2], cfgs[2].cls, 0, BENCH_SCHED_EEPROM_BYTES, true, &stop, &running};
+        for (int i = 0; i < 3; i++)
+        {
+            if (xTaskCreate(bench_sched_task, cfgs[i].name, 4096, &tasks[i], 5 - i, NULL) != pdPASS)
+            {
+                ESP_LOGE(TAG, "Create %s task failed", cfgs[i].name);
+                return ESP_ERR_NO_MEM;
+            }
+        }
+        vTaskDelay(pdMS_TO_TICKS(duration_ms));
+        stop = true;
+        while (atomic_load(&running) > 0)
+        {
+            vTaskDelay(1);
+        }
+
+        for (int i = 0; i < 3; i++)
+        {
+            mpr121_sched_client_stats_t st;
+            mpr121_sched_get_stats(&clients[i], &st);
+            ESP_LOGI(TAG, "sched %-11s %-6s: %5lu xfers %5lu holds, wait avg %5lu us max %5lu us, hold max %5lu us, "
+                          "%6lu B/s",
+                     mode_names[mode], cfgs[i].name, (unsigned long)st.transfers, (unsigned long)st.chunks,
+                     (unsigned long)st.wait_avg_us, (unsigned long)st.wait_max_us, (unsigned long)st.hold_max_us,
+                     (unsigned long)((uint64_t)st.bytes * 1000 / duration_ms));
+            vSemaphoreDelete(clients[i].grant);
+        }
+        sched.head[MPR121_SCHED_BULK] = &clients[2]; // 模拟仍在排队的客户端
+        if (mpr121_sched_deinit(&sched) != ESP_ERR_INVALID_STATE)
+        {
+            ESP_LOGE(TAG, "sched deinit accepted a queued client");
+            return ESP_FAIL;
+        }
+        sched.head[MPR121_SCHED_BULK] = NULL;
+        ESP_RETURN_ON_ERROR(mpr121_sched_deinit(&sched), TAG, "Scheduler deinit failed");
+    }
+    return ESP_OK;
+}
+
+// -------------------------- 逐电极阈值自动调校测试 --------------------------
+#define BENCH_TUNE_NOISY ((1 << 3) | (1 << 8)) // 大面积电极：噪声峰值10，默认阈值下频繁误触发
+#define BENCH_TUNE_QUIET (1 << 0)              // 小面积电极：噪声峰值1
+
+/**
+ * @brief 每个阶段的真实触摸（位置为阶段长度的千分比），调校器应丢弃这些窗口，调校后仍须检测到
+ */
+static const struct
+{
+    uint16_t start, end; // 千分比
+    uint8_t electrode;
+    uint16_t drop;
+} s_bench_tune_touches[] = {
+    {200, 250, 1, 40},
+    {500, 550, 3, 70},
+    {750, 800, 6, 40},
+};
+
+esp_err_t mpr121_bench_tune(uint32_t samples)
+{
+    static mpr121_sim_t sim;
+    static mpr121_dev_t dev;
+    static mpr121_tune_t tune;
+    const size_t touch_count = sizeof(s_bench_tune_touches) / sizeof(s_bench_tune_touches[0]);
+    uint32_t irqs[2] = {0};
+    uint16_t detected = 0; // 调校后检测到的真实触摸
+    mpr121_frame_t frame;
+
+    ESP_RETURN_ON_ERROR(mpr121_bench_sim_setup(&sim, &dev, NULL, MPR121_DEFAULT_ADDR, 700, 2), TAG, "Setup failed");
+    mpr121_sim_set_noise(&sim, BENCH_TUNE_NOISY, 10);
+    mpr121_sim_set_noise(&sim, BENCH_TUNE_QUIET, 1);
+    for (int phase = 0; phase < 2; phase++)
+    {
+        for (size_t i = 0; i < touch_count; i++)
+        {
+            const mpr121_sim_touch_t touch = {
+                .start_sample = phase * samples + samples * s_bench_tune_touches[i].start / 1000,
+                .end_sample = phase * samples + samples * s_bench_tune_touches[i].end / 1000,
+                .mask = 1 << s_bench_tune_touches[i].electrode,
+                .drop = s_bench_tune_touches[i].drop,
+            };
+            ESP_RETURN_ON_ERROR(mpr121_sim_add_touch(&sim, &touch), TAG, "Add touch failed");
+        }
+    }
+    ESP_RETURN_ON_ERROR(mpr121_tune_init(&tune, NULL), TAG, "Init tuner failed");
+
+    // 阶段0以默认统一阈值运行并统计噪声，阶段1以调校后的逐电极阈值运行（两阶段触摸脚本相同）
+    mpr121_tune_result_t result;
+    for (int phase = 0; phase < 2; phase++)
+    {
+        for (uint32_t n = 0; n < samples; n++)
+        {
+            mpr121_sim_step(&sim);
+            irqs[phase] += sim.irq;
+            ESP_RETURN_ON_ERROR(mpr121_read_frame(&dev, &frame), TAG, "Read frame failed");
+            mpr121_tune_add(&tune, &frame);
+            for (size_t i = 0; phase == 1 && i < touch_count; i++)
+            {
+                uint32_t pos = n * 1000 / samples;
+                if (pos >= s_bench_tune_touches[i].start && pos < s_bench_tune_touches[i].end &&
+                    (frame.touch_status & (1 << s_bench_tune_touches[i].electrode)))
+                {
+                    detected |= 1 << i;
+                }
+            }
+        }
+        if (phase == 0)
+        {
+            ESP_RETURN_ON_ERROR(mpr121_tune_compute(&tune, &result), TAG, "Not enough idle frames");
+            ESP_RETURN_ON_ERROR(mpr121_tune_apply(&tune, &dev, &result), TAG, "Apply thresholds failed");
+        }
+    }
+
+    mpr121_tune_report_t report;
+    mpr121_tune_get_report(&tune, &report);
+    static const uint8_t shown[] = {0, 1, 3, 8};
+    for (size_t i = 0; i < sizeof(shown); i++)
+    {
+        uint8_t ch = shown[i];
+        ESP_LOGI(TAG, "tune ELE%-2d     : noise rms %2u.%u, idle peak %3d, %5lu idle frames -> touch %3u release %3u",
+                 ch, result.noise_x10[ch] / 10, result.noise_x10[ch] % 10, result.peak[ch],
+                 (unsigned long)result.samples[ch], result.touch[ch], result.release[ch]);
+    }
+    ESP_LOGI(TAG, "tune spurious  : %lu in %lu idle frames (uniform 15/10) -> %lu in %lu (per electrode), -%ld.%ld%%",
+             (unsigned long)report.spurious_before, (unsigned long)report.idle_frames_before,
+             (unsigned long)report.spurious_after, (unsigned long)report.idle_frames_after,
+             (long)(report.reduction_permille / 10), (long)(report.reduction_permille % 10));
+    ESP_LOGI(TAG, "tune IRQs      : %lu -> %lu per %lu samples, %d/%d real touches detected, %lu windows rejected",
+             (unsigned long)irqs[0], (unsigned long)irqs[1], (unsigned long)samples, __builtin_popcount(detected),
+             (int)touch_count, (unsigned long)report.rejected_windows);
+
+    bool ok = detected == (1 << touch_count) - 1 && irqs[1] < irqs[0] && report.reduction_permille > 900 &&
+              sim.regs[MPR121_TOUCH_THRESH_0 + 3 * 2] == result.touch[3] &&
+              sim.regs[MPR121_RELEASE_THRESH_0 + 8 * 2] == result.release[8] &&
+              result.touch[0] < MPR121_DEFAULT_TOUCH_THRESH;
+    return ok ? ESP_OK : ESP_ERR_INVALID_RESPONSE;
+}
+
+// -------------------------- 多订阅者发布测试 --------------------------
+#define BENCH_PUBSUB_SLOW_EVERY 8 // 慢订阅者每隔该数量的采集才读取一次
+
+/**
+ * @brief 读取订阅者的全部待读消息并释放，校验消息位于共享槽中（无拷贝）
+ * @return bool true: 全部消息都在共享槽中
+ */
+static bool bench_pubsub_drain(mpr121_pubsub_t *ps, mpr121_pubsub_sub_t *sub, uint32_t counts[3])
+{
+    const mpr121_pubsub_msg_t *msg;
+    bool shared = true;
+    while ((msg = mpr121_pubsub_receive(sub, 0)) != NULL)
+    {
+        const char *p = (const char *)msg;
+        shared &= p >= (const char *)ps->slots && p < (const char *)&ps->slots[MPR121_PUBSUB_POOL_SIZE];
+        counts[msg->kind == MPR121_PUBSUB_FRAME ? 0 : (msg->kind == MPR121_PUBSUB_PRESS ? 1 : 2)]++;
+        mpr121_pubsub_release(sub, msg);
+    }
+    return shared;
+}
+
+esp_err_t mpr121_bench_pubsub(uint32_t steps)
+{
+    static mpr121_sim_t sim;
+    static mpr121_dev_t dev;
+    static mpr121_pubsub_t ps;
+    static mpr121_pubsub_sub_t subs[4];
+    static const char *const names[] = {"ui", "haptics", "telemetry", "logger"};
+    static const mpr121_pubsub_filter_t filters[] = {
+        {.kinds = MPR121_PUBSUB_PRESS | MPR121_PUBSUB_RELEASE, .electrodes = 0x003F}, // ELE0~ELE5的按键界面
+        {.kinds = MPR121_PUBSUB_PRESS, .electrodes = 0x0FFF},                         // 任意电极按下时振动
+        {.kinds = MPR121_PUBSUB_FRAME},                                               // 每帧上报
+        {.kinds = MPR121_PUBSUB_FRAME | MPR121_PUBSUB_PRESS | MPR121_PUBSUB_RELEASE, .electrodes = 0x1FFF}, // 慢速记录
+    };
+    // 前半程只有1个订阅者，后半程4个；每半程各有触摸
+    const mpr121_sim_touch_t touches[] = {
+        {.start_sample = steps / 10, .end_sample = steps * 3 / 10, .mask = 1 << 1, .drop = 40},
+        {.start_sample = steps * 6 / 10, .end_sample = steps * 7 / 10, .mask = 1 << 7, .drop = 40},
+        {.start_sample = steps * 8 / 10, .end_sample = steps * 9 / 10, .mask = 1 << 2, .drop = 40},
+    };
+    uint32_t counts[4][3] = {0}; // 各订阅者收到的帧/按下/释放
+    uint64_t bus_bits[2] = {0};
+    int64_t publish_us = 0;
+    bool shared = true;
+
+    ESP_RETURN_ON_ERROR(mpr121_bench_sim_setup(&sim, &dev, NULL, MPR121_DEFAULT_ADDR, 700, 2), TAG, "Setup failed");
+    for (size_t i = 0; i < sizeof(touches) / sizeof(touches[0]); i++)
+    {
+        ESP_RETURN_ON_ERROR(mpr121_sim_add_touch(&sim, &touches[i]), TAG, "Add touch failed");
+    }
+    ESP_RETURN_ON_ERROR(mpr121_pubsub_init(&ps), TAG, "Init pubsub failed");
+    ESP_RETURN_ON_ERROR(mpr121_pubsub_subscribe(&ps, &subs[0], names[0], &filters[0]), TAG, "Subscribe failed");
+
+    for (uint32_t n = 0; n < steps; n++)
+    {
+        int half = n >= steps / 2;
+        if (n == steps / 2)
+        {
+            for (int i = 1; i < 4; i++)
+            {
+                ESP_RETURN_ON_ERROR(mpr121_pubsub_subscribe(&ps, &subs[i], names[i], &filters[i]), TAG,
+                                    "Subscribe failed");
+            }
+        }
+        mpr121_sim_step(&sim);
+        uint64_t bits = sim.bus_bits;
+        mpr121_frame_t frame;
+        ESP_RETURN_ON_ERROR(mpr121_read_frame(&dev, &frame), TAG, "Read frame failed");
+        bus_bits[half] += sim.bus_bits - bits;
+        int64_t start = esp_timer_get_time();
+        mpr121_pubsub_process(&ps, &frame);
+        publish_us += esp_timer_get_time() - start;
+
+        for (int i = 0; i < (half ? 4 : 1); i++)
+        {
+            if (i == 3 && (n + 1) % BENCH_PUBSUB_SLOW_EVERY != 0)
+            {
+                continue;
+            }
+            shared &= bench_pubsub_drain(&ps, &subs[i], counts[i]);
+        }
+    }
+
+    mpr121_pubsub_stats_t stats;
+    mpr121_pubsub_get_stats(&ps, &stats);
+    uint32_t half_steps = steps / 2;
+    ESP_LOGI(TAG, "pubsub bus     : %.1f bits/step with 1 subscriber, %.1f with 4 (separate reads: %.1f)",
+             (double)bus_bits[0] / half_steps, (double)bus_bits[1] / (steps - half_steps),
+             4.0 * bus_bits[1] / (steps - half_steps));
+    ESP_LOGI(TAG, "pubsub publish : %lu frames, %lu events, %lu deliveries, %lu unmatched, %lu pool full, %.2f us/step",
+             (unsigned long)stats.frames, (unsigned long)stats.events, (unsigned long)stats.deliveries,
+             (unsigned long)stats.unmatched, (unsigned long)stats.pool_full, (double)publish_us / steps);
+    for (int i = 0; i < 4; i++)
+    {
+        mpr121_pubsub_sub_stats_t sub_stats;
+        mpr121_pubsub_get_sub_stats(&subs[i], &sub_stats);
+        ESP_LOGI(TAG, "pubsub %-9s: %4lu frames %lu press %lu release, dropped %lu, lag %lu msgs peak, %lu us avg",
+                 names[i], (unsigned long)counts[i][0], (unsigned long)counts[i][1], (unsigned long)counts[i][2],
+                 (unsigned long)sub_stats.dropped, (unsigned long)sub_stats.pending_peak,
+                 (unsigned long)sub_stats.lag_avg_us);
+    }
+
+    // 全部消息读完后共享槽应全部回收
+    bool freed = true;
+    for (int i = 0; i < MPR121_PUBSUB_POOL_SIZE; i++)
+    {
+        freed &= atomic_load(&ps.slots[i].refs) == 0;
+    }
+    // ui：ELE1与ELE2各一次按下/释放（ELE7不在过滤范围）；haptics：后半程ELE7与ELE2按下；logger：后半程全部帧与事件
+    bool ok = shared && freed && bus_bits[0] / half_steps == bus_bits[1] / (steps - half_steps) &&
+              counts[0][1] == 2 && counts[0][2] == 2 && counts[1][1] == 2 && counts[1][2] == 0 &&
+              counts[2][0] == steps - half_steps && counts[3][0] == steps - half_steps &&
+              counts[3][1] == 2 && counts[3][2] == 2 && stats.pool_full == 0;
+    return ok ? ESP_OK : ESP_ERR_INVALID_RESPONSE;
+}
+
+// -------------------------- 自动配置启动测试 --------------------------
+/**
+ * @brief 模拟器读取：每次从触摸状态寄存器开始的读取（即一次取帧/清IRQ）前推进一个采样周期，
+ *        使启动过程中的轮询看到基线逐步收敛；自动配置搜索进行中时每次读取都推进（见bench_search_bus_read）
+ */
+static esp_err_t bench_calib_bus_read(void *ctx, uint8_t reg, uint8_t *data, size_t len)
+{
+    if (reg == MPR121_TOUCHSTATUS_L || ((mpr121_sim_t *)ctx)->autoconfig_pending)
+    {
+        mpr121_sim_step((mpr121_sim_t *)ctx);
+    }
+    return mpr121_sim_bus_ops.read(ctx, reg, data, len);
+}
+
+static const mpr121_bus_ops_t bench_calib_bus_ops = {
+    .write = bench_sim_bus_write,
+    .read = bench_calib_bus_read,
+};
+
+/**
+ * @brief 在模拟器上执行一次冷启动（不保存校准数据），要求自动配置完成且基线稳定
+ */
+static esp_err_t bench_calib_cold_boot(mpr121_sim_t *sim, mpr121_dev_t *dev)
+{
+    const mpr121_calib_config_t cfg = {
+        .vdd_mv = 3300,
+        .storage = NULL,
+    };
+    mpr121_calib_boot_info_t info;
+
+    mpr121_sim_init(sim, 700, 2);
+    ESP_RETURN_ON_ERROR(mpr121_attach_bus(dev, &bench_calib_bus_ops, sim, MPR121_DEFAULT_ADDR), TAG, "Attach failed");
+    ESP_RETURN_ON_ERROR(mpr121_calib_boot(dev, &cfg, &info), TAG, "Cold boot failed");
+    if (info.warm || !info.settled || sim->autoconfig_runs != 1)
+    {
+        ESP_LOGE(TAG, "Cold boot: warm %d, settled %d, %lu auto-config runs", info.warm, info.settled,
+                 (unsigned long)sim->autoconfig_runs);
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief 读取前count个通道的基线，返回与before相比的最大变化
+ */
+static esp_err_t bench_baseline_drift(mpr121_dev_t *dev, const uint8_t *before, uint8_t count, int *drift)
+{
+    uint8_t after[MPR121_NUM_CHANNELS];
+    ESP_RETURN_ON_ERROR(mpr121_read_regs(dev, MPR121_BASELINE_0, after, count), TAG, "Read baseline failed");
+    *drift = 0;
+    for (int ch = 0; ch < count; ch++)
+    {
+        int d = after[ch] > before[ch] ? after[ch] - before[ch] : before[ch] - after[ch];
+        *drift = d > *drift ? d : *drift;
+    }
+    return ESP_OK;
+}
+
+esp_err_t mpr121_bench_calib(void)
+{
+    static mpr121_sim_t sim;
+    static mpr121_dev_t dev;
+    uint8_t before[MPR121_NUM_CHANNELS];
+    uint8_t touch = 0;
+    int drift = 0;
+
+    ESP_RETURN_ON_ERROR(bench_calib_cold_boot(&sim, &dev), TAG, "Cold boot failed");
+
+    // 修改一个仅待机可写、与自动配置无关的寄存器：提交时经过一次待机→运行切换
+    ESP_RETURN_ON_ERROR(mpr121_read_regs(&dev, MPR121_BASELINE_0, before, sizeof(before)), TAG, "Read baseline failed");
+    mpr121_cfg_get(&dev, MPR121_TOUCH_THRESH_0, &touch);
+    mpr121_cfg_set(&dev, MPR121_TOUCH_THRESH_0, touch + 1);
+    ESP_RETURN_ON_ERROR(mpr121_cfg_commit(&dev), TAG, "Commit failed");
+    ESP_RETURN_ON_ERROR(bench_baseline_drift(&dev, before, MPR121_NUM_CHANNELS, &drift), TAG, "Read baseline failed");
+
+    ESP_LOGI(TAG, "calib cold boot: AUTO_CFG0 0x%02X, auto-config runs %lu after unrelated commit, "
+                  "max baseline change %d",
+             sim.regs[MPR121_AUTO_CFG0], (unsigned long)sim.autoconfig_runs, drift);
+    return sim.autoconfig_runs == 1 && drift == 0 ? ESP_OK : ESP_ERR_INVALID_RESPONSE;
+}
+
+// -------------------------- 低功耗切换测试 --------------------------
+/**
+ * @brief 在当前状态下运行samples个采样周期（每次读取触摸状态推进一次模拟器）
+ */
+static esp_err_t bench_power_run(mpr121_dev_t *dev, uint32_t samples)
+{
+    uint16_t touch = 0;
+    for (uint32_t n = 0; n < samples; n++)
+    {
+        ESP_RETURN_ON_ERROR(mpr121_read_touch(dev, &touch), TAG, "Read touch failed");
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief 校验模拟器中的ELE_CFG：CL=00（不重载基线）、接近电极已使能、电极数符合当前状态
+ */
+static bool bench_power_ecr_ok(const mpr121_sim_t *sim, const mpr121_power_config_t *cfg, uint8_t ele_en)
+{
+    uint8_t ecr = sim->regs[MPR121_ELE_CFG];
+    if ((ecr & 0xC0) != 0 || ((ecr >> 4) & 0x03) != cfg->prox_en || (ecr & 0x0F) != ele_en)
+    {
+        ESP_LOGE(TAG, "ELE_CFG 0x%02X, expected CL=00, prox %u, %u electrodes", ecr, cfg->prox_en, ele_en);
+        return false;
+    }
+    return true;
+}
+
+esp_err_t mpr121_bench_power(uint32_t cycles)
+{
+    static mpr121_sim_t sim;
+    static mpr121_dev_t dev;
+    static mpr121_power_t pm;
+    const mpr121_power_config_t cfg = {
+        .idle_esi = 5,
+        .active_esi = 2,
+        .prox_en = 3,
+        .prox_touch = 4,
+        .prox_release = 2,
+        .idle_timeout_ms = 100,
+    };
+    uint8_t before[MPR121_NUM_ELECTRODES];
+    int drift = 0;
+    int drift_max = 0;
+    bool ok = true;
+
+    ESP_RETURN_ON_ERROR(bench_calib_cold_boot(&sim, &dev), TAG, "Cold boot failed");
+    ESP_RETURN_ON_ERROR(bench_power_run(&dev, 16), TAG, "Settle failed");
+    ESP_RETURN_ON_ERROR(mpr121_read_regs(&dev, MPR121_BASELINE_0, before, sizeof(before)), TAG, "Read baseline failed");
+
+    // 冷启动→空闲：电极停止采样，基线冻结
+    ESP_RETURN_ON_ERROR(mpr121_power_init(&pm, &dev, &cfg), TAG, "Init power failed");
+    ok &= bench_power_ecr_ok(&sim, &cfg, 0);
+    for (uint32_t n = 0; n < cycles; n++)
+    {
+        ESP_RETURN_ON_ERROR(bench_power_run(&dev, 32), TAG, "Idle failed");
+
+        // 接近触发唤醒：重新进入运行模式时保留空闲前的基线，不执行自动配置
+        const mpr121_touch_event_t wake = {
+            .timestamp_us = esp_timer_get_time(),
+            .electrode = MPR121_POWER_PROX_CHANNEL,
+            .type = MPR121_EVENT_PRESS,
+        };
+        ESP_RETURN_ON_ERROR(mpr121_power_on_event(&pm, &wake), TAG, "Wake failed");
+        ok &= pm.state == MPR121_POWER_ACTIVE && bench_power_ecr_ok(&sim, &cfg, MPR121_NUM_ELECTRODES);
+        ESP_RETURN_ON_ERROR(bench_baseline_drift(&dev, before, sizeof(before), &drift), TAG, "Read baseline failed");
+        drift_max = drift > drift_max ? drift : drift_max;
+
+        // 接近释放、超时后回到空闲（唤醒后不运行采样周期，基线保持与比较值一致）
+        const mpr121_touch_event_t release = {
+            .timestamp_us = esp_timer_get_time(),
+            .electrode = MPR121_POWER_PROX_CHANNEL,
+            .type = MPR121_EVENT_RELEASE,
+        };
+        ESP_RETURN_ON_ERROR(mpr121_power_on_event(&pm, &release), TAG, "Release failed");
+        ESP_RETURN_ON_ERROR(mpr121_power_tick(&pm, release.timestamp_us + cfg.idle_timeout_ms * 1000LL), TAG,
+                            "Sleep failed");
+        ok &= pm.state == MPR121_POWER_IDLE && bench_power_ecr_ok(&sim, &cfg, 0);
+    }
+
+    mpr121_power_stats_t stats;
+    mpr121_power_get_stats(&pm, &stats);
+    ESP_LOGI(TAG, "power cycles  : %lu wakes, %lu sleeps, auto-config runs %lu, max baseline change %d",
+             (unsigned long)stats.wakes, (unsigned long)stats.sleeps, (unsigned long)sim.autoconfig_runs, drift_max);
+    ok &= stats.wakes == cycles && stats.sleeps == cycles && sim.autoconfig_runs == 1 && drift_max == 0;
+    return ok ? ESP_OK : ESP_ERR_INVALID_RESPONSE;
+}
+
+// -------------------------- 手势识别测试 --------------------------
+#define BENCH_GESTURE_TICK_US 10000   // tick周期（与10ms主循环一致）
+#define BENCH_GESTURE_MAX_STEPS 2048  // 时间线最多的掩码变化数
+#define BENCH_GESTURE_MAX_OUT 512     // 最多记录的手势数
+#define BENCH_GESTURE_SPACING_MS 400  // 随机会话中相邻手势的间隔（大于双击窗口与滑动步进）
+#define BENCH_GESTURE_E(n) (1 << (n))
+
+/**
+ * @brief 时间线中的一步：t_ms时刻触摸掩码变为mask
+ */
+typedef struct
+{
+    uint32_t t_ms;
+    uint16_t mask;
+} bench_gesture_step_t;
+
+/**
+ * @brief 期望识别出的手势
+ */
+typedef struct
+{
+    uint8_t type;
+    uint8_t electrode;
+} bench_gesture_expect_t;
+
+/**
+ * @brief 回调收到的手势
+ */
+typedef struct
+{
+    mpr121_gesture_t out[BENCH_GESTURE_MAX_OUT];
+    uint32_t count;
+} bench_gesture_log_t;
+
+// 单击≤200ms，双击间隔≤250ms，长按600ms，滑动轨迹ELE0~ELE7、相邻≤150ms、至少3个电极
+static const mpr121_gesture_config_t bench_gesture_cfg = {
+    .tap_max_us = 200000,
+    .double_tap_gap_us = 250000,
+    .long_press_us = 600000,
+    .swipe_step_us = 150000,
+    .swipe_min_electrodes = 3,
+    .swipe_order = {0, 1, 2, 3, 4, 5, 6, 7},
+    .swipe_count = 8,
+};
+
+static void bench_gesture_cb(const mpr121_gesture_t *gesture, void *arg)
+{
+    bench_gesture_log_t *log = (bench_gesture_log_t *)arg;
+    if (log->count < BENCH_GESTURE_MAX_OUT)
+    {
+        log->out[log->count++] = *gesture;
+    }
+}
+
+/**
+ * @brief 按时间线输入掩码，其间按tick_us周期调用tick（0=只输入边沿），结束后再运行1s
+ */
+static esp_err_t bench_gesture_run(const bench_gesture_step_t *steps, uint32_t count, uint32_t tick_us,
+                                   bench_gesture_log_t *log)
+{
+    static mpr121_gesture_recognizer_t rec;
+    mpr121_gesture_config_t cfg = bench_gesture_cfg;
+    cfg.callback = bench_gesture_cb;
+    cfg.user_arg = log;
+    log->count = 0;
+    ESP_RETURN_ON_ERROR(mpr121_gesture_init(&rec, &cfg), TAG, "Init gesture failed");
+
+    int64_t next_tick = tick_us;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        int64_t t = steps[i].t_ms * 1000LL;
+        while (tick_us != 0 && next_tick < t)
+        {
+            mpr121_gesture_tick(&rec, next_tick);
+            next_tick += tick_us;
+        }
+        mpr121_gesture_feed_mask(&rec, steps[i].mask, t);
+    }
+    int64_t end = (count ? steps[count - 1].t_ms * 1000LL : 0) + 1000000;
+    while (tick_us != 0 && next_tick <= end)
+    {
+        mpr121_gesture_tick(&rec, next_tick);
+        next_tick += tick_us;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief 按顺序对比识别结果与期望
+ * @param[out] false_pos 不在期望中的手势数
+ * @return uint32_t 命中的期望数
+ */
+static uint32_t bench_gesture_match(const bench_gesture_log_t *log, const bench_gesture_expect_t *expect,
+                                    uint32_t count, uint32_t *false_pos)
+{
+    uint32_t hits = 0;
+    *false_pos = 0;
+    for (uint32_t i = 0; i < log->count; i++)
+    {
+        if (hits < count && log->out[i].type == expect[hits].type && log->out[i].electrode == expect[hits].electrode)
+        {
+            hits++;
+        }
+        else
+        {
+            (*false_pos)++;
+        }
+    }
+    return hits;
+}
+
+/**
+ * @brief 线性同余随机数，返回[lo, hi]
+ */
+static uint32_t bench_gesture_rand(uint32_t *state, uint32_t lo, uint32_t hi)
+{
+    *state = *state * 1664525u + 1013904223u;
+    return lo + (*state >> 8) % (hi - lo + 1);
+}
+
+esp_err_t mpr121_bench_gesture(uint32_t gestures)
+{
+    static bench_gesture_log_t log;
+    static bench_gesture_step_t steps[BENCH_GESTURE_MAX_STEPS];
+    static bench_gesture_expect_t expect[BENCH_GESTURE_MAX_OUT];
+    static const struct
+    {
+        const char *name;
+        uint32_t tick_us;
+        uint8_t step_count;
+        bench_gesture_step_t steps[8];
+        uint8_t expect_count;
+        bench_gesture_expect_t expect[2];
+    } cases[] = {
+        {"tap", BENCH_GESTURE_TICK_US, 2, {{0, BENCH_GESTURE_E(3)}, {80, 0}}, 1, {{MPR121_GESTURE_TAP, 3}}},
+        {"double tap", BENCH_GESTURE_TICK_US, 4,
+         {{0, BENCH_GESTURE_E(3)}, {80, 0}, {200, BENCH_GESTURE_E(3)}, {260, 0}}, 1,
+         {{MPR121_GESTURE_DOUBLE_TAP, 3}}},
+        {"long press", BENCH_GESTURE_TICK_US, 2, {{0, BENCH_GESTURE_E(4)}, {900, 0}}, 1,
+         {{MPR121_GESTURE_LONG_PRESS, 4}}},
+        {"long, no tick", 0, 2, {{0, BENCH_GESTURE_E(4)}, {900, 0}}, 1, {{MPR121_GESTURE_LONG_PRESS, 4}}},
+        {"tap+long", BENCH_GESTURE_TICK_US, 4,
+         {{0, BENCH_GESTURE_E(2)}, {80, 0}, {200, BENCH_GESTURE_E(2)}, {1000, 0}}, 2,
+         {{MPR121_GESTURE_TAP, 2}, {MPR121_GESTURE_LONG_PRESS, 2}}},
+        {"tap+long, no tick", 0, 4,
+         {{0, BENCH_GESTURE_E(2)}, {80, 0}, {200, BENCH_GESTURE_E(2)}, {1000, 0}}, 2,
+         {{MPR121_GESTURE_TAP, 2}, {MPR121_GESTURE_LONG_PRESS, 2}}},
+        {"tap+medium", BENCH_GESTURE_TICK_US, 4,
+         {{0, BENCH_GESTURE_E(2)}, {80, 0}, {200, BENCH_GESTURE_E(2)}, {600, 0}}, 1, {{MPR121_GESTURE_TAP, 2}}},
+        {"swipe+ELE9 tap", BENCH_GESTURE_TICK_US, 8,
+         {{0, BENCH_GESTURE_E(9)}, {60, 0}, {100, BENCH_GESTURE_E(0)}, {160, 0}, {180, BENCH_GESTURE_E(1)},
+          {240, 0}, {260, BENCH_GESTURE_E(2)}, {320, 0}},
+         2, {{MPR121_GESTURE_SWIPE_FORWARD, 2}, {MPR121_GESTURE_TAP, 9}}},
+        {"swipe backward", BENCH_GESTURE_TICK_US, 6,
+         {{0, BENCH_GESTURE_E(5)}, {60, 0}, {80, BENCH_GESTURE_E(4)}, {140, 0}, {160, BENCH_GESTURE_E(3)}, {220, 0}},
+         1, {{MPR121_GESTURE_SWIPE_BACKWARD, 3}}},
+    };
+    static const char *const type_names[MPR121_GESTURE_TYPE_MAX] = {"tap", "double", "long", "swipe fwd", "swipe bwd"};
+    bool ok = true;
+    uint32_t false_pos = 0;
+
+    // 脚本用例：固定时间线，期望结果逐个比对
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++)
+    {
+        ESP_RETURN_ON_ERROR(bench_gesture_run(cases[c].steps, cases[c].step_count, cases[c].tick_us, &log),
+                            TAG, "Run gesture case failed");
+        uint32_t hits = bench_gesture_match(&log, cases[c].expect, cases[c].expect_count, &false_pos);
+        bool pass = hits == cases[c].expect_count && false_pos == 0;
+        ok &= pass;
+        ESP_LOGI(TAG, "gesture %-17s: %s (%lu/%u expected, %lu false)", cases[c].name, pass ? "ok" : "FAIL",
+                 (unsigned long)hits, cases[c].expect_count, (unsigned long)false_pos);
+    }
+
+    // 随机会话：时间在各窗口内随机取值，相邻手势间隔足够远，期望结果由生成过程确定
+    uint32_t rng = 0x1234567;
+    uint32_t count = 0, expected = 0;
+    uint32_t t = 0;
+    uint16_t mask = 0;
+    for (uint32_t g = 0; g < gestures && count + 10 <= BENCH_GESTURE_MAX_STEPS && expected + 2 <= BENCH_GESTURE_MAX_OUT; g++)
+    {
+        uint8_t e = bench_gesture_rand(&rng, 0, MPR121_NUM_ELECTRODES - 1);
+        uint32_t kind = bench_gesture_rand(&rng, 0, 4);
+        if (kind == 0 || kind == 1)
+        {
+            // 单击/双击：按下30~180ms，双击间隔50~200ms
+            int presses = kind == 0 ? 1 : 2;
+            for (int n = 0; n < presses; n++)
+            {
+                t += n ? bench_gesture_rand(&rng, 50, 200) : 0;
+                steps[count++] = (bench_gesture_step_t){t, mask |= 1 << e};
+                t += bench_gesture_rand(&rng, 30, 180);
+                steps[count++] = (bench_gesture_step_t){t, mask &= ~(1 << e)};
+            }
+            expect[expected++] = (bench_gesture_expect_t){kind == 0 ? MPR121_GESTURE_TAP : MPR121_GESTURE_DOUBLE_TAP, e};
+        }
+        else if (kind == 2 || kind == 4)
+        {
+            // 长按：按住700~1500ms；kind=4时之前先单击一次，第二次按下落在双击窗口内（单击与长按各一次）
+            if (kind == 4)
+            {
+                steps[count++] = (bench_gesture_step_t){t, mask |= 1 << e};
+                t += bench_gesture_rand(&rng, 30, 180);
+                steps[count++] = (bench_gesture_step_t){t, mask &= ~(1 << e)};
+                t += bench_gesture_rand(&rng, 50, 200);
+                expect[expected++] = (bench_gesture_expect_t){MPR121_GESTURE_TAP, e};
+            }
+            steps[count++] = (bench_gesture_step_t){t, mask |= 1 << e};
+            t += bench_gesture_rand(&rng, 700, 1500);
+            steps[count++] = (bench_gesture_step_t){t, mask &= ~(1 << e)};
+            expect[expected++] = (bench_gesture_expect_t){MPR121_GESTURE_LONG_PRESS, e};
+        }
+        else
+        {
+            // 滑动：沿ELE0~ELE7经过3~5个电极，步进60~140ms，相邻电极按下重叠20ms
+            int len = bench_gesture_rand(&rng, 3, 5);
+            int dir = bench_gesture_rand(&rng, 0, 1) ? 1 : -1;
+            int start = dir > 0 ? bench_gesture_rand(&rng, 0, 8 - len) : bench_gesture_rand(&rng, len - 1, 7);
+            uint32_t step = bench_gesture_rand(&rng, 60, 140);
+            for (int n = 0; n < len; n++)
+            {
+                steps[count++] = (bench_gesture_step_t){t + n * step, mask |= 1 << (start + n * dir)};
+                if (n > 0)
+                {
+                    steps[count++] = (bench_gesture_step_t){t + n * step + 20, mask &= ~(1 << (start + (n - 1) * dir))};
+                }
+            }
+            t += (len - 1) * step + step / 2;
+            steps[count++] = (bench_gesture_step_t){t, mask &= ~(1 << (start + (len - 1) * dir))};
+            expect[expected++] = (bench_gesture_expect_t){
+                dir > 0 ? MPR121_GESTURE_SWIPE_FORWARD : MPR121_GESTURE_SWIPE_BACKWARD, start + 2 * dir};
+        }
+        t += BENCH_GESTURE_SPACING_MS;
+    }
+    ESP_RETURN_ON_ERROR(bench_gesture_run(steps, count, BENCH_GESTURE_TICK_US, &log), TAG, "Run session failed");
+    uint32_t hits = bench_gesture_match(&log, expect, expected, &false_pos);
+
+    uint64_t sum[MPR121_GESTURE_TYPE_MAX] = {0};
+    uint32_t max[MPR121_GESTURE_TYPE_MAX] = {0}, n[MPR121_GESTURE_TYPE_MAX] = {0};
+    for (uint32_t i = 0; i < log.count; i++)
+    {
+        const mpr121_gesture_t *out = &log.out[i];
+        sum[out->type] += out->latency_us;
+        max[out->type] = out->latency_us > max[out->type] ? out->latency_us : max[out->type];
+        n[out->type]++;
+    }
+    ESP_LOGI(TAG, "gesture session          : %lu gestures, %lu detected, %lu missed, %lu false positives (%.2f%%)",
+             (unsigned long)expected, (unsigned long)hits, (unsigned long)(expected - hits), (unsigned long)false_pos,
+             expected ? 100.0 * false_pos / expected : 0.0);
+    for (int type = 0; type < MPR121_GESTURE_TYPE_MAX; type++)
+    {
+        ESP_LOGI(TAG, "gesture latency %-9s: %3lu x, avg %6lu us, max %6lu us", type_names[type],
+                 (unsigned long)n[type], (unsigned long)(n[type] ? sum[type] / n[type] : 0), (unsigned long)max[type]);
+    }
+
+    // 长按在阈值后一个tick内判定；单击须等双击窗口结束，或窗口内的第二次按下超过单击时长；
+    // 双击与滑动在决定性边沿上立即判定
+    ok &= hits == expected && false_pos == 0;
+    ok &= max[MPR121_GESTURE_LONG_PRESS] <= BENCH_GESTURE_TICK_US;
+    ok &= max[MPR121_GESTURE_TAP] <=
+          bench_gesture_cfg.double_tap_gap_us + bench_gesture_cfg.tap_max_us + BENCH_GESTURE_TICK_US;
+    ok &= max[MPR121_GESTURE_DOUBLE_TAP] == 0 && max[MPR121_GESTURE_SWIPE_FORWARD] == 0 &&
+          max[MPR121_GESTURE_SWIPE_BACKWARD] == 0;
+    return ok ? ESP_OK : ESP_ERR_INVALID_RESPONSE;
+}
+
+// -------------------------- 流模式节拍测试 --------------------------
+#define BENCH_STREAM_SCL_HZ 100000 // 模拟的SCL频率（整帧突发读取约4.2ms）
+#define BENCH_STREAM_FAST_US 1000  // 快于整帧读取的采样周期（原默认值）
+
+/**
+ * @brief 模拟器读取：推进一个采样周期，并按BENCH_STREAM_SCL_HZ下传输的位数忙等，使读取耗时与真实总线一致
+ */
+static esp_err_t bench_stream_bus_read(void *ctx, uint8_t reg, uint8_t *data, size_t len)
+{
+    mpr121_sim_t *sim = (mpr121_sim_t *)ctx;
+    uint64_t bus_before = mpr121_sim_bus_time_us(sim, BENCH_STREAM_SCL_HZ);
+    int64_t start = esp_timer_get_time();
+
+    mpr121_sim_step(sim);
+    esp_err_t err = mpr121_sim_bus_ops.read(ctx, reg, data, len);
+    int64_t end = start + (int64_t)(mpr121_sim_bus_time_us(sim, BENCH_STREAM_SCL_HZ) - bus_before);
+    while (esp_timer_get_time() < end)
+    {
+    }
+    return err;
+}
+
+static esp_err_t bench_stream_bus_write(void *ctx, uint8_t reg, const uint8_t *data, size_t len)
+{
+    return mpr121_sim_bus_ops.write(ctx, reg, data, len);
+}
+
+static const mpr121_bus_ops_t bench_stream_bus_ops = {
+    .write = bench_stream_bus_write,
+    .read = bench_stream_bus_read,
+};
+
+/**
+ * @brief 以period_us运行流模式duration_ms并停止；consume时消费者每1ms取一次最新帧
+ * @param[out] stats 停止后的统计
+ * @param[out] acquired 消费者取到的新帧数（含停止后取走的最后一帧）
+ * @param[out] elapsed_us 实际运行时间
+ */
+static esp_err_t bench_stream_run(mpr121_sim_t *sim, mpr121_dev_t *dev, uint32_t period_us, uint32_t duration_ms,
+                                  bool consume, mpr121_stream_stats_t *stats, uint32_t *acquired, int64_t *elapsed_us)
+{
+    static mpr121_stream_t stream;
+    const mpr121_frame_t *frame;
+
+    *acquired = 0;
+    int64_t start = esp_timer_get_time();
+    ESP_RETURN_ON_ERROR(mpr121_stream_start(&stream, dev, period_us), TAG, "Start stream failed");
+    if ((sim->regs[MPR121_FILT_CDT_CFG] & 0x1F) != 0)
+    {
+        ESP_LOGE(TAG, "Stream did not select SFI=4/ESI=1ms (CDT cfg 0x%02X)", sim->regs[MPR121_FILT_CDT_CFG]);
+        mpr121_stream_stop(&stream);
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+    for (uint32_t ms = 0; ms < duration_ms; ms++)
+    {
+        vTaskDelay(pdMS_TO_TICKS(1));
+        if (consume && mpr121_stream_acquire(&stream, &frame))
+        {
+            (*acquired)++;
+        }
+    }
+    ESP_RETURN_ON_ERROR(mpr121_stream_stop(&stream), TAG, "Stop stream failed");
+    *elapsed_us = esp_timer_get_time() - start;
+    if (mpr121_stream_acquire(&stream, &frame))
+    {
+        (*acquired)++;
+    }
+    mpr121_stream_get_stats(&stream, stats);
+
+    ESP_LOGI(TAG, "stream %4lu us : %3lu frames (%4lld us/frame), %3lu dropped, %3lu overwritten, %3lu acquired",
+             (unsigned long)stream.period_us, (unsigned long)stats->frames,
+             (long long)(stats->frames ? *elapsed_us / stats->frames : 0), (unsigned long)stats->dropped,
+             (unsigned long)stats->overwritten, (unsigned long)*acquired);
+    return ESP_OK;
+}
+
+esp_err_t mpr121_bench_stream(uint32_t duration_ms)
+{
+    static mpr121_sim_t sim;
+    static mpr121_dev_t dev;
+    mpr121_stream_stats_t stats;
+    uint32_t acquired;
+    int64_t elapsed_us;
+    bool ok = true;
+
+    if (duration_ms == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    ESP_RETURN_ON_ERROR(mpr121_bench_sim_setup(&sim, &dev, &bench_stream_bus_ops, MPR121_DEFAULT_ADDR, 700, 2), TAG,
+                        "Setup failed");
+    const uint8_t cdt_cfg = sim.regs[MPR121_FILT_CDT_CFG];
+
+    // 一帧突发读取的总线时间（帧间隔的下限）
+    mpr121_frame_t frame;
+    uint64_t bus_before = mpr121_sim_bus_time_us(&sim, BENCH_STREAM_SCL_HZ);
+    ESP_RETURN_ON_ERROR(mpr121_read_frame(&dev, &frame), TAG, "Read frame failed");
+    const uint32_t frame_us = (uint32_t)(mpr121_sim_bus_time_us(&sim, BENCH_STREAM_SCL_HZ) - bus_before);
+
+    // 默认周期长于整帧读取：每个周期一帧，无错过的周期；消费者取走或被覆盖的帧数与采集的帧数相等
+    ESP_RETURN_ON_ERROR(bench_stream_run(&sim, &dev, 0, duration_ms, true, &stats, &acquired, &elapsed_us), TAG,
+                        "Default period failed");
+    uint32_t periods = (uint32_t)(elapsed_us / MPR121_STREAM_DEFAULT_PERIOD_US);
+    uint32_t cycles = stats.frames + stats.dropped + stats.read_errors;
+    ok &= cycles >= periods * 9 / 10 && cycles <= periods * 11 / 10 + 1;
+    ok &= stats.dropped <= stats.frames / 20 && stats.read_errors == 0;
+    ok &= acquired + stats.overwritten == stats.frames;
+
+    // 1ms周期短于读取的总线时间：实际帧间隔被总线限制，其余周期计入dropped；无消费者时除最后一帧外均被覆盖
+    ESP_RETURN_ON_ERROR(bench_stream_run(&sim, &dev, BENCH_STREAM_FAST_US, duration_ms, false, &stats, &acquired,
+                                         &elapsed_us), TAG, "Fast period failed");
+    periods = (uint32_t)(elapsed_us / BENCH_STREAM_FAST_US);
+    cycles = stats.frames + stats.dropped + stats.read_errors;
+    ok &= cycles >= periods * 9 / 10 && cycles <= periods * 11 / 10 + 1;
+    ok &= stats.frames != 0 && elapsed_us / stats.frames >= frame_us * 9 / 10 && stats.dropped >= stats.frames * 2;
+    ok &= acquired == 1 && stats.overwritten + 1 == stats.frames;
+
+    if (sim.regs[MPR121_FILT_CDT_CFG] != cdt_cfg)
+    {
+        ESP_LOGE(TAG, "CDT cfg 0x%02X not restored (expected 0x%02X)", sim.regs[MPR121_FILT_CDT_CFG], cdt_cfg);
+        ok = false;
+    }
+    return ok ? ESP_OK : ESP_ERR_INVALID_RESPONSE;
+}
+
+// -------------------------- 事件管线测试 --------------------------
+#define BENCH_EVENT_SETTLE 64                                   // 开始前让基线收敛的采样周期
+#define BENCH_EVENT_EDGE_IRQS 5                                 // 边沿用例排队的IRQ数（每次处理推进一个采样周期）
+#define BENCH_EVENT_BURST_AT (BENCH_EVENT_SETTLE + BENCH_EVENT_EDGE_IRQS + 16) // 溢出用例开始前的采样序号
+#define BENCH_EVENT_BURST_IRQS 6                                // 溢出用例的IRQ数：全部电极每周期交替按下/释放
+#define BENCH_EVENT_IRQ_EXTRA 5                                 // IRQ环满后多记录的IRQ数
+
+/**
+ * @brief 记录一个IRQ并返回其时间戳的上下界；返回前等待时钟前进，保证相邻IRQ的时间戳互不相同
+ */
+static void bench_event_irq(mpr121_event_pipe_t *pipe, int64_t *before, int64_t *after)
+{
+    *before = esp_timer_get_time();
+    mpr121_event_irq_from_isr(pipe);
+    *after = esp_timer_get_time();
+    while (esp_timer_get_time() <= *after)
+    {
+    }
+}
+
+esp_err_t mpr121_bench_event(void)
+{
+    static mpr121_sim_t sim;
+    static mpr121_dev_t dev;
+    static mpr121_event_pipe_t pipe;
+    // 边沿用例：第k次处理读取第SETTLE+k个采样，ELE1在第1~2个、ELE3在第2~3个采样按下
+    const mpr121_sim_touch_t touches[] = {
+        {.start_sample = BENCH_EVENT_SETTLE + 1, .end_sample = BENCH_EVENT_SETTLE + 3, .mask = 1 << 1, .drop = 80},
+        {.start_sample = BENCH_EVENT_SETTLE + 2, .end_sample = BENCH_EVENT_SETTLE + 4, .mask = 1 << 3, .drop = 80},
+        {.start_sample = BENCH_EVENT_BURST_AT + 1, .end_sample = BENCH_EVENT_BURST_AT + 2, .mask = 0x0FFF, .drop = 80},
+        {.start_sample = BENCH_EVENT_BURST_AT + 3, .end_sample = BENCH_EVENT_BURST_AT + 4, .mask = 0x0FFF, .drop = 80},
+        {.start_sample = BENCH_EVENT_BURST_AT + 5, .end_sample = BENCH_EVENT_BURST_AT + 6, .mask = 0x0FFF, .drop = 80},
+    };
+    // 期望的边沿：IRQ序号、电极、类型
+    static const struct
+    {
+        uint8_t irq;
+        uint8_t electrode;
+        uint8_t type;
+    } expected[] = {
+        {0, 1, MPR121_EVENT_PRESS},
+        {1, 3, MPR121_EVENT_PRESS},
+        {2, 1, MPR121_EVENT_RELEASE},
+        {3, 3, MPR121_EVENT_RELEASE},
+    };
+    const size_t expected_count = sizeof(expected) / sizeof(expected[0]);
+    int64_t before[BENCH_EVENT_EDGE_IRQS], after[BENCH_EVENT_EDGE_IRQS];
+    mpr121_touch_event_t event;
+    mpr121_event_stats_t stats;
+    bool ok = true;
+
+    // 读取触摸状态前推进一个采样周期：排队的每个IRQ对应芯片的一次新状态
+    ESP_RETURN_ON_ERROR(mpr121_bench_sim_setup(&sim, &dev, &bench_calib_bus_ops, MPR121_DEFAULT_ADDR, 700, 2), TAG,
+                        "Setup failed");
+    for (size_t i = 0; i < sizeof(touches) / sizeof(touches[0]); i++)
+    {
+        ESP_RETURN_ON_ERROR(mpr121_sim_add_touch(&sim, &touches[i]), TAG, "Add touch failed");
+    }
+    while (sim.sample < BENCH_EVENT_SETTLE)
+    {
+        mpr121_sim_step(&sim);
+    }
+    ESP_RETURN_ON_ERROR(mpr121_event_pipe_init(&pipe, &dev), TAG, "Init event pipe failed");
+
+    // 1. 边沿：先排队全部IRQ再一次处理，事件时间戳应为对应IRQ的到达时刻而非处理时刻
+    for (int i = 0; i < BENCH_EVENT_EDGE_IRQS; i++)
+    {
+        bench_event_irq(&pipe, &before[i], &after[i]);
+    }
+    int64_t process_start = esp_timer_get_time();
+    ESP_RETURN_ON_ERROR(mpr121_event_process(&pipe), TAG, "Process IRQs failed");
+    int64_t process_end = esp_timer_get_time();
+    uint64_t latency_sum = 0;
+    uint32_t latency_max = 0;
+    size_t n = 0;
+    while (mpr121_event_pop(&pipe, &event))
+    {
+        if (n < expected_count)
+        {
+            int irq = expected[n].irq;
+            ok &= event.electrode == expected[n].electrode && event.type == expected[n].type &&
+                  event.timestamp_us >= before[irq] && event.timestamp_us <= after[irq] &&
+                  event.latency_us >= process_start - event.timestamp_us &&
+                  event.latency_us <= process_end - event.timestamp_us;
+        }
+        latency_sum += event.latency_us;
+        latency_max = event.latency_us > latency_max ? event.latency_us : latency_max;
+        n++;
+    }
+    mpr121_event_get_stats(&pipe, &stats);
+    ESP_LOGI(TAG, "event edges   : %u events from %lu queued IRQs, latency avg %lu us / max %lu us",
+             (unsigned)n, (unsigned long)stats.irqs, (unsigned long)stats.latency_avg_us,
+             (unsigned long)stats.latency_max_us);
+    ok &= n == expected_count && stats.irqs == BENCH_EVENT_EDGE_IRQS && stats.events == expected_count &&
+          stats.latency_avg_us == (uint32_t)(latency_sum / expected_count) && stats.latency_max_us == latency_max;
+
+    // 2. 事件环满：12个电极交替按下/释放，不取出事件，超出容量的事件被丢弃并计数
+    while (sim.sample < BENCH_EVENT_BURST_AT)
+    {
+        mpr121_sim_step(&sim);
+    }
+    int64_t ignore;
+    for (int i = 0; i < BENCH_EVENT_BURST_IRQS; i++)
+    {
+        bench_event_irq(&pipe, &ignore, &ignore);
+    }
+    ESP_RETURN_ON_ERROR(mpr121_event_process(&pipe), TAG, "Process IRQs failed");
+    const uint32_t burst_events = BENCH_EVENT_BURST_IRQS * MPR121_NUM_ELECTRODES;
+    mpr121_event_get_stats(&pipe, &stats);
+    uint32_t popped = 0;
+    while (mpr121_event_pop(&pipe, &event))
+    {
+        popped++;
+    }
+    ESP_LOGI(TAG, "event ring    : %lu events generated, %lu kept, %lu overflowed (ring %d)",
+             (unsigned long)(stats.events - expected_count), (unsigned long)popped,
+             (unsigned long)stats.event_overflows, MPR121_EVENT_RING_SIZE);
+    ok &= stats.events == expected_count + burst_events && popped == MPR121_EVENT_RING_SIZE &&
+          stats.event_overflows == burst_events - MPR121_EVENT_RING_SIZE;
+
+    // 3. IRQ环满：处理前记录超过容量的IRQ，多出的时间戳被丢弃并计数，其余逐个处理
+    uint32_t irqs = stats.irqs;
+    for (int i = 0; i < MPR121_IRQ_RING_SIZE + BENCH_EVENT_IRQ_EXTRA; i++)
+    {
+        mpr121_event_irq_from_isr(&pipe);
+    }
+    ESP_RETURN_ON_ERROR(mpr121_event_process(&pipe), TAG, "Process IRQs failed");
+    mpr121_event_get_stats(&pipe, &stats);
+    ESP_LOGI(TAG, "event IRQ ring: %lu IRQs processed, %lu overflowed (ring %d)", (unsigned long)(stats.irqs - irqs),
+             (unsigned long)stats.irq_overflows, MPR121_IRQ_RING_SIZE);
+    ok &= stats.irqs - irqs == MPR121_IRQ_RING_SIZE && stats.irq_overflows == BENCH_EVENT_IRQ_EXTRA;
+    return ok ? ESP_OK : ESP_ERR_INVALID_RESPONSE;
+}
@@ -0,0 +1,210 @@
+#ifndef MPR121_BENCH_H
+#define MPR121_BENCH_H
+
+#include "mpr121.h"
+#include "mpr121_sim.h"
+#include "mpr121_slider.h"
+
+// -------------------------- 函数接口 --------------------------
+/**
+ * @brief 模拟器测试夹具：以上电默认值初始化模拟器，挂接到设备并执行mpr121_init()
+ * @note 触摸脚本、噪声与故障可在之后设置（模拟器只在mpr121_sim_step()时采样）
+ * @param sim 模拟器
+ * @param dev 设备句柄
+ * @param ops 总线操作（ctx为sim，可包装模拟器总线以在读取时推进采样；NULL=mpr121_sim_bus_ops）
+ * @param addr 设备地址
+ * @param idle_level 未触摸时的滤波数据（0~1023）
+ * @param noise 噪声峰值
+ * @return esp_err_t ESP_OK: 成功；其他: 挂接或初始化失败
+ */
+esp_err_t mpr121_bench_sim_setup(mpr121_sim_t *sim, mpr121_dev_t *dev, const mpr121_bus_ops_t *ops, uint8_t addr,
+                                 uint16_t idle_level, uint8_t noise);
+
+/**
+ * @brief 对比逐电极读取路径与整帧突发读取路径的I2C开销（事务数、字节数、耗时）
+ * @param dev 设备句柄
+ * @param iterations 每条路径重复读取的帧数（结果取平均）
+ * @return esp_err_t ESP_OK: 测试完成；其他: 读取失败
+ */
+esp_err_t mpr121_bench_frame_read(mpr121_dev_t *dev, uint32_t iterations);
+
+/**
+ * @brief 测量运行时重设全部阈值的总线开销（影子缓存合并块写）
+ * @param dev 设备句柄
+ * @param touch 测试用触摸阈值
+ * @param release 测试用释放阈值
+ * @return esp_err_t ESP_OK: 测试完成；其他: 写入失败
+ */
+esp_err_t mpr121_bench_thresholds(mpr121_dev_t *dev, uint8_t touch, uint8_t release);
+
+/**
+ * @brief 测量滑条/滚轮位置引擎每帧的CPU耗时（合成差值数据，不访问总线），并校验无效配置被拒绝、
+ *        质心位置、触摸迟滞边界与滚轮跨零点的平滑方向
+ * @param iterations 更新次数
+ * @return esp_err_t ESP_OK: 测试完成；ESP_ERR_INVALID_RESPONSE: 位置或迟滞不符合预期；其他: 配置失败
+ */
+esp_err_t mpr121_bench_slider(uint32_t iterations);
+
+/**
+ * @brief 在寄存器级模拟器上测量各读取路径：每帧事务数、100k/400kHz下的总线时间、每帧CPU解码耗时
+ * @note 不需要硬件，可在linux目标上运行
+ * @param frames 每条路径读取的帧数
+ * @return esp_err_t ESP_OK: 测试完成；其他: 初始化或读取失败
+ */
+esp_err_t mpr121_bench_sim(uint32_t frames);
+
+/**
+ * @brief 对比同步扫描与异步扫描：每帧耗时、扫描期间任务让出CPU的比例、异步重试/超时统计
+ * @note 须在将执行扫描的任务中调用；异步部分要求设备支持submit_read（mpr121_add_device_async()或模拟器），
+ *       否则仅输出同步结果
+ * @param devs 已初始化的设备句柄数组
+ * @param count 设备数量（1~4）
+ * @param frames 每种方式的扫描帧数
+ * @param[out] touch_mask 最后一帧的48位合并触摸掩码（可为NULL）
+ * @return esp_err_t ESP_OK: 测试完成；ESP_ERR_INVALID_RESPONSE: 异步与同步扫描的掩码不一致；其他: 扫描失败
+ */
+esp_err_t mpr121_bench_scan(mpr121_dev_t *const devs[], uint8_t count, uint32_t frames, uint64_t *touch_mask);
+
+/**
+ * @brief 对比事件输出方式的CPU耗时：格式化事件文本（ESP_LOGI的下限，不含串口发送）与写入二进制跟踪记录
+ * @note 不访问总线，可在linux目标上运行；测试结束后取出并解码最后几条跟踪记录
+ * @param iterations 事件次数
+ * @return esp_err_t ESP_OK: 测试完成；ESP_ERR_INVALID_ARG: 次数为0
+ */
+esp_err_t mpr121_bench_trace(uint32_t iterations);
+
+/**
+ * @brief 在模拟器上依次切换内置调校配置（dry→wet→glove→dry），输出每次的扫描中断时间、写入量与基线是否保持，
+ *        并与待机后整段重写配置寄存器的方式对比；最后使能ACE再依次切换，校验每次自动配置均成功（FFI一致）
+ * @note 不需要硬件，可在linux目标上运行
+ * @return esp_err_t ESP_OK: 测试完成；ESP_ERR_INVALID_RESPONSE: 自动配置失败；其他: 初始化或切换失败
+ */
+esp_err_t mpr121_bench_profile(void);
+
+/**
+ * @brief 测量软件滤波器组（13通道中值+IIR+限摆）每帧的CPU耗时，并对比合成噪声与尖峰下滤波前后的峰峰值
+ * @note 不访问总线，可在linux目标上运行
+ * @param iterations 帧数
+ * @return esp_err_t ESP_OK: 测试完成；其他: 配置失败
+ */
+esp_err_t mpr121_bench_filter(uint32_t iterations);
+
+/**
+ * @brief 以一个tick为周期运行采集/处理流水线，依次测试三种队列满策略：处理回调（滤波器组+模拟负载）比采集周期慢，
+ *        输出吞吐量、端到端延迟、丢帧与反压等待时间
+ * @note 须在设备未被其他任务访问时调用；linux目标下在FreeRTOS POSIX移植上运行（不绑定核）
+ * @param dev 已初始化的设备句柄（可为模拟器）
+ * @param duration_ms 每种策略的运行时间
+ * @return esp_err_t ESP_OK: 测试完成；其他: 启动失败
+ */
+esp_err_t mpr121_bench_pipeline(mpr121_dev_t *dev, uint32_t duration_ms);
+
+/**
+ * @brief 在模拟器上对比LED更新方式：逐次读-改-写GPIO_DATA与合并后每帧一次SET/CLEAR/TOGGLE块写的事务数，
+ *        并校验闪烁与合并结果和模拟芯片的GPIO_DATA一致
+ * @note 不需要硬件，可在linux目标上运行
+ * @param frames 帧数（每帧20次随机LED更新，另有2个引脚闪烁）
+ * @return esp_err_t ESP_OK: 测试完成；ESP_ERR_INVALID_RESPONSE: 电平校验失败；其他: 配置失败
+ */
+esp_err_t mpr121_bench_gpio(uint32_t frames);
+
+/**
+ * @brief 在模拟器上注入总线故障（NACK、总线卡死、掉电复位），验证自动恢复并统计恢复耗时，
+ *        与完整mpr121_init()的总线开销对比
+ * @note 不需要硬件，可在linux目标上运行；每次恢复后校验芯片寄存器与影子缓存一致且无误触摸，NACK计入统计的NACK类
+ * @param cycles 每种故障注入的次数
+ * @return esp_err_t ESP_OK: 全部恢复；ESP_ERR_INVALID_RESPONSE: 恢复后配置不一致、出现误触摸或NACK未按类计数；其他: 初始化失败
+ */
+esp_err_t mpr121_bench_recover(uint32_t cycles);
+
+/**
+ * @brief 在模拟器上制造超范围电极（一个可由自动配置修复，一个无法修复）引起的IRQ风暴并中途注入过流，
+ *        对比事件管线挂接健康监测器前后的IRQ与事件数
+ * @note 不需要硬件，可在linux目标上运行；校验健康电极的CDC保持不变、故障电极被隔离、过流后恢复运行模式，
+ *       故障电极位于使能范围顶端（ELE11）时隔离后ELE_EN收缩、不再产生IRQ
+ * @param samples 采样周期数
+ * @return esp_err_t ESP_OK: 测试完成；ESP_ERR_INVALID_RESPONSE: 处理结果不符合预期；其他: 初始化失败
+ */
+esp_err_t mpr121_bench_health(uint32_t samples);
+
+/**
+ * @brief 在模拟器上全速录制带真实触摸与噪声尖峰的帧流，经控制台导出文本恢复后解码校验无损，
+ *        再以离线回放引擎扫描阈值/去抖组合，对比录制时参数与最优参数的命中、误触发与延迟
+ * @note 不需要硬件，可在linux目标上运行
+ * @param frames 录制帧数（上限2000）
+ * @return esp_err_t ESP_OK: 测试完成；ESP_ERR_INVALID_RESPONSE: 往返校验失败；其他: 初始化或录制失败
+ */
+esp_err_t mpr121_bench_record(uint32_t frames);
+
+/**
+ * @brief 在模拟的共享总线上同时运行MPR121触摸读取（1ms）、IMU读取（2ms）与连续EEPROM大块写入，
+ *        对比先到先得（等同i2c_master总线锁）与调度器（触摸状态优先、大块分块）的各客户端排队延迟
+ * @note 不需要硬件，可在linux目标上运行
+ * @param duration_ms 每种方式的运行时长
+ * @return esp_err_t ESP_OK: 测试完成；其他: 初始化或创建任务失败
+ */
+esp_err_t mpr121_bench_sched(uint32_t duration_ms);
+
+/**
+ * @brief 在模拟器上用噪声不同的电极（大面积电极噪声大、小面积电极噪声小）和少量真实触摸，
+ *        先以统一阈值运行并统计空闲噪声，再应用自动调校的逐电极阈值，对比空闲时的误触发IRQ
+ * @note 不需要硬件，可在linux目标上运行；校验调校后真实触摸仍全部被检测
+ * @param samples 每个阶段的采样周期数
+ * @return esp_err_t ESP_OK: 测试完成；ESP_ERR_INVALID_RESPONSE: 调校结果不符合预期；其他: 初始化失败
+ */
+esp_err_t mpr121_bench_tune(uint32_t samples);
+
+/**
+ * @brief 在模拟器上以一次整帧读取发布帧与事件，前半程1个订阅者、后半程4个（按电极/类型过滤，其中一个慢速读取），
+ *        对比每次采集的总线流量，输出各订阅者收到的消息与滞后
+ * @note 不需要硬件，可在linux目标上运行；校验消息无拷贝、过滤结果正确、共享槽全部回收
+ * @param steps 采集次数
+ * @return esp_err_t ESP_OK: 测试完成；ESP_ERR_INVALID_RESPONSE: 结果不符合预期；其他: 初始化失败
+ */
+esp_err_t mpr121_bench_pubsub(uint32_t steps);
+
+/**
+ * @brief 在模拟器上冷启动（自动配置搜索），随后提交一个与自动配置无关的寄存器，
+ *        校验不会再次执行自动配置、基线不被重载
+ * @note 不需要硬件，可在linux目标上运行
+ * @return esp_err_t ESP_OK: 测试完成；ESP_ERR_INVALID_RESPONSE: 再次执行了自动配置或基线改变；其他: 启动失败
+ */
+esp_err_t mpr121_bench_calib(void);
+
+/**
+ * @brief 在模拟器上冷启动后进入低功耗空闲状态，反复接近唤醒、超时回到空闲，
+ *        校验每次唤醒后电极基线与空闲前一致、不再执行自动配置、各状态的ELE_CFG正确
+ * @note 不需要硬件，可在linux目标上运行
+ * @param cycles 唤醒/休眠循环次数
+ * @return esp_err_t ESP_OK: 测试完成；ESP_ERR_INVALID_RESPONSE: 基线改变、再次自动配置或状态配置错误；其他: 启动失败
+ */
+esp_err_t mpr121_bench_power(uint32_t cycles);
+
+/**
+ * @brief 以合成的带时间戳触摸掩码序列测试手势识别：先运行固定脚本用例（含无tick时的长按、
+ *        第二次按下变为长按、滑动期间轨迹外电极的点击），再运行随机会话，统计漏检、误报与各类手势的判定延迟
+ * @note 不访问总线，结果确定，可在linux目标上运行
+ * @param gestures 随机会话的手势数
+ * @return esp_err_t ESP_OK: 全部符合预期；ESP_ERR_INVALID_RESPONSE: 有漏检、误报或延迟超限
+ */
+esp_err_t mpr121_bench_gesture(uint32_t gestures);
+
+/**
+ * @brief 在模拟器上运行流模式（读取按100kHz总线的传输位数计时）：默认周期下校验每周期一帧、无错过的周期；
+ *        1ms周期下校验帧间隔不短于一帧的总线时间、多出的周期计入dropped、未取走的帧计入overwritten；
+ *        停止后FILT_CDT_CFG恢复原值
+ * @note 不需要硬件，可在linux目标上运行
+ * @param duration_ms 每种周期的运行时间
+ * @return esp_err_t ESP_OK: 测试完成；ESP_ERR_INVALID_RESPONSE: 帧节拍或计数不符合预期；其他: 启动失败
+ */
+esp_err_t mpr121_bench_stream(uint32_t duration_ms);
+
+/**
+ * @brief 在模拟器上测试触摸事件管线：处理前排队多个IRQ，校验按下/释放边沿及其时间戳等于IRQ到达时刻、
+ *        延迟统计与逐事件延迟一致；不取出事件时事件环满的丢弃计数；处理前超过容量的IRQ的丢弃计数
+ * @note 不需要硬件，可在linux目标上运行
+ * @return esp_err_t ESP_OK: 测试完成；ESP_ERR_INVALID_RESPONSE: 事件、时间戳或计数不符合预期；其他: 初始化失败
+ */
+esp_err_t mpr121_bench_event(void);
+
+#endif // MPR121_BENCH_H
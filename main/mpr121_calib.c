@@ -0,0 +1,330 @@
+#include "mpr121_calib.h"
+#include <string.h>
+#include <esp_timer.h>
+
+static const char *TAG = "mpr121_calib";
+
+#define CALIB_CDC_LEN (MPR121_CDT_PROX - MPR121_CDC_0 + 1) // CDC_0~CDT_PROX连续20字节
+#define CALIB_AUTO_LEN (MPR121_AUTO_TL - MPR121_AUTO_CFG0 + 1)
+
+// AUTO_CFG0位定义
+#define AUTO_CFG0_ACE 0x01       // 进入运行模式时执行自动配置
+#define AUTO_CFG0_ARE 0x02       // 超范围时自动重配置
+#define AUTO_CFG0_BVA_CL10 0x08  // 自动配置后基线按CL=10初始化（与冷启动ELE_CFG一致）
+#define AUTO_CFG0_RETRY_2 0x10   // 失败重试2次
+#define OOR_H_ACFF 0x80          // OORSTATUS_H：自动配置失败
+
+_Static_assert(sizeof(mpr121_calib_blob_t) == 52, "calibration blob layout changed, bump MPR121_CALIB_VERSION");
+
+// -------------------------- 静态辅助函数（仅内部使用） --------------------------
+/**
+ * @brief CRC-32（IEEE 802.3，反射多项式0xEDB88320），逐位计算，无查找表
+ * @param data 数据
+ * @param len 字节数
+ * @return uint32_t CRC值
+ */
+static uint32_t calib_crc32(const uint8_t *data, size_t len)
+{
+    uint32_t crc = 0xFFFFFFFFU;
+    for (size_t i = 0; i < len; i++)
+    {
+        crc ^= data[i];
+        for (int b = 0; b < 8; b++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320U & -(crc & 1));
+        }
+    }
+    return ~crc;
+}
+
+/**
+ * @brief 将自动配置参数写入影子缓存（数据手册AN3889推荐公式）
+ *
+ * USL = (Vdd - 0.7) / Vdd * 256，TL = USL * 0.9，LSL = USL * 0.65。
+ * @param dev 设备句柄
+ * @param vdd_mv 供电电压（mV）
+ */
+static void calib_stage_autoconfig(mpr121_dev_t *dev, uint16_t vdd_mv)
+{
+    uint32_t usl = (uint32_t)(vdd_mv - 700) * 256 / vdd_mv;
+    uint8_t cdc_cfg = 0;
+    mpr121_cfg_get(dev, MPR121_FILT_CDC_CFG, &cdc_cfg);
+
+    uint8_t regs[CALIB_AUTO_LEN] = {
+        (cdc_cfg & 0xC0) | AUTO_CFG0_RETRY_2 | AUTO_CFG0_BVA_CL10 | AUTO_CFG0_ARE | AUTO_CFG0_ACE, // FFI须与FILT_CDC_CFG一致
+        0x00,                 // AUTO_CFG1：不跳过充电时间搜索，不使能故障中断（启动时轮询OOR状态）
+        usl,                  // AUTO_USL
+        usl * 65 / 100,       // AUTO_LSL
+        usl * 90 / 100,       // AUTO_TL
+    };
+    mpr121_cfg_set_block(dev, MPR121_AUTO_CFG0, regs, sizeof(regs));
+}
+
+/**
+ * @brief 轮询数据帧直到基线稳定：全部使能电极无触摸、无超范围，且|差值|小于释放阈值
+ * @param dev 设备句柄
+ * @param[out] frame 最后一次读取的数据帧（稳定时即首个有效帧）
+ * @return esp_err_t ESP_OK: 已稳定；ESP_ERR_TIMEOUT: 超时；其他: 读取失败
+ */
+static esp_err_t calib_wait_settled(mpr121_dev_t *dev, mpr121_frame_t *frame)
+{
+    int64_t deadline = esp_timer_get_time() + MPR121_CALIB_SETTLE_TIMEOUT_MS * 1000LL;
+    int electrodes = MPR121_CALIB_ELE_EN & 0x0F;
+
+    while (1)
+    {
+        ESP_RETURN_ON_ERROR(mpr121_read_frame(dev, frame), TAG, "Read frame failed");
+        bool settled = (frame->touch_status & 0x0FFF) == 0 && (frame->oor_status & 0x0FFF) == 0;
+        for (int i = 0; settled && i < electrodes; i++)
+        {
+            uint8_t release = 0;
+            mpr121_cfg_get(dev, MPR121_RELEASE_THRESH_0 + i * 2, &release);
+            int16_t delta = frame->delta[i];
+            settled = frame->filtered[i] != 0 && (delta < 0 ? -delta : delta) < release;
+        }
+        if (settled)
+        {
+            return ESP_OK;
+        }
+        if (esp_timer_get_time() > deadline)
+        {
+            return ESP_ERR_TIMEOUT;
+        }
+        vTaskDelay(pdMS_TO_TICKS(MPR121_CALIB_POLL_MS) ? pdMS_TO_TICKS(MPR121_CALIB_POLL_MS) : 1);
+    }
+}
+
+/**
+ * @brief 读取状态寄存器清除IRQ后，以指定ELE_CFG进入运行模式
+ * @param dev 设备句柄
+ * @param ele_cfg ELE_CFG目标值
+ * @return esp_err_t ESP_OK: 成功；其他: I2C通信失败
+ */
+static esp_err_t calib_enter_run(mpr121_dev_t *dev, uint8_t ele_cfg)
+{
+    uint8_t tmp[2];
+    ESP_RETURN_ON_ERROR(mpr121_read_regs(dev, MPR121_TOUCHSTATUS_L, tmp, sizeof(tmp)), TAG, "Clear IRQ failed");
+    mpr121_cfg_set(dev, MPR121_ELE_CFG, ele_cfg);
+    return mpr121_cfg_commit(dev);
+}
+
+// -------------------------- 外部接口实现 --------------------------
+esp_err_t mpr121_calib_capture(mpr121_dev_t *dev, mpr121_calib_blob_t *blob)
+{
+    if (blob == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint8_t cdc_cdt[CALIB_CDC_LEN];
+    memset(blob, 0, sizeof(*blob));
+    ESP_RETURN_ON_ERROR(mpr121_read_regs(dev, MPR121_CDC_0, cdc_cdt, sizeof(cdc_cdt)), TAG, "Read CDC/CDT failed");
+    ESP_RETURN_ON_ERROR(mpr121_read_regs(dev, MPR121_BASELINE_0, blob->baseline, sizeof(blob->baseline)),
+                        TAG, "Read baseline failed");
+    memcpy(blob->cdc, cdc_cdt, sizeof(blob->cdc));
+    memcpy(blob->cdt, cdc_cdt + sizeof(blob->cdc), sizeof(blob->cdt));
+
+    blob->magic = MPR121_CALIB_MAGIC;
+    blob->version = MPR121_CALIB_VERSION;
+    blob->length = sizeof(*blob);
+    blob->ele_cfg = MPR121_CALIB_ELE_EN;
+    for (int i = 0; i < CALIB_AUTO_LEN; i++)
+    {
+        mpr121_cfg_get(dev, MPR121_AUTO_CFG0 + i, &blob->auto_cfg[i]);
+    }
+    blob->auto_cfg[0] &= ~AUTO_CFG0_ACE; // ACE仅决定是否搜索，不影响结果
+    blob->crc = calib_crc32((const uint8_t *)blob, offsetof(mpr121_calib_blob_t, crc));
+    return ESP_OK;
+}
+
+bool mpr121_calib_valid(mpr121_dev_t *dev, const mpr121_calib_blob_t *blob)
+{
+    if (blob->magic != MPR121_CALIB_MAGIC || blob->version != MPR121_CALIB_VERSION ||
+        blob->length != sizeof(*blob) ||
+        blob->crc != calib_crc32((const uint8_t *)blob, offsetof(mpr121_calib_blob_t, crc)))
+    {
+        return false;
+    }
+    if (blob->ele_cfg != MPR121_CALIB_ELE_EN)
+    {
+        return false;
+    }
+    for (int i = 0; i < CALIB_AUTO_LEN; i++)
+    {
+        uint8_t val = 0;
+        mpr121_cfg_get(dev, MPR121_AUTO_CFG0 + i, &val);
+        if (i == 0)
+        {
+            val &= ~AUTO_CFG0_ACE;
+        }
+        if (val != blob->auto_cfg[i])
+        {
+            return false;
+        }
+    }
+    // 自动配置完成后CDC不为0，全0说明数据来自未完成的配置
+    for (int i = 0; i < (MPR121_CALIB_ELE_EN & 0x0F); i++)
+    {
+        if (blob->cdc[i] == 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+esp_err_t mpr121_calib_wait_autoconfig(mpr121_dev_t *dev, uint8_t electrodes)
+{
+    int64_t deadline = esp_timer_get_time() + MPR121_CALIB_AUTOCFG_TIMEOUT_MS * 1000LL;
+    uint8_t cdc[MPR121_NUM_ELECTRODES];
+    uint8_t oor[2];
+
+    electrodes = electrodes > MPR121_NUM_ELECTRODES ? MPR121_NUM_ELECTRODES : electrodes;
+    while (1)
+    {
+        ESP_RETURN_ON_ERROR(mpr121_read_regs(dev, MPR121_OORSTATUS_L, oor, sizeof(oor)), TAG, "Read OOR failed");
+        if (oor[1] & OOR_H_ACFF)
+        {
+            return ESP_FAIL;
+        }
+        ESP_RETURN_ON_ERROR(mpr121_read_regs(dev, MPR121_CDC_0, cdc, sizeof(cdc)), TAG, "Read CDC failed");
+        int done = 0;
+        while (done < electrodes && cdc[done] != 0)
+        {
+            done++;
+        }
+        if (done == electrodes)
+        {
+            return ESP_OK;
+        }
+        if (esp_timer_get_time() > deadline)
+        {
+            return ESP_ERR_TIMEOUT;
+        }
+        vTaskDelay(pdMS_TO_TICKS(MPR121_CALIB_POLL_MS) ? pdMS_TO_TICKS(MPR121_CALIB_POLL_MS) : 1);
+    }
+}
+
+esp_err_t mpr121_calib_boot(mpr121_dev_t *dev, const mpr121_calib_config_t *cfg, mpr121_calib_boot_info_t *info)
+{
+    if (cfg == NULL || cfg->vdd_mv <= 700)
+    {
+        ESP_LOGE(TAG, "Invalid calibration config");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    mpr121_calib_boot_info_t result = {0};
+    mpr121_calib_blob_t blob;
+    mpr121_frame_t frame;
+    int64_t t_start = esp_timer_get_time();
+
+    // Step 1: 软复位并准备默认配置与自动配置参数（冷/热启动共用）
+    ESP_RETURN_ON_ERROR(mpr121_soft_reset(dev), TAG, "Reset failed");
+    mpr121_cfg_load_defaults(dev);
+    calib_stage_autoconfig(dev, cfg->vdd_mv);
+
+    // Step 2: 读取并校验已保存的校准数据
+    if (cfg->storage != NULL && cfg->storage->load != NULL)
+    {
+        esp_err_t err = cfg->storage->load(cfg->storage->ctx, &blob, sizeof(blob));
+        if (err == ESP_OK)
+        {
+            result.warm = mpr121_calib_valid(dev, &blob);
+            if (!result.warm)
+            {
+                ESP_LOGW(TAG, "Stored calibration invalid or stale, running auto-config");
+            }
+        }
+        else if (err != ESP_ERR_NOT_FOUND)
+        {
+            ESP_LOGW(TAG, "Load calibration failed: %s", esp_err_to_name(err));
+        }
+    }
+
+    if (result.warm)
+    {
+        // Step 3a（热启动）: 待机模式下写回CDC/CDT与基线，关闭ACE，CL=00保留写入的基线
+        uint8_t cdc_cdt[CALIB_CDC_LEN];
+        memcpy(cdc_cdt, blob.cdc, sizeof(blob.cdc));
+        memcpy(cdc_cdt + sizeof(blob.cdc), blob.cdt, sizeof(blob.cdt));
+        mpr121_cfg_set_block(dev, MPR121_CDC_0, cdc_cdt, sizeof(cdc_cdt));
+        mpr121_cfg_set(dev, MPR121_AUTO_CFG0, blob.auto_cfg[0]);
+        ESP_RETURN_ON_ERROR(mpr121_cfg_commit(dev), TAG, "Commit calibration failed");
+        ESP_RETURN_ON_ERROR(mpr121_write_regs(dev, MPR121_BASELINE_0, blob.baseline, sizeof(blob.baseline)),
+                            TAG, "Restore baseline failed");
+        ESP_RETURN_ON_ERROR(calib_enter_run(dev, MPR121_CALIB_ELE_EN), TAG, "Enter run mode failed");
+    }
+    else
+    {
+        // Step 3b（冷启动）: 以CL=10进入运行模式，触发自动配置搜索，完成后将结果同步到影子缓存
+        ESP_RETURN_ON_ERROR(mpr121_cfg_commit(dev), TAG, "Commit auto-config failed");
+        ESP_RETURN_ON_ERROR(calib_enter_run(dev, 0x80 | MPR121_CALIB_ELE_EN), TAG, "Enter run mode failed");
+
+        int64_t t_search = esp_timer_get_time();
+        esp_err_t err = mpr121_calib_wait_autoconfig(dev, MPR121_CALIB_ELE_EN & 0x0F);
+        result.autocfg_us = (uint32_t)(esp_timer_get_time() - t_search);
+        if (err == ESP_FAIL || err == ESP_ERR_TIMEOUT)
+        {
+            ESP_LOGW(TAG, "Auto-config %s, calibration will not be saved",
+                     err == ESP_FAIL ? "failed (ACFF)" : "timed out");
+        }
+        else
+        {
+            ESP_RETURN_ON_ERROR(err, TAG, "Wait auto-config failed");
+        }
+        ESP_RETURN_ON_ERROR(mpr121_cfg_sync(dev, MPR121_CDC_0, CALIB_CDC_LEN), TAG, "Sync CDC/CDT failed");
+        result.saved = (err == ESP_OK); // 暂记为可保存，基线稳定后再确认
+
+        // 与热启动一致关闭ACE并改为CL=00：否则此后每次待机→运行的提交（调校配置、低功耗切换）
+        // 都会重新搜索并按BVA重载基线。搜索已装载的基线保留
+        uint8_t auto_cfg0 = 0;
+        mpr121_cfg_get(dev, MPR121_AUTO_CFG0, &auto_cfg0);
+        mpr121_cfg_set(dev, MPR121_AUTO_CFG0, auto_cfg0 & ~AUTO_CFG0_ACE);
+        mpr121_cfg_set(dev, MPR121_ELE_CFG, MPR121_CALIB_ELE_EN);
+        ESP_RETURN_ON_ERROR(mpr121_cfg_commit(dev), TAG, "Disable auto-config failed");
+    }
+
+    // Step 4: 等待首个有效触摸帧（冷启动需基线收敛，热启动通常为第一帧）
+    esp_err_t err = calib_wait_settled(dev, &frame);
+    result.boot_us = (uint32_t)(esp_timer_get_time() - t_start);
+    if (err == ESP_OK)
+    {
+        result.settled = true;
+    }
+    else if (err == ESP_ERR_TIMEOUT)
+    {
+        ESP_LOGW(TAG, "Baseline not settled within %d ms", MPR121_CALIB_SETTLE_TIMEOUT_MS);
+    }
+    else
+    {
+        return err;
+    }
+
+    // Step 5: 冷启动且自动配置成功、基线已稳定时保存校准数据
+    if (!result.warm && result.saved)
+    {
+        result.saved = false;
+        if (result.settled && cfg->storage != NULL && cfg->storage->save != NULL)
+        {
+            ESP_RETURN_ON_ERROR(mpr121_calib_capture(dev, &blob), TAG, "Capture calibration failed");
+            err = cfg->storage->save(cfg->storage->ctx, &blob, sizeof(blob));
+            if (err == ESP_OK)
+            {
+                result.saved = true;
+            }
+            else
+            {
+                ESP_LOGW(TAG, "Save calibration failed: %s", esp_err_to_name(err));
+            }
+        }
+    }
+
+    ESP_LOGI(TAG, "%s boot: first valid touch after %lu us (auto-config %lu us)%s",
+             result.warm ? "Warm" : "Cold", (unsigned long)result.boot_us,
+             (unsigned long)result.autocfg_us, result.saved ? ", calibration saved" : "");
+    if (info != NULL)
+    {
+        *info = result;
+    }
+    return ESP_OK;
+}
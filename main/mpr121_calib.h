@@ -0,0 +1,107 @@
+#ifndef MPR121_CALIB_H
+#define MPR121_CALIB_H
+
+#include <stdbool.h>
+#include "mpr121.h"
+
+// -------------------------- 可配置参数 --------------------------
+#define MPR121_CALIB_MAGIC 0x3132314DU         // 校准数据魔数（小端存储为"M121"）
+#define MPR121_CALIB_VERSION 1                 // 校准数据格式版本（结构变化时递增，旧数据自动失效）
+#define MPR121_CALIB_AUTOCFG_TIMEOUT_MS 200    // 等待自动配置搜索完成的超时
+#define MPR121_CALIB_SETTLE_TIMEOUT_MS 2000    // 等待基线稳定（首个有效触摸帧）的超时
+#define MPR121_CALIB_POLL_MS 2                 // 轮询间隔
+#define MPR121_CALIB_ELE_EN 0x0C               // 校准/运行时使能的电极（ELE_CFG低4位，0x0C=ELE0~ELE11）
+
+// -------------------------- 数据结构 --------------------------
+/**
+ * @brief 持久化的校准数据（自动配置得到的CDC/CDT与稳定后的基线）
+ * @note 结构按字节对齐，可直接整体写入NVS/Flash；crc覆盖crc之前的全部字节
+ */
+typedef struct
+{
+    uint32_t magic;                           // MPR121_CALIB_MAGIC
+    uint16_t version;                         // MPR121_CALIB_VERSION
+    uint16_t length;                          // sizeof(mpr121_calib_blob_t)
+    uint8_t ele_cfg;                          // 校准时的电极使能（ELE_CFG低6位）
+    uint8_t auto_cfg[5];                      // 校准时的AUTO_CFG0~AUTO_TL（配置改变时校准失效）
+    uint8_t cdc[MPR121_NUM_CHANNELS];         // CDC_0~CDC_PROX（0x5F~0x6B）
+    uint8_t cdt[7];                           // CDT_0_1~CDT_PROX（0x6C~0x72）
+    uint8_t baseline[MPR121_NUM_CHANNELS];    // BASELINE_0~BASELINE_PROX（0x1E~0x2A）
+    uint8_t reserved;                         // 保留（填充为0）
+    uint32_t crc;                             // CRC-32（IEEE 802.3）
+} mpr121_calib_blob_t;
+
+/**
+ * @brief 校准数据存储回调（由用户实现，如NVS blob或Flash分区）
+ */
+typedef struct
+{
+    esp_err_t (*load)(void *ctx, void *buf, size_t len);       // 读取len字节；无数据时返回ESP_ERR_NOT_FOUND
+    esp_err_t (*save)(void *ctx, const void *buf, size_t len); // 保存len字节
+    void *ctx;                                                 // 传递给回调的上下文
+} mpr121_calib_storage_t;
+
+/**
+ * @brief 启动配置
+ */
+typedef struct
+{
+    uint16_t vdd_mv;                        // 供电电压（mV），用于计算AUTO_USL/LSL/TL
+    const mpr121_calib_storage_t *storage;  // 存储回调（NULL=每次冷启动且不保存）
+} mpr121_calib_config_t;
+
+/**
+ * @brief 启动结果
+ */
+typedef struct
+{
+    bool warm;           // true: 恢复已保存的校准，跳过自动配置搜索
+    bool saved;          // 本次冷启动的校准结果已保存
+    bool settled;        // 超时前已得到首个有效触摸帧
+    uint32_t autocfg_us; // 自动配置搜索耗时（热启动为0）
+    uint32_t boot_us;    // 启动到首个有效触摸帧的耗时（含复位）
+} mpr121_calib_boot_info_t;
+
+// -------------------------- 函数接口 --------------------------
+/**
+ * @brief 带自动配置的初始化（可替代mpr121_init()）
+ *
+ * 冷启动：软复位，按供电电压配置AUTO_USL/LSL/TL并使能ACE，进入运行模式触发自动配置搜索，
+ * 搜索完成后关闭ACE（此后的待机→运行切换不再重新搜索、不重载基线），
+ * 等待基线稳定后将CDC/CDT与基线保存为校准数据。
+ * 热启动：校验已保存的数据（魔数、版本、长度、CRC及自动配置参数），待机模式下写回CDC/CDT与基线，
+ * 关闭ACE并以CL=00进入运行模式（保留写入的基线），跳过搜索与基线收敛。
+ * 校准数据无效或不存在时自动回退到冷启动。
+ * @param dev 设备句柄
+ * @param cfg 启动配置
+ * @param[out] info 启动结果（可为NULL）
+ * @return esp_err_t ESP_OK: 初始化成功（自动配置失败或基线未稳定时仍可工作，此时不保存）；其他: I2C通信失败
+ */
+esp_err_t mpr121_calib_boot(mpr121_dev_t *dev, const mpr121_calib_config_t *cfg, mpr121_calib_boot_info_t *info);
+
+/**
+ * @brief 轮询直到自动配置写出前electrodes个电极的CDC，或OORSTATUS_H.ACFF置位
+ * @note 搜索完成以CDC非0判断：进入运行模式前须在待机模式下将这些电极的CDC清零
+ * @param dev 设备句柄
+ * @param electrodes 需等待的电极数（ELE0起，超过12按12处理）
+ * @return esp_err_t ESP_OK: 配置完成；ESP_FAIL: 自动配置失败（ACFF）；ESP_ERR_TIMEOUT: 超时；其他: 读取失败
+ */
+esp_err_t mpr121_calib_wait_autoconfig(mpr121_dev_t *dev, uint8_t electrodes);
+
+/**
+ * @brief 从芯片读取当前CDC/CDT与基线，生成校准数据（两次块读）
+ * @param dev 设备句柄
+ * @param[out] blob 校准数据（已填写校验字段）
+ * @return esp_err_t ESP_OK: 读取成功；其他: 读取失败
+ */
+esp_err_t mpr121_calib_capture(mpr121_dev_t *dev, mpr121_calib_blob_t *blob);
+
+/**
+ * @brief 检查校准数据是否完整，且与当前影子缓存中的自动配置参数一致
+ * @param dev 设备句柄
+ * @param blob 校准数据
+ * @return true: 可用于热启动；false: 无效
+ */
+bool mpr121_calib_valid(mpr121_dev_t *dev, const mpr121_calib_blob_t *blob);
+
+#endif // MPR121_CALIB_H
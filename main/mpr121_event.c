@@ -0,0 +1,156 @@
+#include "mpr121_event.h"
+#include "mpr121_stats.h"
+#include <string.h>
+#include <esp_attr.h>
+#include <esp_timer.h>
+
+_Static_assert((MPR121_IRQ_RING_SIZE & (MPR121_IRQ_RING_SIZE - 1)) == 0, "IRQ ring size must be a power of 2");
+_Static_assert((MPR121_EVENT_RING_SIZE & (MPR121_EVENT_RING_SIZE - 1)) == 0, "Event ring size must be a power of 2");
+
+// -------------------------- 静态辅助函数（仅内部使用） --------------------------
+/**
+ * @brief 写入一个事件（生产者：采集任务），环满时丢弃并计数
+ * @param pipe 事件管线
+ * @param event 事件
+ */
+static void event_push(mpr121_event_pipe_t *pipe, const mpr121_touch_event_t *event)
+{
+    unsigned head = atomic_load_explicit(&pipe->ev_head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&pipe->ev_tail, memory_order_acquire);
+    if (head - tail >= MPR121_EVENT_RING_SIZE)
+    {
+        pipe->ev_overflows++;
+        return;
+    }
+    pipe->events[head & (MPR121_EVENT_RING_SIZE - 1)] = *event;
+    atomic_store_explicit(&pipe->ev_head, head + 1, memory_order_release);
+}
+
+// -------------------------- 外部接口实现 --------------------------
+esp_err_t mpr121_event_pipe_init(mpr121_event_pipe_t *pipe, mpr121_dev_t *dev)
+{
+    if (pipe == NULL || dev == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(pipe, 0, sizeof(*pipe));
+    pipe->dev = dev;
+    return ESP_OK;
+}
+
+void mpr121_event_pipe_set_health(mpr121_event_pipe_t *pipe, mpr121_health_t *health)
+{
+    pipe->health = health;
+}
+
+void IRAM_ATTR mpr121_event_irq_from_isr(mpr121_event_pipe_t *pipe)
+{
+    unsigned head = atomic_load_explicit(&pipe->irq_head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&pipe->irq_tail, memory_order_acquire);
+    if (head - tail >= MPR121_IRQ_RING_SIZE)
+    {
+        atomic_fetch_add_explicit(&pipe->irq_overflows, 1, memory_order_relaxed);
+        return;
+    }
+    pipe->irq_ts[head & (MPR121_IRQ_RING_SIZE - 1)] = esp_timer_get_time();
+    atomic_store_explicit(&pipe->irq_head, head + 1, memory_order_release);
+}
+
+esp_err_t mpr121_event_process(mpr121_event_pipe_t *pipe)
+{
+    if (pipe == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    unsigned tail = atomic_load_explicit(&pipe->irq_tail, memory_order_relaxed);
+    unsigned head = atomic_load_explicit(&pipe->irq_head, memory_order_acquire);
+    while (tail != head)
+    {
+        int64_t irq_ts = pipe->irq_ts[tail & (MPR121_IRQ_RING_SIZE - 1)];
+        uint16_t mask = 0;
+        // 每个IRQ对应一次状态读取（读取后MPR121释放IRQ引脚），读取失败时保留该IRQ待下次重试
+        esp_err_t err;
+        if (pipe->health != NULL)
+        {
+            // 超范围与过流标志随同一次突发读取获得，无需额外事务
+            mpr121_status_t status;
+            err = mpr121_read_status(pipe->dev, &status);
+            if (err == ESP_OK)
+            {
+                mpr121_health_update(pipe->health, &status); // 处理失败已写入跟踪记录，不影响事件生成
+                mask = mpr121_health_mask(pipe->health, status.touch);
+            }
+        }
+        else
+        {
+            err = mpr121_read_touch(pipe->dev, &mask);
+        }
+        if (err != ESP_OK)
+        {
+            return err; // 失败已写入跟踪记录，热路径不做格式化输出
+        }
+        tail++;
+        atomic_store_explicit(&pipe->irq_tail, tail, memory_order_release);
+        pipe->irqs++;
+        MPR121_STATS_IRQ_LATENCY(esp_timer_get_time() - irq_ts);
+
+        uint16_t changed = mask ^ pipe->last_mask;
+        pipe->last_mask = mask;
+        if (changed == 0)
+        {
+            continue;
+        }
+
+        int64_t now = esp_timer_get_time();
+        uint32_t latency = (uint32_t)(now - irq_ts);
+        while (changed)
+        {
+            uint8_t ele = __builtin_ctz(changed);
+            changed &= changed - 1;
+            mpr121_touch_event_t event = {
+                .timestamp_us = irq_ts,
+                .latency_us = latency,
+                .electrode = ele,
+                .type = (mask & (1 << ele)) ? MPR121_EVENT_PRESS : MPR121_EVENT_RELEASE,
+            };
+            event_push(pipe, &event);
+            pipe->event_count++;
+            pipe->latency_sum_us += latency;
+            if (latency > pipe->latency_max_us)
+            {
+                pipe->latency_max_us = latency;
+            }
+        }
+    }
+    return ESP_OK;
+}
+
+bool mpr121_event_pop(mpr121_event_pipe_t *pipe, mpr121_touch_event_t *event)
+{
+    unsigned tail = atomic_load_explicit(&pipe->ev_tail, memory_order_relaxed);
+    unsigned head = atomic_load_explicit(&pipe->ev_head, memory_order_acquire);
+    if (tail == head)
+    {
+        return false;
+    }
+    *event = pipe->events[tail & (MPR121_EVENT_RING_SIZE - 1)];
+    atomic_store_explicit(&pipe->ev_tail, tail + 1, memory_order_release);
+    return true;
+}
+
+void mpr121_event_get_stats(mpr121_event_pipe_t *pipe, mpr121_event_stats_t *stats)
+{
+    if (pipe == NULL || stats == NULL)
+    {
+        return;
+    }
+
+    stats->irqs = pipe->irqs;
+    stats->events = pipe->event_count;
+    stats->irq_overflows = atomic_load_explicit(&pipe->irq_overflows, memory_order_relaxed);
+    stats->event_overflows = pipe->ev_overflows;
+    stats->latency_avg_us = pipe->event_count ? (uint32_t)(pipe->latency_sum_us / pipe->event_count) : 0;
+    stats->latency_max_us = pipe->latency_max_us;
+}
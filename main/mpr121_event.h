@@ -0,0 +1,120 @@
+#ifndef MPR121_EVENT_H
+#define MPR121_EVENT_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include "mpr121.h"
+#include "mpr121_health.h"
+
+// -------------------------- 可配置参数 --------------------------
+#define MPR121_IRQ_RING_SIZE 32   // IRQ时间戳环形缓冲容量（必须为2的幂）
+#define MPR121_EVENT_RING_SIZE 64 // 触摸事件环形缓冲容量（必须为2的幂）
+
+// -------------------------- 数据结构 --------------------------
+/**
+ * @brief 触摸事件类型
+ */
+typedef enum
+{
+    MPR121_EVENT_PRESS = 0,   // 电极按下
+    MPR121_EVENT_RELEASE = 1, // 电极释放
+} mpr121_event_type_t;
+
+/**
+ * @brief 带时间戳的单电极边沿事件
+ */
+typedef struct
+{
+    int64_t timestamp_us; // 边沿时刻（IRQ到达时间，esp_timer时间，μs）
+    uint32_t latency_us;  // IRQ到事件生成的延迟
+    uint8_t electrode;    // 电极编号（0~11，12=ELEPROX接近电极）
+    uint8_t type;         // 事件类型（mpr121_event_type_t）
+} mpr121_touch_event_t;
+
+/**
+ * @brief 事件管线统计
+ */
+typedef struct
+{
+    uint32_t irqs;            // 已处理的IRQ数
+    uint32_t events;          // 已生成的事件数
+    uint32_t irq_overflows;   // IRQ环满导致丢弃的时间戳数
+    uint32_t event_overflows; // 事件环满导致丢弃的事件数
+    uint32_t latency_avg_us;  // IRQ到事件平均延迟
+    uint32_t latency_max_us;  // IRQ到事件最大延迟
+} mpr121_event_stats_t;
+
+/**
+ * @brief 触摸事件管线：ISR写入IRQ时间戳（单生产者），采集任务比较相邻触摸掩码生成事件（单消费者）
+ */
+typedef struct
+{
+    mpr121_dev_t *dev;        // 设备句柄
+    mpr121_health_t *health;  // 健康监测器（NULL=仅读取触摸状态）
+
+    // IRQ时间戳SPSC环（生产者：ISR，消费者：采集任务）
+    atomic_uint irq_head;
+    atomic_uint irq_tail;
+    atomic_uint irq_overflows;
+    int64_t irq_ts[MPR121_IRQ_RING_SIZE];
+
+    // 触摸事件SPSC环（生产者：采集任务，消费者：应用任务）
+    atomic_uint ev_head;
+    atomic_uint ev_tail;
+    uint32_t ev_overflows;
+    mpr121_touch_event_t events[MPR121_EVENT_RING_SIZE];
+
+    // 采集任务私有状态
+    uint16_t last_mask;      // 上一次读取的触摸掩码
+    uint32_t irqs;           // 已处理的IRQ数
+    uint32_t event_count;    // 已生成的事件数
+    uint64_t latency_sum_us; // 延迟累计（求平均）
+    uint32_t latency_max_us; // 最大延迟
+} mpr121_event_pipe_t;
+
+// -------------------------- 函数接口 --------------------------
+/**
+ * @brief 初始化事件管线
+ * @param pipe 事件管线
+ * @param dev 已初始化的设备句柄
+ * @return esp_err_t ESP_OK: 初始化成功；ESP_ERR_INVALID_ARG: 参数无效
+ */
+esp_err_t mpr121_event_pipe_init(mpr121_event_pipe_t *pipe, mpr121_dev_t *dev);
+
+/**
+ * @brief 挂接健康监测器：此后每次IRQ以一次4字节突发读取同时获得触摸与超范围状态（多2字节），
+ *        交给监测器处理，并从触摸掩码中去除已隔离的通道
+ * @param pipe 事件管线
+ * @param health 健康监测器（NULL=取消挂接）
+ */
+void mpr121_event_pipe_set_health(mpr121_event_pipe_t *pipe, mpr121_health_t *health);
+
+/**
+ * @brief 在IRQ中断中记录时间戳（无锁，可在IRAM中断中调用）
+ * @param pipe 事件管线
+ */
+void mpr121_event_irq_from_isr(mpr121_event_pipe_t *pipe);
+
+/**
+ * @brief 处理所有待处理的IRQ：每个IRQ读取一次触摸状态，与上一次掩码比较生成按下/释放事件
+ * @param pipe 事件管线
+ * @return esp_err_t ESP_OK: 处理成功；其他: 读取触摸状态失败
+ */
+esp_err_t mpr121_event_process(mpr121_event_pipe_t *pipe);
+
+/**
+ * @brief 取出一个触摸事件（仅限单个消费者调用）
+ * @param pipe 事件管线
+ * @param[out] event 事件
+ * @return true: 取到事件；false: 无事件
+ */
+bool mpr121_event_pop(mpr121_event_pipe_t *pipe, mpr121_touch_event_t *event);
+
+/**
+ * @brief 获取事件管线统计
+ * @param pipe 事件管线
+ * @param[out] stats 统计信息
+ */
+void mpr121_event_get_stats(mpr121_event_pipe_t *pipe, mpr121_event_stats_t *stats);
+
+#endif // MPR121_EVENT_H
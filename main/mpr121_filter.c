@@ -0,0 +1,113 @@
+#include "mpr121_filter.h"
+#include <string.h>
+
+static const char *TAG = "mpr121_filter";
+
+// -------------------------- 静态辅助函数（仅内部使用） --------------------------
+static inline int32_t filter_min(int32_t a, int32_t b)
+{
+    return a < b ? a : b;
+}
+
+static inline int32_t filter_max(int32_t a, int32_t b)
+{
+    return a > b ? a : b;
+}
+
+/**
+ * @brief 三数中值（无分支，编译为min/max指令）
+ */
+static inline int32_t filter_median3(int32_t a, int32_t b, int32_t c)
+{
+    return filter_max(filter_min(a, b), filter_min(filter_max(a, b), c));
+}
+
+// -------------------------- 外部接口实现 --------------------------
+esp_err_t mpr121_filter_init(mpr121_filter_bank_t *bank, const mpr121_filter_config_t *cfg)
+{
+    if (bank == NULL || cfg == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (int ch = 0; ch < MPR121_NUM_CHANNELS; ch++)
+    {
+        uint8_t n = cfg->median_n[ch];
+        if ((n != 1 && n != 3 && n != 5) || cfg->iir_shift[ch] > MPR121_FILTER_IIR_SHIFT_MAX)
+        {
+            ESP_LOGE(TAG, "Invalid filter config for channel %d", ch);
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+
+    memset(bank, 0, sizeof(*bank));
+    for (int ch = 0; ch < MPR121_FILTER_LANES; ch++)
+    {
+        // 补齐通道按直通处理，输入恒为0
+        bool used = ch < MPR121_NUM_CHANNELS;
+        bank->median_n[ch] = used ? cfg->median_n[ch] : 1;
+        bank->iir_shift[ch] = used ? cfg->iir_shift[ch] : 0;
+        bank->slew_max[ch] = used && cfg->slew_max[ch] ? cfg->slew_max[ch] : INT16_MAX;
+    }
+    return ESP_OK;
+}
+
+void mpr121_filter_process(mpr121_filter_bank_t *bank, mpr121_frame_t *frame)
+{
+    int32_t x[MPR121_FILTER_LANES] = {0};
+    for (int ch = 0; ch < MPR121_NUM_CHANNELS; ch++)
+    {
+        x[ch] = frame->filtered[ch];
+    }
+
+    if (!bank->primed)
+    {
+        for (int k = 0; k < MPR121_FILTER_MEDIAN_MAX; k++)
+        {
+            memcpy(bank->hist[k], x, sizeof(x));
+        }
+        for (int ch = 0; ch < MPR121_FILTER_LANES; ch++)
+        {
+            bank->iir_acc[ch] = x[ch] << 8;
+            bank->out[ch] = x[ch];
+        }
+        bank->primed = true;
+    }
+
+    // 新样本写入环形历史，r0为最新、r4为最旧（行指针在通道循环外计算，循环体内无索引运算）
+    uint8_t pos = bank->hist_pos + 1 < MPR121_FILTER_MEDIAN_MAX ? bank->hist_pos + 1 : 0;
+    bank->hist_pos = pos;
+    memcpy(bank->hist[pos], x, sizeof(x));
+    const int32_t *r[MPR121_FILTER_MEDIAN_MAX];
+    for (int k = 0; k < MPR121_FILTER_MEDIAN_MAX; k++)
+    {
+        r[k] = bank->hist[(pos + MPR121_FILTER_MEDIAN_MAX - k) % MPR121_FILTER_MEDIAN_MAX];
+    }
+    const int32_t *restrict r0 = r[0], *restrict r1 = r[1], *restrict r2 = r[2], *restrict r3 = r[3], *restrict r4 = r[4];
+    int32_t *restrict acc = bank->iir_acc;
+    int32_t *restrict out = bank->out;
+
+    // 一次遍历全部通道：中值 → IIR → 限摆，逐通道参数以select代替分支
+    for (int ch = 0; ch < MPR121_FILTER_LANES; ch++)
+    {
+        int32_t a = r0[ch], b = r1[ch], c = r2[ch], d = r3[ch], e = r4[ch];
+        int32_t m3 = filter_median3(a, b, c);
+        int32_t m5 = filter_median3(e, filter_max(filter_min(a, b), filter_min(c, d)),
+                                    filter_min(filter_max(a, b), filter_max(c, d)));
+        int32_t n = bank->median_n[ch];
+        int32_t m = n == 5 ? m5 : (n == 3 ? m3 : a);
+
+        int32_t y_q8 = acc[ch] + (((m << 8) - acc[ch]) >> bank->iir_shift[ch]);
+        acc[ch] = y_q8;
+        int32_t y = (y_q8 + 128) >> 8;
+
+        int32_t prev = out[ch];
+        int32_t slew = bank->slew_max[ch];
+        out[ch] = filter_min(filter_max(y, prev - slew), prev + slew);
+    }
+
+    for (int ch = 0; ch < MPR121_NUM_CHANNELS; ch++)
+    {
+        frame->filtered[ch] = (uint16_t)out[ch];
+        frame->delta[ch] = (int16_t)(((int32_t)frame->baseline[ch] << 2) - out[ch]);
+    }
+}
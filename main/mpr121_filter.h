@@ -0,0 +1,57 @@
+#ifndef MPR121_FILTER_H
+#define MPR121_FILTER_H
+
+#include <stdbool.h>
+#include "mpr121.h"
+
+// -------------------------- 可配置参数 --------------------------
+#define MPR121_FILTER_LANES 16      // 状态数组宽度（13通道补齐到16，循环可按SIMD宽度展开，补齐通道恒为0）
+#define MPR121_FILTER_MEDIAN_MAX 5  // 中值滤波最大窗口（支持1/3/5）
+#define MPR121_FILTER_IIR_SHIFT_MAX 8 // IIR系数上限：y += (x-y)>>k，k=0为直通
+
+// -------------------------- 数据结构 --------------------------
+/**
+ * @brief 滤波器组配置（逐通道，ELE0~ELE11 + ELEPROX）
+ *
+ * 处理顺序：中值（去除尖峰）→ 定点IIR（平滑噪声）→ 限摆（限制每帧变化量）。
+ */
+typedef struct
+{
+    uint8_t median_n[MPR121_NUM_CHANNELS];   // 中值窗口（1=不滤波，3或5）
+    uint8_t iir_shift[MPR121_NUM_CHANNELS];  // IIR系数k（0=不滤波，最大MPR121_FILTER_IIR_SHIFT_MAX）
+    uint16_t slew_max[MPR121_NUM_CHANNELS];  // 每帧最大变化量（10位数据单位，0=不限）
+} mpr121_filter_config_t;
+
+/**
+ * @brief 滤波器组状态（结构数组布局：每个字段为全部通道的一行，一次遍历更新所有通道）
+ */
+typedef struct
+{
+    int32_t hist[MPR121_FILTER_MEDIAN_MAX][MPR121_FILTER_LANES]; // 中值历史（环形，按行存放）
+    int32_t iir_acc[MPR121_FILTER_LANES];   // IIR累加器（Q8）
+    int32_t out[MPR121_FILTER_LANES];       // 上一帧输出（限摆参考）
+    int32_t median_n[MPR121_FILTER_LANES];  // 中值窗口
+    int32_t iir_shift[MPR121_FILTER_LANES]; // IIR系数
+    int32_t slew_max[MPR121_FILTER_LANES];  // 限摆幅度（不限时为INT16_MAX）
+    uint8_t hist_pos;                       // 最新样本所在行
+    bool primed;                            // 已用首帧初始化状态
+} mpr121_filter_bank_t;
+
+// -------------------------- 函数接口 --------------------------
+/**
+ * @brief 初始化滤波器组（状态在首帧时以该帧数据填充，无启动瞬态）
+ * @param bank 滤波器组
+ * @param cfg 配置
+ * @return esp_err_t ESP_OK: 初始化成功；ESP_ERR_INVALID_ARG: 配置无效
+ */
+esp_err_t mpr121_filter_init(mpr121_filter_bank_t *bank, const mpr121_filter_config_t *cfg);
+
+/**
+ * @brief 用一帧数据更新全部通道（纯定点、无分支的逐通道循环，可自动向量化）
+ * @note 就地替换frame的filtered为软件滤波结果，并按原基线重新计算delta
+ * @param bank 滤波器组
+ * @param frame 帧数据（来自mpr121_read_frame()）
+ */
+void mpr121_filter_process(mpr121_filter_bank_t *bank, mpr121_frame_t *frame);
+
+#endif // MPR121_FILTER_H
@@ -0,0 +1,261 @@
+#include "mpr121_gesture.h"
+#include <string.h>
+
+static const char *TAG = "mpr121_gesture";
+
+// 每电极状态机
+enum
+{
+    GS_IDLE = 0,       // 未按下
+    GS_PRESSED,        // 第一次按下（等待释放或长按）
+    GS_TAP_PENDING,    // 短按已释放，等待双击窗口结束
+    GS_PRESSED_SECOND, // 双击窗口内第二次按下
+    GS_HELD,           // 已触发长按、按住过久或已归入滑动，等待释放
+};
+
+// -------------------------- 静态辅助函数（仅内部使用） --------------------------
+/**
+ * @brief 上报手势并更新统计
+ * @param rec 识别器
+ * @param type 手势类型
+ * @param electrode 电极编号
+ * @param span 经过的电极数
+ * @param now_us 判定时刻
+ * @param since_us 延迟计时起点
+ */
+static void gesture_emit(mpr121_gesture_recognizer_t *rec, uint8_t type, uint8_t electrode,
+                         uint8_t span, int64_t now_us, int64_t since_us)
+{
+    mpr121_gesture_t gesture = {
+        .timestamp_us = now_us,
+        .latency_us = (uint32_t)(now_us - since_us),
+        .type = type,
+        .electrode = electrode,
+        .span = span,
+    };
+    rec->stats.gestures[type]++;
+    if (gesture.latency_us > rec->stats.latency_max_us[type])
+    {
+        rec->stats.latency_max_us[type] = gesture.latency_us;
+    }
+    if (rec->cfg.callback != NULL)
+    {
+        rec->cfg.callback(&gesture, rec->cfg.user_arg);
+    }
+}
+
+/**
+ * @brief 跟踪滑动轨迹：相邻电极在swipe_step_us内依次按下即延长轨迹
+ * @param rec 识别器
+ * @param electrode 刚按下的电极
+ * @param now_us 按下时刻
+ */
+static void gesture_track_swipe(mpr121_gesture_recognizer_t *rec, uint8_t electrode, int64_t now_us)
+{
+    int8_t pos = rec->swipe_pos[electrode];
+    if (pos < 0)
+    {
+        return;
+    }
+
+    int8_t dir = pos - rec->swipe_last;
+    if (rec->swipe_last >= 0 && (dir == 1 || dir == -1) &&
+        now_us - rec->swipe_last_us <= rec->cfg.swipe_step_us)
+    {
+        if (rec->swipe_dir == 0 || rec->swipe_dir == dir)
+        {
+            rec->swipe_len++;
+        }
+        else
+        {
+            // 方向反转：以上一个电极为起点重新计数
+            rec->swipe_len = 2;
+            rec->swipe_fired = false;
+        }
+        rec->swipe_dir = dir;
+    }
+    else
+    {
+        rec->swipe_len = 1;
+        rec->swipe_dir = 0;
+        rec->swipe_fired = false;
+    }
+    rec->swipe_last = pos;
+    rec->swipe_last_us = now_us;
+
+    if (rec->swipe_fired)
+    {
+        // 已上报的滑动继续延伸：该电极归入滑动，不再产生点击
+        rec->state[electrode] = GS_HELD;
+        rec->timed_mask &= ~(1 << electrode);
+    }
+    else if (rec->swipe_len >= rec->cfg.swipe_min_electrodes)
+    {
+        rec->swipe_fired = true;
+        // 取消轨迹上尚未判定的点击/长按，避免滑动同时产生误触发；不在swipe_order中的电极不受影响
+        uint16_t timed = rec->timed_mask;
+        while (timed)
+        {
+            uint8_t e = __builtin_ctz(timed);
+            timed &= timed - 1;
+            if (rec->swipe_pos[e] < 0)
+            {
+                continue;
+            }
+            rec->state[e] = (rec->mask & (1 << e)) ? GS_HELD : GS_IDLE;
+            rec->timed_mask &= ~(1 << e);
+        }
+        gesture_emit(rec, rec->swipe_dir > 0 ? MPR121_GESTURE_SWIPE_FORWARD : MPR121_GESTURE_SWIPE_BACKWARD,
+                     electrode, rec->swipe_len, now_us, now_us);
+    }
+}
+
+// -------------------------- 外部接口实现 --------------------------
+esp_err_t mpr121_gesture_init(mpr121_gesture_recognizer_t *rec, const mpr121_gesture_config_t *cfg)
+{
+    if (rec == NULL || cfg == NULL || cfg->swipe_count > MPR121_NUM_ELECTRODES ||
+        (cfg->swipe_count > 0 && cfg->swipe_min_electrodes < 2))
+    {
+        ESP_LOGE(TAG, "Invalid gesture config");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(rec, 0, sizeof(*rec));
+    rec->cfg = *cfg;
+    memset(rec->swipe_pos, -1, sizeof(rec->swipe_pos));
+    for (int i = 0; i < cfg->swipe_count; i++)
+    {
+        if (cfg->swipe_order[i] >= MPR121_NUM_ELECTRODES)
+        {
+            ESP_LOGE(TAG, "Invalid swipe electrode: %d", cfg->swipe_order[i]);
+            return ESP_ERR_INVALID_ARG;
+        }
+        rec->swipe_pos[cfg->swipe_order[i]] = i;
+    }
+    rec->swipe_last = -1;
+    return ESP_OK;
+}
+
+void mpr121_gesture_edge(mpr121_gesture_recognizer_t *rec, uint8_t electrode, bool pressed, int64_t timestamp_us)
+{
+    if (electrode >= MPR121_NUM_ELECTRODES)
+    {
+        return;
+    }
+
+    uint16_t bit = 1 << electrode;
+    uint8_t *state = &rec->state[electrode];
+    rec->stats.edges++;
+
+    if (pressed)
+    {
+        rec->mask |= bit;
+        if (*state == GS_TAP_PENDING && timestamp_us - rec->release_us[electrode] <= rec->cfg.double_tap_gap_us)
+        {
+            *state = GS_PRESSED_SECOND;
+        }
+        else
+        {
+            if (*state == GS_TAP_PENDING)
+            {
+                // 双击窗口已过但尚未tick：先补报单击
+                gesture_emit(rec, MPR121_GESTURE_TAP, electrode, 1, timestamp_us, rec->release_us[electrode]);
+            }
+            *state = GS_PRESSED;
+        }
+        rec->press_us[electrode] = timestamp_us;
+        rec->timed_mask |= bit;
+        gesture_track_swipe(rec, electrode, timestamp_us);
+        return;
+    }
+
+    rec->mask &= ~bit;
+    int64_t held_us = timestamp_us - rec->press_us[electrode];
+    bool short_press = held_us <= rec->cfg.tap_max_us;
+    if (*state == GS_PRESSED && short_press)
+    {
+        *state = GS_TAP_PENDING;
+        rec->release_us[electrode] = timestamp_us;
+        return;
+    }
+    if (*state == GS_PRESSED_SECOND && short_press)
+    {
+        gesture_emit(rec, MPR121_GESTURE_DOUBLE_TAP, electrode, 1, timestamp_us, timestamp_us);
+    }
+    else if (*state == GS_PRESSED || *state == GS_PRESSED_SECOND)
+    {
+        if (*state == GS_PRESSED_SECOND)
+        {
+            // 第二次按下不构成双击：第一次点击单独成立
+            gesture_emit(rec, MPR121_GESTURE_TAP, electrode, 1, timestamp_us, rec->release_us[electrode]);
+        }
+        if (held_us >= rec->cfg.long_press_us)
+        {
+            // 按住期间未经tick：释放时补报长按
+            gesture_emit(rec, MPR121_GESTURE_LONG_PRESS, electrode, 1, timestamp_us,
+                         rec->press_us[electrode] + rec->cfg.long_press_us);
+        }
+    }
+    *state = GS_IDLE;
+    rec->timed_mask &= ~bit;
+}
+
+void mpr121_gesture_feed_mask(mpr121_gesture_recognizer_t *rec, uint16_t mask, int64_t timestamp_us)
+{
+    mask &= 0x0FFF;
+    uint16_t changed = mask ^ rec->mask;
+    while (changed)
+    {
+        uint8_t e = __builtin_ctz(changed);
+        changed &= changed - 1;
+        mpr121_gesture_edge(rec, e, (mask >> e) & 1, timestamp_us);
+    }
+}
+
+void mpr121_gesture_tick(mpr121_gesture_recognizer_t *rec, int64_t now_us)
+{
+    uint16_t timed = rec->timed_mask;
+    while (timed)
+    {
+        uint8_t e = __builtin_ctz(timed);
+        timed &= timed - 1;
+
+        if (rec->state[e] == GS_PRESSED_SECOND && now_us - rec->press_us[e] > rec->cfg.tap_max_us)
+        {
+            // 第二次按下已超过单击时长，不构成双击：第一次点击单独成立，此后按普通按下处理（可成为长按）
+            rec->state[e] = GS_PRESSED;
+            gesture_emit(rec, MPR121_GESTURE_TAP, e, 1, now_us, rec->release_us[e]);
+        }
+        switch (rec->state[e])
+        {
+        case GS_PRESSED:
+        case GS_PRESSED_SECOND:
+            if (now_us - rec->press_us[e] >= rec->cfg.long_press_us)
+            {
+                rec->state[e] = GS_HELD;
+                rec->timed_mask &= ~(1 << e);
+                gesture_emit(rec, MPR121_GESTURE_LONG_PRESS, e, 1, now_us, rec->press_us[e] + rec->cfg.long_press_us);
+            }
+            break;
+        case GS_TAP_PENDING:
+            if (now_us - rec->release_us[e] > rec->cfg.double_tap_gap_us)
+            {
+                rec->state[e] = GS_IDLE;
+                rec->timed_mask &= ~(1 << e);
+                gesture_emit(rec, MPR121_GESTURE_TAP, e, 1, now_us, rec->release_us[e]);
+            }
+            break;
+        default:
+            rec->timed_mask &= ~(1 << e);
+            break;
+        }
+    }
+}
+
+void mpr121_gesture_get_stats(const mpr121_gesture_recognizer_t *rec, mpr121_gesture_stats_t *stats)
+{
+    if (rec != NULL && stats != NULL)
+    {
+        *stats = rec->stats;
+    }
+}
@@ -0,0 +1,124 @@
+#ifndef MPR121_GESTURE_H
+#define MPR121_GESTURE_H
+
+#include <stdbool.h>
+#include "mpr121.h"
+
+// -------------------------- 数据结构 --------------------------
+/**
+ * @brief 手势类型
+ */
+typedef enum
+{
+    MPR121_GESTURE_TAP = 0,        // 单击
+    MPR121_GESTURE_DOUBLE_TAP,     // 双击
+    MPR121_GESTURE_LONG_PRESS,     // 长按（按住期间达到阈值即由tick触发，无需等待释放；其间未tick则释放时补报）
+    MPR121_GESTURE_SWIPE_FORWARD,  // 沿swipe_order正方向滑动
+    MPR121_GESTURE_SWIPE_BACKWARD, // 沿swipe_order反方向滑动
+    MPR121_GESTURE_TYPE_MAX,
+} mpr121_gesture_type_t;
+
+/**
+ * @brief 识别出的手势
+ */
+typedef struct
+{
+    int64_t timestamp_us; // 手势判定时刻
+    uint32_t latency_us;  // 从决定性边沿（或计时起点）到判定的延迟
+    uint8_t type;         // 手势类型（mpr121_gesture_type_t）
+    uint8_t electrode;    // 电极编号（滑动为最后经过的电极）
+    uint8_t span;         // 滑动经过的电极数（其他手势为1）
+} mpr121_gesture_t;
+
+/**
+ * @brief 手势回调（在调用edge/tick的任务上下文中执行，应尽快返回）
+ */
+typedef void (*mpr121_gesture_cb_t)(const mpr121_gesture_t *gesture, void *arg);
+
+/**
+ * @brief 手势识别配置（时间单位均为μs）
+ */
+typedef struct
+{
+    uint32_t tap_max_us;                        // 按下持续时间不超过此值视为点击
+    uint32_t double_tap_gap_us;                 // 两次点击之间的最大间隔（单击需等待该窗口结束后判定）
+    uint32_t long_press_us;                     // 按住超过此值触发长按
+    uint32_t swipe_step_us;                     // 滑动中相邻电极按下的最大间隔
+    uint8_t swipe_min_electrodes;               // 判定为滑动所需经过的最少电极数（>=2）
+    uint8_t swipe_order[MPR121_NUM_ELECTRODES]; // 滑动方向上的电极物理顺序
+    uint8_t swipe_count;                        // swipe_order中的电极数（0=不识别滑动）
+    mpr121_gesture_cb_t callback;               // 手势回调
+    void *user_arg;                             // 回调参数
+} mpr121_gesture_config_t;
+
+/**
+ * @brief 识别统计
+ */
+typedef struct
+{
+    uint32_t edges;                                   // 输入边沿数
+    uint32_t gestures[MPR121_GESTURE_TYPE_MAX];       // 各类手势计数
+    uint32_t latency_max_us[MPR121_GESTURE_TYPE_MAX]; // 各类手势最大判定延迟
+} mpr121_gesture_stats_t;
+
+/**
+ * @brief 手势识别器（静态分配，每个边沿O(1)处理）
+ */
+typedef struct
+{
+    mpr121_gesture_config_t cfg;
+    uint8_t state[MPR121_NUM_ELECTRODES];           // 每电极状态机
+    int64_t press_us[MPR121_NUM_ELECTRODES];        // 最近一次按下时刻
+    int64_t release_us[MPR121_NUM_ELECTRODES];      // 最近一次释放时刻
+    int8_t swipe_pos[MPR121_NUM_ELECTRODES];        // 电极在swipe_order中的位置（-1=不参与滑动）
+    uint16_t mask;                                  // 当前按下掩码
+    uint16_t timed_mask;                            // 有计时任务的电极（按住等待长按/等待双击窗口）
+    int8_t swipe_last;                              // 滑动轨迹中最后一个电极的位置（-1=无）
+    int8_t swipe_dir;                               // 滑动方向（+1/-1，0=未定）
+    uint8_t swipe_len;                              // 当前滑动轨迹长度
+    bool swipe_fired;                               // 当前轨迹是否已上报
+    int64_t swipe_last_us;                          // 轨迹最后一次按下时刻
+    mpr121_gesture_stats_t stats;                   // 统计
+} mpr121_gesture_recognizer_t;
+
+// -------------------------- 函数接口 --------------------------
+/**
+ * @brief 初始化手势识别器
+ * @param rec 识别器
+ * @param cfg 配置
+ * @return esp_err_t ESP_OK: 初始化成功；ESP_ERR_INVALID_ARG: 配置无效
+ */
+esp_err_t mpr121_gesture_init(mpr121_gesture_recognizer_t *rec, const mpr121_gesture_config_t *cfg);
+
+/**
+ * @brief 输入单个电极边沿
+ * @param rec 识别器
+ * @param electrode 电极编号（0~11）
+ * @param pressed true=按下，false=释放
+ * @param timestamp_us 边沿时刻
+ */
+void mpr121_gesture_edge(mpr121_gesture_recognizer_t *rec, uint8_t electrode, bool pressed, int64_t timestamp_us);
+
+/**
+ * @brief 输入完整触摸掩码，与上一次掩码比较后逐个边沿处理
+ * @param rec 识别器
+ * @param mask 触摸掩码（bit0~bit11）
+ * @param timestamp_us 掩码采样时刻
+ */
+void mpr121_gesture_feed_mask(mpr121_gesture_recognizer_t *rec, uint16_t mask, int64_t timestamp_us);
+
+/**
+ * @brief 推进时间，判定依赖超时的手势（长按、单击窗口结束、双击窗口内的第二次按下超过单击时长）
+ * @param rec 识别器
+ * @param now_us 当前时刻
+ */
+void mpr121_gesture_tick(mpr121_gesture_recognizer_t *rec, int64_t now_us);
+
+/**
+ * @brief 获取识别统计
+ * @param rec 识别器
+ * @param[out] stats 统计信息
+ */
+void mpr121_gesture_get_stats(const mpr121_gesture_recognizer_t *rec, mpr121_gesture_stats_t *stats);
+
+#endif // MPR121_GESTURE_H
@@ -0,0 +1,264 @@
+#include "mpr121_gpio.h"
+#include <string.h>
+
+static const char *TAG = "mpr121_gpio";
+
+#define GPIO_CFG_LEN (MPR121_GPIO_EN - MPR121_GPIO_CTRL0 + 1)    // CTRL0/CTRL1/DATA/DIR/EN
+#define GPIO_OUT_LEN (MPR121_GPIO_TOGGLE - MPR121_GPIO_SET + 1)  // SET/CLEAR/TOGGLE
+
+/**
+ * @brief 各模式对应的CTL0/CTL1/DIR/EN位值
+ */
+static const struct
+{
+    uint8_t ctl0, ctl1, dir, en;
+} s_gpio_mode_bits[MPR121_GPIO_MODE_MAX] = {
+    [MPR121_GPIO_DISABLED] = {0, 0, 0, 0},
+    [MPR121_GPIO_INPUT] = {0, 0, 0, 1},
+    [MPR121_GPIO_INPUT_PULLDOWN] = {1, 0, 0, 1},
+    [MPR121_GPIO_INPUT_PULLUP] = {1, 1, 0, 1},
+    [MPR121_GPIO_OUTPUT] = {0, 0, 1, 1},
+    [MPR121_GPIO_OUTPUT_HIGH_SIDE] = {1, 1, 1, 1},
+    [MPR121_GPIO_OUTPUT_LOW_SIDE] = {1, 0, 1, 1},
+};
+
+// -------------------------- 静态辅助函数（仅内部使用） --------------------------
+/**
+ * @brief 合并待写入变化后的输出电平
+ */
+static uint8_t gpio_effective_level(const mpr121_gpio_t *gpio)
+{
+    return ((gpio->level | gpio->pend_set) & ~gpio->pend_clear) ^ gpio->pend_toggle;
+}
+
+static void gpio_stage_set(mpr121_gpio_t *gpio, uint8_t pins)
+{
+    gpio->pend_set |= pins;
+    gpio->pend_clear &= ~pins;
+    gpio->pend_toggle &= ~pins;
+}
+
+static void gpio_stage_clear(mpr121_gpio_t *gpio, uint8_t pins)
+{
+    gpio->pend_clear |= pins;
+    gpio->pend_set &= ~pins;
+    gpio->pend_toggle &= ~pins;
+}
+
+/**
+ * @brief ELE_EN与ELEPROX_EN占用的电极数（GPIO仅可用于编号不小于该值的电极）
+ */
+static int gpio_electrodes_in_use(mpr121_dev_t *dev)
+{
+    static const uint8_t prox_span[4] = {0, 2, 4, 12};
+    uint8_t ecr = 0;
+
+    mpr121_cfg_get(dev, MPR121_ELE_CFG, &ecr);
+    int ele = ecr & 0x0F;
+    int prox = prox_span[(ecr >> 4) & 0x03];
+    return ele > prox ? ele : prox;
+}
+
+// -------------------------- 外部接口实现 --------------------------
+esp_err_t mpr121_gpio_init(mpr121_gpio_t *gpio, mpr121_dev_t *dev)
+{
+    if (gpio == NULL || dev == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint8_t data = 0, dir = 0, en = 0;
+    memset(gpio, 0, sizeof(*gpio));
+    gpio->dev = dev;
+    mpr121_cfg_get(dev, MPR121_GPIO_DATA, &data);
+    mpr121_cfg_get(dev, MPR121_GPIO_DIR, &dir);
+    mpr121_cfg_get(dev, MPR121_GPIO_EN, &en);
+    gpio->outputs = dir & en;
+    gpio->level = data & gpio->outputs;
+    return ESP_OK;
+}
+
+esp_err_t mpr121_gpio_config(mpr121_gpio_t *gpio, uint8_t pins, mpr121_gpio_mode_t mode, bool level)
+{
+    if (pins == 0 || mode >= MPR121_GPIO_MODE_MAX)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    int in_use = gpio_electrodes_in_use(gpio->dev);
+    if (in_use > 4 && (pins & ((1u << (in_use - 4)) - 1)))
+    {
+        ESP_LOGE(TAG, "GPIO pins 0x%02X overlap enabled electrodes (ELE0~ELE%d)", pins, in_use - 1);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // 在影子缓存中修改五个配置寄存器，再整段写入（单次事务，避免中间状态短暂出现在引脚上）
+    uint8_t regs[GPIO_CFG_LEN];
+    for (int i = 0; i < GPIO_CFG_LEN; i++)
+    {
+        mpr121_cfg_get(gpio->dev, MPR121_GPIO_CTRL0 + i, &regs[i]);
+    }
+    uint8_t *ctl0 = &regs[MPR121_GPIO_CTRL0 - MPR121_GPIO_CTRL0];
+    uint8_t *ctl1 = &regs[MPR121_GPIO_CTRL1 - MPR121_GPIO_CTRL0];
+    uint8_t *data = &regs[MPR121_GPIO_DATA - MPR121_GPIO_CTRL0];
+    uint8_t *dir = &regs[MPR121_GPIO_DIR - MPR121_GPIO_CTRL0];
+    uint8_t *en = &regs[MPR121_GPIO_EN - MPR121_GPIO_CTRL0];
+    *ctl0 = s_gpio_mode_bits[mode].ctl0 ? (*ctl0 | pins) : (*ctl0 & ~pins);
+    *ctl1 = s_gpio_mode_bits[mode].ctl1 ? (*ctl1 | pins) : (*ctl1 & ~pins);
+    *dir = s_gpio_mode_bits[mode].dir ? (*dir | pins) : (*dir & ~pins);
+    *en = s_gpio_mode_bits[mode].en ? (*en | pins) : (*en & ~pins);
+    // 其余输出引脚写入当前电平（含已合并未写出的变化），整段写入不会改变它们
+    uint8_t out_level = (gpio_effective_level(gpio) & ~pins) | (level ? pins : 0);
+    *data = (*data & ~gpio->outputs & ~pins) | (out_level & (*dir & *en));
+
+    mpr121_cfg_set_block(gpio->dev, MPR121_GPIO_CTRL0, regs, sizeof(regs));
+    ESP_RETURN_ON_ERROR(mpr121_cfg_commit_block(gpio->dev, MPR121_GPIO_CTRL0, GPIO_CFG_LEN),
+                        TAG, "Configure GPIO 0x%02X failed", pins);
+
+    gpio->outputs = *dir & *en;
+    gpio->level = *data & gpio->outputs;
+    gpio->pend_set = gpio->pend_clear = gpio->pend_toggle = 0;
+    gpio->blink_mask &= ~pins;
+    return ESP_OK;
+}
+
+void mpr121_gpio_set(mpr121_gpio_t *gpio, uint8_t pins)
+{
+    gpio->stats.updates++;
+    gpio->blink_mask &= ~pins;
+    gpio_stage_set(gpio, pins);
+}
+
+void mpr121_gpio_clear(mpr121_gpio_t *gpio, uint8_t pins)
+{
+    gpio->stats.updates++;
+    gpio->blink_mask &= ~pins;
+    gpio_stage_clear(gpio, pins);
+}
+
+void mpr121_gpio_toggle(mpr121_gpio_t *gpio, uint8_t pins)
+{
+    gpio->stats.updates++;
+    gpio->blink_mask &= ~pins;
+    // 与已合并的操作叠加：SET后翻转=CLEAR，CLEAR后翻转=SET，两次翻转=无操作
+    uint8_t was_set = gpio->pend_set & pins;
+    uint8_t was_clear = gpio->pend_clear & pins;
+    gpio->pend_set = (gpio->pend_set & ~pins) | was_clear;
+    gpio->pend_clear = (gpio->pend_clear & ~pins) | was_set;
+    gpio->pend_toggle ^= pins & ~(was_set | was_clear);
+}
+
+void mpr121_gpio_write(mpr121_gpio_t *gpio, uint8_t pins, uint8_t value)
+{
+    gpio->stats.updates++;
+    gpio->blink_mask &= ~pins;
+    gpio_stage_set(gpio, pins & value);
+    gpio_stage_clear(gpio, pins & ~value);
+}
+
+esp_err_t mpr121_gpio_blink(mpr121_gpio_t *gpio, uint8_t pins, const mpr121_gpio_blink_t *blink, int64_t now_us)
+{
+    if (blink == NULL || blink->on_ms == 0 || blink->off_ms == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (int i = 0; i < MPR121_GPIO_NUM_PINS; i++)
+    {
+        if (pins & (1u << i))
+        {
+            gpio->blink[i] = *blink;
+            gpio->blink_start_us[i] = now_us;
+        }
+    }
+    gpio->blink_mask |= pins;
+    return ESP_OK;
+}
+
+esp_err_t mpr121_gpio_flush(mpr121_gpio_t *gpio, int64_t now_us)
+{
+    // 1. 按当前时刻计算闪烁引脚应有的电平，差异合并为SET/CLEAR
+    uint8_t current = gpio_effective_level(gpio);
+    for (int i = 0; i < MPR121_GPIO_NUM_PINS; i++)
+    {
+        uint8_t bit = 1u << i;
+        if (!(gpio->blink_mask & bit))
+        {
+            continue;
+        }
+        const mpr121_gpio_blink_t *blink = &gpio->blink[i];
+        int64_t period_us = ((int64_t)blink->on_ms + blink->off_ms) * 1000;
+        int64_t elapsed_us = now_us - gpio->blink_start_us[i];
+        bool on;
+        if (blink->count && elapsed_us >= period_us * blink->count)
+        {
+            on = false;
+            gpio->blink_mask &= ~bit;
+        }
+        else
+        {
+            on = elapsed_us % period_us < (int64_t)blink->on_ms * 1000;
+        }
+        if (on != !!(current & bit))
+        {
+            on ? gpio_stage_set(gpio, bit) : gpio_stage_clear(gpio, bit);
+        }
+    }
+
+    // 2. 仅输出引脚的变化需要写入；SET/CLEAR/TOGGLE写0无副作用，非零区间合并为一次块写
+    uint8_t regs[GPIO_OUT_LEN] = {
+        gpio->pend_set & gpio->outputs,
+        gpio->pend_clear & gpio->outputs,
+        gpio->pend_toggle & gpio->outputs,
+    };
+    int first = 0, last = GPIO_OUT_LEN - 1;
+    while (first < GPIO_OUT_LEN && regs[first] == 0)
+    {
+        first++;
+    }
+    if (first == GPIO_OUT_LEN)
+    {
+        gpio->pend_set = gpio->pend_clear = gpio->pend_toggle = 0;
+        return ESP_OK;
+    }
+    while (regs[last] == 0)
+    {
+        last--;
+    }
+    ESP_RETURN_ON_ERROR(mpr121_write_regs(gpio->dev, MPR121_GPIO_SET + first, &regs[first], last - first + 1),
+                        TAG, "Write GPIO outputs failed");
+    gpio->stats.flushes++;
+    gpio->stats.transactions++;
+
+    gpio->level = gpio_effective_level(gpio) & gpio->outputs;
+    gpio->pend_set = gpio->pend_clear = gpio->pend_toggle = 0;
+
+    // 影子缓存中的DATA跟随输出电平，之后的配置块写或缓存重放不会恢复旧电平
+    uint8_t data = 0;
+    mpr121_cfg_get(gpio->dev, MPR121_GPIO_DATA, &data);
+    mpr121_cfg_set(gpio->dev, MPR121_GPIO_DATA, (data & ~gpio->outputs) | gpio->level);
+    return ESP_OK;
+}
+
+int64_t mpr121_gpio_next_edge_us(const mpr121_gpio_t *gpio, int64_t now_us)
+{
+    int64_t next = INT64_MAX;
+    for (int i = 0; i < MPR121_GPIO_NUM_PINS; i++)
+    {
+        if (!(gpio->blink_mask & (1u << i)))
+        {
+            continue;
+        }
+        const mpr121_gpio_blink_t *blink = &gpio->blink[i];
+        int64_t on_us = (int64_t)blink->on_ms * 1000;
+        int64_t period_us = on_us + (int64_t)blink->off_ms * 1000;
+        int64_t elapsed_us = now_us - gpio->blink_start_us[i];
+        int64_t phase_us = elapsed_us % period_us;
+        int64_t edge = now_us + (phase_us < on_us ? on_us - phase_us : period_us - phase_us);
+        next = edge < next ? edge : next;
+    }
+    return next;
+}
+
+esp_err_t mpr121_gpio_read(mpr121_gpio_t *gpio, uint8_t *value)
+{
+    return mpr121_read_regs(gpio->dev, MPR121_GPIO_DATA, value, 1);
+}
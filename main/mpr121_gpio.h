@@ -0,0 +1,148 @@
+#ifndef MPR121_GPIO_H
+#define MPR121_GPIO_H
+
+#include <stdbool.h>
+#include "mpr121.h"
+
+// -------------------------- 可配置参数 --------------------------
+#define MPR121_GPIO_NUM_PINS 8 // GPIO数量（ELE4~ELE11）
+#define MPR121_GPIO_PIN(ele) ((uint8_t)(1u << ((ele) - 4))) // 电极编号（4~11）转换为GPIO位掩码
+
+// -------------------------- 数据结构 --------------------------
+/**
+ * @brief GPIO模式（数据手册：CTL0/CTL1/DIR/EN组合）
+ */
+typedef enum
+{
+    MPR121_GPIO_DISABLED = 0,        // 禁用（高阻）
+    MPR121_GPIO_INPUT,               // 输入
+    MPR121_GPIO_INPUT_PULLDOWN,      // 输入，内部下拉
+    MPR121_GPIO_INPUT_PULLUP,        // 输入，内部上拉
+    MPR121_GPIO_OUTPUT,              // CMOS推挽输出
+    MPR121_GPIO_OUTPUT_HIGH_SIDE,    // 开漏高边输出（仅输出高电平，适合LED接地驱动）
+    MPR121_GPIO_OUTPUT_LOW_SIDE,     // 开漏低边输出（仅拉低，适合LED接电源驱动）
+    MPR121_GPIO_MODE_MAX,
+} mpr121_gpio_mode_t;
+
+/**
+ * @brief 闪烁模式（软件定时，在mpr121_gpio_flush()时按当前时间计算电平，无需逐次翻转唤醒任务）
+ */
+typedef struct
+{
+    uint16_t on_ms;  // 点亮时间
+    uint16_t off_ms; // 熄灭时间
+    uint16_t count;  // 闪烁次数（0=持续闪烁），结束后保持熄灭
+} mpr121_gpio_blink_t;
+
+/**
+ * @brief GPIO传输统计
+ */
+typedef struct
+{
+    uint32_t updates;      // 调用set/clear/toggle/write的次数
+    uint32_t flushes;      // 产生总线写入的flush次数
+    uint32_t transactions; // 输出写入事务数（每次flush最多1次）
+} mpr121_gpio_stats_t;
+
+/**
+ * @brief GPIO/LED子系统（单任务使用；输出变化先在本地合并，由mpr121_gpio_flush()统一写入）
+ */
+typedef struct
+{
+    mpr121_dev_t *dev;                                  // 设备句柄
+    uint8_t outputs;                                    // 已配置为输出的引脚
+    uint8_t level;                                      // 输出电平（软件视图，flush后与芯片一致）
+    uint8_t pend_set;                                   // 待写入SET的引脚
+    uint8_t pend_clear;                                 // 待写入CLEAR的引脚
+    uint8_t pend_toggle;                                // 待写入TOGGLE的引脚（三者互斥）
+    uint8_t blink_mask;                                 // 正在闪烁的引脚
+    mpr121_gpio_blink_t blink[MPR121_GPIO_NUM_PINS];    // 各引脚闪烁参数
+    int64_t blink_start_us[MPR121_GPIO_NUM_PINS];       // 各引脚闪烁起点
+    mpr121_gpio_stats_t stats;                          // 统计
+} mpr121_gpio_t;
+
+// -------------------------- 函数接口 --------------------------
+/**
+ * @brief 初始化GPIO子系统（从影子缓存取得当前GPIO配置，不访问总线）
+ * @param gpio GPIO上下文
+ * @param dev 已初始化的设备句柄
+ * @return esp_err_t ESP_OK: 初始化成功；ESP_ERR_INVALID_ARG: 参数无效
+ */
+esp_err_t mpr121_gpio_init(mpr121_gpio_t *gpio, mpr121_dev_t *dev);
+
+/**
+ * @brief 配置引脚模式：CTRL0/CTRL1/DATA/DIR/EN（0x73~0x77）以一次块写入
+ * @note 引脚对应的电极须未被ELE_EN或ELEPROX_EN占用；先写入的DATA决定输出引脚的初始电平
+ * @param gpio GPIO上下文
+ * @param pins 引脚位掩码（bit0~bit7=ELE4~ELE11）
+ * @param mode 模式
+ * @param level 输出引脚的初始电平
+ * @return esp_err_t ESP_OK: 配置成功；ESP_ERR_INVALID_ARG: 参数无效；ESP_ERR_INVALID_STATE: 引脚被电极占用；其他: 写入失败
+ */
+esp_err_t mpr121_gpio_config(mpr121_gpio_t *gpio, uint8_t pins, mpr121_gpio_mode_t mode, bool level);
+
+/**
+ * @brief 置高引脚（仅本地合并，取消这些引脚的闪烁）
+ * @param gpio GPIO上下文
+ * @param pins 引脚位掩码
+ */
+void mpr121_gpio_set(mpr121_gpio_t *gpio, uint8_t pins);
+
+/**
+ * @brief 拉低引脚（仅本地合并，取消这些引脚的闪烁）
+ * @param gpio GPIO上下文
+ * @param pins 引脚位掩码
+ */
+void mpr121_gpio_clear(mpr121_gpio_t *gpio, uint8_t pins);
+
+/**
+ * @brief 翻转引脚（仅本地合并，与已合并的SET/CLEAR叠加后仍为单一操作，取消这些引脚的闪烁）
+ * @param gpio GPIO上下文
+ * @param pins 引脚位掩码
+ */
+void mpr121_gpio_toggle(mpr121_gpio_t *gpio, uint8_t pins);
+
+/**
+ * @brief 按掩码写入电平（pins中value对应位为1的置高，为0的拉低）
+ * @param gpio GPIO上下文
+ * @param pins 引脚位掩码
+ * @param value 电平
+ */
+void mpr121_gpio_write(mpr121_gpio_t *gpio, uint8_t pins, uint8_t value);
+
+/**
+ * @brief 为引脚设置闪烁模式（从now_us开始以点亮相位起步）
+ * @param gpio GPIO上下文
+ * @param pins 引脚位掩码
+ * @param blink 闪烁参数（on_ms与off_ms均须大于0）
+ * @param now_us 当前时刻
+ * @return esp_err_t ESP_OK: 设置成功；ESP_ERR_INVALID_ARG: 参数无效
+ */
+esp_err_t mpr121_gpio_blink(mpr121_gpio_t *gpio, uint8_t pins, const mpr121_gpio_blink_t *blink, int64_t now_us);
+
+/**
+ * @brief 计算闪烁电平并写出所有合并的变化：SET/CLEAR/TOGGLE（0x78~0x7A）以最多一次块写入，写0的寄存器无副作用
+ * @note 适合每帧调用一次；无变化时不访问总线
+ * @param gpio GPIO上下文
+ * @param now_us 当前时刻（用于闪烁相位）
+ * @return esp_err_t ESP_OK: 写入成功或无变化；其他: 写入失败（待写入的变化保留，下次重试）
+ */
+esp_err_t mpr121_gpio_flush(mpr121_gpio_t *gpio, int64_t now_us);
+
+/**
+ * @brief 计算下一次闪烁电平变化的时刻（供空闲任务决定何时调用flush）
+ * @param gpio GPIO上下文
+ * @param now_us 当前时刻
+ * @return int64_t 下一次变化时刻；无闪烁引脚时返回INT64_MAX
+ */
+int64_t mpr121_gpio_next_edge_us(const mpr121_gpio_t *gpio, int64_t now_us);
+
+/**
+ * @brief 读取GPIO_DATA（输入引脚为引脚电平，输出引脚为输出寄存器值）
+ * @param gpio GPIO上下文
+ * @param[out] value 引脚电平位掩码
+ * @return esp_err_t ESP_OK: 读取成功；其他: 读取失败
+ */
+esp_err_t mpr121_gpio_read(mpr121_gpio_t *gpio, uint8_t *value);
+
+#endif // MPR121_GPIO_H
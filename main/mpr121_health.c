@@ -0,0 +1,308 @@
+#include "mpr121_health.h"
+#include "mpr121_calib.h"
+#include "mpr121_trace.h"
+#include <string.h>
+
+static const char *TAG = "mpr121_health";
+
+#define HEALTH_CDC_LEN (MPR121_CDT_PROX - MPR121_CDC_0 + 1) // CDC_0~CDT_PROX连续20字节
+#define AUTO_CFG0_ACE 0x01                                  // 进入运行模式时执行自动配置
+#define ELE_CFG_CL_10 0x80                                  // 进入运行模式时按数据高5位装载基线
+
+// -------------------------- 静态辅助函数（仅内部使用） --------------------------
+/**
+ * @brief 将影子缓存中的CDC/CDT（CDC_0~CDT_PROX）中属于通道ch的部分从src恢复
+ * @param cdc_cdt 目标（当前值）
+ * @param src 来源（保存的原值）
+ * @param ch 通道（12为ELEPROX）
+ */
+static void health_restore_channel(uint8_t *cdc_cdt, const uint8_t *src, int ch)
+{
+    cdc_cdt[ch] = src[ch];
+    int idx = MPR121_CDT_0_1 - MPR121_CDC_0 + ch / 2;
+    if (ch == MPR121_NUM_ELECTRODES)
+    {
+        cdc_cdt[idx] = src[idx]; // CDT_PROX独占一个寄存器
+        return;
+    }
+    uint8_t nibble = (ch & 1) ? 0xF0 : 0x0F; // 偶数通道D3~D0，奇数通道D7~D4
+    cdc_cdt[idx] = (cdc_cdt[idx] & ~nibble) | (src[idx] & nibble);
+}
+
+/**
+ * @brief 定向重新自动配置：芯片的自动配置对全部使能电极执行，完成后把健康电极的CDC/CDT与基线恢复为原值，
+ *        只有故障电极采用新的搜索结果
+ *
+ * 搜索前在待机模式下清零使能电极的CDC，进入运行模式后按CDC非0/ACFF轮询搜索结果。
+ * 搜索失败（ACFF）时未得到结果（CDC仍为0）的故障电极视为重新配置失败，恢复原值；超时则全部恢复原值。
+ * ACE已使能时每次进入运行模式都会对全部电极重新搜索，此时无法只保留部分结果，直接采用新结果。
+ * @param health 监测器
+ * @param failing 需要重新配置的通道
+ * @param ecr 原ELE_CFG
+ * @param auto_cfg0 原AUTO_CFG0
+ * @return esp_err_t ESP_OK: 成功；ESP_FAIL: 自动配置失败（ACFF）；ESP_ERR_TIMEOUT: 搜索超时；其他: 总线读写失败
+ */
+static esp_err_t health_reconfigure_run(mpr121_health_t *health, uint16_t failing, uint8_t ecr, uint8_t auto_cfg0)
+{
+    mpr121_dev_t *dev = health->dev;
+    uint8_t saved[HEALTH_CDC_LEN], cdc_cdt[HEALTH_CDC_LEN];
+    uint8_t base_before[MPR121_NUM_CHANNELS], base_after[MPR121_NUM_CHANNELS];
+    uint8_t electrodes = (ecr & 0x0F) > MPR121_NUM_ELECTRODES ? MPR121_NUM_ELECTRODES : (ecr & 0x0F);
+
+    for (int i = 0; i < HEALTH_CDC_LEN; i++)
+    {
+        mpr121_cfg_get(dev, MPR121_CDC_0 + i, &saved[i]);
+    }
+    bool keep_healthy = !(auto_cfg0 & AUTO_CFG0_ACE);
+    ESP_RETURN_ON_ERROR(mpr121_read_regs(dev, MPR121_BASELINE_0, base_before, sizeof(base_before)),
+                        TAG, "Read baseline failed");
+
+    // Step 1: 待机，使能ACE并清零使能电极的CDC（自动配置只在待机→运行切换时执行，CDC非0即搜索完成）
+    static const uint8_t zero[MPR121_NUM_ELECTRODES] = {0};
+    mpr121_cfg_set(dev, MPR121_ELE_CFG, 0x00);
+    mpr121_cfg_set(dev, MPR121_AUTO_CFG0, auto_cfg0 | AUTO_CFG0_ACE);
+    mpr121_cfg_set_block(dev, MPR121_CDC_0, zero, electrodes);
+    ESP_RETURN_ON_ERROR(mpr121_cfg_commit(dev), TAG, "Enter stop mode failed");
+
+    // Step 2: 进入运行模式触发搜索，CL=10按新的充电参数装载基线，等待搜索结束
+    mpr121_cfg_set(dev, MPR121_ELE_CFG, keep_healthy ? ((ecr & 0x3F) | ELE_CFG_CL_10) : ecr);
+    ESP_RETURN_ON_ERROR(mpr121_cfg_commit(dev), TAG, "Run auto-config failed");
+    esp_err_t search = mpr121_calib_wait_autoconfig(dev, electrodes);
+    if (search != ESP_OK && search != ESP_FAIL && search != ESP_ERR_TIMEOUT)
+    {
+        return search; // 总线读取失败，已写入跟踪记录
+    }
+    ESP_RETURN_ON_ERROR(mpr121_cfg_sync(dev, MPR121_CDC_0, HEALTH_CDC_LEN), TAG, "Read auto-config result failed");
+    uint16_t adopted = 0;
+    for (int ch = 0; search != ESP_ERR_TIMEOUT && ch < MPR121_NUM_CHANNELS; ch++)
+    {
+        uint8_t cdc = 0;
+        mpr121_cfg_get(dev, MPR121_CDC_0 + ch, &cdc);
+        adopted |= (cdc != 0) ? (failing & (1 << ch)) : 0;
+    }
+    for (uint16_t lost = failing & ~adopted; lost; lost &= lost - 1)
+    {
+        MPR121_TRACE(MPR121_TRACE_HEALTH, __builtin_ctz(lost), MPR121_HEALTH_ACTION_RECONFIG_FAIL, search);
+    }
+    if (!keep_healthy)
+    {
+        return search;
+    }
+
+    // Step 3: 待机后恢复健康电极（及搜索失败的电极）的CDC/CDT与基线，关闭ACE，以原ELE_CFG重新进入运行模式（CL=00保留写入的基线）
+    ESP_RETURN_ON_ERROR(mpr121_read_regs(dev, MPR121_BASELINE_0, base_after, sizeof(base_after)),
+                        TAG, "Read baseline failed");
+    for (int i = 0; i < HEALTH_CDC_LEN; i++)
+    {
+        mpr121_cfg_get(dev, MPR121_CDC_0 + i, &cdc_cdt[i]);
+    }
+    for (int ch = 0; ch < MPR121_NUM_CHANNELS; ch++)
+    {
+        if (!(adopted & (1 << ch)))
+        {
+            health_restore_channel(cdc_cdt, saved, ch);
+            base_after[ch] = base_before[ch];
+        }
+    }
+    mpr121_cfg_set_block(dev, MPR121_CDC_0, cdc_cdt, sizeof(cdc_cdt));
+    mpr121_cfg_set(dev, MPR121_AUTO_CFG0, auto_cfg0);
+    mpr121_cfg_set(dev, MPR121_ELE_CFG, 0x00);
+    ESP_RETURN_ON_ERROR(mpr121_cfg_commit(dev), TAG, "Restore healthy electrodes failed");
+    ESP_RETURN_ON_ERROR(mpr121_write_regs(dev, MPR121_BASELINE_0, base_after, sizeof(base_after)),
+                        TAG, "Restore baseline failed");
+    mpr121_cfg_set(dev, MPR121_ELE_CFG, ecr);
+    ESP_RETURN_ON_ERROR(mpr121_cfg_commit(dev), TAG, "Resume run mode failed");
+    return search;
+}
+
+/**
+ * @brief 定向重新自动配置；失败时恢复影子缓存中的ELE_CFG/AUTO_CFG0，下次提交或故障恢复时芯片回到原运行模式
+ * @param health 监测器
+ * @param failing 需要重新配置的通道
+ * @return esp_err_t ESP_OK: 成功；ESP_FAIL/ESP_ERR_TIMEOUT: 搜索失败/超时（相关电极已恢复原值）；其他: 总线读写失败
+ */
+static esp_err_t health_reconfigure(mpr121_health_t *health, uint16_t failing)
+{
+    uint8_t ecr = 0, auto_cfg0 = 0;
+    mpr121_cfg_get(health->dev, MPR121_ELE_CFG, &ecr);
+    mpr121_cfg_get(health->dev, MPR121_AUTO_CFG0, &auto_cfg0);
+    esp_err_t err = health_reconfigure_run(health, failing, ecr, auto_cfg0);
+    if (err != ESP_OK)
+    {
+        mpr121_cfg_set(health->dev, MPR121_ELE_CFG, ecr);
+        mpr121_cfg_set(health->dev, MPR121_AUTO_CFG0, auto_cfg0);
+    }
+    return err;
+}
+
+/**
+ * @brief 隔离通道
+ *
+ * ELE_EN只能使能从ELE0起连续的电极：位于已使能范围顶端的隔离通道（及ELEPROX）直接停止采样，
+ * 不再产生触摸、超范围与IRQ。其余通道只能把触摸/释放阈值设为最大，但10位delta可超过255，
+ * 芯片仍可能判定触摸并拉低IRQ——这些通道依靠mpr121_health_mask()在软件中屏蔽，IRQ风暴只是减轻而不会停止。
+ * @param health 监测器
+ * @param channels 需隔离的通道
+ * @return esp_err_t ESP_OK: 成功；其他: 提交失败
+ */
+static esp_err_t health_quarantine(mpr121_health_t *health, uint16_t channels)
+{
+    for (int ch = 0; ch < MPR121_NUM_CHANNELS; ch++)
+    {
+        if (channels & (1 << ch))
+        {
+            mpr121_cfg_set(health->dev, MPR121_TOUCH_THRESH_0 + ch * 2, 0xFF);
+            mpr121_cfg_set(health->dev, MPR121_RELEASE_THRESH_0 + ch * 2, 0xFF);
+        }
+    }
+    health->stats.quarantined |= channels;
+
+    // 从顶端收缩ELE_EN，直到最高的使能电极未被隔离
+    uint8_t ecr = 0;
+    mpr121_cfg_get(health->dev, MPR121_ELE_CFG, &ecr);
+    uint8_t ele_en = ecr & 0x0F;
+    ele_en = ele_en > MPR121_NUM_ELECTRODES ? MPR121_NUM_ELECTRODES : ele_en;
+    while (ele_en > 0 && (health->stats.quarantined & (1 << (ele_en - 1))))
+    {
+        ele_en--;
+    }
+    uint8_t prox = (health->stats.quarantined & (1 << MPR121_NUM_ELECTRODES)) ? 0 : (ecr & 0x30);
+    mpr121_cfg_set(health->dev, MPR121_ELE_CFG, (ecr & 0xC0) | prox | ele_en);
+    return mpr121_cfg_commit(health->dev);
+}
+
+/**
+ * @brief 过流处理：写1清除OVCF，芯片已自行进入待机，按缓存中的ELE_CFG恢复运行（次数有限）
+ * @param health 监测器
+ * @return esp_err_t ESP_OK: 成功或已达恢复次数上限；其他: 写入失败
+ */
+static esp_err_t health_handle_ovcf(mpr121_health_t *health)
+{
+    const uint8_t clear = MPR121_STATUS_OVCF >> 8;
+    health->stats.ovcf++;
+    MPR121_TRACE(MPR121_TRACE_HEALTH, health->ovcf_restarts, MPR121_HEALTH_ACTION_OVCF, 0);
+    ESP_RETURN_ON_ERROR(mpr121_write_regs(health->dev, MPR121_TOUCHSTATUS_H, &clear, 1), TAG, "Clear OVCF failed");
+    if (health->ovcf_restarts >= MPR121_HEALTH_OVCF_RESTARTS)
+    {
+        if (health->ovcf_restarts++ == MPR121_HEALTH_OVCF_RESTARTS)
+        {
+            ESP_LOGE(TAG, "Over-current on REXT persists, electrodes stay stopped");
+        }
+        return ESP_OK;
+    }
+    health->ovcf_restarts++;
+
+    uint8_t ecr = 0;
+    mpr121_cfg_get(health->dev, MPR121_ELE_CFG, &ecr);
+    return mpr121_write_regs(health->dev, MPR121_ELE_CFG, &ecr, 1);
+}
+
+// -------------------------- 外部接口实现 --------------------------
+esp_err_t mpr121_health_init(mpr121_health_t *health, mpr121_dev_t *dev)
+{
+    if (health == NULL || dev == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(health, 0, sizeof(*health));
+    health->dev = dev;
+    return ESP_OK;
+}
+
+esp_err_t mpr121_health_update(mpr121_health_t *health, const mpr121_status_t *status)
+{
+    esp_err_t err = ESP_OK;
+    health->stats.reads++;
+    health->stats.acff += status->acff;
+    health->stats.arff += status->arff;
+    if (status->ovcf)
+    {
+        err = health_handle_ovcf(health);
+    }
+
+    uint16_t oor = status->oor & ~health->stats.quarantined;
+    while (oor)
+    {
+        health->oor_count[__builtin_ctz(oor)]++;
+        oor &= oor - 1;
+    }
+    if (++health->window_reads < MPR121_HEALTH_WINDOW)
+    {
+        return err;
+    }
+
+    // 窗口结束：超范围比例达到阈值的通道先重新自动配置，次数用尽仍故障则隔离；一个窗口无超范围即清零次数
+    uint16_t reconfig = 0, quarantine = 0;
+    for (int ch = 0; ch < MPR121_NUM_CHANNELS; ch++)
+    {
+        uint16_t permille = health->oor_count[ch] * 1000 / MPR121_HEALTH_WINDOW;
+        health->stats.oor_permille[ch] = permille;
+        if (permille == 0)
+        {
+            health->reconfigs[ch] = 0;
+        }
+        else if (permille >= MPR121_HEALTH_OOR_PERMILLE && !(health->stats.quarantined & (1 << ch)))
+        {
+            if (health->reconfigs[ch] < MPR121_HEALTH_RECONFIG_MAX)
+            {
+                health->reconfigs[ch]++;
+                reconfig |= 1 << ch;
+                MPR121_TRACE(MPR121_TRACE_HEALTH, ch, MPR121_HEALTH_ACTION_RECONFIG, permille);
+            }
+            else
+            {
+                quarantine |= 1 << ch;
+                MPR121_TRACE(MPR121_TRACE_HEALTH, ch, MPR121_HEALTH_ACTION_QUARANTINE, permille);
+            }
+        }
+    }
+    memset(health->oor_count, 0, sizeof(health->oor_count));
+    health->window_reads = 0;
+
+    esp_err_t search = ESP_OK;
+    if (reconfig && err == ESP_OK)
+    {
+        health->stats.reconfigs++;
+        err = health_reconfigure(health, reconfig);
+        if (err == ESP_FAIL || err == ESP_ERR_TIMEOUT)
+        {
+            // 搜索失败的电极已恢复原值并保留重新配置次数，下个窗口仍故障即被隔离；不影响本窗口的隔离
+            health->stats.reconfig_failures++;
+            search = err;
+            err = ESP_OK;
+        }
+    }
+    if (quarantine && err == ESP_OK)
+    {
+        err = health_quarantine(health, quarantine);
+    }
+    return err != ESP_OK ? err : search;
+}
+
+esp_err_t mpr121_health_poll(mpr121_health_t *health, mpr121_status_t *status)
+{
+    mpr121_status_t local;
+    mpr121_status_t *st = status != NULL ? status : &local;
+    esp_err_t err = mpr121_read_status(health->dev, st);
+    if (err != ESP_OK)
+    {
+        return err; // 已写入跟踪记录
+    }
+    return mpr121_health_update(health, st);
+}
+
+uint16_t mpr121_health_mask(const mpr121_health_t *health, uint16_t touch)
+{
+    return touch & ~health->stats.quarantined;
+}
+
+void mpr121_health_get_stats(mpr121_health_t *health, mpr121_health_stats_t *stats)
+{
+    if (health == NULL || stats == NULL)
+    {
+        return;
+    }
+
+    *stats = health->stats;
+}
@@ -0,0 +1,94 @@
+#ifndef MPR121_HEALTH_H
+#define MPR121_HEALTH_H
+
+#include <stdbool.h>
+#include "mpr121.h"
+
+// -------------------------- 可配置参数 --------------------------
+#define MPR121_HEALTH_WINDOW 32          // 超范围比例统计窗口（状态读取次数）
+#define MPR121_HEALTH_OOR_PERMILLE 250   // 窗口内超范围比例达到该值（千分比）视为故障电极
+#define MPR121_HEALTH_RECONFIG_MAX 1     // 隔离前对同一电极重新自动配置的次数
+#define MPR121_HEALTH_OVCF_RESTARTS 3    // 过流后自动恢复运行模式的最多次数（之后保持待机，需排查REXT）
+
+// 跟踪记录（MPR121_TRACE_HEALTH）中的动作
+#define MPR121_HEALTH_ACTION_RECONFIG 1   // 重新自动配置（electrode=通道）
+#define MPR121_HEALTH_ACTION_QUARANTINE 2 // 隔离（electrode=通道）
+#define MPR121_HEALTH_ACTION_OVCF 3       // 过流（electrode=已恢复次数）
+#define MPR121_HEALTH_ACTION_RECONFIG_FAIL 4 // 重新自动配置失败，恢复原值（electrode=通道，value=ACFF时ESP_FAIL，超时ESP_ERR_TIMEOUT）
+
+// -------------------------- 数据结构 --------------------------
+/**
+ * @brief 健康监测统计
+ */
+typedef struct
+{
+    uint32_t reads;                                 // 已处理的状态读取次数
+    uint32_t ovcf;                                  // 过流次数
+    uint32_t acff;                                  // 读到自动配置失败标志的次数
+    uint32_t arff;                                  // 读到自动重配置失败标志的次数
+    uint32_t reconfigs;                             // 针对故障电极的重新自动配置次数
+    uint32_t reconfig_failures;                     // 重新自动配置中搜索失败（ACFF）或超时的次数
+    uint16_t quarantined;                           // 已隔离的通道（使能范围顶端的停止采样；其余阈值设为最大、由软件屏蔽）
+    uint16_t oor_permille[MPR121_NUM_CHANNELS];     // 最近一个窗口各通道的超范围比例（千分比）
+} mpr121_health_stats_t;
+
+/**
+ * @brief 芯片健康监测器：从每次状态读取中统计OOR/OVCF/ACFF/ARFF，对故障电极定向重新自动配置，
+ *        仍失败则隔离（由读取状态的任务调用，无内部任务）
+ * @note 只有位于ELE_EN使能范围顶端的电极（及ELEPROX）能真正停止采样；中间的电极只能将阈值设为最大，
+ *       delta超过255时仍会产生触摸状态变化与IRQ，须经mpr121_health_mask()屏蔽。
+ *       低功耗模式按自身记录的电极数重写ELE_CFG时，被截掉的电极会恢复采样（阈值仍为最大）
+ */
+typedef struct
+{
+    mpr121_dev_t *dev;                              // 设备句柄
+    uint16_t window_reads;                          // 当前窗口已统计的读取次数
+    uint16_t oor_count[MPR121_NUM_CHANNELS];        // 当前窗口各通道超范围次数
+    uint8_t reconfigs[MPR121_NUM_CHANNELS];         // 各通道已重新自动配置的次数
+    uint8_t ovcf_restarts;                          // 已执行的过流恢复次数
+    mpr121_health_stats_t stats;                    // 统计
+} mpr121_health_t;
+
+// -------------------------- 函数接口 --------------------------
+/**
+ * @brief 初始化健康监测器
+ * @param health 监测器
+ * @param dev 已初始化的设备句柄
+ * @return esp_err_t ESP_OK: 初始化成功；ESP_ERR_INVALID_ARG: 参数无效
+ */
+esp_err_t mpr121_health_init(mpr121_health_t *health, mpr121_dev_t *dev);
+
+/**
+ * @brief 处理一次状态读取结果：过流时清除OVCF并恢复运行模式；窗口结束时评估各通道超范围比例，
+ *        故障电极先定向重新自动配置，达到次数上限仍故障则隔离
+ * @param health 监测器
+ * @param status mpr121_read_status()的结果
+ * @return esp_err_t ESP_OK: 处理成功；ESP_FAIL/ESP_ERR_TIMEOUT: 重新自动配置搜索失败（ACFF）/超时，相关电极已恢复原值；
+ *         其他: 恢复或重新配置时总线写入失败
+ */
+esp_err_t mpr121_health_update(mpr121_health_t *health, const mpr121_status_t *status);
+
+/**
+ * @brief 读取状态并处理（用于无IRQ时的周期检查，如未使能OORIE时超范围不产生中断）
+ * @param health 监测器
+ * @param[out] status 读取到的状态（可为NULL）
+ * @return esp_err_t ESP_OK: 成功；其他: 读取或处理失败
+ */
+esp_err_t mpr121_health_poll(mpr121_health_t *health, mpr121_status_t *status);
+
+/**
+ * @brief 去除已隔离通道的触摸位（未能停止采样的隔离通道仍可能产生触摸位，触摸状态须经此过滤）
+ * @param health 监测器
+ * @param touch 触摸通道掩码
+ * @return uint16_t 过滤后的掩码
+ */
+uint16_t mpr121_health_mask(const mpr121_health_t *health, uint16_t touch);
+
+/**
+ * @brief 获取健康监测统计
+ * @param health 监测器
+ * @param[out] stats 统计信息
+ */
+void mpr121_health_get_stats(mpr121_health_t *health, mpr121_health_stats_t *stats);
+
+#endif // MPR121_HEALTH_H
@@ -0,0 +1,336 @@
+#include "mpr121_pipeline.h"
+#include <string.h>
+#include <esp_attr.h>
+#include <esp_timer.h>
+
+static const char *TAG = "mpr121_pipeline";
+
+_Static_assert((MPR121_PIPELINE_QUEUE_LEN & (MPR121_PIPELINE_QUEUE_LEN - 1)) == 0, "MPR121_PIPELINE_QUEUE_LEN must be a power of 2");
+
+#define PIPELINE_MASK (MPR121_PIPELINE_QUEUE_LEN - 1)
+#define PIPELINE_NOTIFY_TRIGGER 0x01 // 任务通知位：采集触发（IRQ）/新帧入队
+#define PIPELINE_NOTIFY_STOP 0x02    // 任务通知位：停止（任务只在收到该位后退出，停止方通知时句柄必然有效）
+
+// -------------------------- 静态辅助函数（仅内部使用） --------------------------
+/**
+ * @brief 将核编号转换为任务亲和性（单核配置或linux目标上超出核数时不绑定）
+ */
+static BaseType_t pipeline_affinity(BaseType_t core)
+{
+    return core >= 0 && core < portNUM_PROCESSORS ? core : tskNO_AFFINITY;
+}
+
+/**
+ * @brief 当前时刻低32位（延迟按32位回绕差值计算）
+ */
+static inline uint32_t pipeline_now32(void)
+{
+    return (uint32_t)esp_timer_get_time();
+}
+
+/**
+ * @brief 采集端入队（单生产者），按策略处理队列满
+ * @param pipe 流水线
+ * @param frame 新帧
+ * @param trigger_us 触发时刻
+ */
+static void pipeline_push(mpr121_pipeline_t *pipe, const mpr121_frame_t *frame, uint32_t trigger_us)
+{
+    unsigned head = atomic_load_explicit(&pipe->head, memory_order_relaxed);
+
+    if (pipe->cfg.policy != MPR121_PIPELINE_DROP_OLDEST &&
+        head - atomic_load_explicit(&pipe->tail, memory_order_acquire) >= MPR121_PIPELINE_QUEUE_LEN)
+    {
+        if (pipe->cfg.policy == MPR121_PIPELINE_BLOCK)
+        {
+            // 反压：先声明等待再复查，处理任务取走一帧后释放space信号量
+            int64_t start = esp_timer_get_time();
+            int64_t deadline = start + (int64_t)pipe->cfg.block_timeout_ms * 1000;
+            atomic_store(&pipe->producer_waiting, true);
+            while (pipe->running &&
+                   head - atomic_load(&pipe->tail) >= MPR121_PIPELINE_QUEUE_LEN)
+            {
+                int64_t remain_us = deadline - esp_timer_get_time();
+                if (remain_us <= 0)
+                {
+                    break;
+                }
+                xSemaphoreTake(pipe->space, pdMS_TO_TICKS((remain_us + 999) / 1000) + 1);
+            }
+            atomic_store(&pipe->producer_waiting, false);
+            atomic_fetch_add_explicit(&pipe->blocked_us, (unsigned)(esp_timer_get_time() - start), memory_order_relaxed);
+        }
+        if (head - atomic_load_explicit(&pipe->tail, memory_order_acquire) >= MPR121_PIPELINE_QUEUE_LEN)
+        {
+            atomic_fetch_add_explicit(&pipe->dropped_newest, 1, memory_order_relaxed);
+            return;
+        }
+    }
+
+    // DROP_OLDEST下槽可能正被处理任务读取：先作废序号，读取端据此发现被覆盖
+    mpr121_pipeline_slot_t *slot = &pipe->slots[head & PIPELINE_MASK];
+    atomic_store_explicit(&slot->seq, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    slot->trigger_us = trigger_us;
+    slot->frame = *frame;
+    atomic_store_explicit(&slot->seq, head + 1, memory_order_release);
+    atomic_store_explicit(&pipe->head, head + 1, memory_order_release);
+
+    unsigned depth = head + 1 - atomic_load_explicit(&pipe->tail, memory_order_relaxed);
+    depth = depth < MPR121_PIPELINE_QUEUE_LEN ? depth : MPR121_PIPELINE_QUEUE_LEN;
+    if (depth > atomic_load_explicit(&pipe->queue_peak, memory_order_relaxed))
+    {
+        atomic_store_explicit(&pipe->queue_peak, depth, memory_order_relaxed);
+    }
+    xTaskNotify(pipe->proc_task, PIPELINE_NOTIFY_TRIGGER, eSetBits);
+}
+
+/**
+ * @brief 处理端出队（单消费者），跳过已被覆盖的帧
+ * @param pipe 流水线
+ * @param[out] frame 帧数据
+ * @param[out] trigger_us 触发时刻
+ * @return true: 取到一帧；false: 队列为空
+ */
+static bool pipeline_pop(mpr121_pipeline_t *pipe, mpr121_frame_t *frame, uint32_t *trigger_us)
+{
+    unsigned tail = atomic_load_explicit(&pipe->tail, memory_order_relaxed);
+
+    while (1)
+    {
+        unsigned head = atomic_load_explicit(&pipe->head, memory_order_acquire);
+        if (tail == head)
+        {
+            atomic_store_explicit(&pipe->tail, tail, memory_order_release);
+            return false;
+        }
+        // 落后超过一圈（仅DROP_OLDEST）：最旧的帧已被覆盖
+        if (head - tail > MPR121_PIPELINE_QUEUE_LEN)
+        {
+            atomic_fetch_add_explicit(&pipe->dropped_oldest, head - tail - MPR121_PIPELINE_QUEUE_LEN, memory_order_relaxed);
+            tail = head - MPR121_PIPELINE_QUEUE_LEN;
+        }
+
+        mpr121_pipeline_slot_t *slot = &pipe->slots[tail & PIPELINE_MASK];
+        unsigned seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        if (seq == tail + 1)
+        {
+            *frame = slot->frame;
+            *trigger_us = slot->trigger_us;
+            atomic_thread_fence(memory_order_acquire);
+            if (atomic_load_explicit(&slot->seq, memory_order_relaxed) == seq)
+            {
+                atomic_store_explicit(&pipe->tail, tail + 1, memory_order_release);
+                if (atomic_load(&pipe->producer_waiting))
+                {
+                    xSemaphoreGive(pipe->space);
+                }
+                return true;
+            }
+        }
+        // 读取前或读取期间被新一圈覆盖
+        atomic_fetch_add_explicit(&pipe->dropped_oldest, 1, memory_order_relaxed);
+        tail++;
+    }
+}
+
+/**
+ * @brief 采集任务：等待触发（周期或IRQ）→ 读取整帧 → 入队
+ * @param arg 流水线
+ */
+static void pipeline_acq_task(void *arg)
+{
+    mpr121_pipeline_t *pipe = (mpr121_pipeline_t *)arg;
+    TickType_t last_wake = xTaskGetTickCount();
+    TickType_t period = pdMS_TO_TICKS(pipe->cfg.period_ms); // 启动时已校验为整数个tick
+    mpr121_frame_t frame;
+
+    while (1)
+    {
+        uint32_t trigger_us, bits = 0;
+        if (pipe->cfg.period_ms)
+        {
+            vTaskDelayUntil(&last_wake, period);
+            trigger_us = pipeline_now32();
+            xTaskNotifyWait(0, UINT32_MAX, &bits, 0);
+        }
+        else
+        {
+            xTaskNotifyWait(0, UINT32_MAX, &bits, portMAX_DELAY);
+            trigger_us = atomic_load_explicit(&pipe->trigger_us, memory_order_relaxed);
+        }
+        if (bits & PIPELINE_NOTIFY_STOP)
+        {
+            break;
+        }
+
+        if (mpr121_read_frame(pipe->cfg.dev, &frame) != ESP_OK)
+        {
+            atomic_fetch_add_explicit(&pipe->read_errors, 1, memory_order_relaxed);
+            continue;
+        }
+        atomic_fetch_add_explicit(&pipe->acquired, 1, memory_order_relaxed);
+        pipeline_push(pipe, &frame, trigger_us);
+    }
+
+    xSemaphoreGive(pipe->exited);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief 处理任务：等待入队通知 → 逐帧调用处理回调 → 统计延迟与吞吐量
+ * @param arg 流水线
+ */
+static void pipeline_proc_task(void *arg)
+{
+    mpr121_pipeline_t *pipe = (mpr121_pipeline_t *)arg;
+    int64_t window_start = esp_timer_get_time();
+    uint32_t window_frames = 0;
+    mpr121_frame_t frame;
+    uint32_t trigger_us;
+
+    while (1)
+    {
+        uint32_t bits = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &bits, portMAX_DELAY);
+        if (bits & PIPELINE_NOTIFY_STOP)
+        {
+            break;
+        }
+
+        while (pipeline_pop(pipe, &frame, &trigger_us))
+        {
+            pipe->cfg.process(pipe->cfg.arg, &frame);
+
+            uint32_t latency = pipeline_now32() - trigger_us;
+            pipe->latency_sum_us += latency;
+            if (latency > atomic_load_explicit(&pipe->latency_max_us, memory_order_relaxed))
+            {
+                atomic_store_explicit(&pipe->latency_max_us, latency, memory_order_relaxed);
+            }
+            atomic_fetch_add_explicit(&pipe->processed, 1, memory_order_release);
+            window_frames++;
+        }
+
+        int64_t now = esp_timer_get_time();
+        if (now - window_start >= MPR121_PIPELINE_RATE_WINDOW_US)
+        {
+            atomic_store_explicit(&pipe->fps, (unsigned)((int64_t)window_frames * 1000000 / (now - window_start)), memory_order_relaxed);
+            window_frames = 0;
+            window_start = now;
+        }
+    }
+
+    xSemaphoreGive(pipe->exited);
+    vTaskDelete(NULL);
+}
+
+// -------------------------- 外部接口实现 --------------------------
+esp_err_t mpr121_pipeline_start(mpr121_pipeline_t *pipe, const mpr121_pipeline_config_t *cfg)
+{
+    if (pipe == NULL || cfg == NULL || cfg->dev == NULL || cfg->process == NULL ||
+        cfg->policy > MPR121_PIPELINE_BLOCK)
+    {
+        ESP_LOGE(TAG, "Invalid pipeline config");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (cfg->period_ms != 0 && pdMS_TO_TICKS(cfg->period_ms) * portTICK_PERIOD_MS != cfg->period_ms)
+    {
+        ESP_LOGE(TAG, "Period %lu ms is not a whole number of %u ms ticks", (unsigned long)cfg->period_ms,
+                 (unsigned)portTICK_PERIOD_MS);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(pipe, 0, sizeof(*pipe));
+    pipe->cfg = *cfg;
+    pipe->space = xSemaphoreCreateBinary();
+    pipe->exited = xSemaphoreCreateBinary();
+    if (pipe->space == NULL || pipe->exited == NULL)
+    {
+        mpr121_pipeline_stop(pipe);
+        return ESP_ERR_NO_MEM;
+    }
+
+    // 先创建处理任务，采集任务的第一次入队通知才有接收者
+    pipe->running = true;
+    if (xTaskCreatePinnedToCore(pipeline_proc_task, "mpr121_proc", MPR121_PIPELINE_PROC_STACK, pipe,
+                                cfg->proc_prio, &pipe->proc_task, pipeline_affinity(cfg->proc_core)) != pdPASS)
+    {
+        pipe->proc_task = NULL;
+        ESP_LOGE(TAG, "Create processing task failed");
+        mpr121_pipeline_stop(pipe);
+        return ESP_ERR_NO_MEM;
+    }
+    if (xTaskCreatePinnedToCore(pipeline_acq_task, "mpr121_acq", MPR121_PIPELINE_ACQ_STACK, pipe,
+                                cfg->acq_prio, &pipe->acq_task, pipeline_affinity(cfg->acq_core)) != pdPASS)
+    {
+        pipe->acq_task = NULL;
+        ESP_LOGE(TAG, "Create acquisition task failed");
+        mpr121_pipeline_stop(pipe);
+        return ESP_ERR_NO_MEM;
+    }
+
+    ESP_LOGI(TAG, "Pipeline started: acquisition on core %d, processing on core %d, %s",
+             (int)pipeline_affinity(cfg->acq_core), (int)pipeline_affinity(cfg->proc_core),
+             cfg->period_ms ? "periodic" : "IRQ-triggered");
+    return ESP_OK;
+}
+
+esp_err_t mpr121_pipeline_stop(mpr121_pipeline_t *pipe)
+{
+    if (pipe == NULL || (pipe->space == NULL && pipe->exited == NULL))
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // 先停采集任务（可能正阻塞在反压等待或周期延时中），它退出后不再向处理任务发送入队通知；
+    // 每个任务各通知一次，等待其退出信号后再处理下一个
+    pipe->running = false;
+    if (pipe->acq_task != NULL)
+    {
+        xTaskNotify(pipe->acq_task, PIPELINE_NOTIFY_STOP, eSetBits);
+        xSemaphoreGive(pipe->space);
+        xSemaphoreTake(pipe->exited, portMAX_DELAY);
+        pipe->acq_task = NULL;
+    }
+    if (pipe->proc_task != NULL)
+    {
+        xTaskNotify(pipe->proc_task, PIPELINE_NOTIFY_STOP, eSetBits);
+        xSemaphoreTake(pipe->exited, portMAX_DELAY);
+        pipe->proc_task = NULL;
+    }
+
+    if (pipe->space != NULL)
+    {
+        vSemaphoreDelete(pipe->space);
+        pipe->space = NULL;
+    }
+    if (pipe->exited != NULL)
+    {
+        vSemaphoreDelete(pipe->exited);
+        pipe->exited = NULL;
+    }
+    return ESP_OK;
+}
+
+void IRAM_ATTR mpr121_pipeline_trigger_from_isr(mpr121_pipeline_t *pipe, BaseType_t *woken)
+{
+    atomic_store_explicit(&pipe->trigger_us, pipeline_now32(), memory_order_relaxed);
+    xTaskNotifyFromISR(pipe->acq_task, PIPELINE_NOTIFY_TRIGGER, eSetBits, woken);
+}
+
+void mpr121_pipeline_get_stats(mpr121_pipeline_t *pipe, mpr121_pipeline_stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    stats->processed = atomic_load_explicit(&pipe->processed, memory_order_acquire);
+    stats->acquired = atomic_load_explicit(&pipe->acquired, memory_order_relaxed);
+    stats->dropped_newest = atomic_load_explicit(&pipe->dropped_newest, memory_order_relaxed);
+    stats->dropped_oldest = atomic_load_explicit(&pipe->dropped_oldest, memory_order_relaxed);
+    stats->read_errors = atomic_load_explicit(&pipe->read_errors, memory_order_relaxed);
+    stats->blocked_us = atomic_load_explicit(&pipe->blocked_us, memory_order_relaxed);
+    stats->queue_peak = atomic_load_explicit(&pipe->queue_peak, memory_order_relaxed);
+    stats->fps = atomic_load_explicit(&pipe->fps, memory_order_relaxed);
+    stats->latency_max_us = atomic_load_explicit(&pipe->latency_max_us, memory_order_relaxed);
+    // latency_sum_us由处理任务更新，快照可能与processed相差一帧，仅用于平均值
+    stats->latency_avg_us = stats->processed ? (uint32_t)(pipe->latency_sum_us / stats->processed) : 0;
+}
@@ -0,0 +1,139 @@
+#ifndef MPR121_PIPELINE_H
+#define MPR121_PIPELINE_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include "mpr121.h"
+
+// -------------------------- 可配置参数 --------------------------
+#define MPR121_PIPELINE_QUEUE_LEN 8         // 帧队列容量（必须为2的幂）
+#define MPR121_PIPELINE_ACQ_STACK 3072      // 采集任务栈大小
+#define MPR121_PIPELINE_PROC_STACK 4096     // 处理任务栈大小
+#define MPR121_PIPELINE_RATE_WINDOW_US 1000000 // 吞吐量统计窗口
+
+// -------------------------- 数据结构 --------------------------
+/**
+ * @brief 队列满时的策略
+ */
+typedef enum
+{
+    MPR121_PIPELINE_DROP_NEWEST = 0, // 丢弃新帧（保留队列中较早的帧，适合需要连续历史的处理）
+    MPR121_PIPELINE_DROP_OLDEST,     // 覆盖最旧帧（处理始终拿到最新数据，适合只关心当前状态的处理）
+    MPR121_PIPELINE_BLOCK,           // 反压：采集任务等待处理任务腾出空间（超时后丢弃新帧）
+} mpr121_pipeline_policy_t;
+
+/**
+ * @brief 处理回调（在处理任务中调用，如滤波、滑条、手势）
+ * @param arg 配置中的用户参数
+ * @param frame 帧数据（回调返回后失效）
+ */
+typedef void (*mpr121_pipeline_process_t)(void *arg, const mpr121_frame_t *frame);
+
+/**
+ * @brief 流水线配置
+ */
+typedef struct
+{
+    mpr121_dev_t *dev;                  // 已初始化的设备句柄（此后仅由采集任务访问）
+    uint32_t period_ms;                 // 采集周期（须为整数个tick，见mpr121_pipeline_start()；0=由mpr121_pipeline_trigger_from_isr()触发）
+    mpr121_pipeline_policy_t policy;    // 队列满策略
+    uint32_t block_timeout_ms;          // BLOCK策略下最长等待时间
+    BaseType_t acq_core;                // 采集任务绑定的核（超出核数时不绑定）
+    BaseType_t proc_core;               // 处理任务绑定的核
+    UBaseType_t acq_prio;               // 采集任务优先级（应高于处理任务）
+    UBaseType_t proc_prio;              // 处理任务优先级
+    mpr121_pipeline_process_t process;  // 处理回调
+    void *arg;                          // 处理回调参数
+} mpr121_pipeline_config_t;
+
+/**
+ * @brief 流水线统计
+ */
+typedef struct
+{
+    uint32_t acquired;        // 成功读取的帧数
+    uint32_t processed;       // 处理完成的帧数
+    uint32_t dropped_newest;  // 队列满被丢弃的新帧（DROP_NEWEST或BLOCK超时）
+    uint32_t dropped_oldest;  // 被覆盖的旧帧（DROP_OLDEST）
+    uint32_t read_errors;     // 读取失败次数
+    uint32_t blocked_us;      // 采集任务因反压累计等待时间
+    uint32_t queue_peak;      // 队列深度峰值
+    uint32_t fps;             // 最近一个统计窗口的处理吞吐量（帧/秒）
+    uint32_t latency_avg_us;  // 端到端延迟平均值（触发到处理回调返回）
+    uint32_t latency_max_us;  // 端到端延迟最大值
+} mpr121_pipeline_stats_t;
+
+/**
+ * @brief 帧队列槽（seq=写入位置+1表示帧完整，0表示正在写入）
+ */
+typedef struct
+{
+    atomic_uint seq;        // 槽序号
+    uint32_t trigger_us;    // 触发时刻（esp_timer时间低32位，用于端到端延迟）
+    mpr121_frame_t frame;   // 帧数据
+} mpr121_pipeline_slot_t;
+
+/**
+ * @brief 采集/处理双任务流水线（采集与处理分别绑定在不同核上，经无锁单生产者单消费者队列连接）
+ */
+typedef struct
+{
+    mpr121_pipeline_config_t cfg;                             // 配置
+    TaskHandle_t acq_task;                                    // 采集任务
+    TaskHandle_t proc_task;                                   // 处理任务
+    volatile bool running;                                    // 运行标志
+    mpr121_pipeline_slot_t slots[MPR121_PIPELINE_QUEUE_LEN];  // 帧队列
+    atomic_uint head;                                         // 下一个写入位置（仅采集任务修改）
+    atomic_uint tail;                                         // 下一个读取位置（仅处理任务修改）
+    atomic_bool producer_waiting;                             // 采集任务正在等待队列空间
+    SemaphoreHandle_t space;                                  // 队列腾出空间（BLOCK策略下唤醒采集任务）
+    SemaphoreHandle_t exited;                                 // 任务退出信号（任务删除自身前释放）
+    atomic_uint trigger_us;                                   // 最近一次IRQ触发时刻（低32位）
+
+    atomic_uint acquired;                                     // 统计：成功读取帧数
+    atomic_uint processed;                                    // 统计：处理完成帧数
+    atomic_uint dropped_newest;                               // 统计：丢弃的新帧
+    atomic_uint dropped_oldest;                               // 统计：覆盖的旧帧
+    atomic_uint read_errors;                                  // 统计：读取失败
+    atomic_uint blocked_us;                                   // 统计：反压等待时间
+    atomic_uint queue_peak;                                   // 统计：队列深度峰值
+    atomic_uint fps;                                          // 统计：处理吞吐量
+    atomic_uint latency_max_us;                               // 统计：最大延迟
+    uint64_t latency_sum_us;                                  // 延迟总和（仅处理任务修改）
+} mpr121_pipeline_t;
+
+// -------------------------- 函数接口 --------------------------
+/**
+ * @brief 启动流水线：创建采集任务（高优先级，绑定acq_core）与处理任务（绑定proc_core）
+ * @note 周期采集由vTaskDelayUntil()驱动，分辨率为一个tick（portTICK_PERIOD_MS，configTICK_RATE_HZ=100时为10ms）：
+ *       period_ms须为portTICK_PERIOD_MS的整数倍，否则返回ESP_ERR_INVALID_ARG，而不是静默地按整数tick运行。
+ *       需要更高采集率时提高configTICK_RATE_HZ，或使用IRQ触发（period_ms=0）/mpr121_stream（esp_timer，μs周期）
+ * @param pipe 流水线（调用者分配，运行期间须保持有效）
+ * @param cfg 配置
+ * @return esp_err_t ESP_OK: 启动成功；ESP_ERR_INVALID_ARG: 配置无效（含周期不是整数个tick）；ESP_ERR_NO_MEM: 创建任务失败
+ */
+esp_err_t mpr121_pipeline_start(mpr121_pipeline_t *pipe, const mpr121_pipeline_config_t *cfg);
+
+/**
+ * @brief 停止流水线并等待两个任务退出（队列中未处理的帧被丢弃）
+ * @note IRQ触发模式下须先禁用触发中断，停止后不得再调用mpr121_pipeline_trigger_from_isr()
+ * @param pipe 流水线
+ * @return esp_err_t ESP_OK: 停止成功；ESP_ERR_INVALID_STATE: 未启动
+ */
+esp_err_t mpr121_pipeline_stop(mpr121_pipeline_t *pipe);
+
+/**
+ * @brief 在IRQ中触发一次采集（period_ms=0时使用；仅记录时间戳并通知采集任务）
+ * @param pipe 流水线
+ * @param[out] woken 是否唤醒了更高优先级任务（用于portYIELD_FROM_ISR）
+ */
+void mpr121_pipeline_trigger_from_isr(mpr121_pipeline_t *pipe, BaseType_t *woken);
+
+/**
+ * @brief 获取流水线统计
+ * @param pipe 流水线
+ * @param[out] stats 统计快照
+ */
+void mpr121_pipeline_get_stats(mpr121_pipeline_t *pipe, mpr121_pipeline_stats_t *stats);
+
+#endif // MPR121_PIPELINE_H
@@ -0,0 +1,161 @@
+#include "mpr121_power.h"
+#include <string.h>
+#include <esp_timer.h>
+
+static const char *TAG = "mpr121_power";
+
+static const char *s_power_state_names[MPR121_POWER_STATE_MAX] = {"idle", "active"};
+
+// -------------------------- 静态辅助函数（仅内部使用） --------------------------
+/**
+ * @brief 将状态对应的ESI与ELE_CFG写入影子缓存并提交
+ *
+ * ESI位于FILT_CDT_CFG（仅待机可写），提交时自动进入待机并最后写回ELE_CFG。
+ * CL=00：重新进入运行模式时保留各通道已有基线，空闲期间冻结的电极基线在唤醒后直接可用。
+ * @param pm 管理器
+ * @param state 目标状态
+ * @return esp_err_t ESP_OK: 切换成功；其他: 提交失败
+ */
+static esp_err_t power_apply(mpr121_power_t *pm, mpr121_power_state_t state)
+{
+    uint8_t cdt_cfg = 0;
+    uint8_t esi = state == MPR121_POWER_ACTIVE ? pm->cfg.active_esi : pm->cfg.idle_esi;
+    uint8_t ele_en = state == MPR121_POWER_ACTIVE ? pm->active_ele_en : 0;
+
+    mpr121_cfg_get(pm->dev, MPR121_FILT_CDT_CFG, &cdt_cfg);
+    mpr121_cfg_set(pm->dev, MPR121_FILT_CDT_CFG, (cdt_cfg & 0xF8) | esi);
+    mpr121_cfg_set(pm->dev, MPR121_ELE_CFG, (pm->cfg.prox_en << 4) | ele_en);
+    return mpr121_cfg_commit(pm->dev);
+}
+
+/**
+ * @brief 切换状态并累计上一状态的持续时间
+ * @param pm 管理器
+ * @param state 目标状态
+ * @param now 当前时刻
+ * @return esp_err_t ESP_OK: 切换成功；其他: 提交失败（状态不变）
+ */
+static esp_err_t power_enter(mpr121_power_t *pm, mpr121_power_state_t state, int64_t now)
+{
+    ESP_RETURN_ON_ERROR(power_apply(pm, state), TAG, "Enter %s state failed", s_power_state_names[state]);
+    pm->state_us[pm->state] += now - pm->state_since_us;
+    pm->state = state;
+    pm->state_since_us = now;
+    pm->last_activity_us = now;
+    pm->touch_mask = 0;
+    return ESP_OK;
+}
+
+// -------------------------- 外部接口实现 --------------------------
+esp_err_t mpr121_power_init(mpr121_power_t *pm, mpr121_dev_t *dev, const mpr121_power_config_t *cfg)
+{
+    if (pm == NULL || dev == NULL || cfg == NULL || cfg->idle_esi > 7 || cfg->active_esi > 7 ||
+        cfg->prox_en == 0 || cfg->prox_en > 3 || cfg->prox_release >= cfg->prox_touch)
+    {
+        ESP_LOGE(TAG, "Invalid power config");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(pm, 0, sizeof(*pm));
+    pm->dev = dev;
+    pm->cfg = *cfg;
+
+    uint8_t ecr = 0;
+    mpr121_cfg_get(dev, MPR121_ELE_CFG, &ecr);
+    pm->active_ele_en = (ecr & 0x0F) ? (ecr & 0x0F) : MPR121_NUM_ELECTRODES;
+
+    // 接近电极基线滤波（AN3893推荐值：上升快速跟随，下降缓慢，避免手靠近时基线被拉走）
+    static const uint8_t prox_filter[] = {
+        0xFF, 0xFF, 0x00, 0x00, // MHDR/NHDR/NCLR/FDLR_PROX
+        0x01, 0x01, 0xFF, 0xFF, // MHDF/NHDF/NCLF/FDLF_PROX
+        0x00, 0x00, 0x00,       // NHDT/NCLT/FDLT_PROX
+    };
+    mpr121_cfg_set_block(dev, MPR121_MHDR_PROX, prox_filter, sizeof(prox_filter));
+    mpr121_cfg_set(dev, MPR121_TOUCH_THRESH_PROX, cfg->prox_touch);
+    mpr121_cfg_set(dev, MPR121_RELEASE_THRESH_PROX, cfg->prox_release);
+
+    int64_t now = esp_timer_get_time();
+    pm->state = MPR121_POWER_IDLE;
+    pm->state_since_us = now;
+    pm->last_activity_us = now;
+    ESP_RETURN_ON_ERROR(power_apply(pm, MPR121_POWER_IDLE), TAG, "Enter idle state failed");
+    ESP_LOGI(TAG, "Low-power mode: idle ESI %d ms, active ESI %d ms, timeout %lu ms",
+             1 << cfg->idle_esi, 1 << cfg->active_esi, (unsigned long)cfg->idle_timeout_ms);
+    return ESP_OK;
+}
+
+esp_err_t mpr121_power_on_event(mpr121_power_t *pm, const mpr121_touch_event_t *event)
+{
+    uint16_t bit = 1 << event->electrode;
+
+    if (pm->state == MPR121_POWER_IDLE)
+    {
+        if (event->electrode != MPR121_POWER_PROX_CHANNEL || event->type != MPR121_EVENT_PRESS)
+        {
+            return ESP_OK;
+        }
+        // 接近触发：切换到全扫描，唤醒延迟从IRQ到达算起（芯片侧检测延迟另受空闲ESI限制）
+        int64_t now = esp_timer_get_time();
+        ESP_RETURN_ON_ERROR(power_enter(pm, MPR121_POWER_ACTIVE, now), TAG, "Wake failed");
+        pm->touch_mask = bit; // 接近状态仍保持，释放前不会超时回到空闲
+        uint32_t latency = (uint32_t)(esp_timer_get_time() - event->timestamp_us);
+        pm->wakes++;
+        pm->wake_latency_last_us = latency;
+        pm->wake_latency_sum_us += latency;
+        if (latency > pm->wake_latency_max_us)
+        {
+            pm->wake_latency_max_us = latency;
+        }
+        return ESP_OK;
+    }
+
+    pm->touch_mask = event->type == MPR121_EVENT_PRESS ? (pm->touch_mask | bit) : (pm->touch_mask & ~bit);
+    pm->last_activity_us = event->timestamp_us;
+    return ESP_OK;
+}
+
+esp_err_t mpr121_power_tick(mpr121_power_t *pm, int64_t now_us)
+{
+    if (pm->state != MPR121_POWER_ACTIVE || pm->touch_mask != 0 ||
+        now_us - pm->last_activity_us < (int64_t)pm->cfg.idle_timeout_ms * 1000)
+    {
+        return ESP_OK;
+    }
+
+    ESP_RETURN_ON_ERROR(power_enter(pm, MPR121_POWER_IDLE, now_us), TAG, "Sleep failed");
+    pm->sleeps++;
+    return ESP_OK;
+}
+
+TickType_t mpr121_power_wait_ticks(const mpr121_power_t *pm, int64_t now_us)
+{
+    if (pm->state != MPR121_POWER_ACTIVE || pm->touch_mask != 0)
+    {
+        return portMAX_DELAY;
+    }
+
+    int64_t remain_us = pm->last_activity_us + (int64_t)pm->cfg.idle_timeout_ms * 1000 - now_us;
+    if (remain_us <= 0)
+    {
+        return 0;
+    }
+    return pdMS_TO_TICKS((remain_us + 999) / 1000) + 1;
+}
+
+void mpr121_power_get_stats(const mpr121_power_t *pm, mpr121_power_stats_t *stats)
+{
+    int64_t now = esp_timer_get_time();
+
+    memset(stats, 0, sizeof(*stats));
+    stats->state = pm->state;
+    stats->wakes = pm->wakes;
+    stats->sleeps = pm->sleeps;
+    stats->wake_latency_last_us = pm->wake_latency_last_us;
+    stats->wake_latency_max_us = pm->wake_latency_max_us;
+    stats->wake_latency_avg_us = pm->wakes ? (uint32_t)(pm->wake_latency_sum_us / pm->wakes) : 0;
+    memcpy(stats->state_us, pm->state_us, sizeof(stats->state_us));
+    stats->state_us[pm->state] += now - pm->state_since_us;
+
+    uint64_t total = stats->state_us[MPR121_POWER_IDLE] + stats->state_us[MPR121_POWER_ACTIVE];
+    stats->idle_permille = total ? (uint32_t)(stats->state_us[MPR121_POWER_IDLE] * 1000 / total) : 0;
+}
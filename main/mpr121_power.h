@@ -0,0 +1,112 @@
+#ifndef MPR121_POWER_H
+#define MPR121_POWER_H
+
+#include <stdbool.h>
+#include "mpr121.h"
+#include "mpr121_event.h"
+
+// -------------------------- 可配置参数 --------------------------
+#define MPR121_POWER_PROX_CHANNEL MPR121_NUM_ELECTRODES // ELEPROX在触摸状态/事件中的通道号（12）
+
+// -------------------------- 数据结构 --------------------------
+/**
+ * @brief 电源状态
+ */
+typedef enum
+{
+    MPR121_POWER_IDLE = 0, // 空闲：仅ELEPROX组合接近电极以长ESI采样
+    MPR121_POWER_ACTIVE,   // 活动：全部电极以短ESI快速采样
+    MPR121_POWER_STATE_MAX,
+} mpr121_power_state_t;
+
+/**
+ * @brief 低功耗模式配置
+ */
+typedef struct
+{
+    uint8_t idle_esi;         // 空闲状态ESI编码（0~7 → 1/2/4/.../128ms，推荐5=32ms）
+    uint8_t active_esi;       // 活动状态ESI编码（推荐2=4ms，与mpr121_init()一致）
+    uint8_t prox_en;          // ELEPROX_EN：1=ELE0~1，2=ELE0~3，3=ELE0~11组合为接近电极
+    uint8_t prox_touch;       // 接近电极触摸阈值
+    uint8_t prox_release;     // 接近电极释放阈值（需小于prox_touch）
+    uint32_t idle_timeout_ms; // 所有通道释放后持续该时间无事件则回到空闲状态
+} mpr121_power_config_t;
+
+/**
+ * @brief 低功耗模式统计
+ */
+typedef struct
+{
+    mpr121_power_state_t state;    // 当前状态
+    uint32_t wakes;                // 空闲→活动切换次数
+    uint32_t sleeps;               // 活动→空闲切换次数
+    uint32_t wake_latency_last_us; // 最近一次唤醒延迟（接近IRQ到全扫描配置生效）
+    uint32_t wake_latency_max_us;  // 最大唤醒延迟
+    uint32_t wake_latency_avg_us;  // 平均唤醒延迟
+    uint64_t state_us[MPR121_POWER_STATE_MAX]; // 各状态累计时间（含当前状态）
+    uint32_t idle_permille;        // 空闲状态时间占比（千分比）
+} mpr121_power_stats_t;
+
+/**
+ * @brief 接近检测门控的低功耗扫描管理器（由处理触摸事件的任务调用，无内部任务）
+ */
+typedef struct
+{
+    mpr121_dev_t *dev;                  // 设备句柄
+    mpr121_power_config_t cfg;          // 配置
+    mpr121_power_state_t state;         // 当前状态
+    uint8_t active_ele_en;              // 活动状态的ELE_EN（取自进入管理前的ELE_CFG）
+    uint16_t touch_mask;                // 当前按下的通道（由事件维护）
+    int64_t state_since_us;             // 进入当前状态的时刻
+    int64_t last_activity_us;           // 最近一次事件时刻
+    uint64_t state_us[MPR121_POWER_STATE_MAX]; // 已结束的各状态累计时间
+    uint32_t wakes;                     // 唤醒次数
+    uint32_t sleeps;                    // 休眠次数
+    uint32_t wake_latency_last_us;      // 最近一次唤醒延迟
+    uint32_t wake_latency_max_us;       // 最大唤醒延迟
+    uint64_t wake_latency_sum_us;       // 唤醒延迟总和
+} mpr121_power_t;
+
+// -------------------------- 函数接口 --------------------------
+/**
+ * @brief 初始化低功耗管理并进入空闲状态（配置接近电极滤波与阈值，经影子缓存提交）
+ * @note 须在mpr121_init()或mpr121_calib_boot()之后调用；此后ELE_CFG与ESI由本模块管理
+ * @param pm 管理器（调用者分配）
+ * @param dev 已初始化的设备句柄
+ * @param cfg 配置
+ * @return esp_err_t ESP_OK: 初始化成功；ESP_ERR_INVALID_ARG: 配置无效；其他: 提交失败
+ */
+esp_err_t mpr121_power_init(mpr121_power_t *pm, mpr121_dev_t *dev, const mpr121_power_config_t *cfg);
+
+/**
+ * @brief 处理一个触摸事件：空闲状态下ELEPROX按下立即切换到全扫描；活动状态下刷新活动时间
+ * @param pm 管理器
+ * @param event 事件（来自mpr121_event_pop()）
+ * @return esp_err_t ESP_OK: 处理成功；其他: 切换配置失败
+ */
+esp_err_t mpr121_power_on_event(mpr121_power_t *pm, const mpr121_touch_event_t *event);
+
+/**
+ * @brief 检查空闲超时：活动状态下所有通道释放且超过idle_timeout_ms无事件时回到空闲状态
+ * @param pm 管理器
+ * @param now_us 当前时刻（esp_timer时间）
+ * @return esp_err_t ESP_OK: 检查完成；其他: 切换配置失败
+ */
+esp_err_t mpr121_power_tick(mpr121_power_t *pm, int64_t now_us);
+
+/**
+ * @brief 计算事件任务下一次需要醒来调用mpr121_power_tick()的等待时间（空闲状态无需定时醒来）
+ * @param pm 管理器
+ * @param now_us 当前时刻
+ * @return TickType_t 等待tick数（空闲状态或有通道按下时为portMAX_DELAY）
+ */
+TickType_t mpr121_power_wait_ticks(const mpr121_power_t *pm, int64_t now_us);
+
+/**
+ * @brief 获取低功耗模式统计
+ * @param pm 管理器
+ * @param[out] stats 统计快照
+ */
+void mpr121_power_get_stats(const mpr121_power_t *pm, mpr121_power_stats_t *stats);
+
+#endif // MPR121_POWER_H
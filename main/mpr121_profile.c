@@ -0,0 +1,135 @@
+#include "mpr121_profile.h"
+#include <esp_timer.h>
+
+static const char *TAG = "mpr121_profile";
+
+// 内置调校配置（滤波参数参考AN3891/AN3892，阈值针对约1mm覆盖层，实际面板需按需调整）
+static const mpr121_profile_t s_profiles[MPR121_PROFILE_MAX] = {
+    [MPR121_PROFILE_DRY] = {
+        .name = "dry",
+        .filter = {0x01, 0x01, 0x00, 0x00, 0x01, 0x01, 0xFF, 0x02, 0x00, 0x00, 0x00},
+        .thresh = {{0x0F, 0x0A}, {0x0F, 0x0A}, {0x0F, 0x0A}, {0x0F, 0x0A}, {0x0F, 0x0A}, {0x0F, 0x0A},
+                   {0x0F, 0x0A}, {0x0F, 0x0A}, {0x0F, 0x0A}, {0x0F, 0x0A}, {0x0F, 0x0A}, {0x0F, 0x0A}},
+        .debounce = 0x00,
+        .cdc_cfg = 0x10, // FFI=6次，CDC=16μA
+        .cdt_cfg = 0x04, // CDT=0（使用各电极值），SFI=4次，ESI=4
+    },
+    [MPR121_PROFILE_WET] = {
+        .name = "wet",
+        // 下降沿（数据<基线）跟踪放慢，水膜缓慢变化由基线吸收，手指的快速变化仍可检测
+        .filter = {0x01, 0x01, 0x00, 0x00, 0x01, 0x01, 0x10, 0x04, 0x00, 0x00, 0x00},
+        .thresh = {{0x18, 0x10}, {0x18, 0x10}, {0x18, 0x10}, {0x18, 0x10}, {0x18, 0x10}, {0x18, 0x10},
+                   {0x18, 0x10}, {0x18, 0x10}, {0x18, 0x10}, {0x18, 0x10}, {0x18, 0x10}, {0x18, 0x10}},
+        .debounce = 0x22, // DR=2，DT=2
+        .cdc_cfg = 0x50,  // FFI=10次，CDC=16μA
+        .cdt_cfg = 0x0C,  // SFI=6次，ESI=4
+    },
+    [MPR121_PROFILE_GLOVE] = {
+        .name = "glove",
+        // 弱信号持续时间长：下降沿跟踪更慢，避免长按时基线被拉向触摸数据
+        .filter = {0x01, 0x01, 0x00, 0x00, 0x01, 0x01, 0xFF, 0x08, 0x00, 0x00, 0x00},
+        .thresh = {{0x06, 0x03}, {0x06, 0x03}, {0x06, 0x03}, {0x06, 0x03}, {0x06, 0x03}, {0x06, 0x03},
+                   {0x06, 0x03}, {0x06, 0x03}, {0x06, 0x03}, {0x06, 0x03}, {0x06, 0x03}, {0x06, 0x03}},
+        .debounce = 0x11, // DR=1，DT=1
+        .cdc_cfg = 0x90,  // FFI=18次，CDC=16μA
+        .cdt_cfg = 0x14,  // SFI=10次，ESI=4
+    },
+};
+
+// -------------------------- 静态辅助函数（仅内部使用） --------------------------
+/**
+ * @brief 检查配置合理性（释放阈值须小于触摸阈值，去抖与充电时间字段不越界）
+ */
+static bool profile_valid(const mpr121_profile_t *profile)
+{
+    for (int i = 0; i < MPR121_NUM_ELECTRODES; i++)
+    {
+        if (profile->thresh[i][1] >= profile->thresh[i][0])
+        {
+            return false;
+        }
+    }
+    if (profile->debounce & 0x88)
+    {
+        return false;
+    }
+    if (profile->charge_override)
+    {
+        for (int i = 0; i < MPR121_NUM_ELECTRODES; i++)
+        {
+            if (profile->cdc[i] > 0x3F || (profile->cdt[i / 2] & 0x88))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 统计影子缓存中与芯片已知值不同的寄存器数（不含ELE_CFG）
+ */
+static uint16_t profile_count_dirty(const mpr121_dev_t *dev)
+{
+    uint16_t count = 0;
+    for (int reg = MPR121_CFG_FIRST; reg <= MPR121_CFG_LAST; reg++)
+    {
+        int i = reg - MPR121_CFG_FIRST;
+        count += reg != MPR121_ELE_CFG && dev->cfg_shadow[i] != dev->cfg_chip[i];
+    }
+    return count;
+}
+
+// -------------------------- 外部接口实现 --------------------------
+const mpr121_profile_t *mpr121_profile_get(mpr121_profile_id_t id)
+{
+    return id < MPR121_PROFILE_MAX ? &s_profiles[id] : NULL;
+}
+
+esp_err_t mpr121_profile_apply(mpr121_dev_t *dev, const mpr121_profile_t *profile, mpr121_profile_result_t *result)
+{
+    if (dev == NULL || profile == NULL || !profile_valid(profile))
+    {
+        ESP_LOGE(TAG, "Invalid profile");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // 1. 全部变更先进入影子缓存（不访问总线），提交时仅写差异
+    uint8_t ecr = 0;
+    mpr121_cfg_set_block(dev, MPR121_MHDR, profile->filter, sizeof(profile->filter));
+    mpr121_cfg_set_block(dev, MPR121_TOUCH_THRESH_0, &profile->thresh[0][0], sizeof(profile->thresh));
+    mpr121_cfg_set(dev, MPR121_DEBOUNCE, profile->debounce);
+    mpr121_cfg_set(dev, MPR121_FILT_CDC_CFG, profile->cdc_cfg);
+    mpr121_cfg_set(dev, MPR121_FILT_CDT_CFG, profile->cdt_cfg);
+    // 自动配置（ACE/ARE）要求AUTO_CFG0的FFI与FILT_CDC_CFG一致，随配置一起修改
+    uint8_t auto_cfg0 = 0;
+    mpr121_cfg_get(dev, MPR121_AUTO_CFG0, &auto_cfg0);
+    mpr121_cfg_set(dev, MPR121_AUTO_CFG0, (auto_cfg0 & 0x3F) | (profile->cdc_cfg & 0xC0));
+    if (profile->charge_override)
+    {
+        mpr121_cfg_set_block(dev, MPR121_CDC_0, profile->cdc, sizeof(profile->cdc));
+        mpr121_cfg_set_block(dev, MPR121_CDT_0_1, profile->cdt, sizeof(profile->cdt));
+    }
+    // CL=00：重新进入运行模式时沿用待机前的基线
+    mpr121_cfg_get(dev, MPR121_ELE_CFG, &ecr);
+    mpr121_cfg_set(dev, MPR121_ELE_CFG, ecr & 0x3F);
+
+    // 2. 待机 → 差异块写 → 运行（由mpr121_cfg_commit()完成，中间无延时）
+    uint16_t changed = profile_count_dirty(dev);
+    bool running = (dev->cfg_chip[MPR121_ELE_CFG - MPR121_CFG_FIRST] & 0x3F) != 0;
+    mpr121_bus_stats_t before = dev->bus_stats;
+    int64_t start = esp_timer_get_time();
+    ESP_RETURN_ON_ERROR(mpr121_cfg_commit(dev), TAG, "Apply profile %s failed", profile->name);
+    int64_t elapsed_us = esp_timer_get_time() - start;
+
+    if (result != NULL)
+    {
+        result->downtime_us = running && changed ? (uint32_t)elapsed_us : 0;
+        result->regs_changed = changed;
+        result->transactions = (uint16_t)(dev->bus_stats.transactions - before.transactions);
+        result->tx_bytes = (uint16_t)(dev->bus_stats.tx_bytes - before.tx_bytes);
+    }
+    ESP_LOGI(TAG, "Profile %s: %u regs changed, scan downtime %lld us", profile->name, changed,
+             running && changed ? (long long)elapsed_us : 0LL);
+    return ESP_OK;
+}
@@ -0,0 +1,68 @@
+#ifndef MPR121_PROFILE_H
+#define MPR121_PROFILE_H
+
+#include <stdbool.h>
+#include "mpr121.h"
+
+// -------------------------- 可配置参数 --------------------------
+#define MPR121_PROFILE_FILTER_LEN (MPR121_FDLT - MPR121_MHDR + 1) // 普通电极基线滤波寄存器数（MHDR~FDLT）
+
+// -------------------------- 数据结构 --------------------------
+/**
+ * @brief 内置调校配置编号
+ */
+typedef enum
+{
+    MPR121_PROFILE_DRY = 0, // 干燥手指（与mpr121_cfg_load_defaults()一致）
+    MPR121_PROFILE_WET,     // 潮湿/水膜：提高阈值与去抖，加强滤波，抑制水滴引起的误触发
+    MPR121_PROFILE_GLOVE,   // 戴手套：降低阈值，加长滤波平均以提高弱信号信噪比
+    MPR121_PROFILE_MAX,
+} mpr121_profile_id_t;
+
+/**
+ * @brief 调校配置（常量表，按寄存器布局存放，切换时直接与影子缓存比较）
+ */
+typedef struct
+{
+    const char *name;                               // 名称（日志用）
+    uint8_t filter[MPR121_PROFILE_FILTER_LEN];      // MHDR~FDLT（0x2B~0x35）
+    uint8_t thresh[MPR121_NUM_ELECTRODES][2];       // 各电极{触摸阈值, 释放阈值}（0x41~0x58）
+    uint8_t debounce;                               // DEBOUNCE（D6~D4=DR，D2~D0=DT）
+    uint8_t cdc_cfg;                                // FILT_CDC_CFG（D7~D6=FFI，D5~D0=全局CDC；FFI同时写入AUTO_CFG0）
+    uint8_t cdt_cfg;                                // FILT_CDT_CFG（D7~D5=全局CDT，D4~D3=SFI，D2~D0=ESI）
+    bool charge_override;                           // true=写入下方各电极CDC/CDT；false=保留校准得到的值
+    uint8_t cdc[MPR121_NUM_ELECTRODES];             // CDC_0~CDC_11（0x5F~0x6A）
+    uint8_t cdt[MPR121_NUM_ELECTRODES / 2];         // CDT_0_1~CDT_10_11（0x6C~0x71）
+} mpr121_profile_t;
+
+/**
+ * @brief 一次切换的结果
+ */
+typedef struct
+{
+    uint32_t downtime_us;  // 扫描中断时间（进入待机到重新进入运行模式），无需待机时为0
+    uint16_t regs_changed; // 与芯片当前值不同的寄存器数（不含ELE_CFG）
+    uint16_t transactions; // 本次切换的I2C事务数（含进入/退出待机）
+    uint16_t tx_bytes;     // 本次切换发送的字节数（含寄存器地址）
+} mpr121_profile_result_t;
+
+// -------------------------- 函数接口 --------------------------
+/**
+ * @brief 获取内置调校配置
+ * @param id 配置编号
+ * @return const mpr121_profile_t* 配置（编号无效时为NULL）
+ */
+const mpr121_profile_t *mpr121_profile_get(mpr121_profile_id_t id);
+
+/**
+ * @brief 运行时切换调校配置：待机 → 仅写入与芯片不同的寄存器（合并块写）→ 以CL=00重新进入运行模式
+ * @note 待机期间不插入延时；CL=00使芯片保留当前基线，切换后无需重新稳定基线。
+ *       低功耗模块（mpr121_power）在其下一次状态切换时会以自己的ESI覆盖配置中的ESI
+ * @param dev 已初始化的设备句柄
+ * @param profile 目标配置（内置或用户定义的常量表）
+ * @param[out] result 切换结果（可为NULL）
+ * @return esp_err_t ESP_OK: 切换成功；ESP_ERR_INVALID_ARG: 配置无效；其他: 写入失败
+ */
+esp_err_t mpr121_profile_apply(mpr121_dev_t *dev, const mpr121_profile_t *profile, mpr121_profile_result_t *result);
+
+#endif // MPR121_PROFILE_H
@@ -0,0 +1,275 @@
+#include "mpr121_pubsub.h"
+#include <stddef.h>
+#include <string.h>
+#include <esp_timer.h>
+
+static const char *TAG = "mpr121_pubsub";
+
+_Static_assert((MPR121_PUBSUB_SUB_QUEUE & (MPR121_PUBSUB_SUB_QUEUE - 1)) == 0, "Subscriber queue size must be a power of 2");
+_Static_assert(MPR121_PUBSUB_POOL_SIZE <= 256, "Slot index must fit in uint8_t");
+
+// -------------------------- 静态辅助函数（仅内部使用） --------------------------
+/**
+ * @brief 订阅者是否接收该消息
+ */
+static bool pubsub_match(const mpr121_pubsub_sub_t *sub, uint8_t kind, uint8_t electrode)
+{
+    if (!(sub->filter.kinds & kind))
+    {
+        return false;
+    }
+    return kind == MPR121_PUBSUB_FRAME || (sub->filter.electrodes & (1 << electrode));
+}
+
+/**
+ * @brief 从上次分配的位置起查找空闲槽（refs=0，最后一个订阅者已释放）
+ * @return int 槽索引；-1: 无空闲槽
+ */
+static int pubsub_alloc_slot(mpr121_pubsub_t *ps)
+{
+    for (unsigned n = 0; n < MPR121_PUBSUB_POOL_SIZE; n++)
+    {
+        unsigned idx = (ps->next_slot + n) % MPR121_PUBSUB_POOL_SIZE;
+        if (atomic_load_explicit(&ps->slots[idx].refs, memory_order_acquire) == 0)
+        {
+            ps->next_slot = (idx + 1) % MPR121_PUBSUB_POOL_SIZE;
+            return (int)idx;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief 发布一条消息：负载只拷贝一次到共享槽，槽索引投递给所有匹配且待读队列未满的订阅者
+ * @param ps 发布器
+ * @param kind 消息类型
+ * @param electrode 事件的电极（帧忽略）
+ * @param payload 负载（帧或事件）
+ * @param len 负载长度
+ * @return uint32_t 接收的订阅者数
+ */
+static uint32_t pubsub_publish(mpr121_pubsub_t *ps, uint8_t kind, uint8_t electrode, const void *payload, size_t len)
+{
+    unsigned count = atomic_load_explicit(&ps->sub_count, memory_order_acquire);
+    uint32_t targets = 0;
+    bool matched = false;
+
+    ps->seq++;
+    // 先确定投递对象：订阅者只会腾出空间，此处判定有空间的队列在投递时仍有空间
+    for (unsigned i = 0; i < count; i++)
+    {
+        mpr121_pubsub_sub_t *sub = atomic_load_explicit(&ps->subs[i], memory_order_acquire);
+        if (sub == NULL || !pubsub_match(sub, kind, electrode))
+        {
+            continue;
+        }
+        matched = true;
+        unsigned head = atomic_load_explicit(&sub->head, memory_order_relaxed);
+        if (head - atomic_load_explicit(&sub->tail, memory_order_acquire) >= MPR121_PUBSUB_SUB_QUEUE)
+        {
+            atomic_fetch_add_explicit(&sub->dropped, 1, memory_order_relaxed);
+            continue;
+        }
+        targets |= 1u << i;
+    }
+    if (targets == 0)
+    {
+        if (!matched)
+        {
+            atomic_fetch_add_explicit(&ps->unmatched, 1, memory_order_relaxed);
+        }
+        return 0;
+    }
+
+    int idx = pubsub_alloc_slot(ps);
+    if (idx < 0)
+    {
+        atomic_fetch_add_explicit(&ps->pool_full, 1, memory_order_relaxed);
+        return 0;
+    }
+    mpr121_pubsub_slot_t *slot = &ps->slots[idx];
+    slot->msg.seq = ps->seq;
+    slot->msg.publish_us = esp_timer_get_time();
+    slot->msg.kind = kind;
+    memcpy(&slot->msg.frame, payload, len); // frame与event共用同一地址
+    uint32_t receivers = __builtin_popcount(targets);
+    atomic_store_explicit(&slot->refs, receivers, memory_order_relaxed);
+
+    // 队列头以release发布，订阅者读到索引时槽内容与引用计数均已可见
+    for (unsigned i = 0; i < count; i++)
+    {
+        if (!(targets & (1u << i)))
+        {
+            continue;
+        }
+        mpr121_pubsub_sub_t *sub = atomic_load_explicit(&ps->subs[i], memory_order_relaxed);
+        unsigned head = atomic_load_explicit(&sub->head, memory_order_relaxed);
+        sub->queue[head & (MPR121_PUBSUB_SUB_QUEUE - 1)] = (uint8_t)idx;
+        atomic_store_explicit(&sub->head, head + 1, memory_order_release);
+
+        unsigned pending = head + 1 - atomic_load_explicit(&sub->tail, memory_order_relaxed);
+        if (pending > atomic_load_explicit(&sub->pending_peak, memory_order_relaxed))
+        {
+            atomic_store_explicit(&sub->pending_peak, pending, memory_order_relaxed);
+        }
+        xSemaphoreGive(sub->ready);
+    }
+    atomic_fetch_add_explicit(&ps->deliveries, receivers, memory_order_relaxed);
+    return receivers;
+}
+
+// -------------------------- 外部接口实现 --------------------------
+esp_err_t mpr121_pubsub_init(mpr121_pubsub_t *ps)
+{
+    if (ps == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(ps, 0, sizeof(*ps));
+    return ESP_OK;
+}
+
+esp_err_t mpr121_pubsub_subscribe(mpr121_pubsub_t *ps, mpr121_pubsub_sub_t *sub, const char *name,
+                                  const mpr121_pubsub_filter_t *filter)
+{
+    if (ps == NULL || sub == NULL || filter == NULL || filter->kinds == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(sub, 0, sizeof(*sub));
+    sub->ps = ps;
+    sub->name = name;
+    sub->filter = *filter;
+    sub->ready = xSemaphoreCreateBinary();
+    if (sub->ready == NULL)
+    {
+        ESP_LOGE(TAG, "Create semaphore for %s failed", name ? name : "subscriber");
+        return ESP_ERR_NO_MEM;
+    }
+
+    // 以CAS占用首个空位（写入即生效），再把遍历范围推进到覆盖该位置；两步都不等待其他订阅者
+    unsigned idx = 0;
+    for (; idx < MPR121_PUBSUB_MAX_SUBS; idx++)
+    {
+        mpr121_pubsub_sub_t *expected = NULL;
+        if (atomic_compare_exchange_strong_explicit(&ps->subs[idx], &expected, sub, memory_order_release,
+                                                    memory_order_relaxed))
+        {
+            break;
+        }
+    }
+    if (idx >= MPR121_PUBSUB_MAX_SUBS)
+    {
+        vSemaphoreDelete(sub->ready);
+        sub->ready = NULL;
+        ESP_LOGE(TAG, "Too many subscribers (max %d)", MPR121_PUBSUB_MAX_SUBS);
+        return ESP_ERR_NO_MEM;
+    }
+    unsigned count = atomic_load_explicit(&ps->sub_count, memory_order_relaxed);
+    while (count < idx + 1 &&
+           !atomic_compare_exchange_weak_explicit(&ps->sub_count, &count, idx + 1, memory_order_release,
+                                                  memory_order_relaxed))
+    {
+    }
+    return ESP_OK;
+}
+
+uint32_t mpr121_pubsub_publish_frame(mpr121_pubsub_t *ps, const mpr121_frame_t *frame)
+{
+    atomic_fetch_add_explicit(&ps->frames, 1, memory_order_relaxed);
+    return pubsub_publish(ps, MPR121_PUBSUB_FRAME, 0, frame, sizeof(*frame));
+}
+
+uint32_t mpr121_pubsub_publish_event(mpr121_pubsub_t *ps, const mpr121_touch_event_t *event)
+{
+    atomic_fetch_add_explicit(&ps->events, 1, memory_order_relaxed);
+    uint8_t kind = event->type == MPR121_EVENT_PRESS ? MPR121_PUBSUB_PRESS : MPR121_PUBSUB_RELEASE;
+    return pubsub_publish(ps, kind, event->electrode, event, sizeof(*event));
+}
+
+void mpr121_pubsub_process(void *arg, const mpr121_frame_t *frame)
+{
+    mpr121_pubsub_t *ps = (mpr121_pubsub_t *)arg;
+    uint16_t touch = frame->touch_status & MPR121_STATUS_CH_MASK;
+
+    mpr121_pubsub_publish_frame(ps, frame);
+    uint16_t changed = ps->has_last ? (touch ^ ps->last_touch) : touch;
+    ps->last_touch = touch;
+    ps->has_last = true;
+    for (int ch = 0; changed != 0 && ch < MPR121_NUM_CHANNELS; ch++)
+    {
+        if (!(changed & (1 << ch)))
+        {
+            continue;
+        }
+        changed &= ~(1 << ch);
+        const mpr121_touch_event_t event = {
+            .timestamp_us = frame->timestamp_us,
+            .latency_us = (uint32_t)(esp_timer_get_time() - frame->timestamp_us),
+            .electrode = ch,
+            .type = (touch & (1 << ch)) ? MPR121_EVENT_PRESS : MPR121_EVENT_RELEASE,
+        };
+        mpr121_pubsub_publish_event(ps, &event);
+    }
+}
+
+esp_err_t mpr121_pubsub_step(mpr121_pubsub_t *ps, mpr121_dev_t *dev)
+{
+    mpr121_frame_t frame;
+    ESP_RETURN_ON_ERROR(mpr121_read_frame(dev, &frame), TAG, "Read frame failed");
+    mpr121_pubsub_process(ps, &frame);
+    return ESP_OK;
+}
+
+const mpr121_pubsub_msg_t *mpr121_pubsub_receive(mpr121_pubsub_sub_t *sub, TickType_t wait)
+{
+    while (1)
+    {
+        unsigned tail = atomic_load_explicit(&sub->tail, memory_order_relaxed);
+        if (atomic_load_explicit(&sub->head, memory_order_acquire) != tail)
+        {
+            uint8_t idx = sub->queue[tail & (MPR121_PUBSUB_SUB_QUEUE - 1)];
+            atomic_store_explicit(&sub->tail, tail + 1, memory_order_release);
+
+            const mpr121_pubsub_msg_t *msg = &sub->ps->slots[idx].msg;
+            uint32_t lag = (uint32_t)(esp_timer_get_time() - msg->publish_us);
+            sub->received++;
+            sub->lag_sum_us += lag;
+            sub->lag_max_us = lag > sub->lag_max_us ? lag : sub->lag_max_us;
+            return msg;
+        }
+        // 二值信号量可能残留一次已被消费的通知，取到后重新检查队列
+        if (wait == 0 || xSemaphoreTake(sub->ready, wait) != pdTRUE)
+        {
+            return NULL;
+        }
+    }
+}
+
+void mpr121_pubsub_release(mpr121_pubsub_sub_t *sub, const mpr121_pubsub_msg_t *msg)
+{
+    mpr121_pubsub_slot_t *slot = (mpr121_pubsub_slot_t *)((const char *)msg - offsetof(mpr121_pubsub_slot_t, msg));
+    atomic_fetch_sub_explicit(&slot->refs, 1, memory_order_release);
+}
+
+void mpr121_pubsub_get_sub_stats(mpr121_pubsub_sub_t *sub, mpr121_pubsub_sub_stats_t *stats)
+{
+    stats->received = sub->received;
+    stats->dropped = atomic_load_explicit(&sub->dropped, memory_order_relaxed);
+    stats->pending = atomic_load_explicit(&sub->head, memory_order_acquire) -
+                     atomic_load_explicit(&sub->tail, memory_order_relaxed);
+    stats->pending_peak = atomic_load_explicit(&sub->pending_peak, memory_order_relaxed);
+    stats->lag_avg_us = sub->received ? (uint32_t)(sub->lag_sum_us / sub->received) : 0;
+    stats->lag_max_us = sub->lag_max_us;
+}
+
+void mpr121_pubsub_get_stats(mpr121_pubsub_t *ps, mpr121_pubsub_stats_t *stats)
+{
+    stats->frames = atomic_load_explicit(&ps->frames, memory_order_relaxed);
+    stats->events = atomic_load_explicit(&ps->events, memory_order_relaxed);
+    stats->deliveries = atomic_load_explicit(&ps->deliveries, memory_order_relaxed);
+    stats->unmatched = atomic_load_explicit(&ps->unmatched, memory_order_relaxed);
+    stats->pool_full = atomic_load_explicit(&ps->pool_full, memory_order_relaxed);
+}
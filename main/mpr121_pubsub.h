@@ -0,0 +1,205 @@
+#ifndef MPR121_PUBSUB_H
+#define MPR121_PUBSUB_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include "mpr121.h"
+#include "mpr121_event.h"
+
+// -------------------------- 可配置参数 --------------------------
+#define MPR121_PUBSUB_POOL_SIZE 32  // 共享消息槽数（所有订阅者共用，不超过256）
+#define MPR121_PUBSUB_SUB_QUEUE 16  // 每个订阅者的待读队列容量（必须为2的幂）
+#define MPR121_PUBSUB_MAX_SUBS 8    // 订阅者数量上限
+
+// -------------------------- 数据结构 --------------------------
+/**
+ * @brief 消息类型（按位组合用作订阅过滤）
+ */
+typedef enum
+{
+    MPR121_PUBSUB_FRAME = 0x01,   // 完整帧（包含全部通道，不按电极过滤）
+    MPR121_PUBSUB_PRESS = 0x02,   // 电极按下
+    MPR121_PUBSUB_RELEASE = 0x04, // 电极释放
+} mpr121_pubsub_kind_t;
+
+/**
+ * @brief 消息（位于共享槽中，订阅者直接读取，释放前有效）
+ */
+typedef struct
+{
+    uint32_t seq;                      // 发布序号（每次发布加1，含无订阅者接收的消息）
+    int64_t publish_us;                // 发布时刻（esp_timer时间）
+    uint8_t kind;                      // 消息类型（mpr121_pubsub_kind_t）
+    union
+    {
+        mpr121_frame_t frame;          // kind=FRAME
+        mpr121_touch_event_t event;    // kind=PRESS/RELEASE
+    };
+} mpr121_pubsub_msg_t;
+
+/**
+ * @brief 共享消息槽（refs=尚未释放该消息的订阅者数，0表示空闲）
+ */
+typedef struct
+{
+    atomic_uint refs;          // 引用计数
+    mpr121_pubsub_msg_t msg;   // 消息
+} mpr121_pubsub_slot_t;
+
+/**
+ * @brief 订阅过滤条件
+ */
+typedef struct
+{
+    uint8_t kinds;        // 接收的消息类型（mpr121_pubsub_kind_t按位或）
+    uint16_t electrodes;  // 接收的电极事件（bit0~bit11=ELE0~ELE11，bit12=ELEPROX）
+} mpr121_pubsub_filter_t;
+
+/**
+ * @brief 订阅者统计
+ */
+typedef struct
+{
+    uint32_t received;      // 已读取的消息数
+    uint32_t dropped;       // 待读队列满而未投递的消息数
+    uint32_t pending;       // 当前待读的消息数
+    uint32_t pending_peak;  // 待读消息数峰值
+    uint32_t lag_avg_us;    // 发布到读取的平均延迟
+    uint32_t lag_max_us;    // 发布到读取的最大延迟
+} mpr121_pubsub_sub_stats_t;
+
+struct mpr121_pubsub;
+
+/**
+ * @brief 订阅者（调用者分配；待读队列为单生产者单消费者环，只存放槽索引）
+ */
+typedef struct
+{
+    struct mpr121_pubsub *ps;                  // 所属发布器
+    const char *name;                          // 名称（日志用）
+    mpr121_pubsub_filter_t filter;             // 过滤条件
+    SemaphoreHandle_t ready;                   // 有新消息（mpr121_pubsub_receive()等待）
+    atomic_uint head;                          // 下一个写入位置（仅发布者修改）
+    atomic_uint tail;                          // 下一个读取位置（仅订阅者修改）
+    uint8_t queue[MPR121_PUBSUB_SUB_QUEUE];    // 待读的槽索引
+    atomic_uint dropped;                       // 统计：未投递的消息
+    atomic_uint pending_peak;                  // 统计：待读峰值
+
+    // 订阅者私有统计
+    uint32_t received;                         // 已读取数
+    uint64_t lag_sum_us;                       // 延迟累计（求平均）
+    uint32_t lag_max_us;                       // 最大延迟
+} mpr121_pubsub_sub_t;
+
+/**
+ * @brief 发布器统计
+ */
+typedef struct
+{
+    uint32_t frames;      // 已发布的帧
+    uint32_t events;      // 已发布的按下/释放事件
+    uint32_t deliveries;  // 投递次数（消息×接收的订阅者）
+    uint32_t unmatched;   // 没有订阅者接收、未占用槽的消息
+    uint32_t pool_full;   // 无空闲槽而丢弃的消息
+} mpr121_pubsub_stats_t;
+
+/**
+ * @brief 触摸数据发布器：一次采集只读取一次总线，帧与事件各发布一次，写入共享槽后只把槽索引
+ *        投递给过滤条件匹配的订阅者，订阅者直接读取共享槽（无拷贝），全部释放后槽被回收
+ *
+ * 单发布者（采集任务），任意任务可订阅；总线流量与订阅者数量无关。
+ */
+typedef struct mpr121_pubsub
+{
+    mpr121_pubsub_slot_t slots[MPR121_PUBSUB_POOL_SIZE];   // 共享消息槽
+    mpr121_pubsub_sub_t *_Atomic subs[MPR121_PUBSUB_MAX_SUBS]; // 订阅者（以CAS占位，NULL=空位）
+    atomic_uint sub_count;                                 // 发布者需遍历的位置数（只增不减）
+    unsigned next_slot;                                    // 下一次查找空闲槽的起点（仅发布者）
+    uint32_t seq;                                          // 发布序号（仅发布者）
+    uint16_t last_touch;                                   // 上一帧的触摸掩码（由帧生成事件时使用）
+    bool has_last;                                         // last_touch有效
+    atomic_uint frames;                                    // 统计：已发布的帧
+    atomic_uint events;                                    // 统计：已发布的事件
+    atomic_uint deliveries;                                // 统计：投递次数
+    atomic_uint unmatched;                                 // 统计：无订阅者接收
+    atomic_uint pool_full;                                 // 统计：无空闲槽
+} mpr121_pubsub_t;
+
+// -------------------------- 函数接口 --------------------------
+/**
+ * @brief 初始化发布器
+ * @param ps 发布器
+ * @return esp_err_t ESP_OK: 初始化成功；ESP_ERR_INVALID_ARG: 参数无效
+ */
+esp_err_t mpr121_pubsub_init(mpr121_pubsub_t *ps);
+
+/**
+ * @brief 注册订阅者（可在发布进行中调用，之后发布的消息开始投递；订阅在发布器生命周期内有效）
+ * @param ps 发布器
+ * @param[out] sub 订阅者（调用者分配，须保持有效）
+ * @param name 名称
+ * @param filter 过滤条件
+ * @return esp_err_t ESP_OK: 成功；ESP_ERR_INVALID_ARG: 参数无效；ESP_ERR_NO_MEM: 订阅者已满或创建信号量失败
+ */
+esp_err_t mpr121_pubsub_subscribe(mpr121_pubsub_t *ps, mpr121_pubsub_sub_t *sub, const char *name,
+                                  const mpr121_pubsub_filter_t *filter);
+
+/**
+ * @brief 发布一帧（仅限发布者任务调用）
+ * @param ps 发布器
+ * @param frame 帧
+ * @return uint32_t 接收该消息的订阅者数
+ */
+uint32_t mpr121_pubsub_publish_frame(mpr121_pubsub_t *ps, const mpr121_frame_t *frame);
+
+/**
+ * @brief 发布一个按下/释放事件（仅限发布者任务调用，如事件管线的消费循环）
+ * @param ps 发布器
+ * @param event 事件
+ * @return uint32_t 接收该消息的订阅者数
+ */
+uint32_t mpr121_pubsub_publish_event(mpr121_pubsub_t *ps, const mpr121_touch_event_t *event);
+
+/**
+ * @brief 发布一帧，并与上一帧的触摸掩码比较发布按下/释放事件（流水线处理回调，arg为mpr121_pubsub_t指针）
+ */
+void mpr121_pubsub_process(void *arg, const mpr121_frame_t *frame);
+
+/**
+ * @brief 一次采集：读取一帧（一次突发读取）并按mpr121_pubsub_process()发布
+ * @param ps 发布器
+ * @param dev 设备句柄
+ * @return esp_err_t ESP_OK: 成功；其他: 读取失败
+ */
+esp_err_t mpr121_pubsub_step(mpr121_pubsub_t *ps, mpr121_dev_t *dev);
+
+/**
+ * @brief 读取下一条消息（仅限该订阅者的任务调用）
+ * @param sub 订阅者
+ * @param wait 无消息时的最长等待（0=不等待）
+ * @return const mpr121_pubsub_msg_t* 共享槽中的消息（用完后调用mpr121_pubsub_release()）；NULL: 超时
+ */
+const mpr121_pubsub_msg_t *mpr121_pubsub_receive(mpr121_pubsub_sub_t *sub, TickType_t wait);
+
+/**
+ * @brief 释放读取到的消息（最后一个订阅者释放后槽被回收）
+ * @param sub 订阅者
+ * @param msg mpr121_pubsub_receive()返回的消息
+ */
+void mpr121_pubsub_release(mpr121_pubsub_sub_t *sub, const mpr121_pubsub_msg_t *msg);
+
+/**
+ * @brief 获取订阅者统计（含当前待读数，即相对发布者的滞后）
+ * @param sub 订阅者
+ * @param[out] stats 统计
+ */
+void mpr121_pubsub_get_sub_stats(mpr121_pubsub_sub_t *sub, mpr121_pubsub_sub_stats_t *stats);
+
+/**
+ * @brief 获取发布器统计
+ * @param ps 发布器
+ * @param[out] stats 统计
+ */
+void mpr121_pubsub_get_stats(mpr121_pubsub_t *ps, mpr121_pubsub_stats_t *stats);
+
+#endif // MPR121_PUBSUB_H
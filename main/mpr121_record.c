@@ -0,0 +1,311 @@
+#include "mpr121_record.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "mpr121_record";
+
+static const uint8_t s_record_magic[4] = {'M', '1', '2', '1'};
+
+// -------------------------- 静态辅助函数（仅内部使用） --------------------------
+/**
+ * @brief 写入无符号变长整数（每字节7位，最高位表示后续还有字节）
+ * @return size_t 写入的字节数
+ */
+static size_t record_put_varint(uint8_t *out, uint64_t v)
+{
+    size_t n = 0;
+    while (v >= 0x80)
+    {
+        out[n++] = (uint8_t)v | 0x80;
+        v >>= 7;
+    }
+    out[n++] = (uint8_t)v;
+    return n;
+}
+
+/**
+ * @brief 读取无符号变长整数
+ * @return bool true: 成功；false: 数据被截断或超长
+ */
+static bool record_get_varint(mpr121_record_reader_t *reader, uint64_t *v)
+{
+    uint64_t result = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        if (reader->pos >= reader->len)
+        {
+            return false;
+        }
+        uint8_t b = reader->data[reader->pos++];
+        result |= (uint64_t)(b & 0x7F) << shift;
+        if (!(b & 0x80))
+        {
+            *v = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool record_get_u16(mpr121_record_reader_t *reader, uint16_t *v)
+{
+    if (reader->len - reader->pos < 2)
+    {
+        return false;
+    }
+    *v = reader->data[reader->pos] | (reader->data[reader->pos + 1] << 8);
+    reader->pos += 2;
+    return true;
+}
+
+/**
+ * @brief 编码一帧（prev为差分参考，关键帧时为全零帧）
+ * @return size_t 编码长度（不超过MPR121_RECORD_FRAME_MAX）
+ */
+static size_t record_encode(uint8_t *out, const mpr121_frame_t *frame, const mpr121_frame_t *prev, bool key)
+{
+    uint16_t base_mask = 0;
+    for (int ch = 0; ch < MPR121_NUM_CHANNELS; ch++)
+    {
+        base_mask |= (frame->baseline[ch] != prev->baseline[ch]) << ch;
+    }
+    uint8_t flags = (key ? MPR121_RECORD_FLAG_KEY : 0) |
+                    (frame->touch_status != prev->touch_status ? MPR121_RECORD_FLAG_TOUCH : 0) |
+                    (frame->oor_status != prev->oor_status ? MPR121_RECORD_FLAG_OOR : 0) |
+                    (base_mask ? MPR121_RECORD_FLAG_BASE : 0);
+
+    size_t n = 0;
+    out[n++] = flags;
+    n += record_put_varint(&out[n], (uint64_t)(frame->timestamp_us - prev->timestamp_us));
+    if (flags & MPR121_RECORD_FLAG_TOUCH)
+    {
+        out[n++] = frame->touch_status & 0xFF;
+        out[n++] = frame->touch_status >> 8;
+    }
+    if (flags & MPR121_RECORD_FLAG_OOR)
+    {
+        out[n++] = frame->oor_status & 0xFF;
+        out[n++] = frame->oor_status >> 8;
+    }
+    for (int ch = 0; ch < MPR121_NUM_CHANNELS; ch++)
+    {
+        int32_t d = (int32_t)frame->filtered[ch] - prev->filtered[ch];
+        n += record_put_varint(&out[n], ((uint32_t)d << 1) ^ (uint32_t)(d >> 31)); // zigzag：小幅正负变化都编码为小整数
+    }
+    if (base_mask)
+    {
+        out[n++] = base_mask & 0xFF;
+        out[n++] = base_mask >> 8;
+        for (int ch = 0; ch < MPR121_NUM_CHANNELS; ch++)
+        {
+            if (base_mask & (1 << ch))
+            {
+                out[n++] = (uint8_t)(frame->baseline[ch] - prev->baseline[ch]);
+            }
+        }
+    }
+    return n;
+}
+
+// -------------------------- 外部接口实现 --------------------------
+esp_err_t mpr121_record_init(mpr121_record_t *rec, uint8_t *buf, size_t cap, uint32_t period_us)
+{
+    if (rec == NULL || buf == NULL || cap < MPR121_RECORD_HEADER_LEN)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(rec, 0, sizeof(*rec));
+    rec->buf = buf;
+    rec->cap = cap;
+    memcpy(buf, s_record_magic, sizeof(s_record_magic));
+    buf[4] = MPR121_RECORD_VERSION;
+    buf[5] = MPR121_NUM_CHANNELS;
+    buf[6] = MPR121_RECORD_KEYFRAME_INTERVAL & 0xFF;
+    buf[7] = MPR121_RECORD_KEYFRAME_INTERVAL >> 8;
+    for (int i = 0; i < 4; i++)
+    {
+        buf[8 + i] = (uint8_t)(period_us >> (i * 8));
+    }
+    rec->len = MPR121_RECORD_HEADER_LEN;
+    return ESP_OK;
+}
+
+esp_err_t mpr121_record_add(mpr121_record_t *rec, const mpr121_frame_t *frame)
+{
+    static const mpr121_frame_t zero = {0};
+    uint8_t enc[MPR121_RECORD_FRAME_MAX];
+
+    bool key = rec->frames == 0 || rec->since_key >= MPR121_RECORD_KEYFRAME_INTERVAL;
+    size_t n = record_encode(enc, frame, key ? &zero : &rec->prev, key);
+    if (rec->cap - rec->len < n)
+    {
+        rec->dropped++;
+        return ESP_ERR_NO_MEM;
+    }
+    memcpy(&rec->buf[rec->len], enc, n);
+    rec->len += n;
+    rec->frames++;
+    rec->since_key = key ? 1 : rec->since_key + 1;
+    rec->prev = *frame;
+    return ESP_OK;
+}
+
+void mpr121_record_process(void *arg, const mpr121_frame_t *frame)
+{
+    mpr121_record_add((mpr121_record_t *)arg, frame);
+}
+
+void mpr121_record_reset(mpr121_record_t *rec)
+{
+    rec->len = MPR121_RECORD_HEADER_LEN;
+    rec->frames = 0;
+    rec->dropped = 0;
+    rec->since_key = 0;
+}
+
+void mpr121_record_dump(const mpr121_record_t *rec, mpr121_record_sink_t sink, void *arg)
+{
+    // 标记+偏移+每字节两位十六进制
+    char line[sizeof(MPR121_RECORD_MARKER) + 8 + MPR121_RECORD_DUMP_BYTES * 2 + 1];
+
+    snprintf(line, sizeof(line), MPR121_RECORD_MARKER " BEGIN %u %lu", (unsigned)rec->len, (unsigned long)rec->frames);
+    sink ? sink(line, arg) : (void)printf("%s\n", line);
+    for (size_t off = 0; off < rec->len; off += MPR121_RECORD_DUMP_BYTES)
+    {
+        size_t chunk = rec->len - off < MPR121_RECORD_DUMP_BYTES ? rec->len - off : MPR121_RECORD_DUMP_BYTES;
+        int pos = snprintf(line, sizeof(line), MPR121_RECORD_MARKER " %06X ", (unsigned)off);
+        for (size_t i = 0; i < chunk; i++)
+        {
+            pos += snprintf(&line[pos], sizeof(line) - pos, "%02X", rec->buf[off + i]);
+        }
+        sink ? sink(line, arg) : (void)printf("%s\n", line);
+    }
+    snprintf(line, sizeof(line), MPR121_RECORD_MARKER " END");
+    sink ? sink(line, arg) : (void)printf("%s\n", line);
+    if (rec->dropped)
+    {
+        ESP_LOGW(TAG, "%lu frames dropped (buffer full)", (unsigned long)rec->dropped);
+    }
+}
+
+esp_err_t mpr121_record_parse_line(const char *line, uint8_t *buf, size_t cap, size_t *len)
+{
+    const char *p = strstr(line, MPR121_RECORD_MARKER " ");
+    if (p == NULL)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+    p += sizeof(MPR121_RECORD_MARKER);
+    if (strncmp(p, "BEGIN", 5) == 0 || strncmp(p, "END", 3) == 0)
+    {
+        return ESP_OK;
+    }
+
+    unsigned off = 0;
+    int consumed = 0;
+    if (sscanf(p, "%x %n", &off, &consumed) != 1)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    p += consumed;
+    size_t pos = off;
+    unsigned byte;
+    while (sscanf(p, "%2x", &byte) == 1)
+    {
+        if (pos >= cap)
+        {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        buf[pos++] = (uint8_t)byte;
+        p += 2;
+    }
+    *len = pos > *len ? pos : *len;
+    return ESP_OK;
+}
+
+esp_err_t mpr121_record_reader_init(mpr121_record_reader_t *reader, const uint8_t *data, size_t len)
+{
+    if (reader == NULL || data == NULL || len < MPR121_RECORD_HEADER_LEN ||
+        memcmp(data, s_record_magic, sizeof(s_record_magic)) != 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (data[4] != MPR121_RECORD_VERSION || data[5] != MPR121_NUM_CHANNELS)
+    {
+        ESP_LOGE(TAG, "Unsupported recording: version %u, %u channels", data[4], data[5]);
+        return ESP_ERR_INVALID_VERSION;
+    }
+
+    memset(reader, 0, sizeof(*reader));
+    reader->data = data;
+    reader->len = len;
+    reader->pos = MPR121_RECORD_HEADER_LEN;
+    reader->period_us = data[8] | (data[9] << 8) | (data[10] << 16) | ((uint32_t)data[11] << 24);
+    return ESP_OK;
+}
+
+esp_err_t mpr121_record_next(mpr121_record_reader_t *reader, mpr121_frame_t *frame)
+{
+    if (reader->pos >= reader->len)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    uint8_t flags = reader->data[reader->pos++];
+    mpr121_frame_t f = {0};
+    if (!(flags & MPR121_RECORD_FLAG_KEY))
+    {
+        f = reader->prev;
+    }
+
+    uint64_t v = 0;
+    if (!record_get_varint(reader, &v))
+    {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    f.timestamp_us += (int64_t)v;
+    if (((flags & MPR121_RECORD_FLAG_TOUCH) && !record_get_u16(reader, &f.touch_status)) ||
+        ((flags & MPR121_RECORD_FLAG_OOR) && !record_get_u16(reader, &f.oor_status)))
+    {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    for (int ch = 0; ch < MPR121_NUM_CHANNELS; ch++)
+    {
+        if (!record_get_varint(reader, &v))
+        {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        int32_t d = (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+        f.filtered[ch] = (uint16_t)(f.filtered[ch] + d);
+    }
+    if (flags & MPR121_RECORD_FLAG_BASE)
+    {
+        uint16_t base_mask = 0;
+        if (!record_get_u16(reader, &base_mask))
+        {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        for (int ch = 0; ch < MPR121_NUM_CHANNELS; ch++)
+        {
+            if (!(base_mask & (1 << ch)))
+            {
+                continue;
+            }
+            if (reader->pos >= reader->len)
+            {
+                return ESP_ERR_INVALID_SIZE;
+            }
+            f.baseline[ch] = (uint8_t)(f.baseline[ch] + reader->data[reader->pos++]);
+        }
+    }
+    for (int ch = 0; ch < MPR121_NUM_CHANNELS; ch++)
+    {
+        f.delta[ch] = (int16_t)((f.baseline[ch] << 2) - f.filtered[ch]);
+    }
+
+    reader->prev = f;
+    reader->frames++;
+    *frame = f;
+    return ESP_OK;
+}
@@ -0,0 +1,134 @@
+#ifndef MPR121_RECORD_H
+#define MPR121_RECORD_H
+
+#include <stdbool.h>
+#include "mpr121.h"
+
+// -------------------------- 可配置参数 --------------------------
+#define MPR121_RECORD_KEYFRAME_INTERVAL 256 // 关键帧间隔（帧）：关键帧不依赖前一帧，数据损坏后可从下一个关键帧恢复解码
+#define MPR121_RECORD_DUMP_BYTES 32         // 控制台导出时每行的字节数
+#define MPR121_RECORD_MARKER "MPR121REC"    // 控制台导出行的标记（主机端据此从日志中提取数据）
+
+/*
+ * 录制格式（小端）：
+ *   文件头（12字节）：'M' '1' '2' '1'，版本，通道数，关键帧间隔（u16），标称采样周期（u32，μs，0=未知）
+ *   每帧：标志字节（MPR121_RECORD_FLAG_*）
+ *         时间戳：关键帧为绝对值，其他帧为与前一帧之差（μs，无符号变长整数）
+ *         [TOUCH] 触摸状态u16  [OOR] 超范围状态u16
+ *         13个通道的滤波数据与前一帧之差（zigzag变长整数，噪声范围内每通道1字节）
+ *         [BASE] 基线变化通道掩码u16，随后每个变化通道1字节差值（模256）
+ *   关键帧以全零帧为前一帧，因此与普通帧共用同一编码。
+ */
+#define MPR121_RECORD_VERSION 2
+#define MPR121_RECORD_HEADER_LEN 12
+#define MPR121_RECORD_FRAME_MAX 56          // 单帧最大编码长度：1+10+2+2+13×2+2+13
+
+#define MPR121_RECORD_FLAG_KEY 0x01   // 关键帧
+#define MPR121_RECORD_FLAG_TOUCH 0x02 // 触摸状态有变化（关键帧中非零）
+#define MPR121_RECORD_FLAG_OOR 0x04   // 超范围状态有变化
+#define MPR121_RECORD_FLAG_BASE 0x08  // 基线有变化
+
+// -------------------------- 数据结构 --------------------------
+/**
+ * @brief 帧录制器：把完整帧差分编码写入调用者提供的缓冲区（写满后停止并计数丢弃）
+ */
+typedef struct
+{
+    uint8_t *buf;             // 输出缓冲区
+    size_t cap;               // 缓冲区容量
+    size_t len;               // 已写入字节数（含文件头）
+    uint32_t frames;          // 已录制帧数
+    uint32_t dropped;         // 缓冲区已满而丢弃的帧数
+    uint32_t since_key;       // 距上一个关键帧的帧数
+    mpr121_frame_t prev;      // 上一帧（差分参考）
+} mpr121_record_t;
+
+/**
+ * @brief 录制数据读取器（纯C，无硬件依赖，可在主机端解码导出的录制数据）
+ */
+typedef struct
+{
+    const uint8_t *data;      // 录制数据（含文件头）
+    size_t len;               // 数据长度
+    size_t pos;               // 下一帧的读取位置
+    uint32_t frames;          // 已解码帧数
+    uint32_t period_us;       // 文件头中的标称采样周期（μs，0=未知；实际间隔以各帧时间戳为准）
+    mpr121_frame_t prev;      // 上一帧（差分参考）
+} mpr121_record_reader_t;
+
+/**
+ * @brief 控制台导出的行输出回调
+ * @param line 一行文本（不含换行符）
+ * @param arg 用户参数
+ */
+typedef void (*mpr121_record_sink_t)(const char *line, void *arg);
+
+// -------------------------- 函数接口 --------------------------
+/**
+ * @brief 初始化录制器并写入文件头
+ * @param rec 录制器
+ * @param buf 输出缓冲区（调用者分配，录制与导出期间须保持有效）
+ * @param cap 缓冲区容量（噪声较小时约16~20字节/帧）
+ * @param period_us 标称采样周期（μs，写入文件头供离线分析；0=未知）
+ * @return esp_err_t ESP_OK: 初始化成功；ESP_ERR_INVALID_ARG: 参数无效或容量不足以容纳文件头
+ */
+esp_err_t mpr121_record_init(mpr121_record_t *rec, uint8_t *buf, size_t cap, uint32_t period_us);
+
+/**
+ * @brief 追加一帧（单生产者，无锁，无总线访问，可在采集路径中全速调用）
+ * @param rec 录制器
+ * @param frame 帧数据（来自mpr121_read_frame()，delta不录制，解码时由基线与滤波数据重新计算）
+ * @return esp_err_t ESP_OK: 已录制；ESP_ERR_NO_MEM: 缓冲区已满，该帧被丢弃
+ */
+esp_err_t mpr121_record_add(mpr121_record_t *rec, const mpr121_frame_t *frame);
+
+/**
+ * @brief 流水线处理回调形式的mpr121_record_add()（arg为mpr121_record_t*），可直接作为mpr121_pipeline_config_t.process
+ * @param arg 录制器
+ * @param frame 帧数据
+ */
+void mpr121_record_process(void *arg, const mpr121_frame_t *frame);
+
+/**
+ * @brief 清空已录制的数据（保留文件头），用于导出后继续录制下一段
+ * @param rec 录制器
+ */
+void mpr121_record_reset(mpr121_record_t *rec);
+
+/**
+ * @brief 以十六进制文本行导出录制数据：BEGIN行（字节数、帧数），数据行（偏移、数据），END行
+ * @param rec 录制器
+ * @param sink 行输出回调（NULL=printf输出到控制台）
+ * @param arg 回调参数
+ */
+void mpr121_record_dump(const mpr121_record_t *rec, mpr121_record_sink_t sink, void *arg);
+
+/**
+ * @brief 解析一行导出文本，把数据行写回缓冲区（行中标记前的日志前缀被忽略）
+ * @param line 一行文本
+ * @param[out] buf 录制数据缓冲区
+ * @param cap 缓冲区容量
+ * @param[in,out] len 已恢复的数据长度（取各数据行末尾的最大值）
+ * @return esp_err_t ESP_OK: 已处理（含BEGIN/END行）；ESP_ERR_NOT_FOUND: 不是导出行；
+ *         ESP_ERR_INVALID_SIZE: 超出缓冲区；ESP_ERR_INVALID_ARG: 格式错误
+ */
+esp_err_t mpr121_record_parse_line(const char *line, uint8_t *buf, size_t cap, size_t *len);
+
+/**
+ * @brief 初始化读取器并校验文件头
+ * @param reader 读取器
+ * @param data 录制数据
+ * @param len 数据长度
+ * @return esp_err_t ESP_OK: 成功；ESP_ERR_INVALID_ARG: 不是录制数据；ESP_ERR_INVALID_VERSION: 版本或通道数不匹配
+ */
+esp_err_t mpr121_record_reader_init(mpr121_record_reader_t *reader, const uint8_t *data, size_t len);
+
+/**
+ * @brief 解码下一帧（delta按(基线<<2)-滤波数据重新计算）
+ * @param reader 读取器
+ * @param[out] frame 帧数据
+ * @return esp_err_t ESP_OK: 成功；ESP_ERR_NOT_FOUND: 已到末尾；ESP_ERR_INVALID_SIZE: 数据被截断
+ */
+esp_err_t mpr121_record_next(mpr121_record_reader_t *reader, mpr121_frame_t *frame);
+
+#endif // MPR121_RECORD_H
@@ -0,0 +1,140 @@
+#include "mpr121_recover.h"
+#include "mpr121_trace.h"
+#include <string.h>
+#include <esp_timer.h>
+
+static const char *TAG = "mpr121_recover";
+
+// -------------------------- 静态辅助函数（仅内部使用） --------------------------
+/**
+ * @brief 记录一次恢复结果
+ * @param rec 恢复器
+ * @param start_us 故障确认时刻
+ * @param replayed 是否重放了配置
+ * @param err 恢复结果
+ */
+static void recover_account(mpr121_recover_t *rec, int64_t start_us, bool replayed, esp_err_t err)
+{
+    if (err != ESP_OK)
+    {
+        rec->stats.failures++;
+        MPR121_TRACE(MPR121_TRACE_RECOVERY, rec->dev->addr, replayed, -(int32_t)err);
+        return;
+    }
+
+    uint32_t us = (uint32_t)(esp_timer_get_time() - start_us);
+    rec->stats.recoveries++;
+    rec->stats.last_us = us;
+    if (us > rec->stats.max_us)
+    {
+        rec->stats.max_us = us;
+    }
+    rec->total_us += us;
+    MPR121_TRACE(MPR121_TRACE_RECOVERY, rec->dev->addr, replayed, (int32_t)us);
+}
+
+/**
+ * @brief 芯片已应答后恢复扫描：配置丢失时重放，最后读取触摸状态
+ *
+ * 故障期间未读取的触摸状态使IRQ保持拉低，下降沿中断不会再次触发，须在此读取一次释放引脚。
+ * @param rec 恢复器
+ * @param start_us 故障确认时刻
+ * @param intact 配置是否完好
+ * @return esp_err_t ESP_OK: 恢复成功；其他: 重放或读取失败
+ */
+static esp_err_t recover_restore(mpr121_recover_t *rec, int64_t start_us, bool intact)
+{
+    esp_err_t err = ESP_OK;
+    if (!intact)
+    {
+        err = mpr121_cfg_replay(rec->dev);
+        rec->stats.replays += err == ESP_OK;
+    }
+    if (err == ESP_OK)
+    {
+        uint16_t touch = 0;
+        err = mpr121_read_touch(rec->dev, &touch);
+    }
+    recover_account(rec, start_us, !intact, err);
+    return err;
+}
+
+// -------------------------- 外部接口实现 --------------------------
+esp_err_t mpr121_recover_init(mpr121_recover_t *rec, mpr121_dev_t *dev, const mpr121_recover_config_t *cfg)
+{
+    if (rec == NULL || dev == NULL || cfg == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(rec, 0, sizeof(*rec));
+    rec->dev = dev;
+    rec->cfg = *cfg;
+    return ESP_OK;
+}
+
+esp_err_t mpr121_recover_run(mpr121_recover_t *rec, esp_err_t cause)
+{
+    int64_t start_us = esp_timer_get_time();
+    rec->stats.faults++;
+
+    // 探测：回读配置同时确认芯片应答；卡死的总线先复位，NACK则先给芯片上电时间
+    bool intact = false;
+    esp_err_t err = cause;
+    for (int probe = 0; probe < MPR121_RECOVER_PROBES; probe++)
+    {
+        if (probe > 0)
+        {
+            vTaskDelay(pdMS_TO_TICKS(MPR121_RECOVER_RETRY_MS));
+        }
+        if (rec->cfg.bus_reset != NULL && (probe > 0 || cause != ESP_ERR_INVALID_RESPONSE))
+        {
+            rec->stats.bus_resets++;
+            if (rec->cfg.bus_reset(rec->cfg.bus_reset_arg) != ESP_OK)
+            {
+                continue;
+            }
+        }
+        err = mpr121_cfg_verify(rec->dev, &intact);
+        if (err == ESP_OK)
+        {
+            break;
+        }
+    }
+    if (err != ESP_OK)
+    {
+        recover_account(rec, start_us, false, err);
+        ESP_LOGE(TAG, "MPR121 0x%02X not responding after %d probes: %s", rec->dev->addr, MPR121_RECOVER_PROBES,
+                 esp_err_to_name(err));
+        return err;
+    }
+    return recover_restore(rec, start_us, intact);
+}
+
+esp_err_t mpr121_recover_check(mpr121_recover_t *rec)
+{
+    bool intact = false;
+    int64_t start_us = esp_timer_get_time();
+    esp_err_t err = mpr121_cfg_verify(rec->dev, &intact);
+    if (err != ESP_OK)
+    {
+        return mpr121_recover_run(rec, err);
+    }
+    if (intact)
+    {
+        return ESP_OK;
+    }
+    rec->stats.faults++;
+    return recover_restore(rec, start_us, false);
+}
+
+void mpr121_recover_get_stats(mpr121_recover_t *rec, mpr121_recover_stats_t *stats)
+{
+    if (rec == NULL || stats == NULL)
+    {
+        return;
+    }
+
+    *stats = rec->stats;
+    stats->avg_us = rec->stats.recoveries ? (uint32_t)(rec->total_us / rec->stats.recoveries) : 0;
+}
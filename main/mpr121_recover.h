@@ -0,0 +1,87 @@
+#ifndef MPR121_RECOVER_H
+#define MPR121_RECOVER_H
+
+#include "mpr121.h"
+
+// -------------------------- 可配置参数 --------------------------
+#define MPR121_RECOVER_PROBES 4    // 每次恢复最多探测芯片的次数（每次探测前复位总线）
+#define MPR121_RECOVER_RETRY_MS 2  // 探测失败后的重试间隔（芯片上电约需1ms）
+
+// -------------------------- 数据结构 --------------------------
+/**
+ * @brief 总线复位回调（如封装i2c_master_bus_reset()：发送SCL脉冲释放被从机拉住的SDA）
+ * @param arg 配置中的参数
+ * @return esp_err_t ESP_OK: 复位成功；其他: 复位失败
+ */
+typedef esp_err_t (*mpr121_bus_reset_t)(void *arg);
+
+/**
+ * @brief 故障恢复配置
+ */
+typedef struct
+{
+    mpr121_bus_reset_t bus_reset; // 总线复位（NULL=不复位总线，仅重试）
+    void *bus_reset_arg;          // 总线复位参数（如i2c_master_bus_handle_t）
+} mpr121_recover_config_t;
+
+/**
+ * @brief 故障恢复统计
+ */
+typedef struct
+{
+    uint32_t faults;      // 触发恢复的次数（传输失败或配置校验失败）
+    uint32_t recoveries;  // 恢复成功次数
+    uint32_t failures;    // 恢复失败次数（探测次数用尽芯片仍无应答）
+    uint32_t replays;     // 检测到配置丢失并重放的次数
+    uint32_t bus_resets;  // 总线复位次数
+    uint32_t last_us;     // 最近一次恢复耗时（故障确认到芯片恢复扫描）
+    uint32_t max_us;      // 最大恢复耗时
+    uint32_t avg_us;      // 平均恢复耗时
+} mpr121_recover_stats_t;
+
+/**
+ * @brief 总线故障恢复器（由访问该设备的任务调用，无内部任务）
+ */
+typedef struct
+{
+    mpr121_dev_t *dev;              // 设备句柄
+    mpr121_recover_config_t cfg;    // 配置
+    mpr121_recover_stats_t stats;   // 统计
+    uint64_t total_us;              // 恢复耗时累计（求平均）
+} mpr121_recover_t;
+
+// -------------------------- 函数接口 --------------------------
+/**
+ * @brief 初始化故障恢复器
+ * @param rec 恢复器
+ * @param dev 已初始化的设备句柄（此后的配置修改须经影子缓存提交，恢复时据此重放）
+ * @param cfg 配置
+ * @return esp_err_t ESP_OK: 初始化成功；ESP_ERR_INVALID_ARG: 参数无效
+ */
+esp_err_t mpr121_recover_init(mpr121_recover_t *rec, mpr121_dev_t *dev, const mpr121_recover_config_t *cfg);
+
+/**
+ * @brief 传输失败后恢复：复位总线并探测芯片，配置丢失时重放影子缓存，最后读取触摸状态释放IRQ引脚
+ * @note NACK（芯片可能正在上电）时首次探测前不复位总线；超时等其他错误先复位总线
+ * @param rec 恢复器
+ * @param cause 失败传输的错误码
+ * @return esp_err_t ESP_OK: 恢复成功；其他: 芯片仍无应答或重放失败（可稍后再次调用）
+ */
+esp_err_t mpr121_recover_run(mpr121_recover_t *rec, esp_err_t cause);
+
+/**
+ * @brief 周期校验：回读配置检测静默的掉电复位（芯片停止扫描且不再产生IRQ），丢失时执行恢复
+ * @note 一次4字节读取，适合在无中断的等待超时后调用
+ * @param rec 恢复器
+ * @return esp_err_t ESP_OK: 配置完好或已恢复；其他: 恢复失败
+ */
+esp_err_t mpr121_recover_check(mpr121_recover_t *rec);
+
+/**
+ * @brief 获取故障恢复统计
+ * @param rec 恢复器
+ * @param[out] stats 统计信息
+ */
+void mpr121_recover_get_stats(mpr121_recover_t *rec, mpr121_recover_stats_t *stats);
+
+#endif // MPR121_RECOVER_H
@@ -0,0 +1,184 @@
+#include "mpr121_replay.h"
+#include <string.h>
+
+static const char *TAG = "mpr121_replay";
+
+// -------------------------- 外部接口实现 --------------------------
+esp_err_t mpr121_replay_init(mpr121_replay_t *replay, mpr121_replay_frame_t *frames, size_t cap)
+{
+    if (replay == NULL || frames == NULL || cap == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    replay->frames = frames;
+    replay->cap = cap;
+    replay->count = 0;
+    return ESP_OK;
+}
+
+esp_err_t mpr121_replay_load(mpr121_replay_t *replay, const uint8_t *data, size_t len)
+{
+    mpr121_record_reader_t reader;
+    mpr121_frame_t frame;
+    esp_err_t err;
+
+    ESP_RETURN_ON_ERROR(mpr121_record_reader_init(&reader, data, len), TAG, "Invalid recording");
+    replay->count = 0;
+    int64_t t0 = 0;
+    while ((err = mpr121_record_next(&reader, &frame)) == ESP_OK)
+    {
+        if (replay->count == replay->cap)
+        {
+            ESP_LOGW(TAG, "Recording truncated to %u frames", (unsigned)replay->cap);
+            return ESP_ERR_NO_MEM;
+        }
+        if (replay->count == 0)
+        {
+            t0 = frame.timestamp_us;
+        }
+        mpr121_replay_frame_t *f = &replay->frames[replay->count++];
+        f->t_us = (uint32_t)(frame.timestamp_us - t0);
+        f->touch = frame.touch_status & MPR121_STATUS_CH_MASK;
+        f->truth = f->touch;
+        memcpy(f->delta, frame.delta, sizeof(f->delta));
+    }
+    if (err != ESP_ERR_NOT_FOUND)
+    {
+        ESP_LOGE(TAG, "Recording corrupted after %u frames", (unsigned)replay->count);
+        return err;
+    }
+    return ESP_OK;
+}
+
+void mpr121_replay_label(mpr121_replay_t *replay, size_t first, size_t end, uint16_t channels, bool touched)
+{
+    end = end < replay->count ? end : replay->count;
+    for (size_t i = first; i < end; i++)
+    {
+        replay->frames[i].truth = touched ? (replay->frames[i].truth | channels) : (replay->frames[i].truth & ~channels);
+    }
+}
+
+void mpr121_replay_run(const mpr121_replay_t *replay, uint16_t channels, const mpr121_replay_params_t *params,
+                       mpr121_replay_result_t *result)
+{
+    // 逐通道状态：判定状态、去抖计数、当前参考触摸的开始时刻与是否已命中
+    uint8_t count[MPR121_NUM_CHANNELS] = {0};
+    uint32_t start_us[MPR121_NUM_CHANNELS] = {0};
+    uint16_t touched = 0, truth_prev = 0, hit = 0;
+    uint64_t latency_sum = 0;
+    const int32_t touch_th = params->touch_th, release_th = params->release_th;
+
+    memset(result, 0, sizeof(*result));
+    result->params = *params;
+    for (size_t i = 0; i < replay->count; i++)
+    {
+        const mpr121_replay_frame_t *f = &replay->frames[i];
+        uint16_t truth = f->truth & channels;
+
+        // 参考触摸的开始与结束
+        uint16_t began = truth & ~truth_prev;
+        uint16_t ended = truth_prev & ~truth;
+        result->touches += __builtin_popcount(began);
+        result->misses += __builtin_popcount(ended & ~hit);
+        hit &= ~(began | ended);
+        truth_prev = truth;
+
+        for (int ch = 0; ch < MPR121_NUM_CHANNELS; ch++)
+        {
+            uint16_t bit = 1 << ch;
+            if (!(channels & bit))
+            {
+                continue;
+            }
+            if (began & bit)
+            {
+                start_us[ch] = f->t_us;
+            }
+
+            // 与芯片相同的判定：越过阈值连续(去抖次数+1)次后翻转，中途回落则计数清零
+            int32_t delta = f->delta[ch];
+            if (!(touched & bit))
+            {
+                if (delta <= touch_th)
+                {
+                    count[ch] = 0;
+                    continue;
+                }
+                if (++count[ch] <= params->dt)
+                {
+                    continue;
+                }
+                count[ch] = 0;
+                touched |= bit;
+                if ((truth & bit) && !(hit & bit))
+                {
+                    uint32_t latency = f->t_us - start_us[ch];
+                    hit |= bit;
+                    result->hits++;
+                    latency_sum += latency;
+                    result->latency_max_us = latency > result->latency_max_us ? latency : result->latency_max_us;
+                }
+                else
+                {
+                    result->false_triggers++;
+                }
+            }
+            else if (delta < release_th)
+            {
+                if (++count[ch] > params->dr)
+                {
+                    count[ch] = 0;
+                    touched &= ~bit;
+                }
+            }
+            else
+            {
+                count[ch] = 0;
+            }
+        }
+    }
+    result->misses += __builtin_popcount(truth_prev & ~hit); // 录制结束时仍未命中的参考触摸
+
+    result->latency_avg_us = result->hits ? (uint32_t)(latency_sum / result->hits) : 0;
+    result->cost = latency_sum + (uint64_t)result->false_triggers * MPR121_REPLAY_FALSE_COST_US +
+                   (uint64_t)result->misses * MPR121_REPLAY_MISS_COST_US;
+}
+
+uint32_t mpr121_replay_sweep(const mpr121_replay_t *replay, const mpr121_replay_grid_t *grid,
+                             mpr121_replay_result_t *best)
+{
+    mpr121_replay_result_t result;
+    uint32_t evaluated = 0;
+    uint8_t touch_step = grid->touch_step ? grid->touch_step : 1;
+    uint8_t release_step = grid->release_step ? grid->release_step : 1;
+
+    memset(best, 0, sizeof(*best));
+    best->cost = UINT64_MAX;
+    for (unsigned th = grid->touch_min; th <= grid->touch_max; th += touch_step)
+    {
+        for (unsigned rel = grid->release_min; rel < th; rel += release_step)
+        {
+            for (unsigned dt = 0; dt <= grid->dt_max && dt <= 7; dt++)
+            {
+                for (unsigned dr = 0; dr <= grid->dr_max && dr <= 7; dr++)
+                {
+                    const mpr121_replay_params_t params = {
+                        .touch_th = th,
+                        .release_th = rel,
+                        .dt = dt,
+                        .dr = dr,
+                    };
+                    mpr121_replay_run(replay, grid->channels, &params, &result);
+                    evaluated++;
+                    if (result.cost < best->cost)
+                    {
+                        *best = result;
+                    }
+                }
+            }
+        }
+    }
+    return evaluated;
+}
@@ -0,0 +1,123 @@
+#ifndef MPR121_REPLAY_H
+#define MPR121_REPLAY_H
+
+#include <stdbool.h>
+#include "mpr121.h"
+#include "mpr121_record.h"
+
+// -------------------------- 可配置参数 --------------------------
+#define MPR121_REPLAY_FALSE_COST_US 250000 // 评分：一次误触发折算的延迟（μs）
+#define MPR121_REPLAY_MISS_COST_US 1000000 // 评分：一次漏检折算的延迟（μs）
+
+// -------------------------- 数据结构 --------------------------
+/**
+ * @brief 回放帧（解码后只保留判定所需的字段）
+ */
+typedef struct
+{
+    uint32_t t_us;                        // 相对首帧的时间（μs）
+    uint16_t touch;                       // 录制时芯片输出的触摸状态
+    uint16_t truth;                       // 参考触摸状态（默认等于touch，可按标注修改）
+    int16_t delta[MPR121_NUM_CHANNELS];   // (基线<<2) - 滤波数据
+} mpr121_replay_frame_t;
+
+/**
+ * @brief 候选判定参数（与芯片寄存器语义相同）
+ */
+typedef struct
+{
+    uint8_t touch_th;   // 触摸阈值：delta > touch_th连续dt+1次判定按下
+    uint8_t release_th; // 释放阈值：delta < release_th连续dr+1次判定释放
+    uint8_t dt;         // 触摸去抖次数（0~7）
+    uint8_t dr;         // 释放去抖次数（0~7）
+} mpr121_replay_params_t;
+
+/**
+ * @brief 一组参数的回放结果
+ */
+typedef struct
+{
+    mpr121_replay_params_t params; // 参数
+    uint32_t touches;              // 参考中的触摸次数
+    uint32_t hits;                 // 在参考触摸期间首次按下的次数
+    uint32_t misses;               // 参考触摸期间没有按下的次数
+    uint32_t false_triggers;       // 参考触摸之外的按下及同一次触摸中的重复按下
+    uint32_t latency_avg_us;       // 命中时从参考触摸开始到按下的平均延迟
+    uint32_t latency_max_us;       // 最大延迟
+    uint64_t cost;                 // 评分：延迟总和 + 误触发与漏检的折算延迟（越小越好）
+} mpr121_replay_result_t;
+
+/**
+ * @brief 参数扫描网格（release_th取release_min起、小于touch_th的值）
+ */
+typedef struct
+{
+    uint8_t touch_min, touch_max, touch_step; // 触摸阈值范围
+    uint8_t release_min, release_step;        // 释放阈值起点与步长
+    uint8_t dt_max, dr_max;                   // 去抖次数上限（0~7）
+    uint16_t channels;                        // 参与评分的通道
+} mpr121_replay_grid_t;
+
+/**
+ * @brief 离线回放引擎：把录制数据解码为回放帧，按候选参数重新执行芯片的阈值/去抖判定并评分
+ *
+ * 纯C，无硬件依赖，供linux目标离线调参。基线取录制值：芯片在触摸期间冻结基线，
+ * 候选参数与录制时差别很大时基线行为会有偏差，宜以接近最终值的参数录制。
+ */
+typedef struct
+{
+    mpr121_replay_frame_t *frames; // 回放帧（调用者分配）
+    size_t cap;                    // 容量
+    size_t count;                  // 已载入帧数
+} mpr121_replay_t;
+
+// -------------------------- 函数接口 --------------------------
+/**
+ * @brief 初始化回放引擎
+ * @param replay 回放引擎
+ * @param frames 回放帧缓冲区（调用者分配）
+ * @param cap 容量（帧）
+ * @return esp_err_t ESP_OK: 成功；ESP_ERR_INVALID_ARG: 参数无效
+ */
+esp_err_t mpr121_replay_init(mpr121_replay_t *replay, mpr121_replay_frame_t *frames, size_t cap);
+
+/**
+ * @brief 解码录制数据并载入（参考触摸状态初始化为录制时的触摸状态）
+ * @param replay 回放引擎
+ * @param data 录制数据（mpr121_record_t.buf或由mpr121_record_parse_line()恢复的数据）
+ * @param len 数据长度
+ * @return esp_err_t ESP_OK: 成功；ESP_ERR_NO_MEM: 帧数超过容量（已载入的帧保留）；其他: 数据格式错误
+ */
+esp_err_t mpr121_replay_load(mpr121_replay_t *replay, const uint8_t *data, size_t len);
+
+/**
+ * @brief 标注参考触摸：[first, end)帧内channels的参考状态设为touched
+ * @param replay 回放引擎
+ * @param first 起始帧
+ * @param end 结束帧（不含，超出时截断）
+ * @param channels 通道掩码
+ * @param touched 参考状态
+ */
+void mpr121_replay_label(mpr121_replay_t *replay, size_t first, size_t end, uint16_t channels, bool touched);
+
+/**
+ * @brief 以一组参数回放全部帧并评分
+ * @param replay 回放引擎
+ * @param channels 参与评分的通道
+ * @param params 候选参数
+ * @param[out] result 结果
+ */
+void mpr121_replay_run(const mpr121_replay_t *replay, uint16_t channels, const mpr121_replay_params_t *params,
+                       mpr121_replay_result_t *result);
+
+/**
+ * @brief 扫描网格中的全部参数组合，返回评分最好的一组
+ * @param replay 回放引擎
+ * @param grid 扫描网格
+ * @param[out] best 最优结果
+ * @return uint32_t 评估的组合数
+ */
+uint32_t mpr121_replay_sweep(const mpr121_replay_t *replay, const mpr121_replay_grid_t *grid,
+                             mpr121_replay_result_t *best);
+
+#endif // MPR121_REPLAY_H
@@ -0,0 +1,160 @@
+#include "mpr121_scan.h"
+#include "mpr121_trace.h"
+#include <string.h>
+#include <esp_timer.h>
+
+static const char *TAG = "mpr121_scan";
+
+#define SCAN_RATE_WINDOW_US 1000000 // 帧率统计窗口（1s）
+
+// -------------------------- 静态辅助函数（仅内部使用） --------------------------
+/**
+ * @brief 将第index片芯片的原始触摸状态解码并写入合并掩码
+ * @param mask 合并掩码
+ * @param index 芯片序号
+ * @param raw 原始触摸状态（0x00~0x01）
+ * @return uint64_t 更新后的合并掩码
+ */
+static inline uint64_t scan_decode(uint64_t mask, uint8_t index, const uint8_t raw[2])
+{
+    uint64_t bits = ((raw[1] << 8) | raw[0]) & 0x0FFF; // 仅ELE0~ELE11
+    uint8_t shift = index * MPR121_NUM_ELECTRODES;
+    return (mask & ~(0x0FFFULL << shift)) | (bits << shift);
+}
+
+/**
+ * @brief 更新帧计数与1s窗口帧率
+ * @param scanner 扫描器
+ * @param now 当前时刻
+ */
+static void scan_count_frame(mpr121_scanner_t *scanner, int64_t now)
+{
+    scanner->frames++;
+    scanner->window_frames++;
+    int64_t elapsed = now - scanner->window_start_us;
+    if (elapsed >= SCAN_RATE_WINDOW_US)
+    {
+        scanner->frame_rate = (uint32_t)((int64_t)scanner->window_frames * 1000000 / elapsed);
+        scanner->window_frames = 0;
+        scanner->window_start_us = now;
+    }
+}
+
+// -------------------------- 外部接口实现 --------------------------
+esp_err_t mpr121_scanner_init(mpr121_scanner_t *scanner, mpr121_dev_t *const devs[], uint8_t count)
+{
+    if (scanner == NULL || devs == NULL || count == 0 || count > MPR121_MAX_DEVICES)
+    {
+        ESP_LOGE(TAG, "Invalid scanner args (count %d)", count);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(scanner, 0, sizeof(*scanner));
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (devs[i] == NULL)
+        {
+            return ESP_ERR_INVALID_ARG;
+        }
+        scanner->devs[i] = devs[i];
+    }
+    scanner->count = count;
+    scanner->window_start_us = esp_timer_get_time();
+    return ESP_OK;
+}
+
+esp_err_t mpr121_scanner_scan(mpr121_scanner_t *scanner, uint64_t *touch_mask)
+{
+    if (scanner == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    int64_t start = esp_timer_get_time();
+    uint64_t mask = scanner->touch_mask;
+    // 逐片阻塞读取：每次读取返回后才发起下一片（传输不重叠，需要多传输在途时使用mpr121_scanner_scan_async()）
+    for (uint8_t i = 0; i < scanner->count; i++)
+    {
+        uint8_t raw[2];
+        esp_err_t err = mpr121_read_regs(scanner->devs[i], MPR121_TOUCHSTATUS_L, raw, sizeof(raw));
+        if (err != ESP_OK)
+        {
+            return err; // 已写入跟踪记录
+        }
+        mask = scan_decode(mask, i, raw);
+    }
+    scanner->touch_mask = mask;
+
+    // 帧率统计（按1s窗口滚动）；同步读取期间任务无法做其他事，全部计为忙碌
+    int64_t now = esp_timer_get_time();
+    scanner->busy_us += now - start;
+    scan_count_frame(scanner, now);
+
+    if (touch_mask != NULL)
+    {
+        *touch_mask = mask;
+    }
+    return ESP_OK;
+}
+
+esp_err_t mpr121_scanner_scan_async(mpr121_scanner_t *scanner, mpr121_async_t *async, uint64_t *touch_mask)
+{
+    if (scanner == NULL || async == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    int handles[MPR121_MAX_DEVICES];
+    esp_err_t submit_err[MPR121_MAX_DEVICES];
+    int64_t start = esp_timer_get_time();
+    uint64_t wait_before = async->stats.wait_us;
+
+    // 一次性提交所有芯片的读取，I2C驱动按队列顺序依次完成
+    for (uint8_t i = 0; i < scanner->count; i++)
+    {
+        submit_err[i] = mpr121_async_submit(async, scanner->devs[i], MPR121_TOUCHSTATUS_L, 2,
+                                            MPR121_SCAN_DEADLINE_US, MPR121_SCAN_RETRIES, &handles[i]);
+    }
+    mpr121_async_wait(async);
+
+    esp_err_t ret = ESP_OK;
+    uint64_t mask = scanner->touch_mask;
+    for (uint8_t i = 0; i < scanner->count; i++)
+    {
+        uint8_t raw[2];
+        esp_err_t err = submit_err[i] == ESP_OK ? mpr121_async_collect(async, handles[i], raw) : submit_err[i];
+        if (err == ESP_OK)
+        {
+            mask = scan_decode(mask, i, raw);
+        }
+        else
+        {
+            MPR121_TRACE(MPR121_TRACE_READ_ERROR, scanner->devs[i]->addr, MPR121_TOUCHSTATUS_L, err);
+            ret = err;
+        }
+    }
+    scanner->touch_mask = mask;
+
+    int64_t now = esp_timer_get_time();
+    uint64_t waited = async->stats.wait_us - wait_before;
+    scanner->free_us += waited;
+    scanner->busy_us += (now - start) - waited;
+    scan_count_frame(scanner, now);
+
+    if (touch_mask != NULL)
+    {
+        *touch_mask = mask;
+    }
+    return ret;
+}
+
+uint32_t mpr121_scanner_get_idle_permille(const mpr121_scanner_t *scanner)
+{
+    uint64_t total = scanner->busy_us + scanner->free_us;
+    return total ? (uint32_t)(scanner->free_us * 1000 / total) : 0;
+}
+
+uint32_t mpr121_scanner_get_frame_rate(const mpr121_scanner_t *scanner)
+{
+    return scanner != NULL ? scanner->frame_rate : 0;
+}
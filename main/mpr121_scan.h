@@ -0,0 +1,72 @@
+#ifndef MPR121_SCAN_H
+#define MPR121_SCAN_H
+
+#include "mpr121.h"
+#include "mpr121_async.h"
+
+// -------------------------- 可配置参数 --------------------------
+#define MPR121_SCAN_DEADLINE_US 5000 // 异步扫描中单片读取的截止时间（含重试）
+#define MPR121_SCAN_RETRIES 2        // 异步扫描中单片读取失败后的重试次数
+
+// -------------------------- 数据结构 --------------------------
+/**
+ * @brief 多芯片触摸扫描器（同一总线最多4片MPR121，合并为48位触摸掩码）
+ */
+typedef struct
+{
+    mpr121_dev_t *devs[MPR121_MAX_DEVICES]; // 参与扫描的设备（顺序决定掩码中的位置）
+    uint8_t count;                          // 设备数量
+    uint64_t touch_mask;                    // 合并触摸掩码：bit(12*i+e)对应第i片的ELEe
+    uint32_t frames;                        // 累计完成的扫描帧数
+    uint32_t window_frames;                 // 当前统计窗口内的帧数
+    int64_t window_start_us;                // 当前统计窗口起始时刻
+    uint32_t frame_rate;                    // 最近一个完整窗口（1s）的帧率（帧/秒）
+    uint64_t busy_us;                       // 扫描任务占用时间（同步扫描为全部耗时：任务阻塞在传输调用中无法做其他事）
+    uint64_t free_us;                       // 扫描期间任务让出CPU等待完成的时间（仅异步扫描）
+} mpr121_scanner_t;
+
+// -------------------------- 函数接口 --------------------------
+/**
+ * @brief 初始化扫描器
+ * @param scanner 扫描器
+ * @param devs 已初始化的设备句柄数组
+ * @param count 设备数量（1~4）
+ * @return esp_err_t ESP_OK: 初始化成功；ESP_ERR_INVALID_ARG: 参数无效
+ */
+esp_err_t mpr121_scanner_init(mpr121_scanner_t *scanner, mpr121_dev_t *const devs[], uint8_t count);
+
+/**
+ * @brief 扫描所有芯片的触摸状态（每片一次阻塞的2字节突发读取，逐片依次进行），更新合并掩码与帧率
+ * @note 阻塞接口不做流水线：前一片读取返回后才发起下一片，耗时约为单片的count倍；
+ *       需要多片读取重叠时使用mpr121_scanner_scan_async()
+ * @param scanner 扫描器
+ * @param[out] touch_mask 合并后的48位触摸掩码（可为NULL）
+ * @return esp_err_t ESP_OK: 扫描成功；其他: 某片读取失败（掩码保持上一帧）
+ */
+esp_err_t mpr121_scanner_scan(mpr121_scanner_t *scanner, uint64_t *touch_mask);
+
+/**
+ * @brief 异步扫描：一次性向所有芯片提交2字节读取（多个传输同时在途），阻塞等待完成通知后解码
+ * @note 设备须以mpr121_add_device_async()添加（或使用模拟器）；每个读取带截止时间与有限重试
+ * @param scanner 扫描器
+ * @param async 异步上下文（须在调用任务中初始化）
+ * @param[out] touch_mask 合并后的48位触摸掩码（可为NULL）
+ * @return esp_err_t ESP_OK: 扫描成功；其他: 某片读取失败或超时（该片掩码保持上一帧，其余芯片照常更新）
+ */
+esp_err_t mpr121_scanner_scan_async(mpr121_scanner_t *scanner, mpr121_async_t *async, uint64_t *touch_mask);
+
+/**
+ * @brief 获取扫描期间任务的忙碌/空闲时间占比
+ * @param scanner 扫描器
+ * @return uint32_t 空闲时间占扫描总时间的千分比（0~1000）
+ */
+uint32_t mpr121_scanner_get_idle_permille(const mpr121_scanner_t *scanner);
+
+/**
+ * @brief 获取扫描器最近1秒的聚合帧率
+ * @param scanner 扫描器
+ * @return uint32_t 帧/秒
+ */
+uint32_t mpr121_scanner_get_frame_rate(const mpr121_scanner_t *scanner);
+
+#endif // MPR121_SCAN_H
@@ -0,0 +1,372 @@
+#include "mpr121_sched.h"
+#include <string.h>
+#include <esp_timer.h>
+
+static const char *TAG = "mpr121_sched";
+
+// -------------------------- I2C底层传输（ESP-IDF i2c_master） --------------------------
+#if MPR121_I2C_SUPPORTED
+static esp_err_t sched_i2c_write(void *ctx, const uint8_t *addr, size_t addr_len, const uint8_t *data, size_t len)
+{
+    i2c_master_transmit_multi_buffer_info_t buffers[2] = {
+        {.write_buffer = (uint8_t *)addr, .buffer_size = addr_len},
+        {.write_buffer = (uint8_t *)data, .buffer_size = len},
+    };
+    return i2c_master_multi_buffer_transmit((i2c_master_dev_handle_t)ctx, buffers, 2, MPR121_I2C_TIMEOUT_MS);
+}
+
+static esp_err_t sched_i2c_read(void *ctx, const uint8_t *addr, size_t addr_len, uint8_t *data, size_t len)
+{
+    return i2c_master_transmit_receive((i2c_master_dev_handle_t)ctx, addr, addr_len, data, len, MPR121_I2C_TIMEOUT_MS);
+}
+
+static const mpr121_sched_io_t s_sched_i2c_io = {
+    .write = sched_i2c_write,
+    .read = sched_i2c_read,
+};
+#endif // MPR121_I2C_SUPPORTED
+
+// -------------------------- MPR121总线操作（经调度器） --------------------------
+static esp_err_t sched_dev_write(void *ctx, uint8_t reg, const uint8_t *data, size_t len)
+{
+    return mpr121_sched_write((mpr121_sched_client_t *)ctx, reg, data, len);
+}
+
+static esp_err_t sched_dev_read(void *ctx, uint8_t reg, uint8_t *data, size_t len)
+{
+    mpr121_sched_client_t *client = (mpr121_sched_client_t *)ctx;
+    // 触摸/超范围状态读取决定触摸延迟，优先于总线上的其他所有请求
+    mpr121_sched_class_t cls = reg + len <= MPR121_OORSTATUS_H + 1 ? MPR121_SCHED_URGENT : client->cfg.cls;
+    return mpr121_sched_transfer(client, cls, true, reg, data, len);
+}
+
+static const mpr121_bus_ops_t s_sched_dev_ops = {
+    .write = sched_dev_write,
+    .read = sched_dev_read,
+};
+
+// -------------------------- 静态辅助函数（仅内部使用） --------------------------
+/**
+ * @brief 从等待队列中移除客户端（调用者持有lock）
+ * @return bool true: 已移除；false: 不在队列中（已被移交总线）
+ */
+static bool sched_dequeue(mpr121_sched_t *sched, mpr121_sched_client_t *client, mpr121_sched_class_t cls)
+{
+    mpr121_sched_client_t *prev = NULL;
+    for (mpr121_sched_client_t *c = sched->head[cls]; c != NULL; prev = c, c = c->next)
+    {
+        if (c != client)
+        {
+            continue;
+        }
+        if (prev != NULL)
+        {
+            prev->next = c->next;
+        }
+        else
+        {
+            sched->head[cls] = c->next;
+        }
+        if (sched->tail[cls] == c)
+        {
+            sched->tail[cls] = prev;
+        }
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief 占用总线：空闲时直接占用，否则排队等待移交
+ * @param client 客户端
+ * @param cls 优先级类别
+ * @param[out] wait_us 排队延迟
+ * @return esp_err_t ESP_OK: 已占用；ESP_ERR_TIMEOUT: 等待超时
+ */
+static esp_err_t sched_acquire(mpr121_sched_client_t *client, mpr121_sched_class_t cls, uint32_t *wait_us)
+{
+    mpr121_sched_t *sched = client->sched;
+    int64_t start = esp_timer_get_time();
+
+    xSemaphoreTake(sched->lock, portMAX_DELAY);
+    if (!sched->busy)
+    {
+        sched->busy = true; // 总线空闲即意味着队列为空（释放时直接移交给等待者）
+        xSemaphoreGive(sched->lock);
+        *wait_us = 0;
+        return ESP_OK;
+    }
+    client->next = NULL;
+    if (sched->tail[cls] != NULL)
+    {
+        sched->tail[cls]->next = client;
+    }
+    else
+    {
+        sched->head[cls] = client;
+    }
+    sched->tail[cls] = client;
+    xSemaphoreGive(sched->lock);
+
+    if (xSemaphoreTake(client->grant, pdMS_TO_TICKS(MPR121_SCHED_WAIT_MS)) != pdTRUE)
+    {
+        xSemaphoreTake(sched->lock, portMAX_DELAY);
+        bool removed = sched_dequeue(sched, client, cls);
+        xSemaphoreGive(sched->lock);
+        if (removed)
+        {
+            return ESP_ERR_TIMEOUT;
+        }
+        xSemaphoreTake(client->grant, portMAX_DELAY); // 超时的同时已被移交：移交信号必然到达
+    }
+    client->stats.waited++;
+    *wait_us = (uint32_t)(esp_timer_get_time() - start);
+    return ESP_OK;
+}
+
+/**
+ * @brief 释放总线：移交给最高类别中最早到达的等待者，无等待者时置为空闲
+ */
+static void sched_release(mpr121_sched_t *sched)
+{
+    mpr121_sched_client_t *next = NULL;
+
+    xSemaphoreTake(sched->lock, portMAX_DELAY);
+    for (int cls = 0; cls < MPR121_SCHED_CLASS_MAX && next == NULL; cls++)
+    {
+        next = sched->head[cls];
+        if (next != NULL)
+        {
+            sched->head[cls] = next->next;
+            if (sched->head[cls] == NULL)
+            {
+                sched->tail[cls] = NULL;
+            }
+        }
+    }
+    sched->busy = next != NULL;
+    xSemaphoreGive(sched->lock);
+
+    if (next != NULL)
+    {
+        xSemaphoreGive(next->grant);
+    }
+}
+
+/**
+ * @brief 等待设备写周期结束（不占用总线）
+ */
+static void sched_wait_device(mpr121_sched_client_t *client)
+{
+    int64_t now = esp_timer_get_time();
+    if (client->busy_until_us <= now)
+    {
+        return;
+    }
+    uint32_t us = (uint32_t)(client->busy_until_us - now);
+    TickType_t ticks = pdMS_TO_TICKS((us + 999) / 1000);
+    vTaskDelay(ticks ? ticks : 1);
+    client->stats.deferred_us += (uint32_t)(esp_timer_get_time() - now);
+}
+
+// -------------------------- 外部接口实现 --------------------------
+esp_err_t mpr121_sched_init(mpr121_sched_t *sched, uint16_t chunk_bytes)
+{
+    if (sched == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(sched, 0, sizeof(*sched));
+    sched->chunk_bytes = chunk_bytes;
+    sched->lock = xSemaphoreCreateMutex();
+    if (sched->lock == NULL)
+    {
+        ESP_LOGE(TAG, "Create scheduler lock failed");
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+esp_err_t mpr121_sched_deinit(mpr121_sched_t *sched)
+{
+    if (sched == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (sched->lock == NULL)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    xSemaphoreTake(sched->lock, portMAX_DELAY);
+    bool idle = !sched->busy;
+    for (int cls = 0; cls < MPR121_SCHED_CLASS_MAX; cls++)
+    {
+        idle = idle && sched->head[cls] == NULL;
+    }
+    xSemaphoreGive(sched->lock);
+    if (!idle)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    vSemaphoreDelete(sched->lock);
+    sched->lock = NULL;
+    return ESP_OK;
+}
+
+esp_err_t mpr121_sched_add_client(mpr121_sched_t *sched, const mpr121_sched_client_config_t *cfg,
+                                  const mpr121_sched_io_t *io, void *io_ctx, mpr121_sched_client_t *client)
+{
+    if (sched == NULL || cfg == NULL || io == NULL || io->write == NULL || io->read == NULL || client == NULL ||
+        cfg->cls >= MPR121_SCHED_CLASS_MAX || cfg->addr_len == 0 || cfg->addr_len > MPR121_SCHED_MAX_ADDR_LEN)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(client, 0, sizeof(*client));
+    client->sched = sched;
+    client->cfg = *cfg;
+    client->io = *io;
+    client->io_ctx = io_ctx;
+    client->grant = xSemaphoreCreateBinary();
+    if (client->grant == NULL)
+    {
+        ESP_LOGE(TAG, "Create grant semaphore for %s failed", cfg->name ? cfg->name : "?");
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+#if MPR121_I2C_SUPPORTED
+esp_err_t mpr121_sched_add_i2c_client(mpr121_sched_t *sched, i2c_master_bus_handle_t bus, uint8_t i2c_addr,
+                                      uint32_t scl_speed_hz, const mpr121_sched_client_config_t *cfg,
+                                      mpr121_sched_client_t *client)
+{
+    i2c_master_dev_handle_t i2c_dev = NULL;
+    i2c_device_config_t dev_cfg = {
+        .dev_addr_length = I2C_ADDR_BIT_LEN_7,
+        .device_address = i2c_addr,
+        .scl_speed_hz = scl_speed_hz,
+    };
+    ESP_RETURN_ON_ERROR(i2c_master_bus_add_device(bus, &dev_cfg, &i2c_dev), TAG, "Add 0x%02X to I2C bus failed", i2c_addr);
+    esp_err_t err = mpr121_sched_add_client(sched, cfg, &s_sched_i2c_io, i2c_dev, client);
+    if (err != ESP_OK)
+    {
+        i2c_master_bus_rm_device(i2c_dev);
+    }
+    return err;
+}
+
+esp_err_t mpr121_sched_del_i2c_client(mpr121_sched_client_t *client)
+{
+    if (client == NULL || client->io_ctx == NULL)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    ESP_RETURN_ON_ERROR(i2c_master_bus_rm_device((i2c_master_dev_handle_t)client->io_ctx), TAG,
+                        "Remove %s failed", client->cfg.name ? client->cfg.name : "client");
+    vSemaphoreDelete(client->grant);
+    client->io_ctx = NULL;
+    client->grant = NULL;
+    return ESP_OK;
+}
+#endif
+
+esp_err_t mpr121_sched_transfer(mpr121_sched_client_t *client, mpr121_sched_class_t cls, bool read, uint32_t addr,
+                                uint8_t *data, size_t len)
+{
+    if (client == NULL || data == NULL || len == 0 || cls >= MPR121_SCHED_CLASS_MAX)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    mpr121_sched_t *sched = client->sched;
+    esp_err_t err = ESP_OK;
+    for (size_t off = 0; off < len && err == ESP_OK;)
+    {
+        // 块大小：BULK按分块大小拆分；写入不跨越页边界
+        size_t n = len - off;
+        if (cls == MPR121_SCHED_BULK && sched->chunk_bytes && n > sched->chunk_bytes)
+        {
+            n = sched->chunk_bytes;
+        }
+        uint16_t page = client->cfg.page_size;
+        if (!read && page && n > page - (addr + off) % page)
+        {
+            n = page - (addr + off) % page;
+        }
+
+        sched_wait_device(client);
+        uint32_t wait_us = 0;
+        err = sched_acquire(client, cls, &wait_us);
+        if (err != ESP_OK)
+        {
+            break;
+        }
+
+        uint8_t abuf[MPR121_SCHED_MAX_ADDR_LEN];
+        uint32_t a = addr + off;
+        for (int i = client->cfg.addr_len - 1; i >= 0; i--, a >>= 8)
+        {
+            abuf[i] = a & 0xFF; // 大端
+        }
+        int64_t t0 = esp_timer_get_time();
+        err = read ? client->io.read(client->io_ctx, abuf, client->cfg.addr_len, &data[off], n)
+                   : client->io.write(client->io_ctx, abuf, client->cfg.addr_len, &data[off], n);
+        int64_t t1 = esp_timer_get_time();
+        sched_release(sched);
+
+        uint32_t hold_us = (uint32_t)(t1 - t0);
+        client->stats.chunks++;
+        client->wait_sum_us += wait_us;
+        client->stats.wait_max_us = wait_us > client->stats.wait_max_us ? wait_us : client->stats.wait_max_us;
+        client->stats.hold_max_us = hold_us > client->stats.hold_max_us ? hold_us : client->stats.hold_max_us;
+        if (!read && client->cfg.write_busy_us)
+        {
+            client->busy_until_us = t1 + client->cfg.write_busy_us;
+        }
+        off += n;
+    }
+
+    if (err != ESP_OK)
+    {
+        client->stats.errors++;
+        return err;
+    }
+    client->stats.transfers++;
+    client->stats.bytes += len;
+    return ESP_OK;
+}
+
+esp_err_t mpr121_sched_write(mpr121_sched_client_t *client, uint32_t addr, const uint8_t *data, size_t len)
+{
+    return mpr121_sched_transfer(client, client->cfg.cls, false, addr, (uint8_t *)data, len);
+}
+
+esp_err_t mpr121_sched_read(mpr121_sched_client_t *client, uint32_t addr, uint8_t *data, size_t len)
+{
+    return mpr121_sched_transfer(client, client->cfg.cls, true, addr, data, len);
+}
+
+esp_err_t mpr121_sched_attach_dev(mpr121_dev_t *dev, mpr121_sched_client_t *client, uint8_t addr)
+{
+    if (client == NULL || client->cfg.addr_len != 1)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return mpr121_attach_bus(dev, &s_sched_dev_ops, client, addr);
+}
+
+void mpr121_sched_get_stats(mpr121_sched_client_t *client, mpr121_sched_client_stats_t *stats)
+{
+    if (client == NULL || stats == NULL)
+    {
+        return;
+    }
+
+    *stats = client->stats;
+    stats->wait_avg_us = client->stats.chunks ? (uint32_t)(client->wait_sum_us / client->stats.chunks) : 0;
+}
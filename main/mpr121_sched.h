@@ -0,0 +1,183 @@
+#ifndef MPR121_SCHED_H
+#define MPR121_SCHED_H
+
+#include <stdbool.h>
+#include "mpr121.h"
+
+// -------------------------- 可配置参数 --------------------------
+#define MPR121_SCHED_CHUNK_BYTES 32     // BULK传输的分块大小（块间释放总线，决定高优先级请求的最长等待）
+#define MPR121_SCHED_WAIT_MS 100        // 等待总线的超时
+#define MPR121_SCHED_MAX_ADDR_LEN 2     // 寄存器/存储地址最大字节数
+
+// -------------------------- 数据结构 --------------------------
+/**
+ * @brief 优先级类别（数值越小越优先；同类按到达顺序）
+ */
+typedef enum
+{
+    MPR121_SCHED_URGENT = 0, // 触摸状态读取等延迟敏感的短事务
+    MPR121_SCHED_NORMAL,     // 一般传感器读写（如IMU）
+    MPR121_SCHED_BULK,       // 大块传输（如EEPROM）：按块拆分，块间让出总线
+    MPR121_SCHED_CLASS_MAX,
+} mpr121_sched_class_t;
+
+/**
+ * @brief 客户端的底层传输（地址与数据在同一次事务中；读为写地址后重复起始读取）
+ */
+typedef struct
+{
+    esp_err_t (*write)(void *ctx, const uint8_t *addr, size_t addr_len, const uint8_t *data, size_t len);
+    esp_err_t (*read)(void *ctx, const uint8_t *addr, size_t addr_len, uint8_t *data, size_t len);
+} mpr121_sched_io_t;
+
+/**
+ * @brief 客户端配置
+ */
+typedef struct
+{
+    const char *name;              // 名称（统计输出用）
+    mpr121_sched_class_t cls;      // 默认优先级类别
+    uint8_t addr_len;              // 寄存器/存储地址字节数（1或2，大端；分块时逐块递增）
+    uint16_t page_size;            // 分块不跨越的页边界（EEPROM页写，0=不限）
+    uint32_t write_busy_us;        // 每块写入后设备忙的时间（EEPROM写周期），期间总线让给其他客户端
+} mpr121_sched_client_config_t;
+
+/**
+ * @brief 客户端统计
+ */
+typedef struct
+{
+    uint32_t transfers;     // 完成的传输次数
+    uint32_t chunks;        // 占用总线的次数（BULK传输按块计）
+    uint32_t bytes;         // 传输的数据字节数
+    uint32_t errors;        // 失败次数（含等待超时）
+    uint32_t waited;        // 因总线被占用而排队的次数
+    uint32_t wait_avg_us;   // 平均排队延迟（全部占用次数平均）
+    uint32_t wait_max_us;   // 最大排队延迟
+    uint32_t hold_max_us;   // 单次占用总线的最长时间
+    uint32_t deferred_us;   // 等待设备写周期而延后的累计时间
+} mpr121_sched_client_stats_t;
+
+struct mpr121_sched;
+
+/**
+ * @brief 总线客户端（每个客户端同一时刻只能被一个任务使用）
+ */
+typedef struct mpr121_sched_client
+{
+    struct mpr121_sched *sched;           // 所属调度器
+    mpr121_sched_client_config_t cfg;     // 配置
+    mpr121_sched_io_t io;                 // 底层传输
+    void *io_ctx;                         // 底层传输上下文（I2C实现中为i2c_master_dev_handle_t）
+    SemaphoreHandle_t grant;              // 总线移交信号
+    struct mpr121_sched_client *next;     // 等待队列链接
+    int64_t busy_until_us;                // 设备写周期结束时刻
+    mpr121_sched_client_stats_t stats;    // 统计
+    uint64_t wait_sum_us;                 // 排队延迟累计（求平均）
+} mpr121_sched_client_t;
+
+/**
+ * @brief 总线调度器：所有客户端经此访问共享总线；总线空闲时请求者直接占用，
+ *        否则按类别排队，释放时移交给最高类别中最早到达的等待者（无调度任务，传输在请求者任务中执行）
+ */
+typedef struct mpr121_sched
+{
+    SemaphoreHandle_t lock;                                // 保护下列状态
+    bool busy;                                             // 总线已被占用
+    mpr121_sched_client_t *head[MPR121_SCHED_CLASS_MAX];   // 各类别等待队列
+    mpr121_sched_client_t *tail[MPR121_SCHED_CLASS_MAX];
+    uint16_t chunk_bytes;                                  // BULK分块大小（0=不拆分）
+} mpr121_sched_t;
+
+// -------------------------- 函数接口 --------------------------
+/**
+ * @brief 初始化调度器
+ * @param sched 调度器
+ * @param chunk_bytes BULK传输分块大小（0=不拆分，通常为MPR121_SCHED_CHUNK_BYTES）
+ * @return esp_err_t ESP_OK: 成功；ESP_ERR_INVALID_ARG: 参数无效；ESP_ERR_NO_MEM: 创建互斥量失败
+ */
+esp_err_t mpr121_sched_init(mpr121_sched_t *sched, uint16_t chunk_bytes);
+
+/**
+ * @brief 释放调度器的互斥量（客户端须先停止访问，I2C客户端须先用mpr121_sched_del_i2c_client()移除）
+ * @param sched 调度器
+ * @return esp_err_t ESP_OK: 成功；ESP_ERR_INVALID_ARG: 参数无效；ESP_ERR_INVALID_STATE: 未初始化，或仍有传输进行中/客户端排队
+ */
+esp_err_t mpr121_sched_deinit(mpr121_sched_t *sched);
+
+/**
+ * @brief 以自定义底层传输添加客户端（如主机端模拟器）
+ * @param sched 调度器
+ * @param cfg 客户端配置
+ * @param io 底层传输（须在客户端使用期间保持有效）
+ * @param io_ctx 底层传输上下文
+ * @param[out] client 客户端（调用者分配）
+ * @return esp_err_t ESP_OK: 成功；ESP_ERR_INVALID_ARG: 参数无效；ESP_ERR_NO_MEM: 创建信号量失败
+ */
+esp_err_t mpr121_sched_add_client(mpr121_sched_t *sched, const mpr121_sched_client_config_t *cfg,
+                                  const mpr121_sched_io_t *io, void *io_ctx, mpr121_sched_client_t *client);
+
+#if MPR121_I2C_SUPPORTED
+/**
+ * @brief 将I2C设备添加到总线并作为客户端（此后该设备只能经调度器访问）
+ * @param sched 调度器
+ * @param bus I2C总线句柄
+ * @param i2c_addr 7位I2C地址
+ * @param scl_speed_hz SCL频率
+ * @param cfg 客户端配置
+ * @param[out] client 客户端（调用者分配）
+ * @return esp_err_t ESP_OK: 成功；其他: 添加设备失败
+ */
+esp_err_t mpr121_sched_add_i2c_client(mpr121_sched_t *sched, i2c_master_bus_handle_t bus, uint8_t i2c_addr,
+                                      uint32_t scl_speed_hz, const mpr121_sched_client_config_t *cfg,
+                                      mpr121_sched_client_t *client);
+
+/**
+ * @brief 从总线移除I2C客户端（调用者须确保没有任务正在使用该客户端）
+ * @param client 客户端
+ * @return esp_err_t ESP_OK: 成功；其他: 移除设备失败
+ */
+esp_err_t mpr121_sched_del_i2c_client(mpr121_sched_client_t *client);
+#endif
+
+/**
+ * @brief 以指定类别执行一次传输（BULK类别按块拆分，块间及设备写周期内让出总线）
+ * @param client 客户端
+ * @param cls 优先级类别
+ * @param read true=读取；false=写入
+ * @param addr 起始寄存器/存储地址
+ * @param data 数据缓冲区
+ * @param len 字节数
+ * @return esp_err_t ESP_OK: 成功；ESP_ERR_TIMEOUT: 等待总线超时；其他: 传输失败
+ */
+esp_err_t mpr121_sched_transfer(mpr121_sched_client_t *client, mpr121_sched_class_t cls, bool read, uint32_t addr,
+                                uint8_t *data, size_t len);
+
+/**
+ * @brief 以客户端默认类别写入
+ */
+esp_err_t mpr121_sched_write(mpr121_sched_client_t *client, uint32_t addr, const uint8_t *data, size_t len);
+
+/**
+ * @brief 以客户端默认类别读取
+ */
+esp_err_t mpr121_sched_read(mpr121_sched_client_t *client, uint32_t addr, uint8_t *data, size_t len);
+
+/**
+ * @brief 使MPR121设备句柄经调度器访问总线：触摸/超范围状态读取（0x00起不超过4字节）按URGENT类别，
+ *        其他读写按客户端默认类别
+ * @param[out] dev 设备句柄（调用者分配）
+ * @param client 客户端（addr_len须为1）
+ * @param addr 7位I2C地址
+ * @return esp_err_t ESP_OK: 成功；ESP_ERR_INVALID_ARG: 参数无效
+ */
+esp_err_t mpr121_sched_attach_dev(mpr121_dev_t *dev, mpr121_sched_client_t *client, uint8_t addr);
+
+/**
+ * @brief 获取客户端统计
+ * @param client 客户端
+ * @param[out] stats 统计信息
+ */
+void mpr121_sched_get_stats(mpr121_sched_client_t *client, mpr121_sched_client_stats_t *stats);
+
+#endif // MPR121_SCHED_H
@@ -0,0 +1,509 @@
+#include "mpr121_sim.h"
+#include <string.h>
+
+static const char *TAG = "mpr121_sim";
+
+// I2C帧开销（位）：起始+地址字节+寄存器字节+停止；读操作另加重复起始+地址字节
+#define SIM_WRITE_OVERHEAD_BITS (1 + 9 + 9 + 1)
+#define SIM_READ_OVERHEAD_BITS (SIM_WRITE_OVERHEAD_BITS + 1 + 9)
+#define SIM_BITS_PER_BYTE 9 // 8位数据+应答位
+
+// -------------------------- 静态辅助函数（仅内部使用） --------------------------
+/**
+ * @brief 寄存器恢复上电/软复位默认值
+ * @param sim 模拟器
+ */
+static void sim_reset(mpr121_sim_t *sim)
+{
+    memset(sim->regs, 0, sizeof(sim->regs));
+    sim->regs[MPR121_FILT_CDC_CFG] = 0x10;
+    sim->regs[MPR121_FILT_CDT_CFG] = 0x24;
+    memset(sim->debounce, 0, sizeof(sim->debounce));
+    sim->irq = false;
+    sim->autoconfig_pending = 0;
+}
+
+/**
+ * @brief 当前是否处于运行模式（ELE_EN或ELEPROX_EN非0）
+ * @param sim 模拟器
+ * @return true: 运行模式；false: 待机模式
+ */
+static inline bool sim_running(const mpr121_sim_t *sim)
+{
+    return (sim->regs[MPR121_ELE_CFG] & 0x3F) != 0;
+}
+
+/**
+ * @brief 通道是否已使能
+ * @param sim 模拟器
+ * @param ch 通道（0~11为电极，12为ELEPROX）
+ * @return true: 已使能；false: 未使能
+ */
+static inline bool sim_channel_enabled(const mpr121_sim_t *sim, int ch)
+{
+    uint8_t ecr = sim->regs[MPR121_ELE_CFG];
+    if (ch == MPR121_NUM_ELECTRODES)
+    {
+        return (ecr & 0x30) != 0;
+    }
+    uint8_t ele_en = ecr & 0x0F;
+    return ch < (ele_en > MPR121_NUM_ELECTRODES ? MPR121_NUM_ELECTRODES : ele_en);
+}
+
+/**
+ * @brief 按脚本计算通道在当前采样周期的滤波数据
+ * @param sim 模拟器
+ * @param ch 通道
+ * @return uint16_t 10位滤波数据
+ */
+static uint16_t sim_channel_value(mpr121_sim_t *sim, int ch)
+{
+    int32_t drop = 0;
+    for (int i = 0; i < sim->touch_count; i++)
+    {
+        const mpr121_sim_touch_t *t = &sim->touches[i];
+        if (sim->sample < t->start_sample || sim->sample >= t->end_sample)
+        {
+            continue;
+        }
+        if (t->mask & (1 << ch))
+        {
+            drop += t->drop;
+        }
+        else if (ch == MPR121_NUM_ELECTRODES)
+        {
+            // ELEPROX为全部电极并联，任一电极的触摸也会以较小幅度体现
+            drop += t->drop / 4;
+        }
+    }
+
+    if ((sim->oor_mask & (1 << ch)) && (sim->sample & 1))
+    {
+        drop += 200; // 超范围通道：数据在两次采样间大幅跳变
+    }
+
+    int32_t noise = 0;
+    uint8_t peak = sim->noise_ch[ch] ? sim->noise_ch[ch] : sim->noise;
+    if (peak)
+    {
+        sim->rng = sim->rng * 1664525u + 1013904223u;
+        noise = (int32_t)((sim->rng >> 16) % (2 * peak + 1)) - peak;
+    }
+
+    int32_t value = sim->idle_level - drop + noise;
+    return value < 0 ? 0 : (value > 1023 ? 1023 : value);
+}
+
+/**
+ * @brief 自动配置模型：为已使能的通道生成确定的CDC/CDT结果（不影响滤波数据）
+ * @param sim 模拟器
+ */
+static void sim_autoconfig(mpr121_sim_t *sim)
+{
+    // AUTO_CFG0与FILT_CDC_CFG的FFI须一致（数据手册要求），不一致时视为搜索失败
+    bool ffi_mismatch = (sim->regs[MPR121_AUTO_CFG0] & 0xC0) != (sim->regs[MPR121_FILT_CDC_CFG] & 0xC0);
+    bool failed = ffi_mismatch;
+    for (int ch = 0; !ffi_mismatch && ch < MPR121_NUM_CHANNELS; ch++)
+    {
+        if (!sim_channel_enabled(sim, ch))
+        {
+            continue;
+        }
+        if (sim->oor_stuck & (1 << ch))
+        {
+            failed = true; // 该电极搜索失败，CDC/CDT保持不变，OOR继续置位；其余电极照常搜索
+            continue;
+        }
+        sim->oor_mask &= ~(1 << ch);
+        sim->regs[MPR121_CDC_0 + ch] = 0x10 + ch; // 电极越远充电电流越大，仅用于区分各通道
+        uint8_t *cdt = &sim->regs[MPR121_CDT_0_1 + ch / 2];
+        *cdt = (ch & 1) ? ((*cdt & 0x0F) | 0x20) : ((*cdt & 0xF0) | 0x02);
+    }
+    sim->regs[MPR121_OORSTATUS_H] = failed ? (sim->regs[MPR121_OORSTATUS_H] | 0x80) : (sim->regs[MPR121_OORSTATUS_H] & 0x7F);
+    sim->autoconfig_runs++;
+}
+
+/**
+ * @brief 进入运行模式时按ELE_CFG的CL位初始化基线（00=保留当前基线，01=停止跟踪，10=取数据高5位，11=取全部数据）
+ * @param sim 模拟器
+ */
+static void sim_load_baseline(mpr121_sim_t *sim)
+{
+    uint8_t cl = sim->regs[MPR121_ELE_CFG] >> 6;
+    for (int ch = 0; ch < MPR121_NUM_CHANNELS; ch++)
+    {
+        uint16_t value = sim_channel_value(sim, ch);
+        sim->regs[MPR121_FILTDATA_0L + ch * 2] = value & 0xFF;
+        sim->regs[MPR121_FILTDATA_0H + ch * 2] = value >> 8;
+        if (cl == 2)
+        {
+            sim->regs[MPR121_BASELINE_0 + ch] = (value >> 2) & 0xF8;
+        }
+        else if (cl == 3)
+        {
+            sim->regs[MPR121_BASELINE_0 + ch] = value >> 2;
+        }
+        sim->debounce[ch] = 0;
+    }
+}
+
+/**
+ * @brief 写入单个寄存器（应用运行/待机模式写保护与特殊寄存器行为）
+ * @param sim 模拟器
+ * @param reg 寄存器地址
+ * @param val 写入值
+ */
+static void sim_write_byte(mpr121_sim_t *sim, uint8_t reg, uint8_t val)
+{
+    if (reg == MPR121_SOFT_RESET)
+    {
+        if (val == 0x63)
+        {
+            sim_reset(sim);
+        }
+        return;
+    }
+    if (reg == MPR121_TOUCHSTATUS_H)
+    {
+        if (val & 0x80)
+        {
+            sim->regs[reg] &= 0x7F; // 写1清除OVCF
+        }
+        return;
+    }
+    if (reg < MPR121_BASELINE_0 || reg > MPR121_SOFT_RESET)
+    {
+        return; // 状态与滤波数据寄存器只读
+    }
+
+    if (reg == MPR121_ELE_CFG)
+    {
+        bool was_running = sim_running(sim);
+        sim->regs[reg] = val;
+        if (!was_running && sim_running(sim))
+        {
+            // 进入运行模式：AUTO_CFG0.ACE=1时先执行自动配置搜索（持续若干采样周期，完成后才初始化基线）
+            if (sim->regs[MPR121_AUTO_CFG0] & 0x01)
+            {
+                sim->autoconfig_pending = MPR121_SIM_AUTOCONFIG_SAMPLES;
+                sim->regs[MPR121_OORSTATUS_H] &= 0x7F;
+                return;
+            }
+            sim_load_baseline(sim);
+        }
+        else if (!sim_running(sim))
+        {
+            sim->autoconfig_pending = 0; // 进入待机模式中止未完成的搜索
+        }
+        return;
+    }
+
+    if (reg >= MPR121_GPIO_CTRL0 && reg <= MPR121_GPIO_TOGGLE)
+    {
+        // GPIO寄存器在运行模式下同样可写；SET/CLEAR/TOGGLE作用于DATA寄存器
+        switch (reg)
+        {
+        case MPR121_GPIO_SET:
+            sim->regs[MPR121_GPIO_DATA] |= val;
+            break;
+        case MPR121_GPIO_CLEAR:
+            sim->regs[MPR121_GPIO_DATA] &= ~val;
+            break;
+        case MPR121_GPIO_TOGGLE:
+            sim->regs[MPR121_GPIO_DATA] ^= val;
+            break;
+        default:
+            sim->regs[reg] = val;
+            break;
+        }
+        return;
+    }
+
+    if (sim_running(sim))
+    {
+        sim->ignored_writes++; // 数据手册：其余寄存器仅待机模式可写
+        return;
+    }
+    sim->regs[reg] = val;
+}
+
+/**
+ * @brief 按注入的故障决定本次传输的结果
+ * @param sim 模拟器
+ * @return esp_err_t ESP_OK: 传输正常进行；其他: 传输失败
+ */
+static esp_err_t sim_fault_check(mpr121_sim_t *sim)
+{
+    switch (sim->fault)
+    {
+    case MPR121_SIM_FAULT_NACK:
+        if (--sim->fault_count == 0)
+        {
+            sim->fault = MPR121_SIM_FAULT_NONE;
+        }
+        return ESP_ERR_INVALID_RESPONSE;
+    case MPR121_SIM_FAULT_BUS_STUCK:
+        return ESP_ERR_TIMEOUT;
+    default:
+        return ESP_OK;
+    }
+}
+
+/**
+ * @brief 总线写操作（地址自动递增）
+ * @param ctx 模拟器
+ * @param reg 起始寄存器地址
+ * @param data 写入数据
+ * @param len 字节数
+ * @return esp_err_t ESP_OK: 写入成功；其他: 注入的故障
+ */
+static esp_err_t sim_bus_write(void *ctx, uint8_t reg, const uint8_t *data, size_t len)
+{
+    mpr121_sim_t *sim = (mpr121_sim_t *)ctx;
+    sim->transactions++;
+    esp_err_t err = sim_fault_check(sim);
+    if (err != ESP_OK)
+    {
+        sim->bus_bits += SIM_WRITE_OVERHEAD_BITS; // 按一次地址阶段计
+        return err;
+    }
+    sim->bus_bits += SIM_WRITE_OVERHEAD_BITS + SIM_BITS_PER_BYTE * len;
+    for (size_t i = 0; i < len; i++)
+    {
+        sim_write_byte(sim, reg + i, data[i]);
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief 总线读操作（地址自动递增，读取触摸状态寄存器释放IRQ）
+ * @param ctx 模拟器
+ * @param reg 起始寄存器地址
+ * @param[out] data 接收缓冲区
+ * @param len 字节数
+ * @return esp_err_t ESP_OK: 读取成功；其他: 注入的故障
+ */
+static esp_err_t sim_bus_read(void *ctx, uint8_t reg, uint8_t *data, size_t len)
+{
+    mpr121_sim_t *sim = (mpr121_sim_t *)ctx;
+    sim->transactions++;
+    esp_err_t err = sim_fault_check(sim);
+    if (err != ESP_OK)
+    {
+        sim->bus_bits += SIM_WRITE_OVERHEAD_BITS; // 按一次地址阶段计
+        return err;
+    }
+    sim->bus_bits += SIM_READ_OVERHEAD_BITS + SIM_BITS_PER_BYTE * len;
+    for (size_t i = 0; i < len; i++)
+    {
+        unsigned addr = reg + i;
+        data[i] = addr < MPR121_SIM_REG_COUNT ? sim->regs[addr] : 0;
+        if (addr <= MPR121_TOUCHSTATUS_H)
+        {
+            sim->irq = false;
+        }
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief 异步读操作：立即完成读取并在提交者上下文中调用完成回调
+ * @param ctx 模拟器
+ * @param reg 起始寄存器地址
+ * @param[out] data 接收缓冲区
+ * @param len 字节数
+ * @param cb 完成回调
+ * @param arg 回调参数
+ * @return esp_err_t 始终ESP_OK（传输结果经回调返回）
+ */
+static esp_err_t sim_bus_submit_read(void *ctx, uint8_t reg, uint8_t *data, size_t len,
+                                     mpr121_xfer_cb_t cb, void *arg)
+{
+    esp_err_t err = sim_bus_read(ctx, reg, data, len);
+    cb(arg, err);
+    return ESP_OK;
+}
+
+const mpr121_bus_ops_t mpr121_sim_bus_ops = {
+    .write = sim_bus_write,
+    .read = sim_bus_read,
+    .submit_read = sim_bus_submit_read,
+};
+
+// -------------------------- 外部接口实现 --------------------------
+void mpr121_sim_init(mpr121_sim_t *sim, uint16_t idle_level, uint8_t noise)
+{
+    memset(sim, 0, sizeof(*sim));
+    sim->idle_level = idle_level;
+    sim->noise = noise;
+    sim->rng = 0x12345678;
+    sim_reset(sim);
+}
+
+esp_err_t mpr121_sim_add_touch(mpr121_sim_t *sim, const mpr121_sim_touch_t *touch)
+{
+    if (sim->touch_count >= MPR121_SIM_MAX_TOUCHES)
+    {
+        ESP_LOGE(TAG, "Touch script full");
+        return ESP_ERR_NO_MEM;
+    }
+    sim->touches[sim->touch_count++] = *touch;
+    return ESP_OK;
+}
+
+void mpr121_sim_step(mpr121_sim_t *sim)
+{
+    sim->sample++;
+    if (!sim_running(sim))
+    {
+        return;
+    }
+    if (sim->autoconfig_pending)
+    {
+        // 搜索期间不更新触摸/超范围状态，最后一个周期写出结果并初始化基线
+        if (--sim->autoconfig_pending == 0)
+        {
+            sim_autoconfig(sim);
+            sim_load_baseline(sim);
+        }
+        return;
+    }
+
+    uint8_t cl = sim->regs[MPR121_ELE_CFG] >> 6;
+    uint8_t dt = sim->regs[MPR121_DEBOUNCE] & 0x07;
+    uint8_t dr = (sim->regs[MPR121_DEBOUNCE] >> 4) & 0x07;
+    uint16_t status = (sim->regs[MPR121_TOUCHSTATUS_H] << 8) | sim->regs[MPR121_TOUCHSTATUS_L];
+    uint16_t old_status = status;
+
+    for (int ch = 0; ch < MPR121_NUM_CHANNELS; ch++)
+    {
+        uint16_t bit = 1 << ch;
+        if (!sim_channel_enabled(sim, ch))
+        {
+            status &= ~bit;
+            continue;
+        }
+
+        uint16_t value = sim_channel_value(sim, ch);
+        sim->regs[MPR121_FILTDATA_0L + ch * 2] = value & 0xFF;
+        sim->regs[MPR121_FILTDATA_0H + ch * 2] = value >> 8;
+
+        uint8_t *baseline = &sim->regs[MPR121_BASELINE_0 + ch];
+        int32_t delta = (*baseline << 2) - value;
+        uint8_t touch_th = sim->regs[MPR121_TOUCH_THRESH_0 + ch * 2];
+        uint8_t release_th = sim->regs[MPR121_RELEASE_THRESH_0 + ch * 2];
+
+        if (!(status & bit))
+        {
+            if (delta > touch_th)
+            {
+                if (++sim->debounce[ch] > dt)
+                {
+                    status |= bit;
+                    sim->debounce[ch] = 0;
+                }
+            }
+            else
+            {
+                sim->debounce[ch] = 0;
+                // 未触摸时基线每周期逼近数据一半差距（简化的基线滤波模型，CL=01时停止跟踪）
+                int32_t diff = (value >> 2) - *baseline;
+                if (cl != 1 && diff != 0)
+                {
+                    *baseline += (diff / 2) ? diff / 2 : diff;
+                }
+            }
+        }
+        else if (delta < release_th)
+        {
+            if (++sim->debounce[ch] > dr)
+            {
+                status &= ~bit;
+                sim->debounce[ch] = 0;
+            }
+        }
+        else
+        {
+            sim->debounce[ch] = 0;
+        }
+    }
+
+    sim->regs[MPR121_TOUCHSTATUS_L] = status & 0xFF;
+    sim->regs[MPR121_TOUCHSTATUS_H] = (sim->regs[MPR121_TOUCHSTATUS_H] & 0x80) | ((status >> 8) & 0x1F);
+    // 停止采样的通道不报告超范围
+    uint16_t oor = 0;
+    for (int ch = 0; ch < MPR121_NUM_CHANNELS; ch++)
+    {
+        if ((sim->oor_mask & (1 << ch)) && sim_channel_enabled(sim, ch))
+        {
+            oor |= 1 << ch;
+        }
+    }
+    sim->regs[MPR121_OORSTATUS_L] = oor & 0xFF;
+    sim->regs[MPR121_OORSTATUS_H] = (sim->regs[MPR121_OORSTATUS_H] & 0xC0) | (oor >> 8);
+    if (status != old_status)
+    {
+        sim->irq = true;
+    }
+}
+
+void mpr121_sim_inject_fault(mpr121_sim_t *sim, mpr121_sim_fault_t fault, uint32_t count)
+{
+    if (fault == MPR121_SIM_FAULT_BROWNOUT)
+    {
+        sim_reset(sim); // 寄存器（含基线与触摸状态）回到上电默认值，总线不受影响
+        return;
+    }
+    if (fault == MPR121_SIM_FAULT_OVERCURRENT)
+    {
+        sim->regs[MPR121_TOUCHSTATUS_H] |= 0x80;
+        sim->regs[MPR121_ELE_CFG] = 0x00; // 芯片自行进入待机模式
+        sim->autoconfig_pending = 0;
+        sim->irq = true;
+        return;
+    }
+    if (fault == MPR121_SIM_FAULT_NACK && count == 0)
+    {
+        return;
+    }
+    sim->fault = fault;
+    sim->fault_count = count;
+}
+
+void mpr121_sim_set_oor(mpr121_sim_t *sim, uint16_t mask, uint16_t stuck)
+{
+    sim->oor_mask = mask;
+    sim->oor_stuck = stuck & mask;
+}
+
+void mpr121_sim_set_noise(mpr121_sim_t *sim, uint16_t mask, uint8_t noise)
+{
+    for (int ch = 0; ch < MPR121_NUM_CHANNELS; ch++)
+    {
+        if (mask & (1 << ch))
+        {
+            sim->noise_ch[ch] = noise;
+        }
+    }
+}
+
+esp_err_t mpr121_sim_bus_reset(void *ctx)
+{
+    mpr121_sim_t *sim = (mpr121_sim_t *)ctx;
+    sim->bus_resets++;
+    if (sim->fault == MPR121_SIM_FAULT_BUS_STUCK)
+    {
+        sim->fault = MPR121_SIM_FAULT_NONE;
+    }
+    return ESP_OK;
+}
+
+esp_err_t mpr121_sim_attach(mpr121_sim_t *sim, mpr121_dev_t *dev, uint8_t addr)
+{
+    return mpr121_attach_bus(dev, &mpr121_sim_bus_ops, sim, addr);
+}
+
+uint64_t mpr121_sim_bus_time_us(const mpr121_sim_t *sim, uint32_t scl_hz)
+{
+    return scl_hz ? sim->bus_bits * 1000000ULL / scl_hz : 0;
+}
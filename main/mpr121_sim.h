@@ -0,0 +1,144 @@
+#ifndef MPR121_SIM_H
+#define MPR121_SIM_H
+
+#include <stdbool.h>
+#include "mpr121.h"
+
+// -------------------------- 可配置参数 --------------------------
+#define MPR121_SIM_REG_COUNT (MPR121_SOFT_RESET + 1) // 寄存器文件大小（0x00~0x80）
+#define MPR121_SIM_MAX_TOUCHES 16                   // 脚本中最多的触摸片段数
+#define MPR121_SIM_AUTOCONFIG_SAMPLES 3             // 自动配置搜索持续的采样周期数（mpr121_sim_step()调用次数）
+
+// -------------------------- 数据结构 --------------------------
+/**
+ * @brief 电容脚本片段：在[start, end)采样区间内，mask中的电极滤波数据下降drop
+ */
+typedef struct
+{
+    uint32_t start_sample; // 起始采样序号
+    uint32_t end_sample;   // 结束采样序号（不含）
+    uint16_t mask;         // 受影响的通道（bit0~bit11=ELE0~ELE11，bit12=ELEPROX）
+    uint16_t drop;         // 滤波数据下降量（触摸使电容增大、数据减小）
+} mpr121_sim_touch_t;
+
+/**
+ * @brief 注入的故障类型
+ */
+typedef enum
+{
+    MPR121_SIM_FAULT_NONE = 0,  // 无故障
+    MPR121_SIM_FAULT_NACK,      // 接下来若干次传输无应答（ESP_ERR_INVALID_RESPONSE），如芯片正在上电
+    MPR121_SIM_FAULT_BUS_STUCK, // SDA被拉住：所有传输超时（ESP_ERR_TIMEOUT），直到总线复位
+    MPR121_SIM_FAULT_BROWNOUT,  // 掉电复位：寄存器立即恢复上电默认值，总线正常（芯片静默地停止扫描）
+    MPR121_SIM_FAULT_OVERCURRENT, // REXT过流：置OVCF并进入待机模式（向0x01写1清除）
+} mpr121_sim_fault_t;
+
+/**
+ * @brief 寄存器级MPR121模拟器（无硬件依赖，可在主机上运行）
+ *
+ * 模拟的行为：读写地址自动递增；运行模式下仅ELE_CFG与GPIO寄存器可写；
+ * 0x80写入0x63软复位；进入运行模式时按AUTO_CFG0.ACE执行自动配置（FFI与FILT_CDC_CFG不一致时失败并置ACFF）、按CL位初始化基线，
+ * 搜索在MPR121_SIM_AUTOCONFIG_SAMPLES个采样周期后才写出CDC/CDT并初始化基线（期间CDC保持原值、ACFF清零）；
+ * 按触摸/释放阈值与DEBOUNCE计算触摸状态；按脚本生成各通道滤波数据；可注入NACK、总线卡死、掉电复位与过流故障；
+ * 超范围通道在OOR状态中置位且数据每周期翻转（模拟断线/受潮电极引起的IRQ风暴），自动配置可修复非顽固的超范围通道。
+ */
+typedef struct
+{
+    uint8_t regs[MPR121_SIM_REG_COUNT];               // 寄存器文件
+    uint16_t idle_level;                              // 未触摸时的10位滤波数据
+    uint8_t noise;                                    // 噪声峰值（±noise，伪随机）
+    uint8_t noise_ch[MPR121_NUM_CHANNELS];            // 各通道噪声峰值（0=使用noise；模拟面积/走线不同的电极）
+    uint32_t rng;                                     // 噪声发生器状态
+    mpr121_sim_touch_t touches[MPR121_SIM_MAX_TOUCHES]; // 电容脚本
+    uint8_t touch_count;                              // 脚本片段数
+    uint32_t sample;                                  // 已运行的采样周期数
+    uint8_t debounce[MPR121_NUM_CHANNELS];            // 每通道去抖计数
+    bool irq;                                         // IRQ引脚状态（true=拉低），读取触摸状态后释放
+    uint32_t autoconfig_runs;                         // 自动配置搜索执行次数
+    uint8_t autoconfig_pending;                       // 自动配置搜索剩余的采样周期（0=无搜索进行中）
+    mpr121_sim_fault_t fault;                         // 当前注入的故障（NACK/BUS_STUCK）
+    uint32_t fault_count;                             // NACK故障剩余的传输次数
+    uint32_t bus_resets;                              // 收到的总线复位次数
+    uint16_t oor_mask;                                // 超范围通道（数据每周期翻转±200）
+    uint16_t oor_stuck;                               // 自动配置也无法修复的超范围通道
+
+    // 总线统计
+    uint32_t transactions;                            // 事务数
+    uint64_t bus_bits;                                // 总线上传输的位数（含起始/停止/地址/应答）
+    uint32_t ignored_writes;                          // 运行模式下被忽略的写入字节数
+} mpr121_sim_t;
+
+extern const mpr121_bus_ops_t mpr121_sim_bus_ops; // 模拟器总线操作（ctx为mpr121_sim_t指针）
+
+// -------------------------- 函数接口 --------------------------
+/**
+ * @brief 初始化模拟器（寄存器为上电默认值）
+ * @param sim 模拟器
+ * @param idle_level 未触摸时的滤波数据（0~1023）
+ * @param noise 噪声峰值
+ */
+void mpr121_sim_init(mpr121_sim_t *sim, uint16_t idle_level, uint8_t noise);
+
+/**
+ * @brief 向电容脚本追加一个触摸片段
+ * @param sim 模拟器
+ * @param touch 触摸片段
+ * @return esp_err_t ESP_OK: 添加成功；ESP_ERR_NO_MEM: 脚本已满
+ */
+esp_err_t mpr121_sim_add_touch(mpr121_sim_t *sim, const mpr121_sim_touch_t *touch);
+
+/**
+ * @brief 推进一个采样周期（ESI），更新滤波数据、基线与触摸状态
+ * @param sim 模拟器
+ */
+void mpr121_sim_step(mpr121_sim_t *sim);
+
+/**
+ * @brief 将模拟器作为总线挂接到设备句柄
+ * @param sim 模拟器
+ * @param[out] dev 设备句柄
+ * @param addr 模拟的I2C地址
+ * @return esp_err_t ESP_OK: 挂接成功
+ */
+esp_err_t mpr121_sim_attach(mpr121_sim_t *sim, mpr121_dev_t *dev, uint8_t addr);
+
+/**
+ * @brief 注入故障（用于验证总线故障恢复）
+ * @param sim 模拟器
+ * @param fault 故障类型
+ * @param count NACK故障持续的传输次数（其他类型忽略）
+ */
+void mpr121_sim_inject_fault(mpr121_sim_t *sim, mpr121_sim_fault_t fault, uint32_t count);
+
+/**
+ * @brief 设置超范围通道
+ * @param sim 模拟器
+ * @param mask 超范围通道（bit0~bit11=ELE0~ELE11，bit12=ELEPROX）
+ * @param stuck 其中自动配置无法修复的通道（自动配置后仍超范围并置ACFF）
+ */
+void mpr121_sim_set_oor(mpr121_sim_t *sim, uint16_t mask, uint16_t stuck);
+
+/**
+ * @brief 设置部分通道的噪声峰值（大面积电极或长走线拾取的噪声更大）
+ * @param sim 模拟器
+ * @param mask 通道（bit0~bit11=ELE0~ELE11，bit12=ELEPROX）
+ * @param noise 噪声峰值（0=恢复为全局noise）
+ */
+void mpr121_sim_set_noise(mpr121_sim_t *sim, uint16_t mask, uint8_t noise);
+
+/**
+ * @brief 总线复位（对应i2c_master_bus_reset()：SCL脉冲释放SDA），清除BUS_STUCK故障
+ * @param ctx 模拟器（mpr121_sim_t指针，签名与总线复位回调一致）
+ * @return esp_err_t 始终ESP_OK
+ */
+esp_err_t mpr121_sim_bus_reset(void *ctx);
+
+/**
+ * @brief 根据已传输的位数计算总线耗时
+ * @param sim 模拟器
+ * @param scl_hz SCL频率
+ * @return uint64_t 总线耗时（μs）
+ */
+uint64_t mpr121_sim_bus_time_us(const mpr121_sim_t *sim, uint32_t scl_hz);
+
+#endif // MPR121_SIM_H
@@ -0,0 +1,168 @@
+#include "mpr121_slider.h"
+#include <string.h>
+
+static const char *TAG = "mpr121_slider";
+
+#define SLIDER_FILTER_FRAC 4       // IIR内部额外保留的小数位，避免右移截断造成的位置停滞
+#define SLIDER_FILTER_SHIFT_MAX 15 // filter_shift上限（右移位数须小于位置差值的位宽）
+
+// -------------------------- 静态辅助函数（仅内部使用） --------------------------
+/**
+ * @brief 读取电极组中第i个电极的差值（负值按0处理）
+ * @param slider 滑条状态
+ * @param delta 各通道差值
+ * @param i 电极组内序号（允许越界，线性滑条越界返回0，滚轮回绕）
+ * @return int32_t 非负差值
+ */
+static inline int32_t slider_weight(const mpr121_slider_t *slider, const int16_t *delta, int i)
+{
+    int n = slider->cfg.count;
+    if (i < 0 || i >= n)
+    {
+        if (slider->cfg.type == MPR121_SLIDER_LINEAR)
+        {
+            return 0;
+        }
+        i = (i + n) % n;
+    }
+    int32_t w = delta[slider->cfg.electrodes[i]];
+    return w > 0 ? w : 0;
+}
+
+/**
+ * @brief 滚轮位置回绕到[0, range)
+ * @param pos 位置
+ * @param range 范围
+ * @return int32_t 回绕后的位置
+ */
+static inline int32_t slider_wrap(int32_t pos, int32_t range)
+{
+    pos %= range;
+    return pos < 0 ? pos + range : pos;
+}
+
+// -------------------------- 外部接口实现 --------------------------
+esp_err_t mpr121_slider_init(mpr121_slider_t *slider, const mpr121_slider_config_t *cfg)
+{
+    // 释放阈值须为正：处于触摸状态时差值和不低于它，质心计算的除数不会为0
+    if (slider == NULL || cfg == NULL ||
+        (cfg->type != MPR121_SLIDER_LINEAR && cfg->type != MPR121_SLIDER_WHEEL) ||
+        cfg->count > MPR121_NUM_ELECTRODES || cfg->count < (cfg->type == MPR121_SLIDER_WHEEL ? 3 : 2) ||
+        cfg->release_thresh <= 0 || cfg->release_thresh >= cfg->touch_thresh ||
+        cfg->filter_shift > SLIDER_FILTER_SHIFT_MAX)
+    {
+        ESP_LOGE(TAG, "Invalid slider config");
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (int i = 0; i < cfg->count; i++)
+    {
+        if (cfg->electrodes[i] >= MPR121_NUM_ELECTRODES)
+        {
+            ESP_LOGE(TAG, "Invalid electrode: %d", cfg->electrodes[i]);
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+
+    memset(slider, 0, sizeof(*slider));
+    slider->cfg = *cfg;
+    slider->range = (cfg->type == MPR121_SLIDER_WHEEL ? cfg->count : cfg->count - 1) * MPR121_SLIDER_SCALE;
+    return ESP_OK;
+}
+
+bool mpr121_slider_update(mpr121_slider_t *slider, const int16_t delta[MPR121_NUM_CHANNELS], int32_t *position)
+{
+    const mpr121_slider_config_t *cfg = &slider->cfg;
+
+    // 1. 寻找峰值电极
+    int peak = 0;
+    int32_t peak_w = slider_weight(slider, delta, 0);
+    for (int i = 1; i < cfg->count; i++)
+    {
+        int32_t w = slider_weight(slider, delta, i);
+        if (w > peak_w)
+        {
+            peak_w = w;
+            peak = i;
+        }
+    }
+
+    // 2. 峰值及左右相邻电极的三点质心，得到电极间细分位置
+    int32_t w_prev = slider_weight(slider, delta, peak - 1);
+    int32_t w_next = slider_weight(slider, delta, peak + 1);
+    int32_t sum = w_prev + peak_w + w_next;
+
+    // 3. 触摸判定迟滞：按下需超过touch_thresh，释放需低于release_thresh
+    if (slider->active ? sum < cfg->release_thresh : sum < cfg->touch_thresh)
+    {
+        slider->active = false;
+        return false;
+    }
+
+    int32_t raw = peak * MPR121_SLIDER_SCALE + (w_next - w_prev) * MPR121_SLIDER_SCALE / sum;
+    if (cfg->type == MPR121_SLIDER_WHEEL)
+    {
+        raw = slider_wrap(raw, slider->range);
+    }
+    else if (raw < 0)
+    {
+        raw = 0;
+    }
+    else if (raw > slider->range)
+    {
+        raw = slider->range;
+    }
+
+    // 4. 抖动抑制：刚按下时直接采用原始位置，之后一阶IIR平滑+死区
+    if (!slider->active)
+    {
+        slider->active = true;
+        slider->filtered = raw << SLIDER_FILTER_FRAC;
+        slider->position = raw;
+    }
+    else
+    {
+        int32_t diff = (raw << SLIDER_FILTER_FRAC) - slider->filtered;
+        if (cfg->type == MPR121_SLIDER_WHEEL)
+        {
+            // 滚轮沿最短路径逼近，跨越0点时不会绕大圈
+            int32_t half = (slider->range << SLIDER_FILTER_FRAC) / 2;
+            if (diff > half)
+            {
+                diff -= slider->range << SLIDER_FILTER_FRAC;
+            }
+            else if (diff < -half)
+            {
+                diff += slider->range << SLIDER_FILTER_FRAC;
+            }
+        }
+        slider->filtered += diff >> cfg->filter_shift;
+        if (cfg->type == MPR121_SLIDER_WHEEL)
+        {
+            slider->filtered = slider_wrap(slider->filtered, slider->range << SLIDER_FILTER_FRAC);
+        }
+
+        int32_t smoothed = slider->filtered >> SLIDER_FILTER_FRAC;
+        int32_t moved = smoothed - slider->position;
+        if (cfg->type == MPR121_SLIDER_WHEEL)
+        {
+            if (moved > slider->range / 2)
+            {
+                moved -= slider->range;
+            }
+            else if (moved < -slider->range / 2)
+            {
+                moved += slider->range;
+            }
+        }
+        if (moved >= cfg->deadband || moved <= -cfg->deadband)
+        {
+            slider->position = smoothed;
+        }
+    }
+
+    if (position != NULL)
+    {
+        *position = slider->position;
+    }
+    return true;
+}
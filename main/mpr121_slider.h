@@ -0,0 +1,64 @@
+#ifndef MPR121_SLIDER_H
+#define MPR121_SLIDER_H
+
+#include <stdbool.h>
+#include "mpr121.h"
+
+// -------------------------- 可配置参数 --------------------------
+#define MPR121_SLIDER_SCALE 256 // 位置定点精度：相邻两电极间细分为256份（Q8）
+
+// -------------------------- 数据结构 --------------------------
+/**
+ * @brief 电极组类型
+ */
+typedef enum
+{
+    MPR121_SLIDER_LINEAR = 0, // 线性滑条：位置范围0 ~ (count-1)*256
+    MPR121_SLIDER_WHEEL = 1,  // 圆形滚轮：位置范围0 ~ count*256-1，首尾相接
+} mpr121_slider_type_t;
+
+/**
+ * @brief 滑条/滚轮配置
+ */
+typedef struct
+{
+    mpr121_slider_type_t type;                      // 电极组类型
+    uint8_t electrodes[MPR121_NUM_ELECTRODES];      // 按物理排列顺序的电极编号
+    uint8_t count;                                  // 电极数量（线性>=2，滚轮>=3）
+    int16_t touch_thresh;                           // 峰值邻域差值和达到此值判定为触摸
+    int16_t release_thresh;                         // 低于此值判定为释放（需大于0且小于touch_thresh，形成迟滞）
+    uint8_t filter_shift;                           // 一阶IIR平滑系数k：y += (x-y)>>k（0=不平滑，最大15）
+    uint16_t deadband;                              // 位置变化小于该值（Q8）时保持输出不变（抑制抖动）
+} mpr121_slider_config_t;
+
+/**
+ * @brief 滑条/滚轮状态（静态分配，无堆内存）
+ */
+typedef struct
+{
+    mpr121_slider_config_t cfg; // 配置
+    bool active;                // 当前是否处于触摸状态
+    int32_t filtered;           // IIR平滑后的位置（Q8，额外保留4位小数）
+    int32_t position;           // 输出位置（Q8）
+    int32_t range;              // 位置范围（滚轮用于回绕）
+} mpr121_slider_t;
+
+// -------------------------- 函数接口 --------------------------
+/**
+ * @brief 初始化滑条/滚轮
+ * @param slider 滑条状态
+ * @param cfg 配置
+ * @return esp_err_t ESP_OK: 初始化成功；ESP_ERR_INVALID_ARG: 配置无效（类型未知、电极数不符、阈值非正或无迟滞、filter_shift>15）
+ */
+esp_err_t mpr121_slider_init(mpr121_slider_t *slider, const mpr121_slider_config_t *cfg);
+
+/**
+ * @brief 用一帧电极差值更新位置（纯定点运算，无浮点、无堆内存）
+ * @param slider 滑条状态
+ * @param delta 各通道差值（mpr121_frame_t.delta）
+ * @param[out] position 当前位置（Q8，仅在返回true时有效，可为NULL）
+ * @return true: 处于触摸状态；false: 未触摸
+ */
+bool mpr121_slider_update(mpr121_slider_t *slider, const int16_t delta[MPR121_NUM_CHANNELS], int32_t *position);
+
+#endif // MPR121_SLIDER_H
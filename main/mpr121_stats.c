@@ -0,0 +1,151 @@
+#include "mpr121_stats.h"
+#include <stdatomic.h>
+#include <string.h>
+
+static const char *TAG = "mpr121_stats";
+
+#if MPR121_ENABLE_STATS
+// 全部计数器为32位原子量，计数路径仅一次relaxed原子加，可在多任务中并发调用
+static struct
+{
+    atomic_uint api_calls[MPR121_API_MAX];
+    atomic_uint transactions;
+    atomic_uint tx_bytes;
+    atomic_uint rx_bytes;
+    atomic_uint errors[MPR121_ERR_MAX];
+    atomic_uint txn_latency_hist[MPR121_HIST_BUCKETS];
+    atomic_uint irq_latency_hist[MPR121_HIST_BUCKETS];
+} s_stats;
+
+// -------------------------- 静态辅助函数（仅内部使用） --------------------------
+/**
+ * @brief 计算耗时所属的log2桶
+ * @param us 耗时（μs）
+ * @return int 桶序号
+ */
+static inline int stats_bucket(int64_t us)
+{
+    if (us <= 0)
+    {
+        return 0;
+    }
+    int bucket = 32 - __builtin_clz(us > UINT32_MAX ? UINT32_MAX : (uint32_t)us);
+    return bucket < MPR121_HIST_BUCKETS ? bucket : MPR121_HIST_BUCKETS - 1;
+}
+
+/**
+ * @brief 读取（并可选清零）一组原子计数器
+ * @param src 原子计数器数组
+ * @param[out] dst 快照数组
+ * @param count 计数器个数
+ * @param reset 是否同时清零
+ */
+static void stats_take(atomic_uint *src, uint32_t *dst, size_t count, bool reset)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        dst[i] = reset ? atomic_exchange_explicit(&src[i], 0, memory_order_relaxed)
+                       : atomic_load_explicit(&src[i], memory_order_relaxed);
+    }
+}
+
+// -------------------------- 驱动内部埋点 --------------------------
+void mpr121_stats_api(mpr121_api_t api)
+{
+    atomic_fetch_add_explicit(&s_stats.api_calls[api], 1, memory_order_relaxed);
+}
+
+void mpr121_stats_txn(size_t tx_bytes, size_t rx_bytes, esp_err_t err, int64_t elapsed_us)
+{
+    atomic_fetch_add_explicit(&s_stats.transactions, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&s_stats.tx_bytes, tx_bytes, memory_order_relaxed);
+    atomic_fetch_add_explicit(&s_stats.rx_bytes, rx_bytes, memory_order_relaxed);
+    atomic_fetch_add_explicit(&s_stats.txn_latency_hist[stats_bucket(elapsed_us)], 1, memory_order_relaxed);
+    if (err != ESP_OK)
+    {
+        mpr121_err_class_t cls;
+        switch (err)
+        {
+        case ESP_FAIL:
+            cls = MPR121_ERR_FAIL;
+            break;
+        case ESP_ERR_INVALID_RESPONSE:
+            cls = MPR121_ERR_NACK;
+            break;
+        case ESP_ERR_TIMEOUT:
+            cls = MPR121_ERR_TIMEOUT;
+            break;
+        case ESP_ERR_INVALID_STATE:
+            cls = MPR121_ERR_INVALID_STATE;
+            break;
+        case ESP_ERR_INVALID_ARG:
+            cls = MPR121_ERR_INVALID_ARG;
+            break;
+        default:
+            cls = MPR121_ERR_OTHER;
+            break;
+        }
+        atomic_fetch_add_explicit(&s_stats.errors[cls], 1, memory_order_relaxed);
+    }
+}
+
+void mpr121_stats_irq_latency(int64_t latency_us)
+{
+    atomic_fetch_add_explicit(&s_stats.irq_latency_hist[stats_bucket(latency_us)], 1, memory_order_relaxed);
+}
+#endif // MPR121_ENABLE_STATS
+
+// -------------------------- 外部接口实现 --------------------------
+esp_err_t mpr121_get_stats(mpr121_stats_t *stats, bool reset)
+{
+    if (stats == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+#if MPR121_ENABLE_STATS
+    stats_take(s_stats.api_calls, stats->api_calls, MPR121_API_MAX, reset);
+    stats_take(&s_stats.transactions, &stats->transactions, 1, reset);
+    stats_take(&s_stats.tx_bytes, &stats->tx_bytes, 1, reset);
+    stats_take(&s_stats.rx_bytes, &stats->rx_bytes, 1, reset);
+    stats_take(s_stats.errors, stats->errors, MPR121_ERR_MAX, reset);
+    stats_take(s_stats.txn_latency_hist, stats->txn_latency_hist, MPR121_HIST_BUCKETS, reset);
+    stats_take(s_stats.irq_latency_hist, stats->irq_latency_hist, MPR121_HIST_BUCKETS, reset);
+    return ESP_OK;
+#else
+    (void)reset;
+    memset(stats, 0, sizeof(*stats));
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+void mpr121_stats_dump(const mpr121_stats_t *stats)
+{
+    if (stats == NULL)
+    {
+        return;
+    }
+
+    ESP_LOGI(TAG, "calls: init %lu, thresh %lu, touch %lu, filt %lu, base %lu, frame %lu, commit %lu, status %lu",
+             (unsigned long)stats->api_calls[MPR121_API_INIT],
+             (unsigned long)stats->api_calls[MPR121_API_SET_THRESHOLDS],
+             (unsigned long)stats->api_calls[MPR121_API_READ_TOUCH],
+             (unsigned long)stats->api_calls[MPR121_API_READ_FILTERED],
+             (unsigned long)stats->api_calls[MPR121_API_READ_BASELINE],
+             (unsigned long)stats->api_calls[MPR121_API_READ_FRAME],
+             (unsigned long)stats->api_calls[MPR121_API_CFG_COMMIT],
+             (unsigned long)stats->api_calls[MPR121_API_READ_STATUS]);
+    ESP_LOGI(TAG, "bus: %lu txn, %lu tx bytes, %lu rx bytes; errors: fail %lu, nack %lu, timeout %lu, state %lu, arg %lu, other %lu",
+             (unsigned long)stats->transactions, (unsigned long)stats->tx_bytes, (unsigned long)stats->rx_bytes,
+             (unsigned long)stats->errors[MPR121_ERR_FAIL], (unsigned long)stats->errors[MPR121_ERR_NACK],
+             (unsigned long)stats->errors[MPR121_ERR_TIMEOUT],
+             (unsigned long)stats->errors[MPR121_ERR_INVALID_STATE], (unsigned long)stats->errors[MPR121_ERR_INVALID_ARG],
+             (unsigned long)stats->errors[MPR121_ERR_OTHER]);
+    for (int i = 0; i < MPR121_HIST_BUCKETS; i++)
+    {
+        if (stats->txn_latency_hist[i] || stats->irq_latency_hist[i])
+        {
+            ESP_LOGI(TAG, "  <%6lu us: txn %lu, irq %lu", 1UL << i,
+                     (unsigned long)stats->txn_latency_hist[i], (unsigned long)stats->irq_latency_hist[i]);
+        }
+    }
+}
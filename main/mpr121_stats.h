@@ -0,0 +1,89 @@
+#ifndef MPR121_STATS_H
+#define MPR121_STATS_H
+
+#include <stdbool.h>
+#include "mpr121.h"
+
+// -------------------------- 可配置参数 --------------------------
+#define MPR121_HIST_BUCKETS 16 // log2直方图桶数：桶i统计[2^(i-1), 2^i)μs，桶0为0μs，最后一桶含所有更大值
+
+// -------------------------- 数据结构 --------------------------
+/**
+ * @brief 统计调用次数的接口
+ */
+typedef enum
+{
+    MPR121_API_INIT = 0,
+    MPR121_API_SET_THRESHOLDS,
+    MPR121_API_READ_TOUCH,
+    MPR121_API_READ_FILTERED,
+    MPR121_API_READ_BASELINE,
+    MPR121_API_READ_FRAME,
+    MPR121_API_CFG_COMMIT,
+    MPR121_API_READ_STATUS,
+    MPR121_API_MAX,
+} mpr121_api_t;
+
+/**
+ * @brief 按esp_err_t分类的错误计数
+ */
+typedef enum
+{
+    MPR121_ERR_FAIL = 0,      // ESP_FAIL（未归类的传输失败）
+    MPR121_ERR_NACK,          // ESP_ERR_INVALID_RESPONSE（从机无应答，如芯片上电中或地址错误）
+    MPR121_ERR_TIMEOUT,       // ESP_ERR_TIMEOUT
+    MPR121_ERR_INVALID_STATE, // ESP_ERR_INVALID_STATE（总线忙/状态异常）
+    MPR121_ERR_INVALID_ARG,   // ESP_ERR_INVALID_ARG
+    MPR121_ERR_OTHER,         // 其他错误码
+    MPR121_ERR_MAX,
+} mpr121_err_class_t;
+
+/**
+ * @brief 全局性能统计快照
+ */
+typedef struct
+{
+    uint32_t api_calls[MPR121_API_MAX];              // 各接口调用次数
+    uint32_t transactions;                           // I2C事务数（所有设备合计）
+    uint32_t tx_bytes;                               // 发送字节数
+    uint32_t rx_bytes;                               // 接收字节数
+    uint32_t errors[MPR121_ERR_MAX];                 // 事务错误计数
+    uint32_t txn_latency_hist[MPR121_HIST_BUCKETS];  // 单次事务耗时直方图
+    uint32_t irq_latency_hist[MPR121_HIST_BUCKETS];  // IRQ到读取完成延迟直方图
+} mpr121_stats_t;
+
+// -------------------------- 函数接口 --------------------------
+/**
+ * @brief 获取统计快照（各计数器逐个原子读取/清零，无锁）
+ * @param[out] stats 统计快照
+ * @param reset true: 读取的同时清零
+ * @return esp_err_t ESP_OK: 成功；ESP_ERR_NOT_SUPPORTED: 编译时未启用统计
+ */
+esp_err_t mpr121_get_stats(mpr121_stats_t *stats, bool reset);
+
+/**
+ * @brief 打印统计快照（非零直方图桶按μs上限列出）
+ * @param stats 统计快照
+ */
+void mpr121_stats_dump(const mpr121_stats_t *stats);
+
+// -------------------------- 驱动内部埋点（MPR121_ENABLE_STATS=0时编译为空） --------------------------
+#if MPR121_ENABLE_STATS
+#include <esp_timer.h>
+
+void mpr121_stats_api(mpr121_api_t api);
+void mpr121_stats_txn(size_t tx_bytes, size_t rx_bytes, esp_err_t err, int64_t elapsed_us);
+void mpr121_stats_irq_latency(int64_t latency_us);
+
+#define MPR121_STATS_API(api) mpr121_stats_api(api)
+#define MPR121_STATS_TXN_BEGIN() int64_t mpr121_txn_start_us_ = esp_timer_get_time()
+#define MPR121_STATS_TXN_END(tx, rx, err) mpr121_stats_txn((tx), (rx), (err), esp_timer_get_time() - mpr121_txn_start_us_)
+#define MPR121_STATS_IRQ_LATENCY(us) mpr121_stats_irq_latency(us)
+#else
+#define MPR121_STATS_API(api) ((void)0)
+#define MPR121_STATS_TXN_BEGIN() ((void)0)
+#define MPR121_STATS_TXN_END(tx, rx, err) ((void)0)
+#define MPR121_STATS_IRQ_LATENCY(us) ((void)0)
+#endif
+
+#endif // MPR121_STATS_H
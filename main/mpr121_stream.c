@@ -0,0 +1,190 @@
+#include "mpr121_stream.h"
+#include <string.h>
+
+static const char *TAG = "mpr121_stream";
+
+#define STREAM_FRESH_BIT 0x04       // latest中表示“新帧尚未被取走”的标志位
+#define STREAM_INDEX_MASK 0x03      // latest中的帧索引
+#define STREAM_RATE_WINDOW_US 1000000
+
+// FILT_CDT_CFG字段（数据手册：D7~D5=CDT，D4~D3=SFI，D2~D0=ESI）
+#define STREAM_CDT_MASK 0xE0
+#define STREAM_SFI_4 0x00 // SFI=4次采样
+#define STREAM_ESI_1MS 0x00 // ESI=1ms
+
+// -------------------------- 静态辅助函数（仅内部使用） --------------------------
+/**
+ * @brief 定时器回调：仅唤醒采集任务，I2C读取在任务中完成
+ * @param arg 流模式上下文
+ */
+static void stream_timer_cb(void *arg)
+{
+    mpr121_stream_t *stream = (mpr121_stream_t *)arg;
+    xTaskNotifyGive(stream->task);
+}
+
+/**
+ * @brief 采集任务：每个采样周期读取一帧并发布到三缓冲
+ * @param arg 流模式上下文
+ */
+static void stream_task(void *arg)
+{
+    mpr121_stream_t *stream = (mpr121_stream_t *)arg;
+    int64_t window_start = esp_timer_get_time();
+    uint32_t window_frames = 0;
+
+    while (1)
+    {
+        uint32_t ticks = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (!stream->running)
+        {
+            break;
+        }
+        // 通知计数>1说明读取耗时超过采样周期，期间的周期被错过
+        if (ticks > 1)
+        {
+            atomic_fetch_add_explicit(&stream->dropped, ticks - 1, memory_order_relaxed);
+        }
+
+        if (mpr121_read_frame(stream->dev, &stream->frames[stream->back]) != ESP_OK)
+        {
+            atomic_fetch_add_explicit(&stream->read_errors, 1, memory_order_relaxed);
+            continue;
+        }
+
+        // 发布：将写好的帧与latest交换，取回的旧帧作为下一次的写缓冲
+        unsigned prev = atomic_exchange_explicit(&stream->latest, stream->back | STREAM_FRESH_BIT, memory_order_acq_rel);
+        if (prev & STREAM_FRESH_BIT)
+        {
+            atomic_fetch_add_explicit(&stream->overwritten, 1, memory_order_relaxed);
+        }
+        stream->back = prev & STREAM_INDEX_MASK;
+        atomic_fetch_add_explicit(&stream->frame_count, 1, memory_order_relaxed);
+
+        window_frames++;
+        int64_t now = esp_timer_get_time();
+        if (now - window_start >= STREAM_RATE_WINDOW_US)
+        {
+            atomic_store_explicit(&stream->fps, (unsigned)((int64_t)window_frames * 1000000 / (now - window_start)), memory_order_relaxed);
+            window_frames = 0;
+            window_start = now;
+        }
+    }
+
+    stream->task = NULL;
+    vTaskDelete(NULL);
+}
+
+// -------------------------- 外部接口实现 --------------------------
+esp_err_t mpr121_stream_start(mpr121_stream_t *stream, mpr121_dev_t *dev, uint32_t period_us)
+{
+    if (stream == NULL || dev == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(stream, 0, sizeof(*stream));
+    stream->dev = dev;
+    stream->period_us = period_us ? period_us : MPR121_STREAM_DEFAULT_PERIOD_US;
+    // 三缓冲初始分配：生产者0，latest为1（无新帧），消费者2
+    stream->back = 0;
+    atomic_init(&stream->latest, 1);
+    stream->front = 2;
+
+    // 设置最快采样节拍（保留CDT，SFI=4次，ESI=1ms），由影子缓存自动处理待机/运行切换
+    ESP_RETURN_ON_ERROR(mpr121_cfg_get(dev, MPR121_FILT_CDT_CFG, &stream->saved_cdt_cfg), TAG, "Read CDT cfg failed");
+    mpr121_cfg_set(dev, MPR121_FILT_CDT_CFG, (stream->saved_cdt_cfg & STREAM_CDT_MASK) | STREAM_SFI_4 | STREAM_ESI_1MS);
+    ESP_RETURN_ON_ERROR(mpr121_cfg_commit(dev), TAG, "Set fastest ESI/SFI failed");
+
+    stream->running = true;
+    if (xTaskCreate(stream_task, "mpr121_stream", MPR121_STREAM_TASK_STACK, stream,
+                    MPR121_STREAM_TASK_PRIO, &stream->task) != pdPASS)
+    {
+        stream->running = false;
+        stream->task = NULL;
+        ESP_LOGE(TAG, "Create stream task failed");
+        mpr121_stream_stop(stream); // 恢复进入流模式前的FILT_CDT_CFG
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_timer_create_args_t timer_args = {
+        .callback = stream_timer_cb,
+        .arg = stream,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "mpr121_stream",
+    };
+    esp_err_t err = esp_timer_create(&timer_args, &stream->timer);
+    if (err == ESP_OK)
+    {
+        err = esp_timer_start_periodic(stream->timer, stream->period_us);
+    }
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Start stream timer failed: %s", esp_err_to_name(err));
+        mpr121_stream_stop(stream);
+        return err;
+    }
+
+    ESP_LOGI(TAG, "Streaming started (period %lu us)", (unsigned long)stream->period_us);
+    return ESP_OK;
+}
+
+esp_err_t mpr121_stream_stop(mpr121_stream_t *stream)
+{
+    if (stream == NULL || stream->dev == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (stream->timer != NULL)
+    {
+        esp_timer_stop(stream->timer);
+        esp_timer_delete(stream->timer);
+        stream->timer = NULL;
+    }
+    if (stream->task != NULL)
+    {
+        // 通知采集任务退出，并等待其完成当前帧
+        stream->running = false;
+        xTaskNotifyGive(stream->task);
+        while (stream->task != NULL)
+        {
+            vTaskDelay(pdMS_TO_TICKS(1));
+        }
+    }
+
+    mpr121_cfg_set(stream->dev, MPR121_FILT_CDT_CFG, stream->saved_cdt_cfg);
+    ESP_RETURN_ON_ERROR(mpr121_cfg_commit(stream->dev), TAG, "Restore CDT cfg failed");
+    return ESP_OK;
+}
+
+bool mpr121_stream_acquire(mpr121_stream_t *stream, const mpr121_frame_t **frame)
+{
+    bool fresh = false;
+    if (atomic_load_explicit(&stream->latest, memory_order_acquire) & STREAM_FRESH_BIT)
+    {
+        // 用当前持有的帧换取最新帧，生产者始终有空闲缓冲可写，无需等待
+        unsigned prev = atomic_exchange_explicit(&stream->latest, stream->front, memory_order_acq_rel);
+        stream->front = prev & STREAM_INDEX_MASK;
+        fresh = true;
+    }
+    if (frame != NULL)
+    {
+        *frame = &stream->frames[stream->front];
+    }
+    return fresh;
+}
+
+void mpr121_stream_get_stats(mpr121_stream_t *stream, mpr121_stream_stats_t *stats)
+{
+    if (stream == NULL || stats == NULL)
+    {
+        return;
+    }
+
+    stats->frames = atomic_load_explicit(&stream->frame_count, memory_order_relaxed);
+    stats->dropped = atomic_load_explicit(&stream->dropped, memory_order_relaxed);
+    stats->overwritten = atomic_load_explicit(&stream->overwritten, memory_order_relaxed);
+    stats->read_errors = atomic_load_explicit(&stream->read_errors, memory_order_relaxed);
+    stats->fps = atomic_load_explicit(&stream->fps, memory_order_relaxed);
+}
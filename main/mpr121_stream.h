@@ -0,0 +1,86 @@
+#ifndef MPR121_STREAM_H
+#define MPR121_STREAM_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <esp_timer.h>
+#include "mpr121.h"
+
+// -------------------------- 可配置参数 --------------------------
+#define MPR121_STREAM_BUFFERS 3               // 三缓冲：生产者/消费者各持有一帧，另一帧为最新完成帧
+#define MPR121_STREAM_DEFAULT_PERIOD_US 5000  // 默认采样周期（须大于整帧读取的总线时间：100kHz约4.2ms，400kHz约1.1ms）
+#define MPR121_STREAM_TASK_STACK 3072         // 采集任务栈大小
+#define MPR121_STREAM_TASK_PRIO 10            // 采集任务优先级
+
+// -------------------------- 数据结构 --------------------------
+/**
+ * @brief 流模式统计
+ */
+typedef struct
+{
+    uint32_t frames;      // 已采集完成的帧数
+    uint32_t dropped;     // 因上一帧未读完而错过的采样周期数
+    uint32_t overwritten; // 消费者来不及取走而被新帧覆盖的帧数
+    uint32_t read_errors; // 读取失败次数
+    uint32_t fps;         // 最近1秒实际帧率
+} mpr121_stream_stats_t;
+
+/**
+ * @brief 连续高速流模式：定时器按固定周期触发整帧读取，结果写入三缓冲供消费者零拷贝访问
+ */
+typedef struct
+{
+    mpr121_dev_t *dev;                            // 设备句柄
+    uint32_t period_us;                           // 采样周期
+    esp_timer_handle_t timer;                     // 周期定时器
+    TaskHandle_t task;                            // 采集任务
+    volatile bool running;                        // 运行标志
+    uint8_t saved_cdt_cfg;                        // 进入流模式前的FILT_CDT_CFG（退出时恢复）
+
+    mpr121_frame_t frames[MPR121_STREAM_BUFFERS]; // 帧缓冲
+    atomic_uint latest;                           // 最新完成帧索引（bit2=尚未被消费者取走）
+    uint8_t back;                                 // 生产者正在写入的帧索引
+    uint8_t front;                                // 消费者当前持有的帧索引
+
+    atomic_uint frame_count;                      // 统计：已完成帧数
+    atomic_uint dropped;                          // 统计：错过的采样周期
+    atomic_uint overwritten;                      // 统计：被覆盖的帧
+    atomic_uint read_errors;                      // 统计：读取失败次数
+    atomic_uint fps;                              // 统计：最近1秒帧率
+} mpr121_stream_t;
+
+// -------------------------- 函数接口 --------------------------
+/**
+ * @brief 启动流模式：设置ESI=1ms、SFI=4次采样的最快节拍，并按period_us周期采集全部13个通道
+ * @note 每个周期一次43字节突发读取，周期短于读取的总线时间时多出的周期计入dropped，实际帧率受总线速度限制
+ * @param stream 流模式上下文（调用者分配，运行期间须保持有效）
+ * @param dev 已初始化的设备句柄
+ * @param period_us 采样周期（0=默认MPR121_STREAM_DEFAULT_PERIOD_US）
+ * @return esp_err_t ESP_OK: 启动成功；其他: 配置或资源创建失败（FILT_CDT_CFG已恢复）
+ */
+esp_err_t mpr121_stream_start(mpr121_stream_t *stream, mpr121_dev_t *dev, uint32_t period_us);
+
+/**
+ * @brief 停止流模式并恢复原有的FILT_CDT_CFG配置
+ * @param stream 流模式上下文
+ * @return esp_err_t ESP_OK: 停止成功；其他: 恢复配置失败
+ */
+esp_err_t mpr121_stream_stop(mpr121_stream_t *stream);
+
+/**
+ * @brief 获取最新完成帧（零拷贝，不阻塞生产者）
+ * @note 返回的指针在下一次调用本函数前有效；仅限单个消费者调用
+ * @param stream 流模式上下文
+ * @param[out] frame 指向最新帧的指针
+ * @return true: 有新帧；false: 自上次调用以来没有新帧（frame仍指向上一帧）
+ */
+bool mpr121_stream_acquire(mpr121_stream_t *stream, const mpr121_frame_t **frame);
+
+/**
+ * @brief 获取流模式统计
+ * @param stream 流模式上下文
+ * @param[out] stats 统计信息
+ */
+void mpr121_stream_get_stats(mpr121_stream_t *stream, mpr121_stream_stats_t *stats);
+
+#endif // MPR121_STREAM_H
@@ -0,0 +1,163 @@
+#include "mpr121_trace.h"
+#include <stdio.h>
+#include <esp_attr.h>
+#include <esp_timer.h>
+
+static const char *TAG = "mpr121_trace";
+
+_Static_assert((MPR121_TRACE_RING_SIZE & (MPR121_TRACE_RING_SIZE - 1)) == 0, "MPR121_TRACE_RING_SIZE must be a power of 2");
+_Static_assert(sizeof(mpr121_trace_rec_t) == 12, "trace record layout changed");
+
+#define TRACE_DRAIN_BATCH 16 // 输出任务每批取出的记录数
+
+/**
+ * @brief 环形缓冲槽：seq=写入位置+1表示记录完整，0表示正在写入
+ */
+typedef struct
+{
+    atomic_uint seq;
+    mpr121_trace_rec_t rec;
+} trace_slot_t;
+
+static trace_slot_t s_ring[MPR121_TRACE_RING_SIZE];
+static atomic_uint s_head;        // 下一个写入位置（生产者原子递增）
+static unsigned s_tail;           // 下一个读取位置（仅消费者访问）
+static uint32_t s_drained;        // 已取出记录数（仅消费者访问）
+static uint32_t s_dropped;        // 被覆盖的记录数（仅消费者访问）
+static TaskHandle_t s_drain_task; // 输出任务
+
+static const char *s_trace_type_names[MPR121_TRACE_TYPE_MAX] = {
+    "press", "release", "read-err", "write-err", "ev-overflow", "power", "recovery", "health", "user",
+};
+
+// -------------------------- 静态辅助函数（仅内部使用） --------------------------
+/**
+ * @brief 输出任务：周期性取出记录并格式化输出（格式化与串口开销全部在低优先级任务中）
+ * @param arg 输出周期（ms）
+ */
+static void trace_drain_task(void *arg)
+{
+    uint32_t period_ms = (uint32_t)(uintptr_t)arg;
+    mpr121_trace_rec_t recs[TRACE_DRAIN_BATCH];
+    char line[96];
+    uint32_t reported_dropped = 0;
+
+    while (1)
+    {
+        size_t n;
+        while ((n = mpr121_trace_read(recs, TRACE_DRAIN_BATCH)) > 0)
+        {
+            for (size_t i = 0; i < n; i++)
+            {
+                mpr121_trace_format(&recs[i], line, sizeof(line));
+                ESP_LOGI(TAG, "%s", line);
+            }
+        }
+        if (s_dropped != reported_dropped)
+        {
+            ESP_LOGW(TAG, "%lu trace records dropped", (unsigned long)(s_dropped - reported_dropped));
+            reported_dropped = s_dropped;
+        }
+        vTaskDelay(pdMS_TO_TICKS(period_ms) ? pdMS_TO_TICKS(period_ms) : 1);
+    }
+}
+
+// -------------------------- 外部接口实现 --------------------------
+void IRAM_ATTR mpr121_trace_write(mpr121_trace_type_t type, uint8_t electrode, uint16_t aux, int32_t value)
+{
+    unsigned pos = atomic_fetch_add_explicit(&s_head, 1, memory_order_relaxed);
+    trace_slot_t *slot = &s_ring[pos & (MPR121_TRACE_RING_SIZE - 1)];
+
+    // 先作废槽再写入，读取端据此发现被覆盖途中的记录
+    atomic_store_explicit(&slot->seq, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    slot->rec.timestamp_us = (uint32_t)esp_timer_get_time();
+    slot->rec.type = type;
+    slot->rec.electrode = electrode;
+    slot->rec.aux = aux;
+    slot->rec.value = value;
+    atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+}
+
+size_t mpr121_trace_read(mpr121_trace_rec_t *recs, size_t max)
+{
+    size_t count = 0;
+
+    while (count < max)
+    {
+        unsigned head = atomic_load_explicit(&s_head, memory_order_acquire);
+        if (s_tail == head)
+        {
+            break;
+        }
+        // 落后超过一圈：最旧的记录已被覆盖
+        if (head - s_tail > MPR121_TRACE_RING_SIZE)
+        {
+            s_dropped += head - s_tail - MPR121_TRACE_RING_SIZE;
+            s_tail = head - MPR121_TRACE_RING_SIZE;
+        }
+
+        trace_slot_t *slot = &s_ring[s_tail & (MPR121_TRACE_RING_SIZE - 1)];
+        unsigned seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        if (seq == 0 || seq - 1 < s_tail)
+        {
+            break; // 生产者已占位但尚未写完
+        }
+        recs[count] = slot->rec;
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&slot->seq, memory_order_relaxed) != seq || seq != s_tail + 1)
+        {
+            // 读取期间或之前已被新一圈覆盖，丢弃该槽并继续
+            s_dropped++;
+            s_tail++;
+            continue;
+        }
+        s_tail++;
+        s_drained++;
+        count++;
+    }
+    return count;
+}
+
+int mpr121_trace_format(const mpr121_trace_rec_t *rec, char *buf, size_t len)
+{
+    const char *name = rec->type < MPR121_TRACE_TYPE_MAX ? s_trace_type_names[rec->type] : "?";
+
+    switch (rec->type)
+    {
+    case MPR121_TRACE_PRESS:
+    case MPR121_TRACE_RELEASE:
+        return snprintf(buf, len, "%10lu us %-11s ELE%u latency %ld us", (unsigned long)rec->timestamp_us, name,
+                        rec->electrode, (long)rec->value);
+    case MPR121_TRACE_READ_ERROR:
+    case MPR121_TRACE_WRITE_ERROR:
+        return snprintf(buf, len, "%10lu us %-11s dev 0x%02X reg 0x%02X err 0x%lx", (unsigned long)rec->timestamp_us,
+                        name, rec->electrode, rec->aux, (unsigned long)rec->value);
+    default:
+        return snprintf(buf, len, "%10lu us %-11s %u %u %ld", (unsigned long)rec->timestamp_us, name,
+                        rec->electrode, rec->aux, (long)rec->value);
+    }
+}
+
+esp_err_t mpr121_trace_start_drain(uint32_t period_ms)
+{
+    if (s_drain_task != NULL)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (xTaskCreate(trace_drain_task, "mpr121_trace", MPR121_TRACE_DRAIN_STACK, (void *)(uintptr_t)period_ms,
+                    MPR121_TRACE_DRAIN_PRIO, &s_drain_task) != pdPASS)
+    {
+        s_drain_task = NULL;
+        ESP_LOGE(TAG, "Create trace drain task failed");
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+void mpr121_trace_get_stats(mpr121_trace_stats_t *stats)
+{
+    stats->written = atomic_load_explicit(&s_head, memory_order_relaxed);
+    stats->drained = s_drained;
+    stats->dropped = s_dropped;
+}
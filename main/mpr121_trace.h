@@ -0,0 +1,101 @@
+#ifndef MPR121_TRACE_H
+#define MPR121_TRACE_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include "mpr121.h"
+
+// -------------------------- 可配置参数 --------------------------
+#define MPR121_TRACE_RING_SIZE 128      // 跟踪记录环形缓冲容量（必须为2的幂）
+#define MPR121_TRACE_DRAIN_STACK 3072   // 输出任务栈大小
+#define MPR121_TRACE_DRAIN_PRIO 1       // 输出任务优先级（低于所有触摸处理任务）
+
+// -------------------------- 数据结构 --------------------------
+/**
+ * @brief 跟踪记录类型
+ */
+typedef enum
+{
+    MPR121_TRACE_PRESS = 0,      // 电极按下（value=IRQ到事件的延迟μs）
+    MPR121_TRACE_RELEASE,        // 电极释放（value=IRQ到事件的延迟μs）
+    MPR121_TRACE_READ_ERROR,     // 读取失败（electrode=I2C地址，aux=寄存器，value=esp_err_t）
+    MPR121_TRACE_WRITE_ERROR,    // 写入失败（electrode=I2C地址，aux=寄存器，value=esp_err_t）
+    MPR121_TRACE_EVENT_OVERFLOW, // 事件管线溢出（aux=累计IRQ溢出数，value=累计事件溢出数）
+    MPR121_TRACE_POWER,          // 低功耗状态切换（electrode=新状态，value=唤醒延迟μs）
+    MPR121_TRACE_RECOVERY,       // 总线故障恢复（electrode=I2C地址，aux=1表示重放了配置，value=恢复耗时μs，失败时为负的esp_err_t）
+    MPR121_TRACE_HEALTH,         // 芯片健康处理（electrode=通道，aux=MPR121_HEALTH_ACTION_*，value=超范围千分比）
+    MPR121_TRACE_USER,           // 应用自定义（各字段含义由应用决定）
+    MPR121_TRACE_TYPE_MAX,
+} mpr121_trace_type_t;
+
+/**
+ * @brief 定长二进制跟踪记录（12字节，小端，可整块导出后在主机端用mpr121_trace_format()解码）
+ */
+typedef struct
+{
+    uint32_t timestamp_us; // esp_timer时间低32位（约71分钟回绕）
+    uint8_t type;          // mpr121_trace_type_t
+    uint8_t electrode;     // 电极号或I2C地址（依记录类型）
+    uint16_t aux;          // 附加参数（寄存器地址等）
+    int32_t value;         // 数值（延迟、错误码等）
+} mpr121_trace_rec_t;
+
+/**
+ * @brief 跟踪统计
+ */
+typedef struct
+{
+    uint32_t written; // 已写入记录数
+    uint32_t drained; // 已取出记录数
+    uint32_t dropped; // 未及时取出而被覆盖的记录数
+} mpr121_trace_stats_t;
+
+// -------------------------- 函数接口 --------------------------
+/**
+ * @brief 写入一条跟踪记录（无锁，多生产者，可在ISR与任意任务中调用）
+ * @note 环满时覆盖最旧记录（由读取端计入dropped），写入方从不阻塞
+ * @param type 记录类型
+ * @param electrode 电极号或I2C地址
+ * @param aux 附加参数
+ * @param value 数值
+ */
+void mpr121_trace_write(mpr121_trace_type_t type, uint8_t electrode, uint16_t aux, int32_t value);
+
+/**
+ * @brief 取出最多max条记录（单消费者）
+ * @param[out] recs 记录缓冲区
+ * @param max 缓冲区容量
+ * @return size_t 取出的记录数
+ */
+size_t mpr121_trace_read(mpr121_trace_rec_t *recs, size_t max);
+
+/**
+ * @brief 将一条记录格式化为可读文本（纯C，无硬件依赖，可用于主机端解码导出的记录）
+ * @param rec 记录
+ * @param[out] buf 文本缓冲区
+ * @param len 缓冲区长度
+ * @return int 写入的字符数（同snprintf）
+ */
+int mpr121_trace_format(const mpr121_trace_rec_t *rec, char *buf, size_t len);
+
+/**
+ * @brief 启动低优先级输出任务：每period_ms取出全部记录并格式化输出到日志
+ * @param period_ms 输出周期
+ * @return esp_err_t ESP_OK: 启动成功；ESP_ERR_INVALID_STATE: 已启动；ESP_ERR_NO_MEM: 创建任务失败
+ */
+esp_err_t mpr121_trace_start_drain(uint32_t period_ms);
+
+/**
+ * @brief 获取跟踪统计
+ * @param[out] stats 统计快照
+ */
+void mpr121_trace_get_stats(mpr121_trace_stats_t *stats);
+
+// -------------------------- 驱动内部埋点（MPR121_ENABLE_TRACE=0时编译为空） --------------------------
+#if MPR121_ENABLE_TRACE
+#define MPR121_TRACE(type, electrode, aux, value) mpr121_trace_write((type), (electrode), (aux), (value))
+#else
+#define MPR121_TRACE(type, electrode, aux, value) ((void)0)
+#endif
+
+#endif // MPR121_TRACE_H
@@ -0,0 +1,272 @@
+#include "mpr121_tune.h"
+#include <string.h>
+
+static const char *TAG = "mpr121_tune";
+
+// -------------------------- 静态辅助函数（仅内部使用） --------------------------
+/**
+ * @brief 整数平方根（向下取整）
+ */
+static uint32_t tune_isqrt(uint64_t v)
+{
+    uint64_t root = 0;
+    uint64_t bit = 1ULL << 62;
+    while (bit > v)
+    {
+        bit >>= 2;
+    }
+    while (bit != 0)
+    {
+        if (v >= root + bit)
+        {
+            v -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)root;
+}
+
+/**
+ * @brief 将累计量src合并到dst
+ */
+static void tune_acc_merge(mpr121_tune_acc_t *dst, const mpr121_tune_acc_t *src)
+{
+    if (dst->frames == 0 || src->peak > dst->peak)
+    {
+        dst->peak = src->peak;
+    }
+    dst->frames += src->frames;
+    dst->sumsq += src->sumsq;
+    dst->flips += src->flips;
+}
+
+/**
+ * @brief 接受一个空闲窗口：计入噪声统计与当前阶段的误触发统计
+ */
+static void tune_accept(mpr121_tune_t *tune, int ch, const mpr121_tune_acc_t *acc)
+{
+    tune_acc_merge(&tune->idle[ch], acc);
+    if (tune->applied)
+    {
+        tune->report.idle_frames_after += acc->frames;
+        tune->report.spurious_after += acc->flips;
+    }
+    else
+    {
+        tune->report.idle_frames_before += acc->frames;
+        tune->report.spurious_before += acc->flips;
+    }
+}
+
+/**
+ * @brief 窗口结束：干净窗口先暂存，下一个窗口也干净时才接受；有触摸迹象时连同前后窗口一起丢弃
+ */
+static void tune_close_window(mpr121_tune_t *tune)
+{
+    uint16_t dirty = tune->reject_mask | tune->holdoff_mask;
+    for (int ch = 0; ch < MPR121_NUM_CHANNELS; ch++)
+    {
+        uint16_t bit = 1 << ch;
+        if (!(tune->cfg.channels & bit))
+        {
+            continue;
+        }
+        if (dirty & bit)
+        {
+            tune->report.rejected_windows += (tune->pending_mask & bit) ? 2 : 1;
+            tune->pending_mask &= ~bit;
+            continue;
+        }
+        if (tune->pending_mask & bit)
+        {
+            tune_accept(tune, ch, &tune->pending[ch]);
+        }
+        tune->pending[ch] = tune->win[ch];
+        tune->pending_mask |= bit;
+    }
+    tune->holdoff_mask = tune->reject_mask;
+    tune->reject_mask = 0;
+    tune->win_frames = 0;
+    memset(tune->win, 0, sizeof(tune->win));
+}
+
+/**
+ * @brief 开始新的统计阶段（丢弃未完成的窗口与噪声统计）
+ */
+static void tune_restart(mpr121_tune_t *tune)
+{
+    memset(tune->win, 0, sizeof(tune->win));
+    memset(tune->pending, 0, sizeof(tune->pending));
+    memset(tune->idle, 0, sizeof(tune->idle));
+    tune->pending_mask = 0;
+    tune->reject_mask = 0;
+    tune->holdoff_mask = 0;
+    tune->win_frames = 0;
+    tune->has_prev = false;
+}
+
+// -------------------------- 外部接口实现 --------------------------
+esp_err_t mpr121_tune_init(mpr121_tune_t *tune, const mpr121_tune_config_t *cfg)
+{
+    if (tune == NULL || (cfg != NULL && (cfg->channels == 0 || cfg->release_mult_x10 >= cfg->touch_mult_x10 ||
+                                        cfg->min_release >= cfg->min_touch)))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(tune, 0, sizeof(*tune));
+    if (cfg != NULL)
+    {
+        tune->cfg = *cfg;
+    }
+    else
+    {
+        tune->cfg.touch_mult_x10 = MPR121_TUNE_TOUCH_MULT_X10;
+        tune->cfg.release_mult_x10 = MPR121_TUNE_RELEASE_MULT_X10;
+        tune->cfg.min_touch = MPR121_TUNE_MIN_TOUCH;
+        tune->cfg.min_release = MPR121_TUNE_MIN_RELEASE;
+        tune->cfg.idle_guard = MPR121_TUNE_IDLE_GUARD;
+        tune->cfg.channels = (1 << MPR121_NUM_ELECTRODES) - 1;
+        tune->cfg.min_samples = MPR121_TUNE_MIN_SAMPLES;
+    }
+    return ESP_OK;
+}
+
+void mpr121_tune_add(mpr121_tune_t *tune, const mpr121_frame_t *frame)
+{
+    uint16_t touch = frame->touch_status & MPR121_STATUS_CH_MASK;
+    uint16_t flipped = tune->has_prev ? (touch ^ tune->prev_touch) : 0;
+    int32_t guard = tune->cfg.idle_guard;
+
+    for (int ch = 0; ch < MPR121_NUM_CHANNELS; ch++)
+    {
+        uint16_t bit = 1 << ch;
+        if (!(tune->cfg.channels & bit))
+        {
+            continue;
+        }
+
+        // 触摸使delta大幅为正；大幅为负说明基线尚未跟上（如刚释放），超范围通道的数据无意义
+        int32_t d = frame->delta[ch];
+        if (d > guard || d < -guard || (frame->oor_status & bit))
+        {
+            tune->reject_mask |= bit;
+        }
+        mpr121_tune_acc_t *acc = &tune->win[ch];
+        if (acc->frames == 0 || d > acc->peak)
+        {
+            acc->peak = (int16_t)d;
+        }
+        acc->frames++;
+        acc->sumsq += (uint64_t)(d * d);
+        acc->flips += (flipped & bit) ? 1 : 0;
+    }
+    tune->prev_touch = touch;
+    tune->has_prev = true;
+
+    if (++tune->win_frames >= MPR121_TUNE_WINDOW)
+    {
+        tune_close_window(tune);
+    }
+}
+
+void mpr121_tune_process(void *arg, const mpr121_frame_t *frame)
+{
+    mpr121_tune_add((mpr121_tune_t *)arg, frame);
+}
+
+esp_err_t mpr121_tune_collect(mpr121_tune_t *tune, mpr121_dev_t *dev, uint32_t frames, uint32_t period_ms)
+{
+    mpr121_frame_t frame;
+    TickType_t period = pdMS_TO_TICKS(period_ms);
+
+    for (uint32_t i = 0; i < frames; i++)
+    {
+        ESP_RETURN_ON_ERROR(mpr121_read_frame(dev, &frame), TAG, "Read frame failed");
+        mpr121_tune_add(tune, &frame);
+        vTaskDelay(period ? period : 1);
+    }
+    return ESP_OK;
+}
+
+esp_err_t mpr121_tune_compute(mpr121_tune_t *tune, mpr121_tune_result_t *result)
+{
+    const mpr121_tune_config_t *cfg = &tune->cfg;
+
+    memset(result, 0, sizeof(*result));
+    for (int ch = 0; ch < MPR121_NUM_CHANNELS; ch++)
+    {
+        const mpr121_tune_acc_t *acc = &tune->idle[ch];
+        result->samples[ch] = acc->frames;
+        result->peak[ch] = acc->peak;
+        if (!(cfg->channels & (1 << ch)) || acc->frames == 0 || acc->frames < cfg->min_samples)
+        {
+            continue;
+        }
+
+        // RMS相对基线计算（不减均值）：基线的固定偏移同样会推动delta越过阈值
+        uint32_t noise_x10 = tune_isqrt(acc->sumsq * 100 / acc->frames);
+        uint32_t touch = (noise_x10 * cfg->touch_mult_x10 + 99) / 100;
+        uint32_t release = (noise_x10 * cfg->release_mult_x10 + 99) / 100;
+        touch = touch < cfg->min_touch ? cfg->min_touch : touch;
+        release = release < cfg->min_release ? cfg->min_release : release;
+        touch = touch > 0xFF ? 0xFF : touch;
+        release = release >= touch ? touch - 1 : release;
+
+        result->noise_x10[ch] = noise_x10 > UINT16_MAX ? UINT16_MAX : noise_x10;
+        result->touch[ch] = touch;
+        result->release[ch] = release;
+        result->tuned |= 1 << ch;
+    }
+    return result->tuned ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t mpr121_tune_apply(mpr121_tune_t *tune, mpr121_dev_t *dev, const mpr121_tune_result_t *result)
+{
+    for (int ch = 0; ch < MPR121_NUM_CHANNELS; ch++)
+    {
+        if (!(result->tuned & (1 << ch)))
+        {
+            continue;
+        }
+        if (result->release[ch] >= result->touch[ch])
+        {
+            ESP_LOGE(TAG, "Invalid thresholds for ELE%d: touch %d, release %d", ch, result->touch[ch],
+                     result->release[ch]);
+            return ESP_ERR_INVALID_ARG;
+        }
+        mpr121_cfg_set(dev, MPR121_TOUCH_THRESH_0 + ch * 2, result->touch[ch]);
+        mpr121_cfg_set(dev, MPR121_RELEASE_THRESH_0 + ch * 2, result->release[ch]);
+    }
+    ESP_RETURN_ON_ERROR(mpr121_cfg_commit(dev), TAG, "Commit thresholds failed");
+
+    // 再次调校时与上一次调校的结果比较
+    if (tune->applied)
+    {
+        tune->report.idle_frames_before = tune->report.idle_frames_after;
+        tune->report.spurious_before = tune->report.spurious_after;
+        tune->report.idle_frames_after = 0;
+        tune->report.spurious_after = 0;
+    }
+    tune->applied = true;
+    tune_restart(tune);
+    return ESP_OK;
+}
+
+void mpr121_tune_get_report(const mpr121_tune_t *tune, mpr121_tune_report_t *report)
+{
+    *report = tune->report;
+    report->reduction_permille = 0;
+    if (report->spurious_before != 0 && report->idle_frames_after != 0)
+    {
+        // 1 - (after/frames_after) / (before/frames_before)
+        int64_t num = (int64_t)report->spurious_after * report->idle_frames_before * 1000;
+        int64_t den = (int64_t)report->spurious_before * report->idle_frames_after;
+        report->reduction_permille = (int32_t)(1000 - num / den);
+    }
+}
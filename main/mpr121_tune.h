@@ -0,0 +1,146 @@
+#ifndef MPR121_TUNE_H
+#define MPR121_TUNE_H
+
+#include <stdbool.h>
+#include "mpr121.h"
+
+// -------------------------- 可配置参数 --------------------------
+#define MPR121_TUNE_WINDOW 16              // 空闲判定窗口（帧）：窗口内通道无触摸迹象才计入噪声统计
+#define MPR121_TUNE_IDLE_GUARD 0x20        // 窗口内delta超过该值视为有触摸（整个窗口不计入）
+#define MPR121_TUNE_TOUCH_MULT_X10 40      // 触摸阈值 = 噪声RMS × 4.0
+#define MPR121_TUNE_RELEASE_MULT_X10 20    // 释放阈值 = 噪声RMS × 2.0
+#define MPR121_TUNE_MIN_TOUCH 4            // 触摸阈值下限（噪声极小时仍保留余量）
+#define MPR121_TUNE_MIN_RELEASE 2          // 释放阈值下限
+#define MPR121_TUNE_MIN_SAMPLES 256        // 通道至少需要的空闲帧数（不足时保留原阈值）
+
+// -------------------------- 数据结构 --------------------------
+/**
+ * @brief 调校配置
+ */
+typedef struct
+{
+    uint8_t touch_mult_x10;   // 触摸阈值相对噪声RMS的倍数（×10）
+    uint8_t release_mult_x10; // 释放阈值相对噪声RMS的倍数（×10）
+    uint8_t min_touch;        // 触摸阈值下限
+    uint8_t min_release;      // 释放阈值下限（需小于min_touch）
+    uint8_t idle_guard;       // 空闲判定：窗口内delta不超过该值
+    uint16_t channels;        // 参与调校的通道（bit0~bit11=ELE0~ELE11，bit12=ELEPROX）
+    uint32_t min_samples;     // 通道至少需要的空闲帧数
+} mpr121_tune_config_t;
+
+/**
+ * @brief 单通道累计量
+ */
+typedef struct
+{
+    uint32_t frames;  // 帧数
+    uint64_t sumsq;   // delta平方和
+    int16_t peak;     // 最大delta
+    uint32_t flips;   // 触摸状态翻转次数（每次翻转芯片产生一次IRQ）
+} mpr121_tune_acc_t;
+
+/**
+ * @brief 调校结果（各数组按通道索引）
+ */
+typedef struct
+{
+    uint16_t tuned;                             // 已计算新阈值的通道
+    uint32_t samples[MPR121_NUM_CHANNELS];      // 空闲帧数
+    uint16_t noise_x10[MPR121_NUM_CHANNELS];    // 噪声RMS（×10，相对基线，含偏移）
+    int16_t peak[MPR121_NUM_CHANNELS];          // 空闲时的最大delta
+    uint8_t touch[MPR121_NUM_CHANNELS];         // 新触摸阈值
+    uint8_t release[MPR121_NUM_CHANNELS];       // 新释放阈值
+} mpr121_tune_result_t;
+
+/**
+ * @brief 误触发统计：应用新阈值前后空闲窗口内的触摸状态翻转
+ */
+typedef struct
+{
+    uint32_t idle_frames_before;   // 应用前的空闲帧数（各通道合计）
+    uint32_t spurious_before;      // 应用前空闲窗口内的翻转次数（即误触发IRQ）
+    uint32_t idle_frames_after;    // 应用后的空闲帧数
+    uint32_t spurious_after;       // 应用后空闲窗口内的翻转次数
+    int32_t reduction_permille;    // 每帧误触发率的下降（千分比，应用后无数据时为0）
+    uint32_t rejected_windows;     // 因有触摸迹象而丢弃的通道窗口数
+} mpr121_tune_report_t;
+
+/**
+ * @brief 噪声驱动的阈值调校器：从空闲窗口统计各通道delta（(基线<<2)-滤波数据）的噪声，
+ *        按噪声RMS的倍数为每个电极设置触摸/释放阈值，并比较应用前后空闲时的误触发IRQ
+ *
+ * 不要求用户停止触摸：有触摸迹象的窗口及其前后相邻窗口整体丢弃。帧由调用者送入（如流水线的处理回调），
+ * 调校器本身不访问总线（mpr121_tune_apply()/mpr121_tune_collect()除外）。
+ */
+typedef struct
+{
+    mpr121_tune_config_t cfg;                       // 配置
+    mpr121_tune_acc_t win[MPR121_NUM_CHANNELS];     // 当前窗口
+    mpr121_tune_acc_t pending[MPR121_NUM_CHANNELS]; // 上一个干净窗口（下一个窗口也干净才接受，排除触摸前的上升沿）
+    mpr121_tune_acc_t idle[MPR121_NUM_CHANNELS];    // 已接受的空闲帧（当前阶段）
+    uint16_t pending_mask;                          // pending有效的通道
+    uint16_t reject_mask;                           // 当前窗口已出现触摸迹象的通道
+    uint16_t holdoff_mask;                          // 下一个窗口整体丢弃的通道（触摸后的释放拖尾）
+    uint16_t win_frames;                            // 当前窗口帧数
+    uint16_t prev_touch;                            // 上一帧的触摸状态
+    bool has_prev;                                  // prev_touch有效
+    bool applied;                                   // 已应用新阈值（此后统计计入应用后阶段）
+    mpr121_tune_report_t report;                    // 误触发统计
+} mpr121_tune_t;
+
+// -------------------------- 函数接口 --------------------------
+/**
+ * @brief 初始化调校器
+ * @param tune 调校器
+ * @param cfg 调校配置（NULL=使用可配置参数中的默认值，调校ELE0~ELE11）
+ * @return esp_err_t ESP_OK: 初始化成功；ESP_ERR_INVALID_ARG: 参数无效
+ */
+esp_err_t mpr121_tune_init(mpr121_tune_t *tune, const mpr121_tune_config_t *cfg);
+
+/**
+ * @brief 送入一帧（mpr121_read_frame()的结果）
+ * @param tune 调校器
+ * @param frame 帧
+ */
+void mpr121_tune_add(mpr121_tune_t *tune, const mpr121_frame_t *frame);
+
+/**
+ * @brief 流水线处理回调（arg为mpr121_tune_t指针）
+ */
+void mpr121_tune_process(void *arg, const mpr121_frame_t *frame);
+
+/**
+ * @brief 按周期读取帧并送入调校器（阻塞，调用期间不得有其他任务访问设备）
+ * @param tune 调校器
+ * @param dev 设备句柄
+ * @param frames 读取的帧数
+ * @param period_ms 读取周期（不小于芯片采样间隔，否则相邻帧重复）
+ * @return esp_err_t ESP_OK: 成功；其他: 读取失败
+ */
+esp_err_t mpr121_tune_collect(mpr121_tune_t *tune, mpr121_dev_t *dev, uint32_t frames, uint32_t period_ms);
+
+/**
+ * @brief 按已统计的噪声计算各通道阈值
+ * @param tune 调校器
+ * @param[out] result 结果（空闲帧不足的通道不在tuned中）
+ * @return esp_err_t ESP_OK: 至少一个通道已计算；ESP_ERR_NOT_FOUND: 所有通道的空闲帧都不足
+ */
+esp_err_t mpr121_tune_compute(mpr121_tune_t *tune, mpr121_tune_result_t *result);
+
+/**
+ * @brief 将新阈值写入影子缓存并一次提交（连续的阈值寄存器合并为块写），此后送入的帧计入应用后统计
+ * @param tune 调校器
+ * @param dev 设备句柄
+ * @param result mpr121_tune_compute()的结果
+ * @return esp_err_t ESP_OK: 应用成功；其他: 提交失败
+ */
+esp_err_t mpr121_tune_apply(mpr121_tune_t *tune, mpr121_dev_t *dev, const mpr121_tune_result_t *result);
+
+/**
+ * @brief 获取误触发统计
+ * @param tune 调校器
+ * @param[out] report 统计
+ */
+void mpr121_tune_get_report(const mpr121_tune_t *tune, mpr121_tune_report_t *report);
+
+#endif // MPR121_TUNE_H